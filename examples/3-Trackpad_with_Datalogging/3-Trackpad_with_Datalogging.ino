@@ -75,7 +75,9 @@ void setup() {
   err = usb.mount(&msd);                    //FLASH
   
   daq.button[0] = Button("Recording", 20, 65, 60, 20, WHITE, BLUE);
-  daq.button[0].setDisplayText("Record data");
+  daq.button[0].setLook(BUTTON_NORMAL, "Record data", WHITE, BLUE);
+  daq.button[0].setLook(BUTTON_ON, "Stop recording", YELLOW, RED);
+  daq.button[0].setToggle();	//Each release flips daq.button[0].on and shows the matching look
   daq.button[0].setAction(dataButton);
   
   daq.textbox[0] = Textbox("Data count", 20, 90, 60, 8, BLACK, WHITE);
@@ -111,29 +113,22 @@ void trackSlide(void){
   numDatapoints++;
   outStr += String(numDatapoints);
   daq.textbox[0].setDisplayText(outStr);
-  if(daq.fp != NULL){ //Ensure that the file pointer, fp, is not NULL. Don't try fprintf() with a NULL fp.
-  	//fprintf() works similiarly to printf() and snprintf(). Any reference on stdio.h will explain its use.
+  if(daq.fp != NULL){ //Ensure that the file pointer, fp, is not NULL.
+  	//recordSample() writes the time stamp and the values as a line of the data file.
+  	float values[2] = {xValue, yValue};
   	
-    fprintf(daq.fp, "%.3f, %.1f, %.1f\n", (float)millis()/1000.0, xValue, yValue);  //FLASH
+    daq.recordSample(daq.clock.now(), values, 2);  //FLASH
   }
   
 }
 
 void dataButton(void){
-	/* Toggle behavior is accomplished by alternating the dispText property */
+	/* The button is a toggle switch, so on tells which way it went */
 	
-  if(daq.button[0].dispText.equals("Record data")){
+  if(daq.button[0].on){
     daq.startDataRecording("TrackpadDemo2.csv");			//FLASH
-    daq.button[0].fgColor = YELLOW;
-    daq.button[0].bgColor = RED;
-    daq.button[0].setDisplayText("Stop recording");
-    daq.drawButton(0);
   }
-  else if(daq.button[0].dispText.equals("Stop recording")){
+  else{
     daq.endDataRecording();								//FLASH
-    daq.button[0].fgColor = WHITE;
-    daq.button[0].bgColor = BLUE;
-    daq.button[0].setDisplayText("Record data");
-    daq.drawButton(0);
   }
 }
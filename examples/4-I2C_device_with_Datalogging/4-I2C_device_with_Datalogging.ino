@@ -84,7 +84,7 @@ void setup() {
   err = usb.mount(&msd);                    //FLASH
   
   daq.textbox[0] = Textbox("Time", 1, 1, 98, 12, BLACK, WHITE);
-  daq.textbox[0].setDisplayText(String((float)millis()/1000.0,3)); 
+  daq.textbox[0].setDisplayText(String(millis()/1000.0,3)); 
 
   daq.textbox[1] = Textbox("Temperature", 1, 14, 98, 12, WHITE, GREEN);
   daq.textbox[1].setDisplayText("deg C"); 
@@ -93,7 +93,9 @@ void setup() {
   daq.textbox[2].setDisplayText("hPa"); 
 
   daq.button[0] = Button("Recording", 20, 65, 60, 20, WHITE, BLUE);
-  daq.button[0].setDisplayText("Record data");
+  daq.button[0].setLook(BUTTON_NORMAL, "Record data", WHITE, BLUE);
+  daq.button[0].setLook(BUTTON_ON, "Stop recording", YELLOW, RED);
+  daq.button[0].setToggle();	//Each release flips daq.button[0].on and shows the matching look
   daq.button[0].setAction(dataButton);
   
   daq.drawAll();	//Don't leave setup() without this step!
@@ -124,9 +126,10 @@ void loop() {
 
   if (bmp280.getTempPres(temperature, pressure)){     //Data collection
     if(daq.fp != NULL && dataRecording == true){
-      fprintf(daq.fp, "%.3f, %.2f, %.2f\n", (float)millis()/1000., temperature, 100.0*pressure);
+      float values[2] = {temperature, 100.0f*pressure};
+      daq.recordSample(daq.clock.now(), values, 2);    //Time stamp in microseconds, never rounded like a float
     }
-    daq.textbox[0].setDisplayText(String((float)millis()/1000.0,3));
+    daq.textbox[0].setDisplayText(String(millis()/1000.0,3));
     daq.textbox[1].setDisplayText(String(temperature,2));
     daq.textbox[2].setDisplayText(String(100.0*pressure,2));
   }
@@ -138,22 +141,14 @@ void loop() {
 }
 
 void dataButton(void){
-	/* Toggle behavior is accomplished by alternating the dispText property */
+	/* The button is a toggle switch, so on tells which way it went */
 	
-  if(daq.button[0].dispText.equals("Record data")){
+  if(daq.button[0].on){
     daq.startDataRecording("I2C_test.csv");			//FLASH
-    daq.button[0].fgColor = YELLOW;
-    daq.button[0].bgColor = RED;
-    daq.button[0].setDisplayText("Stop recording");
     dataRecording = true;
-    daq.drawButton(0);
   }
-  else if(daq.button[0].dispText.equals("Stop recording")){
+  else{
     daq.endDataRecording();								//FLASH
-    daq.button[0].fgColor = WHITE;
-    daq.button[0].bgColor = BLUE;
-    daq.button[0].setDisplayText("Record data");
     dataRecording = false;
-    daq.drawButton(0);
   }
 }
@@ -0,0 +1,189 @@
+/**
+
+@file
+
+Stand-in for Arduino.h when the GigaDAQ blitters are built on a desktop computer. It provides a
+simulated DMA2D engine with the same registers as the STM32H7, so that Dma2dBlitter runs exactly the
+code it runs on the GIGA. The engine carries out an operation when yield() is called, which is what
+Blitter::wait() does while waiting, and then raises its interrupt like the real one.
+
+Only the parts of the engine that Dma2dBlitter uses are simulated: register-to-memory fills,
+memory-to-memory copies of RGB565 pixels, and loading an ARGB8888 color lookup table and converting
+L8 pixels through it to RGB565. Loading the table takes a call of yield() of its own and raises the
+interrupt when it is done, as on the real engine.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _BLIT_SIM_ARDUINO_INCLUDE_
+#define _BLIT_SIM_ARDUINO_INCLUDE_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+//Writing a flag to IFCR clears it in ISR, as in the real engine
+struct ClearRegister {
+	ClearRegister &operator=(uintptr_t flags);
+};
+//Registers are as wide as a pointer here, so that addresses fit as they do on the 32-bit GIGA
+struct DMA2D_TypeDef {
+	volatile uintptr_t CR, ISR, FGMAR, FGOR, FGPFCCR, FGCMAR, OPFCCR, OCOLR, OMAR, OOR, NLR;
+	ClearRegister IFCR;
+};
+struct RCC_TypeDef {
+	volatile uint32_t AHB3ENR;
+};
+
+#define DMA2D_CR_START			(1UL << 0)
+#define DMA2D_CR_TEIE			(1UL << 8)
+#define DMA2D_CR_TCIE			(1UL << 9)
+#define DMA2D_CR_CAEIE			(1UL << 11)
+#define DMA2D_CR_CTCIE			(1UL << 12)
+#define DMA2D_CR_MODE_0			(1UL << 16)
+#define DMA2D_CR_MODE_1			(1UL << 17)
+#define DMA2D_ISR_TEIF			(1UL << 0)
+#define DMA2D_ISR_TCIF			(1UL << 1)
+#define DMA2D_ISR_CAEIF			(1UL << 3)
+#define DMA2D_ISR_CTCIF			(1UL << 4)
+#define DMA2D_IFCR_CTEIF		(1UL << 0)
+#define DMA2D_IFCR_CTCIF		(1UL << 1)
+#define DMA2D_IFCR_CAECIF		(1UL << 3)
+#define DMA2D_IFCR_CCTCIF		(1UL << 4)
+#define DMA2D_IFCR_CCEIF		(1UL << 5)
+#define DMA2D_FGPFCCR_CM_0		(1UL << 0)
+#define DMA2D_FGPFCCR_CM_1		(1UL << 1)
+#define DMA2D_FGPFCCR_CM_2		(1UL << 2)
+#define DMA2D_FGPFCCR_START		(1UL << 5)
+#define DMA2D_FGPFCCR_CS_Pos	8
+#define DMA2D_OPFCCR_CM_1		(1UL << 1)
+#define DMA2D_NLR_PL_Pos		16
+#define RCC_AHB3ENR_DMA2DEN		(1UL << 4)
+#define DMA2D_IRQn				90
+
+inline DMA2D_TypeDef simDma2d;
+inline RCC_TypeDef simRcc;
+#define DMA2D (&simDma2d)
+
+inline ClearRegister &ClearRegister::operator=(uintptr_t flags){
+	simDma2d.ISR &= ~flags;
+	return *this;
+}
+#define RCC (&simRcc)
+
+inline uintptr_t simVector = 0;
+inline bool simIrqEnabled = false;
+inline uint32_t simPrimask = 0;
+inline uint32_t simOperations = 0;	//Operations the engine has carried out
+inline uint32_t simClutLoads = 0;	//Color lookup tables the engine has loaded
+inline uint32_t simClut[256];		//The engine's color lookup table
+inline int simBusy = 0;			//Calls of yield() left until another user of the engine, such as the display library, is done with it
+
+inline void NVIC_SetVector(int, uintptr_t vector){ simVector = vector; }
+inline void NVIC_EnableIRQ(int){ simIrqEnabled = true; }
+inline uint32_t __get_PRIMASK(void){ return simPrimask; }
+inline void __set_PRIMASK(uint32_t p){ simPrimask = p; }
+inline void __disable_irq(void){ simPrimask = 1; }
+inline void __enable_irq(void){ simPrimask = 0; }
+
+//Makes the engine busy with an operation of another user for a number of calls of yield()
+inline bool simOtherUser(int calls){
+	if(simDma2d.CR & DMA2D_CR_START){
+		return false;
+	}
+	simDma2d.CR = DMA2D_CR_START;		//Without interrupts, as the display library works
+	simBusy = calls;
+	return true;
+}
+
+//Carries out the operation that was started, if any, and raises the interrupt
+inline void yield(void){
+	DMA2D_TypeDef &d = simDma2d;
+	uint16_t *dst, *src;
+	uint8_t *index;
+	uint32_t c;
+	int w, h, i, j;
+
+	if(simBusy > 0){
+		if(--simBusy == 0){
+			d.CR &= ~DMA2D_CR_START;
+		}
+		return;
+	}
+	if(d.FGPFCCR & DMA2D_FGPFCCR_START){		//Loading the lookup table
+		if(d.CR & DMA2D_CR_START){
+			d.ISR |= DMA2D_ISR_CAEIF;		//Only one of the two at a time
+		}
+		else{
+			memcpy(simClut, (const void *)d.FGCMAR, (((d.FGPFCCR >> DMA2D_FGPFCCR_CS_Pos) & 0xFF) + 1) * sizeof(uint32_t));
+			d.ISR |= DMA2D_ISR_CTCIF;
+			simClutLoads++;
+		}
+		d.FGPFCCR &= ~DMA2D_FGPFCCR_START;
+		if(simIrqEnabled && simPrimask == 0 && (d.CR & (DMA2D_CR_CTCIE | DMA2D_CR_CAEIE)) && simVector != 0){
+			((void (*)(void))simVector)();
+		}
+		return;
+	}
+	if(!(d.CR & DMA2D_CR_START)){
+		return;
+	}
+	if(!(simRcc.AHB3ENR & RCC_AHB3ENR_DMA2DEN) || (d.OPFCCR & 7) != 2){
+		d.ISR |= DMA2D_ISR_TEIF;
+	}
+	else{
+		dst = (uint16_t *)d.OMAR;
+		src = (uint16_t *)d.FGMAR;
+		index = (uint8_t *)d.FGMAR;
+		w = (d.NLR >> DMA2D_NLR_PL_Pos) & 0x3FFF;
+		h = d.NLR & 0xFFFF;
+		for(j = 0; j < h; j++){
+			for(i = 0; i < w; i++){
+				if((d.CR & (DMA2D_CR_MODE_0 | DMA2D_CR_MODE_1)) == (DMA2D_CR_MODE_0 | DMA2D_CR_MODE_1)){
+					*dst++ = (uint16_t)d.OCOLR;
+				}
+				else if((d.CR & (DMA2D_CR_MODE_0 | DMA2D_CR_MODE_1)) == DMA2D_CR_MODE_0 && (d.FGPFCCR & 0xF) == 5){
+					c = simClut[*index++];		//L8 through the table, ARGB8888 to RGB565 by dropping the low bits
+					*dst++ = (uint16_t)(((c >> 8) & 0xF800) | ((c >> 5) & 0x07E0) | ((c >> 3) & 0x001F));
+				}
+				else{
+					*dst++ = *src++;
+				}
+			}
+			dst += d.OOR;
+			src += d.FGOR;
+			index += d.FGOR;
+		}
+		d.ISR |= DMA2D_ISR_TCIF;
+		simOperations++;
+	}
+	d.CR &= ~DMA2D_CR_START;
+	if(simIrqEnabled && simPrimask == 0 && (d.CR & (DMA2D_CR_TCIE | DMA2D_CR_TEIE)) && simVector != 0){
+		((void (*)(void))simVector)();
+	}
+}
+
+#endif /* _BLIT_SIM_ARDUINO_INCLUDE_ */
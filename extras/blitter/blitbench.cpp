@@ -0,0 +1,242 @@
+/**
+
+@file
+
+blitbench - checks the GigaDAQ blitters against a plain pixel-by-pixel reference and times them.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. blitbench
+
+The Arduino.h in this folder simulates the DMA2D engine of the STM32H7, so Dma2dBlitter runs the same
+code as on the GIGA, including its queue, fences, interrupt and the waits for the engine to be free.
+
+Usage:
+
+    blitbench [operations]
+
+Thousands of random fills, copies and palette expansions (default 20000), many of them partly off
+the surface and some with a new palette, are done by SoftwareBlitter, by Dma2dBlitter and by the reference, and the three surfaces must stay identical.
+Some operations are left queued while more are added, and the engine is sometimes made busy as if the
+display library were using it. Then the time of full-screen and control-sized operations is measured
+with SoftwareBlitter. On a computer this only compares the sizes with each other; the GIGA itself is
+several times slower.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "Arduino.h"
+#include "Blitter.h"
+
+const int SCREEN_W = 480;
+const int SCREEN_H = 800;
+
+static double seconds(void){
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static BlitSurface surface(uint16_t *pixels, int w, int h, int stride){
+	BlitSurface s = {pixels, w, h, stride};
+	return s;
+}
+
+//The reference: one pixel at a time, each checked against the edges
+static void referenceFill(BlitSurface &dst, int x, int y, int w, int h, uint16_t color){
+	int i, j;
+
+	for(j = y; j < y + h; j++){
+		for(i = x; i < x + w; i++){
+			if(i >= 0 && i < dst.width && j >= 0 && j < dst.height){
+				dst.pixels[j * dst.stride + i] = color;
+			}
+		}
+	}
+}
+static void referenceCopy(BlitSurface &dst, int x, int y, const BlitSurface &src){
+	int i, j;
+
+	for(j = 0; j < src.height; j++){
+		for(i = 0; i < src.width; i++){
+			if(x + i >= 0 && x + i < dst.width && y + j >= 0 && y + j < dst.height){
+				dst.pixels[(y + j) * dst.stride + x + i] = src.pixels[j * src.stride + i];
+			}
+		}
+	}
+}
+
+static void referenceExpand(BlitSurface &dst, int x, int y, const IndexedSurface &src){
+	int i, j;
+
+	for(j = 0; j < src.height; j++){
+		for(i = 0; i < src.width; i++){
+			if(x + i >= 0 && x + i < dst.width && y + j >= 0 && y + j < dst.height){
+				dst.pixels[(y + j) * dst.stride + x + i] = src.palette[src.pixels[j * src.stride + i]];
+			}
+		}
+	}
+}
+
+static int check(int operations){
+	const int W = 97, H = 61, STRIDE = 104;		//Odd sizes and a stride wider than a row find more mistakes
+	static uint16_t ref[STRIDE * H], soft[STRIDE * H], dma[STRIDE * H], src[128 * 128];
+	static uint8_t indexed[NUM_PALETTE_COLORS][128 * 128];	//Pixels for each size of palette
+	uint16_t palette[NUM_PALETTE_COLORS];
+	BlitSurface r = surface(ref, W, H, STRIDE), s = surface(soft, W, H, STRIDE), d = surface(dma, W, H, STRIDE);
+	BlitSurface from;
+	IndexedSurface fromIndexed;
+	SoftwareBlitter software;
+	Dma2dBlitter dma2d;
+	uint32_t fence;
+	int i, j, x, y, w, h, colors = 1, pending = 0, busy = 0, bad = 0;
+	uint16_t color;
+
+	for(i = 0; i < 128 * 128; i++){
+		src[i] = rand();
+		for(j = 0; j < NUM_PALETTE_COLORS; j++){
+			indexed[j][i] = rand() % (j + 1);
+		}
+	}
+	palette[0] = 0;
+	for(i = 0; i < operations; i++){
+		x = rand() % (W + 40) - 20;
+		y = rand() % (H + 40) - 20;
+		w = rand() % 60;
+		h = rand() % 60;
+		if(rand() % 3 == 0){
+			if(rand() % 4 == 0){		//Otherwise the same palette again, which is not loaded again
+				colors = 1 + rand() % NUM_PALETTE_COLORS;
+				for(j = 0; j < colors; j++){
+					palette[j] = rand();
+				}
+			}
+			fromIndexed.pixels = indexed[colors - 1] + rand() % 1000;
+			fromIndexed.width = w;
+			fromIndexed.height = h;
+			fromIndexed.stride = w + rand() % 20;
+			fromIndexed.palette = palette;
+			fromIndexed.colors = colors;
+			referenceExpand(r, x, y, fromIndexed);
+			software.expand(s, x, y, fromIndexed);
+			fence = dma2d.expand(d, x, y, fromIndexed);
+			palette[rand() % colors] = rand();		//May change as soon as expand() returns
+		}
+		else if(rand() % 2){
+			color = rand();
+			referenceFill(r, x, y, w, h, color);
+			software.fill(s, x, y, w, h, color);
+			fence = dma2d.fill(d, x, y, w, h, color);
+		}
+		else{
+			from = surface(src + rand() % 1000, w, h, w + rand() % 20);
+			referenceCopy(r, x, y, from);
+			software.copy(s, x, y, from);
+			fence = dma2d.copy(d, x, y, from);
+		}
+		if(fence != 0 && !dma2d.done(fence)){
+			pending++;		//Still with the engine when the call returned
+		}
+		if(rand() % 50 == 0 && simOtherUser(1 + rand() % 5)){
+			busy++;
+		}
+		if(rand() % 8 == 0){	//Otherwise leave operations queued while adding more
+			dma2d.finish();
+			if(memcmp(ref, soft, sizeof(ref)) != 0 || memcmp(ref, dma, sizeof(ref)) != 0){
+				bad++;
+			}
+		}
+	}
+	dma2d.finish();
+	if(memcmp(ref, soft, sizeof(ref)) != 0 || memcmp(ref, dma, sizeof(ref)) != 0){
+		bad++;
+	}
+	printf("%d operations: %u on the engine, %u palettes loaded, %d still running when the call returned, %d times engine busy elsewhere\n",
+	       operations, dma2d.started, simClutLoads, pending, busy);
+	printf("%s\n", bad ? "MISMATCH between the blitters and the reference" : "all surfaces identical to the reference");
+	return bad ? 1 : 0;
+}
+
+static void bench(void){
+	static uint16_t screen[SCREEN_W * SCREEN_H], page[SCREEN_W * SCREEN_H], canvas[240 * 80];
+	static uint8_t canvas8[240 * 80];
+	static const uint16_t palette[3] = {0x0000, 0x001F, 0xFFFF};
+	BlitSurface scr = surface(screen, SCREEN_W, SCREEN_H, SCREEN_W);
+	BlitSurface pg = surface(page, SCREEN_W, SCREEN_H, SCREEN_W);
+	BlitSurface cv = surface(canvas, 80, 240, 80);
+	IndexedSurface cv8 = {canvas8, 80, 240, 80, palette, 3};
+	SoftwareBlitter software;
+	double t;
+	int i, n;
+
+	n = 200;
+	t = seconds();
+	for(i = 0; i < n; i++){
+		software.fill(scr, 0, 0, SCREEN_W, SCREEN_H, i);
+	}
+	t = (seconds() - t) / n;
+	printf("full-screen fill:     %8.1f us  (%.0f Mpixel/s)\n", t * 1e6, SCREEN_W * SCREEN_H / t / 1e6);
+
+	t = seconds();
+	for(i = 0; i < n; i++){
+		software.copy(scr, 0, 0, pg);
+	}
+	t = (seconds() - t) / n;
+	printf("full-screen copy:     %8.1f us  (%.0f Mpixel/s)\n", t * 1e6, SCREEN_W * SCREEN_H / t / 1e6);
+
+	n = 20000;
+	t = seconds();
+	for(i = 0; i < n; i++){
+		software.copy(scr, (i * 7) % 400, (i * 13) % 560, cv);	//A button-sized canvas in landscape
+	}
+	t = (seconds() - t) / n;
+	printf("80x240 canvas copy:   %8.2f us  (%.0f Mpixel/s)\n", t * 1e6, 80 * 240 / t / 1e6);
+
+	t = seconds();
+	for(i = 0; i < n; i++){
+		software.expand(scr, (i * 7) % 400, (i * 13) % 560, cv8);	//The same canvas with a palette
+	}
+	t = (seconds() - t) / n;
+	printf("80x240 palette expand:%8.2f us  (%.0f Mpixel/s)\n", t * 1e6, 80 * 240 / t / 1e6);
+
+	t = seconds();
+	for(i = 0; i < n; i++){
+		software.fill(scr, i % SCREEN_W, 100, 1, 300, i);		//One column of an overview graph
+	}
+	t = (seconds() - t) / n;
+	printf("1x300 column fill:    %8.2f us\n", t * 1e6);
+}
+
+int main(int argc, char *argv[]){
+	int rc;
+
+	srand(1);
+	rc = check((argc > 1) ? atoi(argv[1]) : 20000);
+	bench();
+	return rc;
+}
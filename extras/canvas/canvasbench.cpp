@@ -0,0 +1,176 @@
+/**
+
+@file
+
+canvasbench - measures what drawing controls on 8-bit canvases with a palette costs and saves,
+compared with RGB565 canvases: canvas memory, time to draw on the canvas, and time to copy it to the
+screen.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. canvasbench
+
+Usage:
+
+    canvasbench [repeats]
+
+A button, a text box and a slider of typical landscape sizes are each drawn repeats times (default
+2000) on an ArenaCanvas16 and on an ArenaCanvas8, with the same calls GigaDAQ makes, and copied to
+the screen by SoftwareBlitter: copy() for the RGB565 canvas, expand() with the palette for the 8-bit
+one. The two results on the screen must be identical. Bytes moved counts the canvas written once and
+then read, and the screen written.
+
+The drawing uses the stand-in GFX library of extras/soak/host, so the drawing times only compare the
+two formats with each other. Whole-screen checks of the 8-bit canvases against the RGB565 ones, in
+every rotation, are in extras/framebuffer.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "GigaDAQ.h"
+
+GigaDAQ daq(LANDSCAPE_USBRIGHT);
+uint16_t reference[GIGA_DS_WIDTH * GIGA_DS_HEIGHT];
+
+struct Shape {
+	const char *name;
+	int w, h;			//Pixels on the rotated screen
+	bool slider;
+	const char *text;
+};
+
+static double seconds(void){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//Draws a shape on a canvas as GigaDAQ does. fg and bg are colors, or numbers in the palette.
+static void render(Adafruit_GFX &canvas, const Shape &s, uint16_t fg, uint16_t bg){
+	if(s.slider){
+		canvas.fillScreen(bg);
+		canvas.drawRect(0, 0, s.w, s.h, fg);
+		canvas.fillRect(0, s.h / 3, s.w, s.h - s.h / 3, fg);
+	}
+	else{
+		daq.drawLabel(canvas, s.text, s.w, s.h, fg, bg);
+	}
+}
+
+int main(int argc, char **argv){
+	const Shape shapes[] = {
+		{"button", 240, 80, false, "Record"},
+		{"text box", 400, 48, false, "-0.003 V"},
+		{"slider", 60, 400, true, ""}
+	};
+	const uint16_t FG = 0xFFFF, BG = 0x001F;
+	int repeats = (argc > 1) ? atoi(argv[1]) : 2000;
+	int i, k, n, cw, ch, x, y, w, h, failures = 0;
+	double t, render16, render8, blit16, blit8;
+	uint16_t palette[3];
+	BlitSurface screen, src;
+	IndexedSurface src8;
+
+	daq.begin();
+	screen = daq.screenSurface();
+	printf("%-10s %-7s %12s %10s %10s %12s\n", "control", "format", "canvas bytes", "draw us", "copy us", "bytes moved");
+	for(k = 0; k < 3; k++){
+		const Shape &s = shapes[k];
+		cw = (daq.rotation & 1) ? s.h : s.w;		//Canvases are made in the screen buffer's own orientation
+		ch = (daq.rotation & 1) ? s.w : s.h;
+		x = 20;
+		y = 20;
+		w = s.w;
+		h = s.h;
+		daq.toScreen(x, y, w, h);
+
+		ArenaCanvas16 canvas16(cw, ch, daq.sdramArena);
+		ArenaCanvas8 canvas8(cw, ch, daq.sdramArena);
+		canvas16.setRotation(daq.rotation);
+		canvas8.setRotation(daq.rotation);
+		if(s.slider){
+			palette[0] = BG;				//Sliders have no black
+			palette[1] = FG;
+			n = 2;
+		}
+		else{
+			palette[0] = 0x0000;
+			palette[1] = BG;
+			palette[2] = FG;
+			n = 3;
+		}
+
+		t = seconds();
+		for(i = 0; i < repeats; i++){
+			render(canvas16, s, FG, BG);
+		}
+		render16 = (seconds() - t) / repeats;
+		t = seconds();
+		for(i = 0; i < repeats; i++){
+			s.slider ? render(canvas8, s, 1, 0) : render(canvas8, s, 2, 1);
+		}
+		render8 = (seconds() - t) / repeats;
+
+		src.pixels = canvas16.getBuffer();
+		src.width = w;
+		src.height = h;
+		src.stride = w;
+		src8.pixels = canvas8.getBuffer();
+		src8.width = w;
+		src8.height = h;
+		src8.stride = w;
+		src8.palette = palette;
+		src8.colors = n;
+
+		memset(screen.pixels, 0, sizeof(reference));
+		t = seconds();
+		for(i = 0; i < repeats; i++){
+			daq.softwareBlitter.copy(screen, x, y, src);
+		}
+		blit16 = (seconds() - t) / repeats;
+		memcpy(reference, screen.pixels, sizeof(reference));
+		memset(screen.pixels, 0, sizeof(reference));
+		t = seconds();
+		for(i = 0; i < repeats; i++){
+			daq.softwareBlitter.expand(screen, x, y, src8);
+		}
+		blit8 = (seconds() - t) / repeats;
+		if(memcmp(reference, screen.pixels, sizeof(reference)) != 0){
+			printf("%s: the 8-bit canvas gives a different picture\n", s.name);
+			failures++;
+		}
+
+		printf("%-10s %-7s %12d %10.2f %10.2f %12d\n", s.name, "RGB565", cw * ch * 2, render16 * 1e6, blit16 * 1e6, cw * ch * (2 + 2 + 2));
+		printf("%-10s %-7s %12d %10.2f %10.2f %12d\n", "", "8-bit", cw * ch, render8 * 1e6, blit8 * 1e6, cw * ch * (1 + 1 + 2));
+	}
+	printf("\n%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,183 @@
+/**
+
+@file
+
+channelstress - hammers a ChannelRegistry from several threads at once to show that readers never see a
+value with another value's time stamp, and never see time go backwards.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. channelstress
+
+Usage:
+
+    channelstress [seconds] [writers] [readers]
+
+Each writer thread owns some of the NUM_CHANNELS channels and writes them as fast as it can. Every value
+is made from its time stamp, so a reader can tell whether the two belong together. Reader threads read
+random channels with get() and check every value. get() gives up on a channel that was being rewritten
+during all CHANNEL_READ_TRIES attempts; on a computer with fewer cores than threads this mostly happens
+when a writer was switched out halfway through a value. For comparison, they also read the same fields
+directly without the sequence number, which shows how often an unguarded read would have been torn.
+
+The run fails (exit status 1) if any guarded read was torn or went back in time.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "ChannelRegistry.h"
+
+static ChannelRegistry registry;
+static std::atomic<bool> running(true);
+
+struct ReaderStats {
+	uint64_t reads, misses, torn, backwards, raw, rawTorn;
+};
+
+//The value that belongs with a time stamp. Exact as a float, since it stays below 2^24.
+static float valueFor(uint64_t t){
+	return (float)((t >> 8) & 0xFFFFFF);
+}
+
+static void writer(int first, int step, uint64_t *writes){
+	uint64_t k = 0;
+	int ch;
+
+	while(running.load(std::memory_order_relaxed)){
+		k++;
+		for(ch = first; ch < NUM_CHANNELS; ch += step){
+			uint64_t t = (k << 8) | ch;		//Low byte names the channel, so a time from another channel shows too
+			registry.set(ch, valueFor(t), t);
+		}
+	}
+	*writes = k * ((NUM_CHANNELS - first + step - 1) / step);
+}
+
+static void reader(unsigned seed, ReaderStats *st){
+	uint64_t last[NUM_CHANNELS], t;
+	uint32_t bits;
+	float v, rv;
+	int ch;
+
+	memset(st, 0, sizeof(*st));
+	memset(last, 0, sizeof(last));
+	while(running.load(std::memory_order_relaxed)){
+		seed = seed * 1103515245 + 12345;
+		ch = (seed >> 16) % NUM_CHANNELS;
+
+		if(!registry.get(ch, v, t)){
+			st->misses++;
+			st->reads++;
+			continue;
+		}
+		st->reads++;
+		if((t & 0xFF) != (uint64_t)ch || v != valueFor(t)){
+			st->torn++;
+		}
+		if(t < last[ch]){
+			st->backwards++;
+		}
+		last[ch] = t;
+
+		//The same fields read without the sequence number, as a plain struct copy would
+		bits = __atomic_load_n(&registry.value[ch].bits, __ATOMIC_RELAXED);
+		t = __atomic_load_n(&registry.value[ch].timeLow, __ATOMIC_RELAXED);
+		t |= (uint64_t)__atomic_load_n(&registry.value[ch].timeHigh, __ATOMIC_RELAXED) << 32;
+		memcpy(&rv, &bits, 4);
+		if(t != 0){
+			st->raw++;
+			if(rv != valueFor(t)){
+				st->rawTorn++;
+			}
+		}
+	}
+}
+
+int main(int argc, char **argv){
+	double seconds = (argc > 1) ? atof(argv[1]) : 5;
+	int writers = (argc > 2) ? atoi(argv[2]) : 4;
+	int readers = (argc > 3) ? atoi(argv[3]) : 4;
+	std::vector<std::thread> threads;
+	std::vector<uint64_t> writes(writers);
+	std::vector<ReaderStats> stats(readers);
+	ReaderStats total;
+	uint64_t written = 0;
+	char name[CHANNEL_NAME_LEN];
+	int i;
+
+	if(writers < 1 || writers > NUM_CHANNELS || readers < 1){
+		fprintf(stderr, "Use 1 to %d writers and at least 1 reader\n", NUM_CHANNELS);
+		return 1;
+	}
+	for(i = 0; i < NUM_CHANNELS; i++){
+		snprintf(name, sizeof(name), "ch%d", i);
+		registry.add(name, "V", 1000);
+	}
+	for(i = 0; i < writers; i++){
+		threads.push_back(std::thread(writer, i, writers, &writes[i]));
+	}
+	for(i = 0; i < readers; i++){
+		threads.push_back(std::thread(reader, 12345u + i, &stats[i]));
+	}
+	std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+	running = false;
+	for(auto &th : threads){
+		th.join();
+	}
+
+	memset(&total, 0, sizeof(total));
+	for(i = 0; i < readers; i++){
+		total.reads += stats[i].reads;
+		total.misses += stats[i].misses;
+		total.torn += stats[i].torn;
+		total.backwards += stats[i].backwards;
+		total.raw += stats[i].raw;
+		total.rawTorn += stats[i].rawTorn;
+	}
+	for(i = 0; i < writers; i++){
+		written += writes[i];
+	}
+	printf("%d writers, %d readers, %.1f s\n", writers, readers, seconds);
+	printf("writes            %12.1f million/s\n", written / seconds / 1e6);
+	printf("reads             %12.1f million/s\n", total.reads / seconds / 1e6);
+	printf("gave up           %12.4f %% of reads (rewritten during all %d tries)\n", 100.0 * total.misses / (total.reads ? total.reads : 1), CHANNEL_READ_TRIES);
+	printf("torn              %12llu\n", (unsigned long long)total.torn);
+	printf("backwards in time %12llu\n", (unsigned long long)total.backwards);
+	printf("unguarded reads torn %9llu of %llu, for comparison\n", (unsigned long long)total.rawTorn, (unsigned long long)total.raw);
+	if(total.torn != 0 || total.backwards != 0){
+		printf("FAILED\n");
+		return 1;
+	}
+	printf("PASSED\n");
+	return 0;
+}
@@ -0,0 +1,93 @@
+/**
+
+@file
+
+A simulated process for trying the GigaDAQ control loops on a desktop computer: a first-order lag with
+dead time, which is close enough to a heater warming a block or a motor spinning up to tune a PID
+controller against. See controlsim.cpp.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _SIMULATED_PLANT_INCLUDE_
+#define _SIMULATED_PLANT_INCLUDE_
+
+#include <math.h>
+#include <stdlib.h>
+
+/**
+@brief A process whose value follows its drive after a delay, approaching ambient + gain * drive - load with time constant tau.
+*/
+class SimulatedPlant {
+public:
+	double gain;		///< Change of the settled value per unit of drive, such as degrees at full power
+	double tau;			///< Time constant in seconds
+	double ambient;		///< Settled value with no drive
+	double load;		///< Disturbance taken off the settled value, such as the drag on a motor
+	double value;		///< The process value
+
+	/**
+	@param gain Change of the settled value per unit of drive
+	@param tau Time constant in seconds
+	@param deadTime Seconds before the process starts to respond to a change of drive
+	@param ambient Settled value with no drive, and the starting value
+	@param step Seconds per call of step()
+	*/
+	SimulatedPlant(double gain, double tau, double deadTime, double ambient, double step){
+		this->gain = gain;
+		this->tau = tau;
+		this->ambient = ambient;
+		this->step = step;
+		load = 0;
+		value = ambient;
+		length = (int)(deadTime / step) + 1;
+		delay = (double *)calloc(length, sizeof(double));
+		head = 0;
+	}
+	~SimulatedPlant(){
+		free(delay);
+	}
+	/**
+	@brief Moves the process on by one step.
+
+	@param drive Output of the controller
+	*/
+	void advance(double drive){
+		double late, target;
+
+		late = delay[head];			//The drive from deadTime ago
+		delay[head] = drive;
+		head = (head + 1) % length;
+		target = ambient + gain * late - load;
+		value = target + (value - target) * exp(-step / tau);
+	}
+private:
+	double step;
+	double *delay;
+	int length, head;
+};
+
+#endif /* _SIMULATED_PLANT_INCLUDE_ */
@@ -0,0 +1,285 @@
+/**
+
+@file
+
+controlsim - runs GigaDAQ control loops against simulated heaters and motors, and checks how well they
+follow a setpoint, how they come back from a limit, and how steady their timing is.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. controlsim
+
+Usage:
+
+    controlsim [stalls_per_thousand] [seed]
+
+The control timer ticks every CONTROL_TICK microseconds and each interrupt is served up to
+TIMER_LATENCY microseconds late. stalls_per_thousand of every thousand ticks (default 2) are held off
+for more than two milliseconds instead, as by a long critical section, so that some runs are missed.
+The sensor is written to a channel from loop() at its own rate with some noise, and the setpoint is
+written to a channel as a slider bound with Slider::bindChannel() would write it.
+
+The scenarios are in makeScenarios(). The heater is run into a setpoint it cannot reach both with and
+without anti-windup, and anti-windup has to bring it back to the next setpoint much sooner. The fan's
+output cannot go below 0 and its feed-forward asks for too much, so the integral has to be negative. The
+program prints a line per scenario with ControlScheduler::report() and exits with 1 if any check fails.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "ControlLoop.h"
+#include "SimulatedPlant.h"
+
+const uint32_t SIM_STEP = 50;			//Microseconds per step of the simulation
+const uint32_t TIMER_LATENCY = 20;		//Most microseconds a timer interrupt usually waits to be served
+const uint32_t TIMER_STALL = 2500;		//Microseconds a stalled timer interrupt waits, at least
+const int MAX_CHANGES = 4;
+
+/** Output that keeps the value for the plant, as MbedPwmOutput would set the duty cycle */
+class SimulatedOutput : public ControlOutput {
+public:
+	float value = 0;
+	void write(float v) override {
+		value = v;
+	}
+};
+
+struct Scenario {
+	const char *name;
+	double gain, tau, deadTime, ambient;	//The plant
+	float kp, ki, kd, kff, lo, hi;			//The controller
+	bool antiWindup;
+	uint32_t interval;						//Microseconds between runs of the controller
+	uint32_t sample;						//Microseconds between sensor readings
+	double noise;							//Largest sensor error
+	int changes;
+	double when[MAX_CHANGES];				//Seconds at which the setpoint changes, the first at 0
+	float setpoint[MAX_CHANGES];
+	double loadAt, load;					//A disturbance and when it starts
+	double seconds;
+};
+
+struct Result {
+	float *trace;			//Process value every millisecond
+	int length;
+	ControlStats stats;
+	char report[160];
+};
+
+static int makeScenarios(Scenario *s){
+	//A heater block: 100 degrees over ambient at full power, 20 s time constant, half a second before the sensor notices.
+	//PI gains from the SIMC rules: kp = tau / (gain * 2 * deadTime), ki = kp / (8 * deadTime).
+	Scenario heater = {"heater step", 100, 20, 0.5, 20, 0.2f, 0.05f, 0, 0, 0, 1, true, 10000, 10000, 0.2,
+	                   2, {0, 2}, {20, 60}, 1e9, 0, 80};
+	//The heater asked for more than it can do for a minute, then for something it can
+	Scenario windup = heater;
+	windup.name = "heater windup";
+	windup.when[1] = 60;
+	windup.setpoint[0] = 150;
+	windup.setpoint[1] = 50;
+	windup.seconds = 160;
+	Scenario unwound = windup;
+	unwound.name = "heater no anti-windup";
+	unwound.antiWindup = false;
+	//A motor: 3000 rpm at full drive, 0.15 s to spin up. Feed-forward does most of the work and PI trims it.
+	Scenario motor = {"motor", 3000, 0.15, 0.001, 0, 0.0024f, 0.028f, 0, 1.0f / 3000, -1, 1, true, 1000, 1000, 5,
+	                  3, {0, 0.5, 4}, {0, 1500, 2400}, 2.5, 600, 6};
+	s[0] = heater;
+	s[1] = windup;
+	s[2] = unwound;
+	//A fan: 100% airflow at full drive, with a feed-forward that asks for 25% too much. The integral has to take it back.
+	Scenario fan = {"fan feed-forward", 100, 1, 0.01, 0, 0.01f, 0.05f, 0, 0.0125f, 0, 1, true, 1000, 1000, 0.2,
+	                1, {0}, {60}, 1e9, 0, 30};
+	s[3] = motor;
+	s[4] = fan;
+	return 5;
+}
+
+static double noise(double amplitude){
+	return amplitude * (2.0 * rand() / RAND_MAX - 1);
+}
+
+static uint32_t latency(double stallRate){
+	if(rand() < stallRate * RAND_MAX){
+		return TIMER_STALL + rand() % 500;
+	}
+	return rand() % (TIMER_LATENCY + 1);
+}
+
+static void simulate(const Scenario &s, double stallRate, Result &r){
+	ChannelRegistry *channels = new ChannelRegistry();
+	ControlScheduler control;
+	SimulatedOutput out;
+	SimulatedPlant plant(s.gain, s.tau, s.deadTime, s.ambient, SIM_STEP * 1e-6);
+	uint64_t end = (uint64_t)(s.seconds * 1e6), tickAt, fireAt, nextSample = 0;
+	int in, sp, drive, n, change = 0;
+
+	in = channels->add("value");
+	sp = channels->add("setpoint");
+	drive = channels->add("drive");
+	n = control.add(in, sp, drive, &out, s.interval);
+	control.loop[n].pid.setGains(s.kp, s.ki, s.kd, s.kff);
+	control.loop[n].pid.setLimits(s.lo, s.hi);
+	control.loop[n].pid.antiWindup = s.antiWindup;
+	control.channels = channels;
+	control.start(n);
+
+	r.length = (int)(end / 1000);
+	r.trace = (float *)malloc(r.length * sizeof(float));
+	tickAt = CONTROL_TICK;
+	fireAt = tickAt + latency(stallRate);
+	for(simTime = 0; simTime < end; simTime += SIM_STEP){
+		//loop(): the slider and the sensor
+		while(change < s.changes && simTime >= s.when[change] * 1e6){
+			channels->set(sp, s.setpoint[change], simTime);
+			change++;
+		}
+		if(simTime >= nextSample){
+			channels->set(in, plant.value + noise(s.noise), simTime);
+			nextSample += s.sample;
+		}
+		plant.load = (simTime >= s.loadAt * 1e6) ? s.load : 0;
+
+		//The timer. Ticks that came due while an interrupt was held off are served straight after it.
+		while(fireAt <= simTime){
+			control.tick(fireAt);
+			tickAt += CONTROL_TICK;
+			fireAt = (tickAt + latency(stallRate) > fireAt) ? tickAt + latency(stallRate) : fireAt;
+		}
+
+		plant.advance(out.value);
+		if(simTime % 1000 == 0){
+			r.trace[simTime / 1000] = (float)plant.value;
+		}
+	}
+	control.readStats(n, r.stats);
+	control.report(n, r.report, sizeof(r.report));
+	delete channels;
+}
+
+/** Step response between two times in seconds: overshoot in percent of the step, seconds until the value stayed within band, and the mean error over the last fifth */
+static void response(const Result &r, double from, double to, float start, float target, float band,
+                     double &overshoot, double &settle, double &error){
+	int i, a = (int)(from * 1000), b = (int)(to * 1000), tail = b - (b - a) / 5;
+	double step = target - start, beyond, sum = 0;
+
+	overshoot = 0;
+	settle = 0;
+	for(i = a; i < b && i < r.length; i++){
+		beyond = (r.trace[i] - target) * (step >= 0 ? 1 : -1);
+		if(beyond > overshoot){
+			overshoot = beyond;
+		}
+		if(fabs(r.trace[i] - target) > band){
+			settle = (i + 1 - a) / 1000.0;
+		}
+		if(i >= tail){
+			sum += r.trace[i] - target;
+		}
+	}
+	overshoot = (step != 0) ? 100 * overshoot / fabs(step) : 0;
+	error = fabs(sum / (b - tail));
+}
+
+static bool check(bool ok, const char *what){
+	printf("  %-52s %s\n", what, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+int main(int argc, char *argv[]){
+	double stallRate = (argc > 1) ? atof(argv[1]) / 1000 : 0.002;
+	int seed = (argc > 2) ? atoi(argv[2]) : 1;
+	Scenario s[8];
+	Result r[8];
+	double over[8], settle[8], error[8], expected;
+	int i, n, failures = 0;
+	char what[80];
+
+	simReadTime = 0;		//The loop below moves the clock
+	srand(seed);
+	n = makeScenarios(s);
+	for(i = 0; i < n; i++){
+		simulate(s[i], stallRate, r[i]);
+	}
+
+	printf("%-24s %s\n", "scenario", "timing");
+	for(i = 0; i < n; i++){
+		printf("%-24s %s\n", s[i].name, r[i].report);
+	}
+	printf("\n");
+
+	//Heater: a 40 degree step, settled within 2% of the step
+	response(r[0], 2, 80, 20, 60, 0.8f, over[0], settle[0], error[0]);
+	printf("heater step: overshoot %.1f%%, settled in %.1f s, error %.2f\n", over[0], settle[0], error[0]);
+	failures += !check(over[0] < 10, "overshoot under 10%");
+	failures += !check(settle[0] < 40, "settled within 40 s");
+	failures += !check(error[0] < 0.3, "steady-state error under 0.3 degrees");
+
+	//Windup: from stuck at full power to 50 degrees, within 2 degrees
+	for(i = 1; i <= 2; i++){
+		response(r[i], 60, 160, 120, 50, 2, over[i], settle[i], error[i]);
+		printf("%s: back to 50 in %.1f s, undershoot %.1f%%, error %.2f\n", s[i].name, settle[i], over[i], error[i]);
+	}
+	failures += !check(settle[1] < 0.75 * settle[2], "anti-windup comes off the limit sooner");
+	failures += !check(over[1] <= over[2], "anti-windup undershoots no more");
+	failures += !check(error[1] < 0.3, "steady-state error under 0.3 degrees");
+
+	//Motor: a step, a load and another step, each settled within 2% of the setpoint
+	response(r[3], 0.5, 2.5, 0, 1500, 30, over[3], settle[3], error[3]);
+	printf("motor step: overshoot %.1f%%, settled in %.3f s, error %.1f rpm\n", over[3], settle[3], error[3]);
+	failures += !check(over[3] < 15, "overshoot under 15%");
+	failures += !check(settle[3] < 0.5, "settled within 0.5 s");
+	response(r[3], 2.5, 4, 1500, 1500, 30, over[4], settle[4], error[4]);
+	printf("motor load: recovered in %.3f s, error %.1f rpm\n", settle[4], error[4]);
+	failures += !check(settle[4] < 1, "recovered from the load within 1 s");
+	response(r[3], 4, 6, 1500, 2400, 48, over[5], settle[5], error[5]);
+	printf("motor second step: overshoot %.1f%%, settled in %.3f s, error %.1f rpm\n", over[5], settle[5], error[5]);
+	failures += !check(error[5] < 15, "steady-state error under 15 rpm");
+
+	//Fan: the output is limited to 0..1, so the integral has to go below 0 to take back the feed-forward
+	response(r[4], 0, 30, 0, 60, 1.2f, over[6], settle[6], error[6]);
+	printf("fan: overshoot %.1f%%, settled in %.1f s, error %.2f%%\n", over[6], settle[6], error[6]);
+	failures += !check(error[6] < 0.5, "steady-state error under 0.5% with a negative integral");
+
+	//Timing: every interval accounted for as a run or a miss
+	printf("timing:\n");
+	for(i = 0; i < n; i++){
+		expected = s[i].seconds * 1e6 / s[i].interval;
+		snprintf(what, sizeof(what), "%s: runs + missed = %.0f", s[i].name, expected);
+		failures += !check(fabs(r[i].stats.runs + r[i].stats.missed - expected) <= 2, what);
+	}
+	failures += !check(stallRate == 0 || r[3].stats.missed > 0, "stalls of more than an interval are counted as missed");
+	failures += !check(stallRate > 0 || r[3].stats.maxJitter <= TIMER_LATENCY, "jitter no more than the timer latency");
+
+	for(i = 0; i < n; i++){
+		free(r[i].trace);
+	}
+	printf("\n%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
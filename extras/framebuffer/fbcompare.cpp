@@ -0,0 +1,259 @@
+/**
+
+@file
+
+fbcompare - checks that controls drawn straight into a framebuffer, or on 8-bit canvases with a
+palette, look exactly like controls drawn on RGB565 canvases and copied to the screen, and measures
+what drawing them directly saves.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. fbcompare
+
+The stand-in libraries of the soak test (extras/soak/host) give GigaDisplay_GFX a screen buffer in
+memory and draw text pixel by pixel, as the real fonts are drawn.
+
+Usage:
+
+    fbcompare [steps]
+
+Three GigaDAQ objects get the same controls and the same changes, steps of them (default 2000) in
+each of the four rotations: new layouts with controls partly off the screen, new text, slider moves,
+page changes, button states and redraws. One has no arena, so it draws every control on an RGB565
+canvas every time. One draws on 8-bit canvases (indexedCanvases) and keeps 8-bit button sprites, and
+its screen buffer must be identical to the first after every step. The third keeps RGB565 button
+sprites and draws into a MemoryFramebuffer, and its front image, which only gets the rectangles that were
+flipped, must be identical as well. Then the time taken by each way of drawing is printed, with the
+number of flips and the pixels they copied.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "GigaDAQ.h"
+
+const int PIXELS = GIGA_DS_WIDTH * GIGA_DS_HEIGHT;
+
+GigaDAQ canvasDaq, indexedDaq, directDaq;
+uint16_t backImage[PIXELS], frontImage[PIXELS];
+MemoryFramebuffer memoryFramebuffer(backImage, frontImage, GIGA_DS_WIDTH, GIGA_DS_HEIGHT);
+double canvasTime, indexedTime, directTime;
+
+static double seconds(void){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//Points both objects to a new rotation, as if they had been made with it
+static void turn(GigaDAQ &daq, DisplayOrientation r){
+	int i;
+
+	daq.rotation = r;
+	daq.screenW = (r & 1) ? GIGA_DS_HEIGHT : GIGA_DS_WIDTH;
+	daq.screenH = (r & 1) ? GIGA_DS_WIDTH : GIGA_DS_HEIGHT;
+	daq.graph.setRotation(r);
+	for(i = 0; i < NUM_PAGES; i++){
+		daq.invalidatePage(i);
+	}
+}
+
+static String randomText(void){
+	static const char *words[] = {"", "0", "12.5", "OVERRANGE", "Stop", "-0.003 V", "Record", "A much longer label than fits"};
+
+	return String(words[rand() % 8]);
+}
+
+//A random layout. Controls may overlap each other and run off the screen.
+static void layout(GigaDAQ &daq, unsigned seed){
+	int i;
+
+	srand(seed);
+	daq.clearControls();
+	for(i = 0; i < 6; i++){
+		daq.button[i] = Button("b", rand() % 95, rand() % 95, 1 + rand() % 40, 1 + rand() % 20, rand() & 0xFFFF, rand() & 0xFFFF);
+		daq.button[i].setDisplayText(randomText());
+		daq.button[i].setLook(BUTTON_ON, randomText(), rand() & 0xFFFF, rand() & 0xFFFF);
+		if(rand() % 2){
+			daq.button[i].setLook(BUTTON_DISABLED, randomText(), rand() & 0xFFFF, rand() & 0xFFFF);
+		}
+		daq.button[i].page = rand() % 2;
+	}
+	for(i = 0; i < 4; i++){
+		daq.slider[i] = Slider("s", rand() % 95, rand() % 95, 1 + rand() % 50, 1 + rand() % 30, rand() & 0xFFFF, rand() & 0xFFFF);
+		daq.slider[i].setMode((SliderMode)(rand() % 3));
+		daq.slider[i].setXlimits(0, 1);
+		daq.slider[i].setYlimits(0, 1);
+		daq.slider[i].setPosition(rand() % 101 / 100.0, rand() % 101 / 100.0);
+		daq.slider[i].page = rand() % 2;
+	}
+	for(i = 0; i < 6; i++){
+		daq.textbox[i] = Textbox("t", rand() % 95, rand() % 95, 1 + rand() % 50, 1 + rand() % 15, rand() & 0xFFFF, rand() & 0xFFFF);
+		daq.textbox[i].setDisplayText(randomText());
+		daq.textbox[i].page = rand() % 2;
+	}
+}
+
+//One change, chosen and carried out the same way on either object
+static void step(GigaDAQ &daq, unsigned seed){
+	int i, kind;
+
+	srand(seed);
+	kind = rand() % 9;
+	switch(kind){
+		case 0:
+			layout(daq, rand());
+			daq.drawAll();
+			break;
+		case 1:
+			i = rand() % 6;
+			daq.button[i].setDisplayText(randomText());
+			daq.drawButton(i);
+			break;
+		case 2:
+		case 3:
+			i = rand() % 6;
+			daq.textbox[i].setDisplayText(randomText());
+			daq.updateDisplays();
+			break;
+		case 4:
+		case 5:
+			for(i = rand() % 4; i < 4; i += 1 + rand() % 3){
+				daq.slider[i].setPosition(rand() % 121 / 100.0 - 0.1, rand() % 121 / 100.0 - 0.1);	//Sometimes past the limits
+			}
+			daq.updateDisplays();
+			break;
+		case 6:
+			daq.showPage(1 - daq.currentPage);
+			break;
+		case 7:
+			daq.beginFrame();		//Several controls that appear together
+			for(i = 0; i < 3; i++){
+				daq.drawButton(rand() % 6);
+				daq.drawSlider(rand() % 4);
+			}
+			daq.endFrame();
+			break;
+		case 8:		//Button states, drawn from sprites once each look has been drawn
+			i = rand() % 6;
+			daq.button[i].setOn(rand() % 2);
+			daq.button[i].setEnabled(rand() % 4 != 0);
+			daq.updateDisplays();
+			break;
+	}
+}
+
+//Finds the first pixel that differs, in the buffer's own coordinates
+static bool same(const uint16_t *a, const uint16_t *b, int &x, int &y){
+	int i;
+
+	for(i = 0; i < PIXELS; i++){
+		if(a[i] != b[i]){
+			x = i % GIGA_DS_WIDTH;
+			y = i / GIGA_DS_WIDTH;
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char **argv){
+	int steps = (argc > 1) ? atoi(argv[1]) : 2000;
+	int i, r, n, x, y, failures = 0;
+	unsigned seed;
+	double t;
+
+	canvasDaq.sdramArenaSize = 0;				//No arena, so no button sprites: every control is drawn on a canvas every time
+	indexedDaq.sdramArenaSize = 1536*1024;
+	directDaq.sdramArenaSize = 1536*1024;
+	canvasDaq.begin();
+	indexedDaq.begin();
+	directDaq.begin();
+	canvasDaq.frameInterval = 0;				//Sliders are redrawn on every updateDisplays()
+	indexedDaq.frameInterval = 0;
+	directDaq.frameInterval = 0;
+	indexedDaq.indexedCanvases = true;
+	directDaq.framebuffer = &memoryFramebuffer;
+	for(i = 0; i < NUM_PAGES; i++){		//Page images from the computer's memory, so that all three keep them alike however full their arenas get
+		canvasDaq.pageCache[i] = (uint16_t *)malloc(sizeof(backImage));
+		indexedDaq.pageCache[i] = (uint16_t *)malloc(sizeof(backImage));
+		directDaq.pageCache[i] = (uint16_t *)malloc(sizeof(backImage));
+	}
+
+	for(r = 0; r < 4 && failures == 0; r++){
+		turn(canvasDaq, (DisplayOrientation)r);
+		turn(indexedDaq, (DisplayOrientation)r);
+		turn(directDaq, (DisplayOrientation)r);
+		memset(canvasDaq.graph.getBuffer(), 0, sizeof(backImage));
+		memset(indexedDaq.graph.getBuffer(), 0, sizeof(backImage));
+		memset(backImage, 0, sizeof(backImage));
+		memset(frontImage, 0, sizeof(frontImage));
+		for(n = 0; n < steps; n++){
+			seed = r * 1000003u + n;
+			if(n == 0){
+				seed = 0;		//Starts with a layout
+			}
+			t = seconds();
+			step(canvasDaq, seed);
+			canvasTime += seconds() - t;
+			t = seconds();
+			step(indexedDaq, seed);
+			indexedTime += seconds() - t;
+			t = seconds();
+			step(directDaq, seed);
+			directTime += seconds() - t;
+			if(!same(canvasDaq.graph.getBuffer(), indexedDaq.graph.getBuffer(), x, y)){
+				printf("Rotation %d, step %d: the 8-bit canvases differ at (%d, %d)\n", r, n, x, y);
+				failures++;
+				break;
+			}
+			if(!same(canvasDaq.graph.getBuffer(), frontImage, x, y)){
+				printf("Rotation %d, step %d: the framebuffer differs at (%d, %d)\n", r, n, x, y);
+				failures++;
+				break;
+			}
+			if(memoryFramebuffer.dirty()){
+				printf("Rotation %d, step %d: drawing was left unflipped\n", r, n);
+				failures++;
+				break;
+			}
+		}
+		if(failures == 0){
+			printf("Rotation %d: %d steps identical\n", r, steps);
+		}
+	}
+
+	printf("\nCanvases:    %8.1f ms\n", canvasTime * 1000);
+	printf("8-bit:       %8.1f ms\n", indexedTime * 1000);
+	printf("Framebuffer: %8.1f ms, %lu flips of %.0f pixels on average\n", directTime * 1000,
+	       (unsigned long)memoryFramebuffer.frames, memoryFramebuffer.frames ? (double)memoryFramebuffer.pixels / memoryFramebuffer.frames : 0.0);
+	printf("\n%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,259 @@
+/**
+
+@file
+
+framesim - shows how the frame governor keeps drawing the screen from delaying data acquisition,
+and checks that no control is left undrawn.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. framesim
+
+The stand-in libraries of the soak test (extras/soak/host) give GigaDisplay_GFX a screen buffer in
+memory and simulate the time. Drawing takes no simulated time by itself, so the blitter charges
+PIXEL_COST microseconds for every pixel it puts on the screen, which makes a text box take about
+1.4 ms, in the range of drawing one on a canvas on the GIGA.
+
+Usage:
+
+    framesim
+
+A sketch takes a sample every 5 ms (a timer of GigaDAQ::power), which takes 150 us, and shows 12
+readings and a slider. For 2 s one reading changes every 200 ms. Then for 6 s the readings change
+a thousand times a second between them while a finger drags the slider back and forth, which is
+far more drawing than fits between the samples. Then it is calm again for 3 s, and for the last
+second nothing changes. This is run without a budget and with a budget of 4 ms.
+
+For each run and phase, the frames per second, the redraws deferred, and how late the samples
+were taken and how many were missed are printed. With the budget, the samples must be missed
+no more and be less late under load, redraws must be deferred under load, there must be fewer
+than half as many frames a second under load as when calm, and they must come back after it (to
+60% of the calm rate over the 3 s, as that takes a moment, and 90% when still), no redraw may
+wait longer than FRAME_MAX_DEFER frames plus one for each control, and at the end every text box
+must show its text.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GigaDAQ.h"
+
+const double PIXEL_COST = 0.1;			//Microseconds of drawing per pixel put on the screen
+const uint64_t SAMPLE_INTERVAL = 5000;	//Microseconds between samples
+const uint64_t SAMPLE_WORK = 150;		//Microseconds taking a sample takes
+const uint64_t PASS_WORK = 20;			//Microseconds of the rest of a pass through the loop
+const int NUM_READINGS = 12;
+const int NUM_PHASES = 4;
+const uint64_t PHASE_END[NUM_PHASES] = {2000000, 8000000, 11000000, 12000000};	//Microseconds from the start
+const char *PHASE_NAME[NUM_PHASES] = {"calm", "busy", "calm again", "still"};
+
+/** A SoftwareBlitter that moves the simulated time on as the GIGA would take to draw */
+class TimedBlitter : public SoftwareBlitter {
+protected:
+	void startFill(uint16_t *dst, int dstStride, int w, int h, uint16_t color) override {
+		SoftwareBlitter::startFill(dst, dstStride, w, h, color);
+		charge(w * h);
+	}
+	void startCopy(uint16_t *dst, int dstStride, const uint16_t *src, int srcStride, int w, int h) override {
+		SoftwareBlitter::startCopy(dst, dstStride, src, srcStride, w, h);
+		charge(w * h);
+	}
+	void startExpand(uint16_t *dst, int dstStride, const uint8_t *src, int srcStride, int w, int h, const uint16_t *palette, int colors) override {
+		SoftwareBlitter::startExpand(dst, dstStride, src, srcStride, w, h, palette, colors);
+		charge(w * h);
+	}
+private:
+	void charge(int pixels){
+		simTime += (uint64_t)(pixels * PIXEL_COST);
+	}
+};
+
+struct Phase {
+	uint32_t frames, deferred, samples, missed;
+	uint64_t late, maxLate;
+};
+
+GigaDAQ daq;
+TimedBlitter timedBlitter;
+
+//Frames per second in phase p
+static double perSecond(const Phase *phase, int p){
+	return phase[p].frames / ((PHASE_END[p] - (p ? PHASE_END[p - 1] : 0)) / 1e6);
+}
+
+static void layout(void){
+	int i;
+
+	daq.clearControls();
+	for(i = 0; i < NUM_READINGS; i++){
+		daq.textbox[i] = Textbox(String("Reading ") + String(i), 2 + (i % 2) * 48, 2 + (i / 2) * 10, 46, 8, 0xFFFF, 0x001F);
+		daq.textbox[i].setDisplayText("0.00");
+	}
+	daq.slider[0] = Slider("Level", 2, 64, 96, 10, 0xFFE0, 0x0000);
+	daq.slider[0].setMode(HORIZONTAL);
+	daq.slider[0].setXlimits(0, 100);
+	daq.drawAll();
+}
+
+//A finger that goes back and forth across the slider once a second
+static void touch(uint64_t t, bool busy){
+	static bool down;
+	GDTpoint_t p[5];
+	double f;
+
+	memset(p, 0, sizeof(p));
+	if(!busy){
+		if(down){
+			simTouchCallback(0, p);
+			down = false;
+		}
+		return;
+	}
+	f = (t % 1000000) / 1e6;
+	f = (f < 0.5) ? 2 * f : 2 - 2 * f;
+	p[0].x = (uint16_t)((0.05 + 0.9 * f) * GIGA_DS_WIDTH);
+	p[0].y = (uint16_t)(0.69 * GIGA_DS_HEIGHT);
+	simTouchCallback(1, p);
+	down = true;
+}
+
+static int run(uint32_t budget, Phase *phase){
+	uint64_t start, t, nextSample, nextChange, nextTouch;
+	uint32_t frames = 0, deferred = 0;
+	int i, p = 0, sampleTimer, failures = 0;
+	char line[200];
+
+	layout();
+	daq.governor = FrameGovernor();
+	daq.governor.budget = budget;
+	memset(phase, 0, NUM_PHASES * sizeof(Phase));
+	daq.power = PowerManager();
+	sampleTimer = daq.power.addTimer(SAMPLE_INTERVAL / 1000);
+	start = simTime;
+	nextSample = simTime + SAMPLE_INTERVAL;
+	nextChange = nextTouch = simTime;
+	srand(1);
+
+	while((t = simTime - start) < PHASE_END[NUM_PHASES - 1]){
+		if(t >= PHASE_END[p]){
+			phase[p].frames = daq.governor.frames - frames;
+			phase[p].deferred = daq.governor.deferred - deferred;
+			frames = daq.governor.frames;
+			deferred = daq.governor.deferred;
+			p++;
+		}
+		if(simTime >= nextTouch){		//The touch controller reports every 10 ms
+			touch(t, p == 1);
+			nextTouch += 10000;
+		}
+		daq.handleInputs();
+
+		daq.power.due(sampleTimer);		//Keeps the timer, and so the headroom, in step with the samples
+		if(simTime >= nextSample){
+			phase[p].samples++;
+			phase[p].late += simTime - nextSample;
+			if(simTime - nextSample > phase[p].maxLate){
+				phase[p].maxLate = simTime - nextSample;
+			}
+			nextSample += SAMPLE_INTERVAL;
+			if(nextSample <= simTime){		//Fell behind by more than an interval, as PowerManager::due()
+				phase[p].missed += (simTime - nextSample) / SAMPLE_INTERVAL + 1;
+				nextSample = simTime + SAMPLE_INTERVAL;
+			}
+			simTime += SAMPLE_WORK;
+		}
+
+		if(p < 3 && simTime >= nextChange){
+			i = rand() % NUM_READINGS;
+			daq.textbox[i].setDisplayText(String((rand() % 20000 - 10000) / 100.0, 2));
+			nextChange += (p == 1) ? 1000 : 200000;
+		}
+		daq.updateDisplays();
+		simTime += PASS_WORK;
+	}
+	phase[p].frames = daq.governor.frames - frames;
+	phase[p].deferred = daq.governor.deferred - deferred;
+
+	printf("Budget %lu us:\n", (unsigned long)budget);
+	for(p = 0; p < NUM_PHASES; p++){
+		printf("  %-10s  %5.1f frames/s  %6lu redraws deferred  samples late mean %4lu max %5lu us, %5lu missed\n", PHASE_NAME[p],
+		       perSecond(phase, p), (unsigned long)phase[p].deferred,
+		       (unsigned long)(phase[p].samples ? phase[p].late / phase[p].samples : 0), (unsigned long)phase[p].maxLate,
+		       (unsigned long)phase[p].missed);
+	}
+	daq.governor.report(line, sizeof(line));
+	printf("  %s\n", line);
+
+	for(i = 0; i < NUM_READINGS; i++){
+		if(!daq.textbox[i].dispText.equals(daq.textbox[i].prevDispText)){
+			printf("  Reading %d was never drawn\n", i);
+			failures++;
+		}
+	}
+	if(daq.slider[0].moved){
+		printf("  The slider was never drawn where the finger left it\n");
+		failures++;
+	}
+	return failures;
+}
+
+int main(void){
+	Phase off[NUM_PHASES], on[NUM_PHASES];
+	int failures = 0;
+
+	daq.sdramArenaSize = 1536*1024;
+	daq.begin();
+	daq.enableTouchInterrupt();
+	daq.blitter = &timedBlitter;
+
+	failures += run(0, off);
+	failures += run(4000, on);
+
+	if(on[1].missed > off[1].missed || on[1].maxLate >= off[1].maxLate){
+		printf("With the budget, samples were not taken more on time under load\n");
+		failures++;
+	}
+	if(on[1].deferred == 0){
+		printf("With the budget, no redraw was deferred under load\n");
+		failures++;
+	}
+	if(perSecond(on, 1) > perSecond(on, 0) / 2){
+		printf("With the budget, the frames were not spread out under load\n");
+		failures++;
+	}
+	if(perSecond(on, 2) < perSecond(on, 0) * 0.6 || perSecond(on, 3) < perSecond(on, 0) * 0.9){
+		printf("With the budget, the frames did not come back after the load\n");
+		failures++;
+	}
+	if(daq.governor.maxWait > FRAME_MAX_DEFER + NUM_READINGS + 1){
+		printf("A redraw waited %d frames\n", daq.governor.maxWait);
+		failures++;
+	}
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+"""
+gdlog_decode.py - turns a recording made with a GigaDAQ LogCompressor back into text.
+
+Usage:
+    python3 gdlog_decode.py run1.gdl [--out run1.csv] [--stats]
+
+Every sample is written as a line of comma-separated values (time in seconds first),
+the same as the data files GigaDAQ writes to the flash drive without a compressor.
+
+The recording is a series of blocks, each a 28-byte header (magic "GDLK", version,
+channels, flags, count, coded length, stored length, XOR mask, Adler-32 checksum,
+64-bit time of the first sample) followed by the stored bytes, all little-endian.
+The stored bytes are LZ4-compressed if flags has bit 0 set. Decompressed, they hold
+for every sample a zigzag varint of the change in the time step, then one varint per
+channel: the zigzag difference of the 32 bits of the float from the previous value,
+or, for channels in the XOR mask, the differing bits without their trailing zeros
+and the number of trailing zeros in the low 5 bits.
+
+A damaged block is skipped and the next one is found by its magic number, so only
+the samples of the damaged block are lost. --stats reports blocks, samples, damaged
+blocks and the compression ratio on stderr.
+
+Written by David A. Trevas. MIT License, Copyright (c) 2025 David A. Trevas.
+See the LICENSE file of the GigaDAQ library.
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+VERSION = 1                 # must match LOG_BLOCK_VERSION in LogCompress.h
+MAGIC = b"GDLK"
+HEADER = struct.Struct("<IBBBBHHHHIII")
+LZ = 0x01
+MAX_CHANNELS = 16
+BLOCK_BYTES = 4096
+
+
+def lz_decompress(data, size):
+    """Decompresses an LZ4 block. Returns None if it is damaged or not size bytes long."""
+    out = bytearray()
+    i = 0
+    n = len(data)
+    while i < n:
+        token = data[i]
+        i += 1
+        lit = token >> 4
+        if lit == 15:
+            while True:
+                if i >= n:
+                    return None
+                b = data[i]
+                i += 1
+                lit += b
+                if b != 255:
+                    break
+        if i + lit > n:
+            return None
+        out += data[i:i + lit]
+        i += lit
+        if i == n:
+            break
+        if i + 2 > n:
+            return None
+        distance = data[i] | (data[i + 1] << 8)
+        i += 2
+        match = token & 15
+        if match == 15:
+            while True:
+                if i >= n:
+                    return None
+                b = data[i]
+                i += 1
+                match += b
+                if b != 255:
+                    break
+        match += 4
+        if distance == 0 or distance > len(out):
+            return None
+        start = len(out) - distance
+        for k in range(match):     # may overlap what it copies
+            out.append(out[start + k])
+        if len(out) > size:
+            return None
+    return bytes(out) if len(out) == size else None
+
+
+def varints(data):
+    """Yields the varints in data, then None if the last one is cut off."""
+    v = shift = 0
+    for b in data:
+        v |= (b & 0x7F) << shift
+        if b & 0x80:
+            shift += 7
+        else:
+            yield v
+            v = shift = 0
+    if shift:
+        yield None
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def decode_block(header, stored):
+    """Returns the samples of a block as (time in microseconds, values), or None if it is damaged."""
+    _, version, channels, flags, _, count, raw_len, stored_len, xor_mask, check, t_low, t_high = header
+    if version != VERSION or not 1 <= channels <= MAX_CHANNELS or raw_len > BLOCK_BYTES:
+        return None
+    if zlib.adler32(stored) != check:
+        return None
+    if flags & LZ:
+        raw = lz_decompress(stored, raw_len)
+        if raw is None:
+            return None
+    elif stored_len == raw_len:
+        raw = stored
+    else:
+        return None
+
+    codes = list(varints(raw))
+    if len(codes) != count * (channels + 1) or (codes and codes[-1] is None):
+        return None
+    t = (t_high << 32) | t_low
+    step = 0
+    prev = [0] * channels
+    rows = []
+    k = 0
+    for _ in range(count):
+        step += unzigzag(codes[k])
+        t += step
+        k += 1
+        bits = []
+        for c in range(channels):
+            code = codes[k]
+            k += 1
+            if xor_mask & (1 << c):
+                prev[c] ^= ((code >> 5) << (code & 31)) & 0xFFFFFFFF if code else 0
+            else:
+                prev[c] = (prev[c] + unzigzag(code)) & 0xFFFFFFFF
+            bits.append(prev[c])
+        rows.append((t, struct.unpack("<%df" % channels, struct.pack("<%dI" % channels, *bits))))
+    return rows
+
+
+def blocks(data, stats):
+    """Yields the samples of every good block in a recording."""
+    pos = 0
+    while pos + HEADER.size <= len(data):
+        header = HEADER.unpack_from(data, pos)
+        if data[pos:pos + 4] == MAGIC:
+            stored_len = header[7]
+            end = pos + HEADER.size + stored_len
+            rows = decode_block(header, data[pos + HEADER.size:end]) if end <= len(data) else None
+            if rows is not None:
+                stats["blocks"] += 1
+                stats["samples"] += len(rows)
+                stats["raw"] += len(rows) * (8 + 4 * header[2])
+                yield rows
+                pos = end
+                continue
+        stats["damaged"] += 1
+        nxt = data.find(MAGIC, pos + 1)     # skip to the next block
+        if nxt < 0:
+            break
+        pos = nxt
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("recording", help="recording made with a LogCompressor, such as run1.gdl")
+    parser.add_argument("--out", default="-", help="CSV file to write, - for standard output")
+    parser.add_argument("--stats", action="store_true", help="report blocks, samples and the compression ratio")
+    args = parser.parse_args()
+
+    with open(args.recording, "rb") as f:
+        data = f.read()
+    out = sys.stdout if args.out == "-" else open(args.out, "w")
+    stats = {"blocks": 0, "samples": 0, "damaged": 0, "raw": 0}
+    try:
+        for rows in blocks(data, stats):
+            for t, values in rows:
+                out.write("%d.%06d%s\n" % (t // 1000000, t % 1000000, "".join(", %g" % v for v in values)))
+    finally:
+        if out is not sys.stdout:
+            out.close()
+    if args.stats:
+        print("blocks %d  samples %d  damaged %d  %.2f times smaller than binary"
+              % (stats["blocks"], stats["samples"], stats["damaged"], stats["raw"] / max(len(data), 1)),
+              file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,284 @@
+/**
+
+@file
+
+logbench - measures how well LogCompressor packs typical sensor recordings and how fast it does it.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. logbench
+
+Usage:
+
+    logbench [seconds]                   Compresses seconds of every trace (default 3600) in memory, checks
+                                         that every sample comes back exactly and is in the block that the
+                                         index points to, and prints the sizes and speeds
+    logbench write trace name [seconds]  Writes a trace both as a compressed recording (name.gdl) and as the
+                                         text file GigaDAQ would have written (name.csv), to check
+                                         gdlog_decode.py against
+
+The traces are made up to look like what GigaDAQ usually records:
+
+    temperature  4 channels at 10 Hz from 12-bit sensors in steps of 0.0625 degrees, drifting slowly
+    pressure     2 channels at 50 Hz, floating point with noise in the last digits
+    accel        3 channels at 1 kHz from a 16-bit accelerometer, vibrating with noise
+    adc          4 channels at 100 Hz of 12-bit analogRead() values scaled to volts
+    switches     8 channels at 20 Hz that are 0 or 1 and change now and then
+
+Speeds are in megabytes per second of plain binary samples (8 bytes for the time and 4 per value) on
+this computer; the GIGA is roughly ten to twenty times slower.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "LogCompress.h"
+
+enum TraceKind { TEMPERATURE, PRESSURE, ACCEL, ADC, SWITCHES };
+
+struct Trace {
+	const char *name;
+	TraceKind kind;
+	int channels;
+	int rate;		//Samples per second
+};
+
+static const Trace traces[] = {
+	{"temperature", TEMPERATURE, 4, 10},
+	{"pressure", PRESSURE, 2, 50},
+	{"accel", ACCEL, 3, 1000},
+	{"adc", ADC, 4, 100},
+	{"switches", SWITCHES, 8, 20}
+};
+const int NUM_TRACES = sizeof(traces) / sizeof(traces[0]);
+
+static double seconds(void){
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static double noise(void){
+	return (rand() + 0.5) / (RAND_MAX + 1.0) - 0.5;
+}
+
+//Makes the samples of a trace: time stamps with a little jitter now and then, as from a real clock
+static void makeTrace(const Trace &tr, double length, std::vector<uint64_t> &t, std::vector<float> &v){
+	int n = (int)(length * tr.rate), i, c;
+	uint64_t time = 1750000000ULL * 1000000;
+	double x;
+
+	srand(1);
+	t.resize(n);
+	v.resize((size_t)n * tr.channels);
+	for(i = 0; i < n; i++){
+		time += 1000000 / tr.rate + ((rand() % 50 == 0) ? rand() % 40 : 0);
+		t[i] = time;
+		for(c = 0; c < tr.channels; c++){
+			x = (double)i / tr.rate;
+			float &out = v[(size_t)i * tr.channels + c];
+			switch(tr.kind){
+				case TEMPERATURE:
+					out = floor((21 + c + 2 * sin(x / 3000 + c) + noise() * 0.1) * 16) / 16;
+					break;
+				case PRESSURE:
+					out = (float)(1013.25 + c * 50 + sin(x / 600) + noise() * 0.02);
+					break;
+				case ACCEL:
+					out = (int)(2000 * sin(x * 2 * M_PI * (30 + c * 7)) + 30 * noise() + (c == 2 ? 16384 : 0)) / 16384.0f;
+					break;
+				case ADC:
+					out = (int)(2048 + 1500 * sin(x / 20 + c) + 3 * noise()) * (3.3f / 4095);
+					break;
+				case SWITCHES:
+					out = (i == 0) ? 0 : ((v[(size_t)(i - 1) * tr.channels + c] != 0) ^ (rand() % 500 == 0));
+					break;
+			}
+		}
+	}
+}
+//Size of the same samples in the text format of GigaDAQ::recordSample()
+static size_t csvLine(char *line, uint64_t t, const float *values, int count){
+	size_t n = sprintf(line, "%lu.%06lu", (unsigned long)(t / 1000000), (unsigned long)(t % 1000000));
+	int i;
+	for(i = 0; i < count; i++){
+		n += sprintf(line + n, ", %g", (double)values[i]);
+	}
+	line[n++] = '\n';
+	line[n] = '\0';
+	return n;
+}
+
+//Compresses a trace in memory and decodes it again. Returns false if a sample did not come back exactly. Each
+//sample's offset is taken as GigaDAQ::recordSample() gives it to the LogIndexWriter, and misplaced counts the
+//samples that are not in the block at that offset.
+static bool bench(const Trace &tr, const std::vector<uint64_t> &t, const std::vector<float> &v, bool lz,
+                  size_t &stored, double &encodeRate, double &decodeRate, size_t &misplaced){
+	static LogCompressor lc;
+	static uint8_t work[LOG_BLOCK_BYTES];
+	std::vector<uint64_t> t2(65536);
+	std::vector<float> v2(65536 * LOG_BLOCK_MAX_CHANNELS);
+	std::vector<uint32_t> offset(t.size());
+	LogBlockHeader h;
+	char *buf = nullptr;
+	size_t len = 0, pos, i, j = 0, raw = t.size() * (8 + 4 * tr.channels);
+	FILE *f;
+	double start;
+	int n, k;
+	bool ok = true;
+
+	f = open_memstream(&buf, &len);
+	lc = LogCompressor();
+	lc.lz = lz;
+	lc.maxAge = 0xFFFFFFFF;
+	lc.begin(f, 0);
+	start = seconds();
+	for(i = 0; i < t.size(); i++){
+		lc.add(t[i], &v[i * tr.channels], tr.channels);
+		offset[i] = lc.blockOffset();
+	}
+	lc.end();
+	fflush(f);
+	encodeRate = raw / (seconds() - start) / 1e6;
+	stored = len;
+
+	start = seconds();
+	for(pos = 0; pos + sizeof(h) <= len; pos += sizeof(h) + h.storedLen){
+		memcpy(&h, buf + pos, sizeof(h));
+		n = decodeLogBlock(h, (const uint8_t *)buf + pos + sizeof(h), work, t2.data(), v2.data());
+		if(n < 0){
+			ok = false;
+			break;
+		}
+		for(k = 0; k < n && j < t.size(); k++, j++){
+			if(t2[k] != t[j] || memcmp(&v2[k * tr.channels], &v[j * tr.channels], 4 * tr.channels) != 0){
+				ok = false;
+			}
+		}
+	}
+	decodeRate = raw / (seconds() - start) / 1e6;
+
+	//Seek to where the index would point for each sample and look for it in that block
+	misplaced = 0;
+	for(i = 0; i < t.size(); i++){
+		pos = offset[i];
+		if(i == 0 || pos != offset[i - 1]){
+			n = -1;
+			if(pos + sizeof(h) <= len){
+				memcpy(&h, buf + pos, sizeof(h));
+				n = decodeLogBlock(h, (const uint8_t *)buf + pos + sizeof(h), work, t2.data(), v2.data());
+			}
+		}
+		for(k = 0; k < n && t2[k] != t[i]; k++);
+		if(k >= n){
+			misplaced++;
+		}
+	}
+	fclose(f);
+	free(buf);
+	return ok && j == t.size();
+}
+
+static int writeTrace(const char *traceName, const char *name, double length){
+	std::vector<uint64_t> t;
+	std::vector<float> v;
+	LogCompressor lc;
+	char path[512], line[512];
+	FILE *f, *csv;
+	int i, k;
+
+	for(k = 0; k < NUM_TRACES && strcmp(traces[k].name, traceName) != 0; k++);
+	if(k == NUM_TRACES){
+		fprintf(stderr, "No trace called %s\n", traceName);
+		return 1;
+	}
+	makeTrace(traces[k], length, t, v);
+	snprintf(path, sizeof(path), "%s.gdl", name);
+	f = fopen(path, "wb");
+	snprintf(path, sizeof(path), "%s.csv", name);
+	csv = fopen(path, "w");
+	if(f == nullptr || csv == nullptr){
+		fprintf(stderr, "Cannot write %s\n", name);
+		return 1;
+	}
+	lc.begin(f, 0);
+	for(i = 0; i < (int)t.size(); i++){
+		lc.add(t[i], &v[(size_t)i * traces[k].channels], traces[k].channels);
+		csvLine(line, t[i], &v[(size_t)i * traces[k].channels], traces[k].channels);
+		fputs(line, csv);
+	}
+	lc.end();
+	fclose(f);
+	fclose(csv);
+	printf("%d samples in %u blocks, %.2f times smaller than binary\n", (int)t.size(), (unsigned)lc.blocks, lc.ratio());
+	return 0;
+}
+
+int main(int argc, char **argv){
+	std::vector<uint64_t> t;
+	std::vector<float> v;
+	double length = 3600, encode, decode, encodeLz, decodeLz;
+	size_t csv, raw, coded, packed, i, misplaced;
+	char line[512];
+	int k;
+	bool ok = true;
+
+	if(argc >= 4 && strcmp(argv[1], "write") == 0){
+		return writeTrace(argv[2], argv[3], (argc > 4) ? atof(argv[4]) : 600);
+	}
+	if(argc > 1){
+		length = atof(argv[1]);
+	}
+
+	printf("%-12s %9s %10s %10s | %14s %14s | %15s %15s\n", "", "samples", "text", "binary",
+	       "coded (ratio)", "+LZ (ratio)", "coded MB/s e/d", "+LZ MB/s e/d");
+	for(k = 0; k < NUM_TRACES; k++){
+		makeTrace(traces[k], length, t, v);
+		csv = 0;
+		for(i = 0; i < t.size(); i++){
+			csv += csvLine(line, t[i], &v[i * traces[k].channels], traces[k].channels);
+		}
+		raw = t.size() * (8 + 4 * traces[k].channels);
+		ok &= bench(traces[k], t, v, false, coded, encode, decode, misplaced);
+		if(misplaced > 0){
+			printf("%-12s %lu samples are not in the block that the index points to\n", traces[k].name, (unsigned long)misplaced);
+			ok = false;
+		}
+		ok &= bench(traces[k], t, v, true, packed, encodeLz, decodeLz, misplaced);
+		if(misplaced > 0){
+			printf("%-12s %lu samples are not in the LZ block that the index points to\n", traces[k].name, (unsigned long)misplaced);
+			ok = false;
+		}
+		printf("%-12s %9d %10lu %10lu | %8lu %5.1f %8lu %5.1f | %7.0f %7.0f %7.0f %7.0f\n", traces[k].name, (int)t.size(),
+		       (unsigned long)csv, (unsigned long)raw, (unsigned long)coded, (double)raw / coded,
+		       (unsigned long)packed, (double)raw / packed, encode, decode, encodeLz, decodeLz);
+	}
+	printf("\nRatios are binary bytes / compressed bytes; text files are larger again by the text/binary column ratio.\n");
+	printf("%s\n", ok ? "Every sample decoded exactly." : "DECODING FAILED");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+/**
+
+@file
+
+logindex - builds and benchmarks the index files that GigaDAQ writes next to a recorded data file.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. logindex
+
+Usage:
+
+    logindex index data.csv              Indexes a data file recorded before GigaDAQ wrote index files
+    logindex make data.csv megabytes [channels]
+                                         Writes a test recording of about the given size, with its index
+    logindex bench data.csv [columns]    Times searches and overviews with the index, and one
+                                         overview made by reading the whole data file for comparison
+
+The data file and its index files (data.csv.ix0, .ix1, ...) are the same as on the flash drive, so a
+recording can be indexed on a computer and then reviewed on the GIGA. The index holds 32-bit offsets,
+so data files must be smaller than 4 GiB (LOG_INDEX_MAX_BYTES), as on a FAT32 drive: index refuses
+larger files and make larger sizes.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#define _FILE_OFFSET_BITS 64		//fseeko() past 2 GB on 32-bit computers too
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "LogIndex.h"
+
+static double seconds(void){
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//Reads one line of a data file the way GigaDAQ::recordSample() writes it. The time is read exactly, digit by digit.
+static int parseLine(const char *line, uint64_t &t, float *values){
+	char *end;
+	uint64_t scale = 100000;
+	int n = 0;
+
+	t = strtoull(line, &end, 10) * 1000000;
+	if(end == line){
+		return -1;
+	}
+	if(*end == '.'){
+		end++;
+		while(*end >= '0' && *end <= '9'){
+			t += (*end++ - '0') * scale;
+			scale /= 10;
+		}
+	}
+	while(*end == ',' && n < LOG_INDEX_MAX_CHANNELS){
+		values[n++] = strtof(end + 1, &end);
+	}
+	return n;
+}
+
+static int indexFile(const char *name){
+	FILE *in = fopen(name, "r");
+	LogIndexWriter writer;
+	char line[1024];
+	float values[LOG_INDEX_MAX_CHANNELS];
+	uint64_t t, offset = 0;
+	long samples = 0;
+	int n;
+
+	if(in == NULL){
+		perror(name);
+		return 1;
+	}
+	for(n = 0; n < LOG_INDEX_LEVELS; n++){		//Start over rather than add to an old index
+		snprintf(line, sizeof(line), "%s.ix%d", name, n);
+		remove(line);
+	}
+	writer.begin(name);
+	while(fgets(line, sizeof(line), in) != NULL){
+		if(offset >= LOG_INDEX_MAX_BYTES){
+			fprintf(stderr, "%s: the index can only point into the first 4 GiB\n", name);
+			writer.end();
+			fclose(in);
+			return 1;
+		}
+		n = parseLine(line, t, values);
+		if(n > 0){
+			writer.add(t, (uint32_t)offset, values, n);
+			samples++;
+		}
+		offset += strlen(line);
+	}
+	writer.end();
+	fclose(in);
+	printf("%ld samples indexed\n", samples);
+	return 0;
+}
+
+static int makeFile(const char *name, double megabytes, int channels){
+	FILE *out;
+	LogIndexWriter writer;
+	float values[LOG_INDEX_MAX_CHANNELS];
+	uint64_t t, offset = 0;
+	double target = megabytes * 1e6;
+	long i = 0;
+	int c, n;
+
+	if(target >= LOG_INDEX_MAX_BYTES){
+		fprintf(stderr, "%s: data files must be smaller than %.0f MB\n", name, LOG_INDEX_MAX_BYTES / 1e6);
+		return 1;
+	}
+	out = fopen(name, "w");
+	if(out == NULL){
+		perror(name);
+		return 1;
+	}
+	writer.begin(name);
+	while(offset < target){
+		t = 1760000000000000ULL + i * 1000;		//One sample per millisecond
+		for(c = 0; c < channels; c++){
+			values[c] = sinf(6.2831853f * (c + 1) * (i % 60000) / 60000.0f) + ((i % 100003) == 0 ? 5.0f : 0.0f);
+		}
+		writer.add(t, (uint32_t)offset, values, channels);
+		n = fprintf(out, "%lu.%06lu", (unsigned long)(t / 1000000), (unsigned long)(t % 1000000));
+		for(c = 0; c < channels; c++){
+			n += fprintf(out, ", %g", (double)values[c]);
+		}
+		fputc('\n', out);
+		offset += n + 1;
+		i++;
+	}
+	writer.end();
+	fclose(out);
+	printf("%ld samples, %.1f MB\n", i, offset / 1e6);
+	return 0;
+}
+
+static int bench(const char *name, int columns){
+	LogIndexReader log;
+	std::vector<float> lo(columns), hi(columns);
+	uint64_t first, last, t, tLine, span;
+	uint32_t offset;
+	FILE *data;
+	char line[1024];
+	float values[LOG_INDEX_MAX_CHANNELS];
+	double start, elapsed;
+	long reads;
+	int i, zoom, n, c, mismatches;
+	const int SEEKS = 10000;
+
+	if(!log.open(name) || !log.timeSpan(first, last)){
+		fprintf(stderr, "%s: no index, run 'logindex index' first\n", name);
+		return 1;
+	}
+	printf("index records per level:");
+	for(i = 0; i < LOG_INDEX_LEVELS; i++){
+		printf(" %u", log.records(i));
+	}
+	printf(", %.1f hours recorded\n", (last - first) / 3.6e9);
+
+	//Searches: each one should touch about log2(records) index records, then at most one block of the data file
+	data = fopen(name, "r");
+	srand(1);
+	start = seconds();
+	for(i = 0; i < SEEKS; i++){
+		t = first + ((uint64_t)rand() * rand()) % (last - first + 1);
+		if(log.seek(t, offset) && i % 100 == 0 && data != NULL){
+			fseeko(data, (off_t)offset, SEEK_SET);		//Check a few: the line there must come at or before t
+			if(fgets(line, sizeof(line), data) == NULL || parseLine(line, tLine, values) < 0 || tLine > t){
+				printf("seek to %llu landed on a later sample\n", (unsigned long long)t);
+			}
+		}
+	}
+	elapsed = seconds() - start;
+	printf("seek: %.2f us each\n", elapsed / SEEKS * 1e6);
+
+	//Overviews at zoom levels from the whole recording down to a few seconds
+	for(zoom = 1; zoom <= 100000; zoom *= 10){
+		span = (last - first) / zoom;
+		start = seconds();
+		reads = log.summarize(first, first + span, 0, columns, lo.data(), hi.data());
+		elapsed = seconds() - start;
+		printf("overview of %10.1f s in %d columns: %6ld index records, %8.3f ms\n",
+			span / 1e6, columns, reads, elapsed * 1e3);
+	}
+
+	//The same whole-recording overview made the slow way, as it would be without an index
+	if(data != NULL){
+		std::vector<float> slo(columns, 1.0f), shi(columns, -1.0f);
+		fseeko(data, 0, SEEK_SET);
+		span = last - first + 1;
+		start = seconds();
+		while(fgets(line, sizeof(line), data) != NULL){
+			n = parseLine(line, t, values);
+			if(n <= 0 || t < first || t > last){
+				continue;
+			}
+			c = (int)((uint64_t)(t - first) * columns / span);
+			if(slo[c] > shi[c]){
+				slo[c] = shi[c] = values[0];
+			}
+			else{
+				if(values[0] < slo[c]) slo[c] = values[0];
+				if(values[0] > shi[c]) shi[c] = values[0];
+			}
+		}
+		elapsed = seconds() - start;
+		log.summarize(first, last, 0, columns, lo.data(), hi.data());
+		mismatches = 0;
+		for(c = 0; c < columns; c++){		//Index columns may be a little wider, never narrower. The data file only has 6 digits.
+			if(slo[c] <= shi[c] && (lo[c] > slo[c] + 1e-5f*fabsf(slo[c]) || hi[c] < shi[c] - 1e-5f*fabsf(shi[c]))){
+				mismatches++;
+			}
+		}
+		printf("overview by reading the data file: %.1f ms, %d columns missing extremes\n", elapsed * 1e3, mismatches);
+		fclose(data);
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[]){
+	if(argc >= 3 && strcmp(argv[1], "index") == 0){
+		return indexFile(argv[2]);
+	}
+	if(argc >= 4 && strcmp(argv[1], "make") == 0){
+		return makeFile(argv[2], atof(argv[3]), (argc >= 5) ? atoi(argv[4]) : 4);
+	}
+	if(argc >= 3 && strcmp(argv[1], "bench") == 0){
+		return bench(argv[2], (argc >= 4) ? atoi(argv[3]) : 800);
+	}
+	fprintf(stderr, "usage: logindex index data.csv\n"
+	                "       logindex make data.csv megabytes [channels]\n"
+	                "       logindex bench data.csv [columns]\n");
+	return 2;
+}
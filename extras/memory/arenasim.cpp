@@ -0,0 +1,175 @@
+/**
+
+@file
+
+arenasim - checks the GigaDAQ MemoryArena on a desktop computer and shows how the SDRAM arena of a
+sketch fills up for a given arena size.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. arenasim
+
+Usage:
+
+    arenasim [sdram_kb] [pages] [redraws] [largest_control_percent]
+
+First, random blocks are taken and given back in random order, and every block is filled with its
+own pattern to check that no two blocks overlap and that the arena ends up in one piece again.
+
+Then the memory use of a GigaDAQ sketch is played through with an SDRAM arena of sdram_kb kilobytes
+(default 4096, as SDRAM_ARENA_SIZE): page images for the given number of pages (default 4) are kept
+as the pages are shown, recordings are started and ended, and controls are redrawn redraws times
+(default 100000). Each redraw takes a canvas for a control of up to largest_control_percent of the
+screen (default 50) and gives it back afterwards. Requests the arena cannot meet are counted, since
+GigaDAQ then falls back to the heap; on the GIGA the heap is in the much smaller internal RAM.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MemoryArena.h"
+
+const size_t PAGE_BYTES = 480 * 800 * 2;
+const size_t LOG_BUFFER = 8192;
+const int MAX_BLOCKS = 256;
+
+static bool checkRandom(void){
+	const size_t REGION = 1 << 20;
+	static uint8_t region[REGION + 64];
+	uint8_t *block[MAX_BLOCKS];
+	size_t len[MAX_BLOCKS], i, j, k;
+	MemoryArena arena;
+	int round;
+
+	memset(block, 0, sizeof(block));
+	if(!arena.begin("test", region + 7, REGION)){		//Deliberately misaligned
+		printf("begin() failed\n");
+		return false;
+	}
+	for(round = 0; round < 200000; round++){
+		i = rand() % MAX_BLOCKS;
+		if(block[i] == nullptr){
+			len[i] = (rand() % 4 == 0) ? rand() % 65536 : rand() % 512;
+			block[i] = (uint8_t *)arena.alloc(len[i]);
+			if(block[i] != nullptr){
+				if(((uintptr_t)block[i] & (ARENA_ALIGN - 1)) != 0 || !arena.owns(block[i]) || !arena.owns(block[i] + len[i] - (len[i] > 0))){
+					printf("Block %lu is misaligned or outside the region\n", (unsigned long)i);
+					return false;
+				}
+				memset(block[i], (int)(i & 0xFF), len[i]);
+			}
+		}
+		else{
+			for(k = 0; k < len[i]; k++){		//Anything else written over the block shows up here
+				if(block[i][k] != (uint8_t)(i & 0xFF)){
+					printf("Block %lu was overwritten at byte %lu\n", (unsigned long)i, (unsigned long)k);
+					return false;
+				}
+			}
+			arena.release(block[i]);
+			block[i] = nullptr;
+		}
+		if(arena.used() > arena.peak() || arena.used() > arena.size()){
+			printf("Bad accounting: %lu used, peak %lu\n", (unsigned long)arena.used(), (unsigned long)arena.peak());
+			return false;
+		}
+	}
+	for(j = 0; j < MAX_BLOCKS; j++){
+		arena.release(block[j]);
+	}
+	arena.release(region);		//Not a block: must be ignored
+	if(arena.used() != 0 || arena.largestFree() != arena.size() - ARENA_ALIGN){
+		printf("The arena did not join up again: %lu used, largest free %lu of %lu\n",
+			(unsigned long)arena.used(), (unsigned long)arena.largestFree(), (unsigned long)arena.size());
+		return false;
+	}
+	printf("Random test passed: %lu blocks handed out, peak %lu of %lu bytes\n",
+		(unsigned long)arena.allocations, (unsigned long)arena.peak(), (unsigned long)arena.size());
+	return true;
+}
+
+int main(int argc, char **argv){
+	size_t sdramKb = (argc > 1) ? atol(argv[1]) : 4096;
+	int pages = (argc > 2) ? atoi(argv[2]) : 4;
+	long redraws = (argc > 3) ? atol(argv[3]) : 100000;
+	int largest = (argc > 4) ? atoi(argv[4]) : 50;
+	void *page[16] = {nullptr};
+	void *logBuffer = nullptr, *canvas;
+	uint8_t *region;
+	MemoryArena sdram;
+	long r, heapCanvases = 0, heapPages = 0;
+	size_t w, h, heapPeak = 0;
+	char line[160];
+
+	srand(1);
+	if(!checkRandom()){
+		return 1;
+	}
+
+	if(pages > 16) pages = 16;
+	region = (uint8_t *)malloc(sdramKb * 1024);
+	if(!sdram.begin("sdram", region, sdramKb * 1024)){
+		printf("An arena of %lu KB is too small\n", (unsigned long)sdramKb);
+		return 1;
+	}
+	for(r = 0; r < redraws; r++){
+		if(r % 1000 == 0){						//Showing a page keeps an image of the one being left
+			int p = rand() % pages;
+			if(page[p] == nullptr){
+				page[p] = sdram.alloc(PAGE_BYTES);
+				if(page[p] == nullptr){
+					page[p] = (void *)1;		//From SDRAM.malloc() instead
+					heapPages++;
+				}
+			}
+		}
+		if(r % 5000 == 0){						//Starting or ending a recording
+			if(logBuffer == nullptr){
+				logBuffer = sdram.alloc(LOG_BUFFER);
+			}
+			else{
+				sdram.release(logBuffer);
+				logBuffer = nullptr;
+			}
+		}
+		w = 1 + rand() % (480 * largest / 100);		//A text box, button or slider being redrawn
+		h = 1 + rand() % (800 * largest / 100);
+		canvas = sdram.alloc(w * h * 2);
+		if(canvas == nullptr){
+			heapCanvases++;
+			if(w * h * 2 > heapPeak) heapPeak = w * h * 2;
+		}
+		sdram.release(canvas);
+	}
+	sdram.report(line, sizeof(line));
+	printf("%s\n", line);
+	printf("Page images outside the arena: %ld. Canvases from the heap: %ld of %ld, largest %lu bytes\n",
+		heapPages, heapCanvases, redraws, (unsigned long)heapPeak);
+	free(region);
+	return 0;
+}
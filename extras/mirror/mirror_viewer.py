@@ -0,0 +1,440 @@
+#!/usr/bin/env python3
+"""
+mirror_viewer.py - shows the screen of a GigaDAQ ScreenMirror and passes mouse clicks back as touches.
+
+Usage:
+    python3 mirror_viewer.py /dev/ttyACM0 [--scale 1.0]
+    python3 mirror_viewer.py --connect 192.168.1.50:5000 [--scale 1.0]
+    python3 mirror_viewer.py /dev/ttyACM0 --snapshot screen.ppm [--seconds 5]
+    python3 mirror_viewer.py --simulate
+
+The picture is turned the same way as the screen. Pressing the mouse button on it puts a finger
+on the screen, dragging moves the finger and releasing the button lifts it, so buttons and
+sliders work as if they were touched. Once a second a status line reports frames, bytes per
+second, bad frames (failed CRC), lost frames (gaps in the sequence numbers) and the bits the
+colors are short of (the GIGA drops low bits when the connection is slow, and sends them again
+when it has caught up) on stderr. After a bad or lost frame, the whole screen is asked for again.
+
+Frames are COBS-encoded and end with a zero byte, like those of SerialStreamSink. Frames from
+the GIGA start with the 16-byte header (version, type, encoding, depth, seq, x, y, w, h): an
+INFO frame gives the size of the screen buffer in w and h and the rotation in encoding, and a
+RECT frame is followed by the pixels of rows y to y + h - 1 of the buffer, raw, as runs of
+colors or as runs of palette colors (see ScreenMirror.h). Frames to the GIGA are 16 bytes
+(version, type, contacts, 0, seq, x[2], y[2]), with the fingers in screen buffer pixels. A
+CRC-32 of everything before it ends every frame, all little-endian.
+
+--snapshot runs without a window and saves the picture as a PPM file after --seconds.
+--simulate sends a test picture in every encoding through a pseudo-terminal and checks that
+it is decoded exactly, so the decoding can be tried on Linux without a GIGA.
+
+Written by David A. Trevas. MIT License, Copyright (c) 2025 David A. Trevas.
+See the LICENSE file of the GigaDAQ library.
+"""
+
+import argparse
+import os
+import socket
+import struct
+import sys
+import termios
+import threading
+import time
+import tty
+import zlib
+
+VERSION = 1                 # must match MIRROR_VERSION in ScreenMirror.h
+INFO, RECT, TOUCH, REFRESH = 1, 2, 3, 4
+RAW, RLE, PALETTE = 0, 1, 2
+HEADER = struct.Struct("<BBBBIHHHH")
+TOUCH_FRAME = struct.Struct("<BBBBIHHHH")
+PALETTE_COLORS = 8
+TOUCH_REPEAT = 0.05         # seconds between reports of a held mouse button, well inside MIRROR_TOUCH_TIMEOUT
+
+
+def cobs_encode(data):
+    out = bytearray()
+    block = bytearray()
+    for b in data:
+        if b == 0:
+            out.append(len(block) + 1)
+            out += block
+            block = bytearray()
+        else:
+            block.append(b)
+            if len(block) == 254:
+                out.append(255)
+                out += block
+                block = bytearray()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+def cobs_decode(data):
+    """Returns the decoded bytes, or None if the encoding is broken."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 255 and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def seal(body):
+    return cobs_encode(body + struct.pack("<I", zlib.crc32(body))) + b"\0"
+
+
+def rgb(c):
+    """RGB565 to three bytes, with the low bits filled so that white stays white."""
+    r, g, b = c >> 11, (c >> 5) & 63, c & 31
+    return bytes(((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)))
+
+
+class Screen:
+    """The picture, kept as RGB rows of the screen buffer, and the frames that change it."""
+
+    def __init__(self):
+        self.width = self.height = self.rotation = 0
+        self.pixels = bytearray()
+        self.expected = None
+        self.frames = self.bad = self.lost = 0
+        self.depth = 0
+        self.changed = False
+        self.lock = threading.Lock()
+
+    def frame(self, encoded):
+        """Applies one encoded frame. Returns False if it is damaged or makes no sense."""
+        frame = cobs_decode(encoded)
+        if frame is None or len(frame) < HEADER.size + 4:
+            return False
+        body, crc = frame[:-4], struct.unpack("<I", frame[-4:])[0]
+        if zlib.crc32(body) != crc:
+            return False
+        version, kind, encoding, depth, seq, x, y, w, h = HEADER.unpack_from(body)
+        if version != VERSION:
+            return False
+        ok = True
+        if self.expected is not None and seq != self.expected:
+            self.lost += (seq - self.expected) & 0xFFFFFFFF
+            ok = False          # pixels are missing, so the whole screen is needed again
+        self.expected = (seq + 1) & 0xFFFFFFFF
+        self.frames += 1
+        with self.lock:
+            if kind == INFO:
+                if (w, h) != (self.width, self.height):
+                    self.pixels = bytearray(3 * w * h)
+                self.width, self.height, self.rotation = w, h, encoding & 3
+                self.changed = True
+                return True
+            if kind != RECT or not self.width or x + w > self.width or y + h > self.height:
+                return False
+            self.depth = depth
+            self.changed = True
+            return self.rect(encoding, x, y, w, h, body[HEADER.size:]) and ok
+
+    def rect(self, encoding, x, y, w, h, data):
+        i = 0
+        palette = []
+        if encoding == PALETTE:
+            if len(data) < 1 + 2 * PALETTE_COLORS:
+                return False
+            palette = [rgb(c) for c in struct.unpack_from("<%dH" % PALETTE_COLORS, data, 1)[:data[0]]]
+            i = 1 + 2 * PALETTE_COLORS
+        for row in range(y, y + h):
+            at = 3 * (row * self.width + x)
+            end = at + 3 * w
+            if encoding == RAW:
+                if i + 2 * w > len(data):
+                    return False
+                for c in struct.unpack_from("<%dH" % w, data, i):
+                    self.pixels[at:at + 3] = rgb(c)
+                    at += 3
+                i += 2 * w
+                continue
+            while at < end:
+                if encoding == RLE:
+                    if i + 3 > len(data):
+                        return False
+                    run = data[i] + 1
+                    color = rgb(data[i + 1] | (data[i + 2] << 8))
+                    i += 3
+                elif encoding == PALETTE:
+                    if i >= len(data) or data[i] >> 5 >= len(palette):
+                        return False
+                    color = palette[data[i] >> 5]
+                    run = (data[i] & 31) + 1
+                    i += 1
+                    if run == 32:
+                        if i >= len(data):
+                            return False
+                        run += data[i]
+                        i += 1
+                else:
+                    return False
+                if at + 3 * run > end:
+                    return False
+                self.pixels[at:at + 3 * run] = color * run
+                at += 3 * run
+        return i == len(data)
+
+    def size(self):
+        """Size of the picture as shown, turned like the screen."""
+        return (self.height, self.width) if self.rotation & 1 else (self.width, self.height)
+
+    def to_buffer(self, sx, sy):
+        """A point of the picture as shown, in screen buffer pixels, the way the GFX library turns what it draws."""
+        w, h = self.width, self.height
+        return [(sx, sy), (w - 1 - sy, sx), (w - 1 - sx, h - 1 - sy), (sy, h - 1 - sx)][self.rotation]
+
+    def ppm(self):
+        """The picture as shown, as a binary PPM image."""
+        w, h, src = self.width, self.height, self.pixels
+        sw, sh = self.size()
+        out = bytearray(3 * sw * sh)
+        with self.lock:
+            for sy in range(sh):
+                o = 3 * sy * sw
+                if self.rotation == 0:
+                    line = src[3 * sy * w:3 * (sy + 1) * w]
+                elif self.rotation == 2:            # a buffer row, backwards
+                    line = bytearray(3 * sw)
+                    row = src[3 * (h - 1 - sy) * w:3 * (h - sy) * w]
+                    for k in range(3):
+                        line[k::3] = row[k::3][::-1]
+                else:                               # a buffer column, down for rotation 1 and up for 3
+                    line = bytearray(3 * sw)
+                    col = w - 1 - sy if self.rotation == 1 else sy
+                    for k in range(3):
+                        channel = src[3 * col + k::3 * w]
+                        line[k::3] = channel if self.rotation == 1 else channel[::-1]
+                out[o:o + 3 * sw] = line
+            self.changed = False
+        return b"P6 %d %d 255\n" % (sw, sh) + bytes(out)
+
+
+class Link:
+    """A serial port or a network connection to the GIGA."""
+
+    def __init__(self, port=None, address=None):
+        self.sock = self.fd = None
+        self.seq = 0
+        if address:
+            host, number = address.rsplit(":", 1)
+            self.sock = socket.create_connection((host, int(number)))
+            self.sock.settimeout(0.2)
+        else:
+            self.fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+            tty.setraw(self.fd)
+            attrs = termios.tcgetattr(self.fd)
+            attrs[6][termios.VMIN] = 0      # reads return after at most 0.2 s
+            attrs[6][termios.VTIME] = 2
+            termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+
+    def read(self):
+        if self.sock is not None:
+            try:
+                data = self.sock.recv(65536)
+            except socket.timeout:
+                return b""
+            if not data:
+                raise OSError("connection closed")
+            return data
+        return os.read(self.fd, 65536)
+
+    def send(self, kind, contacts=0, x=0, y=0):
+        frame = seal(TOUCH_FRAME.pack(VERSION, kind, contacts, 0, self.seq, x, 0, y, 0))
+        self.seq = (self.seq + 1) & 0xFFFFFFFF
+        if self.sock is not None:
+            self.sock.sendall(frame)
+        else:
+            os.write(self.fd, frame)
+
+    def close(self):
+        if self.sock is not None:
+            self.sock.close()
+        else:
+            os.close(self.fd)
+
+
+def receive(link, screen, stop):
+    """Reads frames until stop is set, asking for the whole screen after a bad one."""
+    pending = bytearray()
+    window_bytes = 0
+    window_start = time.monotonic()
+    asked = 0.0
+    link.send(REFRESH)          # the GIGA may have started long before the viewer
+    while not stop.is_set():
+        try:
+            chunk = link.read()
+        except OSError:
+            break
+        window_bytes += len(chunk)
+        pending += chunk
+        while True:
+            end = pending.find(b"\0")
+            if end < 0:
+                break
+            encoded = bytes(pending[:end])
+            del pending[:end + 1]
+            if not encoded:
+                continue
+            if not screen.frame(encoded):
+                screen.bad += 1
+                if time.monotonic() - asked > 1.0:      # once, not for every frame of the damaged update
+                    asked = time.monotonic()
+                    link.send(REFRESH)
+        now = time.monotonic()
+        if now - window_start >= 1.0:
+            print("frames %d  %.1f kB/s  bad frames %d  lost frames %d  colors %d bits short"
+                  % (screen.frames, window_bytes / (now - window_start) / 1000.0, screen.bad, screen.lost, screen.depth),
+                  file=sys.stderr)
+            window_bytes = 0
+            window_start = now
+
+
+def show(link, screen, stop, scale):
+    """Shows the picture in a window and sends the mouse button as a finger."""
+    import tkinter as tk
+
+    root = tk.Tk()
+    root.title("GigaDAQ mirror")
+    label = tk.Label(root, bd=0)
+    label.pack()
+    held = {"down": False, "x": 0, "y": 0, "sent": 0.0}
+
+    def finger(event, contacts):
+        sw, sh = screen.size()
+        sx = min(max(int(event.x / scale), 0), sw - 1)
+        sy = min(max(int(event.y / scale), 0), sh - 1)
+        held.update(down=contacts > 0, x=sx, y=sy, sent=time.monotonic())
+        if screen.width:
+            bx, by = screen.to_buffer(sx, sy)
+            link.send(TOUCH, contacts, bx, by)
+
+    label.bind("<ButtonPress-1>", lambda e: finger(e, 1))
+    label.bind("<B1-Motion>", lambda e: finger(e, 1))
+    label.bind("<ButtonRelease-1>", lambda e: finger(e, 0))
+
+    def refresh():
+        if stop.is_set():
+            root.destroy()
+            return
+        if held["down"] and time.monotonic() - held["sent"] >= TOUCH_REPEAT:   # a finger held still keeps reporting
+            held["sent"] = time.monotonic()
+            link.send(TOUCH, 1, *screen.to_buffer(held["x"], held["y"]))
+        if screen.changed and screen.width:
+            picture = tk.PhotoImage(data=screen.ppm(), format="PPM")
+            if scale != 1.0:
+                factor = max(1, round(scale if scale > 1 else 1 / scale))
+                picture = picture.zoom(factor) if scale > 1 else picture.subsample(factor)
+            label.configure(image=picture)
+            label.image = picture
+        root.after(30, refresh)
+
+    root.protocol("WM_DELETE_WINDOW", stop.set)
+    refresh()
+    root.mainloop()
+
+
+def simulate(fd):
+    """Writes a test picture as a GIGA would: INFO, then a band in each encoding. Returns the picture as RGB rows."""
+    width, height = 480, 800
+    colors = [0x0000, 0xFFFF, 0xF800, 0x07E0, 0x001F, 0xFFE0, 0x07FF, 0xF81F]
+    image = [[colors[(x // 40 + y // 20) % 8] for x in range(width)] for y in range(height)]
+    for y in range(200, 300):               # a gradient needs RAW
+        image[y] = [(x * 37 + y * 11) & 0xFFFF for x in range(width)]
+    for y in range(300, 400):               # many colors in long runs need RLE
+        image[y] = [((x // 60) * 4099 + y * 7) & 0xFFFF for x in range(width)]
+    seq = 0
+
+    def send(header, data=b""):
+        nonlocal seq
+        os.write(fd, seal(HEADER.pack(VERSION, header[0], header[1], 0, seq, *header[2:]) + data))
+        seq += 1
+
+    send((INFO, 0, 0, 0, width, height))
+    for y in range(height):
+        row = image[y]
+        if y < 200 or y >= 400:
+            runs, x = bytearray(), 0
+            while x < width:
+                run = 1
+                while x + run < width and row[x + run] == row[x] and run < 287:
+                    run += 1
+                k = colors.index(row[x])
+                runs += bytes([(k << 5) | 31, run - 32]) if run >= 32 else bytes([(k << 5) | (run - 1)])
+                x += run
+            send((RECT, PALETTE, 0, y, width, 1), bytes([8]) + struct.pack("<8H", *colors) + runs)
+        elif y < 300:
+            send((RECT, RAW, 0, y, width, 1), struct.pack("<%dH" % width, *row))
+        else:
+            runs, x = bytearray(), 0
+            while x < width:
+                run = 1
+                while x + run < width and row[x + run] == row[x] and run < 256:
+                    run += 1
+                runs += struct.pack("<BH", run - 1, row[x])
+                x += run
+            send((RECT, RLE, 0, y, width, 1), runs)
+    return b"".join(b"".join(rgb(c) for c in row) for row in image)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port", nargs="?", help="serial port of the GIGA, such as /dev/ttyACM0")
+    parser.add_argument("--connect", metavar="HOST:PORT", help="network address of the GIGA instead of a serial port")
+    parser.add_argument("--scale", type=float, default=1.0, help="size of the picture, such as 0.5 for half")
+    parser.add_argument("--snapshot", metavar="FILE", help="save the picture as a PPM file after --seconds, without a window")
+    parser.add_argument("--seconds", type=float, default=5.0, help="how long to receive before --snapshot")
+    parser.add_argument("--simulate", action="store_true", help="decode a test picture sent through a pseudo-terminal")
+    args = parser.parse_args()
+
+    screen = Screen()
+    stop = threading.Event()
+    if args.simulate:
+        import pty
+        writer, reader = pty.openpty()
+        tty.setraw(writer)
+        link = Link(os.ttyname(reader))
+        os.close(reader)
+        sender = threading.Thread(target=lambda: expected.append(simulate(writer)), daemon=True)
+        expected = []
+        sender.start()
+        receiver = threading.Thread(target=receive, args=(link, screen, stop), daemon=True)
+        receiver.start()
+        sender.join()
+        time.sleep(1.0)
+        stop.set()
+        receiver.join()
+        link.close()
+        ok = screen.bad == 0 and screen.lost == 0 and bytes(screen.pixels) == expected[0]
+        print("%d frames, %d bad, %d lost: %s" % (screen.frames, screen.bad, screen.lost, "PASSED" if ok else "FAILED"))
+        sys.exit(0 if ok else 1)
+    if not args.port and not args.connect:
+        parser.error("give a serial port, --connect or --simulate")
+
+    link = Link(args.port, args.connect)
+    receiver = threading.Thread(target=receive, args=(link, screen, stop), daemon=True)
+    receiver.start()
+    try:
+        if args.snapshot:
+            time.sleep(args.seconds)
+            with open(args.snapshot, "wb") as f:
+                f.write(screen.ppm())
+        else:
+            show(link, screen, stop, args.scale)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stop.set()
+        receiver.join()
+        link.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,533 @@
+/**
+
+@file
+
+mirrorsim - checks the screen mirror over a simulated connection: that a viewer ends up with exactly
+the picture on the screen, that its taps and drags work the controls, and what the mirror sends.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. mirrorsim
+
+The stand-in libraries of the soak test (extras/soak/host) give GigaDisplay_GFX a screen buffer in
+memory and simulate the time.
+
+Usage:
+
+    mirrorsim
+
+A GigaDAQ with six changing readings, a toggle button and a slider is mirrored through a simulated
+connection to a stand-in for mirror_viewer.py, which decodes the frames into its own picture the
+way the viewer does. For six seconds the readings change 20 times a second while the viewer taps
+the button and drags the slider. Then the screen stays still until the mirror has sent everything
+with exact colors, and the viewer's picture must be identical to the screen buffer, the button must
+be on and the slider where the finger left it. This is done for a fast USB connection, a network
+connection in landscape with the touch screen polled, a 115200-baud serial port, and a connection
+that damages a byte now and then, after which the viewer must ask for the whole screen again.
+
+For each connection the updates, bytes and the most bits dropped from the colors are printed, with
+the bytes that sending the whole screen for each update would have taken.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+#include "GigaDAQ.h"
+#include "SerialStream.h"
+
+const int PIXELS = GIGA_DS_WIDTH * GIGA_DS_HEIGHT;
+const uint64_t STEP = 1000;				//Microseconds per pass through the main loop
+const uint64_t BUSY_TIME = 6000000;		//Microseconds of changing readings and touches
+const uint64_t END_TIME = 60000000;		//Microseconds by which the viewer must have caught up
+
+/** A connection between the GIGA and a viewer, carrying bytesPerSecond towards the viewer, with a transmit buffer of buffer bytes on the GIGA's side */
+class LoopbackPort : public Stream {
+public:
+	uint32_t bytesPerSecond;
+	int buffer;
+	uint32_t damageEvery;				//Flip a bit of every so many bytes carried, 0 never to
+	bool damage;
+	uint32_t damaged;
+	std::deque<uint8_t> queued;			//Written by the GIGA, not yet carried
+	std::deque<uint8_t> arrived;		//Carried to the viewer, not yet read
+	std::deque<uint8_t> fromViewer;		//Written by the viewer, read by the GIGA
+
+	LoopbackPort(uint32_t rate, int buffer, uint32_t damageEvery){
+		bytesPerSecond = rate;
+		this->buffer = buffer;
+		this->damageEvery = damageEvery;
+		damage = damageEvery > 0;
+		damaged = 0;
+		last = simTime;
+		credit = 0;
+		carried = 0;
+	}
+	//Carries what the connection has had time for since the last call
+	void advance(void){
+		uint8_t b;
+
+		credit += (simTime - last) * (double)bytesPerSecond / 1e6;
+		last = simTime;
+		while(credit >= 1 && !queued.empty()){
+			b = queued.front();
+			queued.pop_front();
+			if(damage && ++carried % damageEvery == 0){
+				b ^= 1 << (carried / damageEvery % 8);
+				damaged++;
+			}
+			arrived.push_back(b);
+			credit -= 1;
+		}
+		if(queued.empty() && credit > 1){
+			credit = 1;		//A connection that was idle doesn't save up
+		}
+	}
+	size_t write(uint8_t c) override {
+		return write(&c, 1);
+	}
+	size_t write(const uint8_t *b, size_t n) override {
+		size_t i;
+
+		for(i = 0; i < n && (int)queued.size() < buffer; i++){
+			queued.push_back(b[i]);
+		}
+		return i;
+	}
+	int availableForWrite(void) override { return buffer - queued.size(); }
+	int available(void) override { return fromViewer.size(); }
+	int read(void) override {
+		int c;
+
+		if(fromViewer.empty()){
+			return -1;
+		}
+		c = fromViewer.front();
+		fromViewer.pop_front();
+		return c;
+	}
+	int peek(void) override { return fromViewer.empty() ? -1 : fromViewer.front(); }
+	bool idle(void){ return queued.empty() && arrived.empty(); }
+private:
+	uint64_t last;
+	double credit;
+	uint32_t carried;
+};
+
+/** Decodes the mirror frames into a picture of the screen buffer, like mirror_viewer.py, and sends it touches */
+class MirrorViewer {
+public:
+	uint16_t image[PIXELS];
+	int width, height, rotation;
+	bool info, refreshPending;
+	uint32_t frames, badFrames, lost, refreshes;
+	int maxDepth;
+
+	MirrorViewer(LoopbackPort &port) : port(port) {
+		memset(image, 0, sizeof(image));
+		width = height = rotation = 0;
+		info = refreshPending = false;
+		frames = badFrames = lost = refreshes = 0;
+		maxDepth = 0;
+		expected = 0;
+		touchSeq = 0;
+	}
+	//Reads what has arrived
+	void service(void){
+		std::vector<uint8_t> buf;
+		int n;
+
+		while(!port.arrived.empty()){
+			uint8_t c = port.arrived.front();
+			port.arrived.pop_front();
+			if(c != 0){
+				in.push_back(c);
+				continue;
+			}
+			if(in.empty()){
+				continue;
+			}
+			buf.resize(in.size());
+			n = cobsDecode(in.data(), in.size(), buf.data());
+			in.clear();
+			if(!frame(buf.data(), n)){
+				badFrames++;
+				refresh();
+			}
+		}
+	}
+	//Reports a finger at a point of the picture as the viewer shows it, turned like the screen
+	void touch(int contacts, int sx, int sy){
+		MirrorTouch m;
+
+		memset(&m, 0, sizeof(m));
+		m.version = MIRROR_VERSION;
+		m.type = MIRROR_TOUCH;
+		m.contacts = contacts;
+		toBuffer(sx, sy, m.x[0], m.y[0]);
+		send(m);
+	}
+private:
+	LoopbackPort &port;
+	std::vector<uint8_t> in;
+	uint32_t expected, touchSeq;
+
+	void send(MirrorTouch &m){
+		uint8_t buf[sizeof(m) + 4], out[sizeof(buf) + 2];
+		uint32_t crc;
+		int i, n;
+
+		m.seq = touchSeq++;
+		memcpy(buf, &m, sizeof(m));
+		crc = crc32(buf, sizeof(m));
+		memcpy(&buf[sizeof(m)], &crc, 4);
+		n = cobsEncode(buf, sizeof(buf), out);
+		for(i = 0; i < n; i++){
+			port.fromViewer.push_back(out[i]);
+		}
+		port.fromViewer.push_back(0);
+	}
+	void refresh(void){
+		MirrorTouch m;
+
+		if(refreshPending){
+			return;
+		}
+		memset(&m, 0, sizeof(m));
+		m.version = MIRROR_VERSION;
+		m.type = MIRROR_REFRESH;
+		send(m);
+		refreshPending = true;
+		refreshes++;
+	}
+	//Turns a point of the picture as shown into the screen buffer, as the GFX library turns what it draws
+	void toBuffer(int sx, int sy, uint16_t &bx, uint16_t &by){
+		switch(rotation){
+			case 1:
+				bx = width - 1 - sy;
+				by = sx;
+				break;
+			case 2:
+				bx = width - 1 - sx;
+				by = height - 1 - sy;
+				break;
+			case 3:
+				bx = sy;
+				by = height - 1 - sx;
+				break;
+			default:
+				bx = sx;
+				by = sy;
+		}
+	}
+	bool frame(const uint8_t *buf, int n){
+		MirrorHeader hd;
+		uint32_t crc;
+
+		if(n < (int)sizeof(hd) + 4){
+			return false;
+		}
+		memcpy(&crc, &buf[n - 4], 4);
+		if(crc != crc32(buf, n - 4)){
+			return false;
+		}
+		memcpy(&hd, buf, sizeof(hd));
+		if(hd.version != MIRROR_VERSION){
+			return false;
+		}
+		if(hd.seq != expected && frames > 0){
+			lost += hd.seq - expected;
+			refresh();
+		}
+		expected = hd.seq + 1;
+		frames++;
+		if(hd.type == MIRROR_INFO){
+			width = hd.w;
+			height = hd.h;
+			rotation = hd.encoding;
+			info = true;
+			refreshPending = false;		//The whole screen follows
+			return width * height <= PIXELS;
+		}
+		if(hd.type != MIRROR_RECT || !info || hd.x + hd.w > width || hd.y + hd.h > height){
+			return false;
+		}
+		if(hd.depth > maxDepth){
+			maxDepth = hd.depth;
+		}
+		return pixels(hd, buf + sizeof(hd), n - 4 - sizeof(hd));
+	}
+	bool pixels(const MirrorHeader &hd, const uint8_t *p, int n){
+		uint16_t palette[MIRROR_PALETTE_COLORS], c, *px;
+		int i = 0, x, y, run, k, colors = 0;
+
+		if(hd.encoding == MIRROR_PALETTE){
+			if(n < 1 + (int)sizeof(palette)){
+				return false;
+			}
+			colors = p[0];
+			memcpy(palette, &p[1], sizeof(palette));
+			i = 1 + sizeof(palette);
+		}
+		for(y = hd.y; y < hd.y + hd.h; y++){
+			px = &image[y * width + hd.x];
+			for(x = 0; x < hd.w; x += run){
+				if(hd.encoding == MIRROR_RAW){
+					if(i + 2 > n){
+						return false;
+					}
+					memcpy(&c, &p[i], 2);
+					i += 2;
+					run = 1;
+				}
+				else if(hd.encoding == MIRROR_RLE){
+					if(i + 3 > n){
+						return false;
+					}
+					run = p[i] + 1;
+					memcpy(&c, &p[i + 1], 2);
+					i += 3;
+				}
+				else if(hd.encoding == MIRROR_PALETTE){
+					if(i + 1 > n){
+						return false;
+					}
+					k = p[i] >> 5;
+					run = (p[i] & 31) + 1;
+					i++;
+					if(run == 32){
+						if(i + 1 > n){
+							return false;
+						}
+						run += p[i++];
+					}
+					if(k >= colors){
+						return false;
+					}
+					c = palette[k];
+				}
+				else{
+					return false;
+				}
+				if(x + run > hd.w){
+					return false;
+				}
+				for(k = 0; k < run; k++){
+					px[x + k] = c;
+				}
+			}
+		}
+		return i == n;
+	}
+};
+
+struct Link {
+	const char *name;
+	uint32_t bytesPerSecond;
+	int buffer;				//Transmit buffer of the port
+	DisplayOrientation rotation;
+	bool interrupt;			//Touch screen interrupt, or polling
+	uint32_t damageEvery;
+};
+
+GigaDAQ daq;
+uint32_t buttonPresses, sliderMoves;
+
+//Points the object to a new rotation, as if it had been made with it
+static void turn(DisplayOrientation r){
+	int i;
+
+	daq.rotation = r;
+	daq.screenW = (r & 1) ? GIGA_DS_HEIGHT : GIGA_DS_WIDTH;
+	daq.screenH = (r & 1) ? GIGA_DS_WIDTH : GIGA_DS_HEIGHT;
+	daq.graph.setRotation(r);
+	for(i = 0; i < NUM_PAGES; i++){
+		daq.invalidatePage(i);
+	}
+}
+
+static void layout(void){
+	int i;
+
+	daq.clearControls();
+	for(i = 0; i < 6; i++){
+		daq.textbox[i] = Textbox(String("Reading ") + String(i), 5 + (i % 2) * 45, 5 + (i / 2) * 12, 40, 10, 0xFFFF, 0x001F);
+		daq.textbox[i].setDisplayText("0.00");
+	}
+	daq.button[0] = Button("Hold", 5, 85, 40, 10, 0xFFFF, 0xF800);
+	daq.button[0].setLook(BUTTON_ON, "Held", 0xFFE0, 0xF800);
+	daq.button[0].setToggle();
+	daq.button[0].setHandler([](){ buttonPresses++; });
+	daq.slider[0] = Slider("Level", 5, 52, 90, 8, 0xFFE0, 0x0000);
+	daq.slider[0].setMode(HORIZONTAL);
+	daq.slider[0].setXlimits(0, 100);
+	daq.slider[0].setPosition(0, 0);
+	daq.slider[0].setHandler([](){ sliderMoves++; });
+	daq.drawAll();
+}
+
+//Percent of the screen as the user sees it, in pixels
+static int pixelX(float percent){ return (int)(percent * daq.screenW / 100); }
+static int pixelY(float percent){ return (int)(percent * daq.screenH / 100); }
+
+static bool same(const uint16_t *a, const uint16_t *b, int &x, int &y){
+	int i;
+
+	for(i = 0; i < PIXELS; i++){
+		if(a[i] != b[i]){
+			x = i % GIGA_DS_WIDTH;
+			y = i / GIGA_DS_WIDTH;
+			return false;
+		}
+	}
+	return true;
+}
+
+static MirrorViewer *viewer;
+
+static int run(const Link &link){
+	LoopbackPort port(link.bytesPerSecond, link.buffer, link.damageEvery);
+	ScreenMirror mirror;
+	uint64_t start, t, nextText, lastReport = 0;
+	uint32_t busyBytes = 0, busyUpdates = 0;
+	int failures = 0, x, y, i;
+	float f;
+
+	viewer = new MirrorViewer(port);
+	turn(link.rotation);
+	daq.touchInterrupt = link.interrupt;
+	buttonPresses = sliderMoves = 0;
+	layout();
+	daq.startMirror(mirror, port);
+	start = nextText = simTime;
+	srand(1);
+
+	while(simTime - start < END_TIME){
+		t = simTime - start;
+		port.advance();
+		viewer->service();
+		if(t < BUSY_TIME){
+			if(simTime >= nextText){		//A reading changes 20 times a second
+				i = rand() % 6;
+				daq.textbox[i].setDisplayText(String((rand() % 20000 - 10000) / 100.0, 2));
+				nextText += 50000;
+			}
+			if(t - lastReport >= 20000){	//The viewer reports a held finger every 20 ms, like mouse motion
+				lastReport = t;
+				if(t >= 2000000 && t < 2120000){		//Taps the button
+					viewer->touch(1, pixelX(25), pixelY(90));
+				}
+				else if(t >= 3500000 && t < 4100000){	//Drags the slider from 10% to 90%
+					f = 10 + 80 * (t - 3500000) / 600000.0f;
+					viewer->touch(1, pixelX(5 + 0.9f * f), pixelY(56));
+				}
+				else if((t >= 2120000 && t < 2140000) || (t >= 4100000 && t < 4120000)){
+					viewer->touch(0, 0, 0);
+				}
+			}
+		}
+		else{
+			port.damage = false;
+			if(busyBytes == 0){
+				busyBytes = mirror.bytesSent;
+				busyUpdates = mirror.updatesSent;
+			}
+		}
+		daq.handleInputs();
+		daq.updateDisplays();
+		daq.serviceMirror();
+		simTime += STEP;
+		if(t >= BUSY_TIME && !mirror.busy() && mirror.depth == 0 && port.idle() && !viewer->refreshPending){
+			break;
+		}
+	}
+
+	printf("%s: %u updates (%.1f per second while busy), %u frames, %u bytes (%.1f kB/s while busy), %.1f kB as whole screens, "
+	       "%u pixels sent, most bits dropped %d, %.1f s to catch up\n",
+	       link.name, mirror.updatesSent, busyUpdates / (BUSY_TIME / 1e6), mirror.framesSent, mirror.bytesSent, busyBytes / (BUSY_TIME / 1e3),
+	       mirror.updatesSent * (PIXELS * 2 / 1e3), mirror.pixelsSent, viewer->maxDepth, (simTime - start - BUSY_TIME) / 1e6);
+	if(link.damageEvery > 0){
+		printf("%s: %u bytes damaged, %u bad frames and %u lost at the viewer, %u refreshes\n",
+		       link.name, port.damaged, viewer->badFrames, viewer->lost, viewer->refreshes);
+	}
+	if(simTime - start >= END_TIME){
+		printf("%s: the mirror never caught up\n", link.name);
+		failures++;
+	}
+	if(!same(viewer->image, daq.graph.getBuffer(), x, y)){
+		printf("%s: the viewer's picture differs at (%d, %d)\n", link.name, x, y);
+		failures++;
+	}
+	if(viewer->rotation != link.rotation){
+		printf("%s: the viewer turned the picture %d instead of %d\n", link.name, viewer->rotation, (int)link.rotation);
+		failures++;
+	}
+	if(buttonPresses != 1 || !daq.button[0].on){
+		printf("%s: the tap pressed the button %u times\n", link.name, buttonPresses);
+		failures++;
+	}
+	if(sliderMoves == 0 || daq.slider[0].posX < 85 || daq.slider[0].posX > 95){
+		printf("%s: the drag left the slider at %.1f\n", link.name, daq.slider[0].posX);
+		failures++;
+	}
+	if(link.damageEvery > 0 && (viewer->badFrames == 0 || mirror.badFrames != 0)){
+		printf("%s: the damage went unnoticed\n", link.name);
+		failures++;
+	}
+	if(link.damageEvery == 0 && (viewer->badFrames != 0 || viewer->lost != 0 || mirror.badFrames != 0)){
+		printf("%s: frames were damaged on a clean connection\n", link.name);
+		failures++;
+	}
+	if(mirror.touches.overruns != 0){
+		printf("%s: touch reports were lost\n", link.name);
+		failures++;
+	}
+	daq.stopMirror();
+	delete viewer;
+	return failures;
+}
+
+int main(void){
+	const Link links[] = {
+		{"USB", 1000000, 4096, PORTRAIT_USBDOWN, true, 0},
+		{"Network", 200000, 2920, LANDSCAPE_USBRIGHT, false, 0},
+		{"115200 baud", 11520, 64, PORTRAIT_USBUP, true, 0},
+		{"Damaging", 50000, 512, LANDSCAPE_USBLEFT, true, 20011}
+	};
+	int i, failures = 0;
+
+	daq.sdramArenaSize = 1536*1024;
+	daq.begin();
+	daq.enableTouchInterrupt();
+	for(i = 0; i < (int)(sizeof(links) / sizeof(links[0])); i++){
+		failures += run(links[i]);
+	}
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,290 @@
+/**
+
+@file
+
+panelc - compiles a GigaDAQ panel description (text) into a panel file (binary) that GigaDAQ::loadPanel() reads from the flash drive.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. panelc
+
+Usage:
+
+    panelc input.panel output.gdp
+
+Each line of the description is one control. Blank lines and lines starting with # are ignored.
+
+    textbox "Name" x y w h fgColor bgColor [text="..."]
+    button  "Name" x y w h fgColor bgColor [text="..."] [action=name] [hold=name]
+    slider  "Name" x y w h fgColor bgColor [mode=HORIZONTAL|VERTICAL|TRACKPAD]
+            [x=min,max] [y=min,max] [pos=px,py] [action=name] [pinch=name]
+
+Any control may also be given page=N to place it on a page other than 0, and slot=N to choose its array position (otherwise controls of each type are numbered in the order they appear). Colors are the names in Control.h (BLACK, WHITE, RED, ...) or 5-6-5 values such as 0xF800.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "PanelFormat.h"
+
+//These must match ControlType and SliderMode in the library, and the array sizes in GigaDAQ.h
+const int TYPE_BUTTON = 1;
+const int TYPE_SLIDER = 2;
+const int TYPE_TEXTBOX = 100;
+const int MAX_SLOTS[3] = {20, 10, 15};	//Buttons, sliders, text boxes
+
+struct NamedColor {
+	const char *name;
+	uint16_t value;
+};
+
+const NamedColor COLORS[] = {
+	{"CYAN", 0x07FF}, {"RED", 0xF800}, {"BLUE", 0x001F}, {"GREEN", 0x07E0},
+	{"MAGENTA", 0xF81F}, {"WHITE", 0xFFFF}, {"BLACK", 0x0000}, {"YELLOW", 0xFFE0}
+};
+
+static const char *inName;
+static int lineNo;
+
+static void fail(const char *msg, const std::string &detail){
+	fprintf(stderr, "%s:%d: %s%s\n", inName, lineNo, msg, detail.c_str());
+	exit(1);
+}
+
+//Splits a line into words. Double quotes group words, and key="value" stays one word without the quotes.
+static std::vector<std::string> tokenize(const char *line){
+	std::vector<std::string> words;
+	std::string word;
+	bool inQuotes = false, haveWord = false;
+	const char *p;
+
+	for(p = line; *p != '\0' && *p != '\n' && *p != '\r'; p++){
+		if(*p == '"'){
+			inQuotes = !inQuotes;
+			haveWord = true;
+		}
+		else if(!inQuotes && (*p == ' ' || *p == '\t')){
+			if(haveWord){
+				words.push_back(word);
+			}
+			word.clear();
+			haveWord = false;
+		}
+		else{
+			word += *p;
+			haveWord = true;
+		}
+	}
+	if(inQuotes){
+		fail("missing closing quote", "");
+	}
+	if(haveWord){
+		words.push_back(word);
+	}
+	return words;
+}
+
+static long toInt(const std::string &s, long lo, long hi){
+	char *end;
+	long v = strtol(s.c_str(), &end, 0);
+
+	if(s.empty() || *end != '\0' || v < lo || v > hi){
+		fail("bad number: ", s);
+	}
+	return v;
+}
+
+static uint16_t toColor(const std::string &s){
+	size_t i;
+
+	for(i = 0; i < sizeof(COLORS)/sizeof(COLORS[0]); i++){
+		if(s == COLORS[i].name){
+			return COLORS[i].value;
+		}
+	}
+	return (uint16_t)toInt(s, 0, 0xFFFF);
+}
+
+static void toPair(const std::string &s, float &a, float &b){
+	char *end;
+	size_t comma = s.find(',');
+
+	if(comma == std::string::npos){
+		fail("expected two values separated by a comma: ", s);
+	}
+	a = strtof(s.substr(0, comma).c_str(), &end);
+	b = strtof(s.substr(comma+1).c_str(), &end);
+}
+
+static void copyText(char *dst, int len, const std::string &s){
+	if((int)s.size() >= len){
+		fail("text too long: ", s);
+	}
+	memset(dst, 0, len);
+	memcpy(dst, s.c_str(), s.size());
+}
+
+int main(int argc, char *argv[]){
+	FILE *in, *out;
+	char line[512];
+	std::vector<PanelRecord> records;
+	int nextSlot[3] = {0, 0, 0};
+	PanelHeader header;
+	size_t i;
+
+	if(argc != 3){
+		fprintf(stderr, "usage: panelc input.panel output.gdp\n");
+		return 2;
+	}
+	inName = argv[1];
+	in = fopen(argv[1], "r");
+	if(in == NULL){
+		perror(argv[1]);
+		return 1;
+	}
+
+	while(fgets(line, sizeof(line), in) != NULL){
+		std::vector<std::string> words;
+		PanelRecord r;
+		int kind;
+		bool slotGiven = false;
+
+		lineNo++;
+		words = tokenize(line);
+		if(words.empty() || words[0][0] == '#'){
+			continue;
+		}
+		if(words.size() < 8){
+			fail("expected: type \"Name\" x y w h fgColor bgColor", "");
+		}
+
+		memset(&r, 0, sizeof(r));
+		if(words[0] == "button"){
+			r.type = TYPE_BUTTON;
+			kind = 0;
+		}
+		else if(words[0] == "slider"){
+			r.type = TYPE_SLIDER;
+			kind = 1;
+			r.maxX = r.maxY = 1.0;		//Same defaults as the Slider constructor
+			r.posX = r.posY = 0.5;
+		}
+		else if(words[0] == "textbox"){
+			r.type = TYPE_TEXTBOX;
+			kind = 2;
+		}
+		else{
+			fail("unknown control type: ", words[0]);
+		}
+		copyText(r.name, PANEL_NAME_LEN, words[1]);
+		r.x = toInt(words[2], 0, 100);
+		r.y = toInt(words[3], 0, 100);
+		r.w = toInt(words[4], 0, 100);
+		r.h = toInt(words[5], 0, 100);
+		r.fgColor = toColor(words[6]);
+		r.bgColor = toColor(words[7]);
+
+		for(i = 8; i < words.size(); i++){
+			size_t eq = words[i].find('=');
+			std::string key, val;
+
+			if(eq == std::string::npos){
+				fail("expected key=value: ", words[i]);
+			}
+			key = words[i].substr(0, eq);
+			val = words[i].substr(eq+1);
+
+			if(key == "text"){
+				copyText(r.text, PANEL_TEXT_LEN, val);
+			}
+			else if(key == "page"){
+				r.page = toInt(val, 0, 255);
+			}
+			else if(key == "slot"){
+				r.slot = toInt(val, 0, MAX_SLOTS[kind]-1);
+				slotGiven = true;
+			}
+			else if(key == "action" && kind != 2){
+				copyText(r.action, PANEL_ACTION_LEN, val);
+			}
+			else if((key == "hold" && kind == 0) || (key == "pinch" && kind == 1)){
+				copyText(r.action2, PANEL_ACTION_LEN, val);
+			}
+			else if(key == "mode" && kind == 1){
+				if(val == "HORIZONTAL") r.mode = 0;
+				else if(val == "VERTICAL") r.mode = 1;
+				else if(val == "TRACKPAD") r.mode = 2;
+				else fail("unknown slider mode: ", val);
+			}
+			else if(key == "x" && kind == 1){
+				toPair(val, r.minX, r.maxX);
+			}
+			else if(key == "y" && kind == 1){
+				toPair(val, r.minY, r.maxY);
+			}
+			else if(key == "pos" && kind == 1){
+				toPair(val, r.posX, r.posY);
+			}
+			else{
+				fail("option not allowed here: ", key);
+			}
+		}
+
+		if(!slotGiven){
+			if(nextSlot[kind] >= MAX_SLOTS[kind]){
+				fail("too many controls of type ", words[0]);
+			}
+			r.slot = nextSlot[kind];
+		}
+		nextSlot[kind] = r.slot + 1;
+		records.push_back(r);
+	}
+	fclose(in);
+
+	header.magic = PANEL_MAGIC;
+	header.version = PANEL_VERSION;
+	header.count = (uint16_t)records.size();
+
+	out = fopen(argv[2], "wb");
+	if(out == NULL){
+		perror(argv[2]);
+		return 1;
+	}
+	if(fwrite(&header, sizeof(header), 1, out) != 1 ||
+	   (!records.empty() && fwrite(&records[0], sizeof(PanelRecord), records.size(), out) != records.size())){
+		perror(argv[2]);
+		fclose(out);
+		return 1;
+	}
+	fclose(out);
+	printf("%s: %d controls, %d bytes\n", argv[2], (int)records.size(),
+	       (int)(sizeof(header) + records.size()*sizeof(PanelRecord)));
+	return 0;
+}
@@ -0,0 +1,179 @@
+/**
+
+@file
+
+powersim - runs the GigaDAQ PowerManager in a simulated sketch and reports how much of the time the
+processor could sleep, how late the timers ran and how quickly a touch was noticed.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. powersim
+
+Usage:
+
+    powersim [hours] [touches_per_hour] [sample_ms] [work_us]
+
+hours is simulated time (default 2, which takes the microsecond counter past its wrap-around at
+71.6 minutes). Somebody uses the screen touches_per_hour times (default 20) for a few seconds each,
+with the touch screen reporting every 10 milliseconds. A sample is taken every sample_ms
+milliseconds (default 100) and each pass through loop() takes work_us microseconds (default 50).
+
+The sketch is the one in the README: a timer for samples, a timer for a clock display, and
+sleepIfIdle() at the end of loop(). A touch wakes the processor, as the touch interrupt does on the
+GIGA. The simulated sleep moves the clock forward instead of waiting, and the time really asleep is
+added up separately to check PowerManager::sleepFraction().
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "PowerManager.h"
+
+static uint64_t nextTouch;			//When the next touch report arrives
+static uint64_t sessionEnd;			//When the finger leaves the screen
+static bool touchWaiting;			//A report arrived and loop() has not handled it yet
+static uint64_t touchArrived;		//When that report arrived
+static double touchRate;			//Touch sessions per microsecond
+static uint64_t reallyAsleep;
+
+static double randomUniform(void){
+	return (rand() + 1.0) / (RAND_MAX + 2.0);
+}
+static void nextSession(uint64_t after){
+	nextTouch = after + (uint64_t)(-log(randomUniform()) / touchRate);
+	sessionEnd = nextTouch + 1000000 + rand() % 4000000;
+}
+//Moves the clock forward, stopping early if a touch report arrives
+static void advance(uint64_t us){
+	uint64_t until = simTime + us;
+
+	if(nextTouch <= until){
+		simTime = (nextTouch > simTime) ? nextTouch : simTime;
+		touchWaiting = true;
+		touchArrived = simTime;
+		if(nextTouch + 10000 < sessionEnd){
+			nextTouch += 10000;
+		}
+		else{
+			nextSession(sessionEnd);
+		}
+		return;
+	}
+	simTime = until;
+}
+static void simSleep(uint32_t us){
+	uint64_t start = simTime;
+
+	if(touchWaiting){		//The wake-up came before the sleep, which then returns at once, as with the event flags on the GIGA
+		return;
+	}
+	advance(us);
+	reallyAsleep += simTime - start;
+}
+
+static int backlightLevel = 100;
+static uint32_t dimChanges;
+static void simBacklight(int percent){
+	backlightLevel = percent;
+	dimChanges++;
+}
+
+int main(int argc, char **argv){
+	double hours = (argc > 1) ? atof(argv[1]) : 2;
+	double touchesPerHour = (argc > 2) ? atof(argv[2]) : 20;
+	uint32_t sampleMs = (argc > 3) ? atoi(argv[3]) : 100;
+	uint32_t workUs = (argc > 4) ? atoi(argv[4]) : 50;
+	uint64_t end = (uint64_t)(hours * 3600e6);
+	uint64_t expected[2] = {0, 0}, late, maxLate[2] = {0, 0}, wakeDelay, maxWake = 0, sumWake = 0;
+	uint64_t dimmedSince = 0, dimmedTime = 0;
+	uint32_t runs[2] = {0, 0}, touches = 0, passes = 0;
+	uint64_t lastTouch = 0;
+	bool touching = false;
+	PowerManager power;
+	int timer[2], i;
+
+	simReadTime = 0;		//The loop and the simulated sleep move the clock
+	srand(1);
+	touchRate = touchesPerHour / 3600e6;
+	nextSession(0);
+	power.sleep = simSleep;
+	power.backlight = simBacklight;
+	power.dimTimeout = 30000;
+	timer[0] = power.addTimer(sampleMs);
+	timer[1] = power.addTimer(1000);		//Clock display
+	expected[0] = expected[1] = simTime;
+
+	while(simTime < end){
+		passes++;
+		if(touchWaiting){						//handleInputs()
+			touchWaiting = false;
+			touches++;
+			wakeDelay = simTime - touchArrived;
+			sumWake += wakeDelay;
+			if(wakeDelay > maxWake) maxWake = wakeDelay;
+			lastTouch = simTime;
+			power.activity();
+		}
+		touching = simTime - lastTouch < 80000;		//Until the release timeout, GigaDAQ stays awake
+		for(i = 0; i < 2; i++){
+			if(power.due(timer[i])){
+				late = simTime - expected[i];
+				if(late > maxLate[i]) maxLate[i] = late;
+				runs[i]++;
+				expected[i] += (uint64_t)((i == 0) ? sampleMs : 1000) * 1000;
+				if(expected[i] < simTime) expected[i] = simTime;
+				advance((i == 0) ? 300 : 2000);		//Taking a sample, redrawing the clock
+			}
+		}
+		advance(workUs);
+		if(!touching){							//sleepIfIdle()
+			power.idle();
+		}
+		if(power.dimmed && backlightLevel != 100 && dimmedSince == 0){
+			dimmedSince = simTime;
+		}
+		if(!power.dimmed && dimmedSince != 0){
+			dimmedTime += simTime - dimmedSince;
+			dimmedSince = 0;
+		}
+	}
+	if(dimmedSince != 0){
+		dimmedTime += simTime - dimmedSince;
+	}
+
+	printf("Simulated %.2f hours, %u passes through loop()\n", simTime / 3600e6, passes);
+	printf("Asleep:            %.1f%% (PowerManager says %.1f%%), %u sleeps\n",
+		100.0 * reallyAsleep / simTime, 100.0 * power.sleepFraction(), power.sleeps);
+	printf("Sample timer:      %u runs, %u expected, latest %.3f ms\n",
+		runs[0], (unsigned)(simTime / (sampleMs * 1000ULL)) + 1, maxLate[0] / 1000.0);
+	printf("Clock timer:       %u runs, latest %.3f ms\n", runs[1], maxLate[1] / 1000.0);
+	printf("Touch reports:     %u, noticed after %.3f ms on average, %.3f ms at most\n",
+		touches, touches ? sumWake / 1000.0 / touches : 0.0, maxWake / 1000.0);
+	printf("Backlight dimmed:  %.1f%% of the time, %u changes\n", 100.0 * dimmedTime / simTime, dimChanges);
+	return 0;
+}
@@ -0,0 +1,95 @@
+/**
+
+@file
+
+A simulated sensor bus for trying the GigaDAQ SensorBus on a desktop computer. Transactions take a
+set time (a fixed latency plus a time per byte, with some random jitter) measured on a simulated
+clock, and a chosen share of them fail, so the scheduler can be run for hours of bus time in a
+fraction of a second. See busbench.cpp.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _SIMULATED_BUS_INCLUDE_
+#define _SIMULATED_BUS_INCLUDE_
+
+#include <stdlib.h>
+#include "SensorBus.h"
+
+/**
+@brief A BusPort whose transfers finish after a simulated delay. The received bytes count up from the
+register address, so a RegisterSensor reads a predictable value.
+*/
+class SimulatedBusPort : public BusPort {
+public:
+	uint64_t now;			///< Simulated time in microseconds. The caller moves it forward.
+	uint32_t latency;		///< Microseconds every transaction takes, such as the start and address bytes of I2C
+	double perByte;			///< Microseconds per byte sent or received (22.5 for I2C at 400 kHz)
+	uint32_t jitter;		///< Largest random extra time per transaction, in microseconds
+	double errorRate;		///< Share of transactions that fail, from 0 to 1
+	uint32_t transactions;	///< Transactions started
+	uint64_t busyTime;		///< Microseconds spent on transfers
+
+	SimulatedBusPort(uint32_t latency, double perByte, uint32_t jitter = 0, double errorRate = 0){
+		now = 0;
+		this->latency = latency;
+		this->perByte = perByte;
+		this->jitter = jitter;
+		this->errorRate = errorRate;
+		transactions = 0;
+		busyTime = 0;
+		doneAt = 0;
+		failed = false;
+	}
+	bool start(BusTransaction &t) override {
+		uint32_t length;
+		int i;
+
+		length = latency + (uint32_t)(perByte * (t.txLen + t.rxLen));
+		if(jitter > 0){
+			length += rand() % (jitter + 1);
+		}
+		for(i = 0; i < t.rxLen; i++){
+			t.rx[i] = (uint8_t)(t.tx[0] + i);
+		}
+		doneAt = now + length;
+		busyTime += length;
+		transactions++;
+		failed = errorRate > 0 && rand() < errorRate * RAND_MAX;
+		return true;
+	}
+	BusStatus status(void) override {
+		if(now < doneAt){
+			return BUS_BUSY;
+		}
+		return failed ? BUS_ERROR : BUS_DONE;
+	}
+private:
+	uint64_t doneAt;
+	bool failed;
+};
+
+#endif /* _SIMULATED_BUS_INCLUDE_ */
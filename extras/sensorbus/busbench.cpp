@@ -0,0 +1,138 @@
+/**
+
+@file
+
+busbench - runs the GigaDAQ SensorBus scheduler on a simulated bus and reports how well each device
+kept to its rate, how late readings were, and how busy the bus was.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. busbench
+
+Usage:
+
+    busbench [seconds] [loop_us] [latency_us] [us_per_byte] [error_percent]
+
+seconds is simulated time (default 60). loop_us is how long each pass through loop() takes apart from
+the bus (default 200), latency_us and us_per_byte set the length of a transaction (default 50 and
+22.5, like I2C at 400 kHz) and error_percent is the share of transactions that fail (default 0).
+
+The devices are a mix of fast and slow sensors: see makeDevices(). Fairness is Jain's index of the
+share of its requested readings that each device got, 1.0 when every device is served equally well.
+The blocking column is how long loop() would have waited for the bus each second if every transaction
+waited until it was done, as with Wire.
+
+Simulated time starts in 2025, as the time stamps from GigaDAQ::clock do. The first reading of each
+device is checked: it may not have skipped readings it had no chance to make, and its delay may not be
+longer than the bus has been running. PASSED is printed if every device passes, otherwise FAILED, and
+the exit status is 1.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "SensorBus.h"
+#include "SimulatedBus.h"
+
+const uint64_t START = 1750000000ULL * 1000000;		//Microseconds since 1970, as from GigaDAQ::clock
+
+struct BenchDevice {
+	const char *name;
+	RegisterSensor *sensor;
+	uint32_t interval;
+};
+
+static int makeDevices(BenchDevice *d){
+	static RegisterSensor imu(0x68, 0x3B, 7, 1.0f / 16384);		//Acceleration, temperature and rotation
+	static RegisterSensor current(0x40, 0x01, 2, 0.001f);		//Shunt and bus voltage
+	static RegisterSensor adc(0x48, 0x00, 1, 0.000125f);		//Converts on command
+	static RegisterSensor pressure(0x77, 0xF7, 3, 1.0f);
+	static RegisterSensor temperature(0x49, 0x00, 1, 0.0625f / 16);
+	int n = 0;
+
+	adc.setTrigger(0x01, 0xC3, 1200);
+	d[n++] = {"imu 1 kHz", &imu, 1000};
+	d[n++] = {"current 200 Hz", &current, 5000};
+	d[n++] = {"adc 100 Hz", &adc, 10000};
+	d[n++] = {"pressure 50 Hz", &pressure, 20000};
+	d[n++] = {"temp 10 Hz", &temperature, 100000};
+	return n;
+}
+
+int main(int argc, char *argv[]){
+	double seconds = (argc > 1) ? atof(argv[1]) : 60;
+	uint32_t loopTime = (argc > 2) ? atoi(argv[2]) : 200;
+	uint32_t latency = (argc > 3) ? atoi(argv[3]) : 50;
+	double perByte = (argc > 4) ? atof(argv[4]) : 22.5;
+	double errors = (argc > 5) ? atof(argv[5]) / 100 : 0;
+	BenchDevice dev[NUM_SENSORS];
+	SimulatedBusPort port(latency, perByte, latency / 2, errors);
+	SensorBus bus;
+	uint64_t end, samples = 0;
+	double share, sum = 0, sumSquares = 0;
+	int i, n, failures = 0;
+
+	srand(1);
+	bus.begin(port);
+	n = makeDevices(dev);
+	for(i = 0; i < n; i++){
+		bus.addDevice(dev[i].sensor, dev[i].interval);
+	}
+
+	port.now = START;
+	end = START + (uint64_t)(seconds * 1e6);
+	while(port.now < end){
+		if(bus.service(port.now)){
+			samples++;		//GigaDAQ::serviceSensors() would record the row here
+			SensorSlot &s = bus.slot[bus.sampleSlot];
+			if(s.readings == 1 && (s.late > (port.now - START) / s.interval || s.maxDelay > port.now - START)){
+				printf("%s: first reading %.2f ms after starting with %u late and a delay of %u us\n",
+				       dev[bus.sampleSlot].name, (port.now - START) / 1000.0, s.late, s.maxDelay);
+				failures++;
+			}
+		}
+		port.now += loopTime / 2 + rand() % (loopTime + 1);
+	}
+
+	printf("%-16s %9s %9s %8s %6s %6s %10s\n", "device", "requested", "readings", "share", "late", "errors", "max delay");
+	for(i = 0; i < n; i++){
+		SensorSlot &s = bus.slot[i];
+		double requested = seconds * 1e6 / dev[i].interval;
+		share = s.readings / requested;
+		sum += share;
+		sumSquares += share * share;
+		printf("%-16s %9.0f %9u %7.1f%% %6u %6u %7.2f ms\n", dev[i].name, requested, s.readings,
+		       100 * share, s.late, s.errors, s.maxDelay / 1000.0);
+	}
+	printf("\nsamples recorded: %llu (%.0f per second)\n", (unsigned long long)samples, samples / seconds);
+	printf("transactions:     %u (%.0f per second)\n", port.transactions, port.transactions / seconds);
+	printf("bus utilization:  %.1f%%\n", 100 * bus.utilization(port.now));
+	printf("blocking:         %.0f ms of every second\n", port.busyTime / seconds / 1000);
+	printf("fairness:         %.3f\n", sum * sum / (n * sumSquares));
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
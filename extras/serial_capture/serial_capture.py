@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+"""
+serial_capture.py - records the USB serial stream of a GigaDAQ SerialStreamSink.
+
+Usage:
+    python3 serial_capture.py /dev/ttyACM0 [--out data.csv] [--seconds 0]
+    python3 serial_capture.py --simulate [--rate 2000] [--channels 4] [--seconds 5]
+    python3 serial_capture.py --simulate --driver ./streampty [--out /dev/null]
+
+Every sample is written as a line of comma-separated values (time in seconds first),
+the same as the data files GigaDAQ writes to the flash drive. Once a second a status
+line reports frames, samples, bytes per second, bad frames (failed CRC) and lost
+frames (gaps in the sequence numbers) on stderr.
+
+Frames are COBS-encoded and end with a zero byte. Inside is the 20-byte header
+(version, channels, count, seq, dropped, 64-bit start time in microseconds), the
+samples (uint32 microseconds after the start time, followed by float values) and a
+CRC-32 of everything before it, all little-endian.
+
+--simulate opens a pseudo-terminal pair, writes frames into one end the same way a
+GIGA would and captures them from the other end, so the whole path can be tried on
+Linux without a GIGA.
+
+With --driver, the frames are written by that program instead, such as streampty.cpp,
+which runs the library's SerialStreamSink on this computer. It is given the name of the
+writing end and must print "samples N" with the number of samples it sent. The capture
+then prints PASSED if no frame was damaged or missing and every sample arrived or was
+counted as dropped, otherwise FAILED, and exits with status 1.
+
+Written by David A. Trevas. MIT License, Copyright (c) 2025 David A. Trevas.
+See the LICENSE file of the GigaDAQ library.
+"""
+
+import argparse
+import math
+import os
+import select
+import struct
+import subprocess
+import sys
+import termios
+import threading
+import time
+import tty
+import zlib
+
+VERSION = 2                 # must match SERIAL_STREAM_VERSION in SerialStream.h
+HEADER = struct.Struct("<BBHIIII")
+FRAME_BYTES = 512
+
+
+def cobs_encode(data):
+    out = bytearray()
+    block = bytearray()
+    for b in data:
+        if b == 0:
+            out.append(len(block) + 1)
+            out += block
+            block = bytearray()
+        else:
+            block.append(b)
+            if len(block) == 254:
+                out.append(255)
+                out += block
+                block = bytearray()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+def cobs_decode(data):
+    """Returns the decoded bytes, or None if the encoding is broken."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 255 and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def encode_frame(seq, dropped, channels, samples):
+    sample = struct.Struct("<I%df" % channels)
+    base = samples[0][0]
+    body = HEADER.pack(VERSION, channels, len(samples), seq, dropped, base & 0xFFFFFFFF, base >> 32)
+    body += b"".join(sample.pack(s[0] - base, *s[1:]) for s in samples)
+    return cobs_encode(body + struct.pack("<I", zlib.crc32(body))) + b"\0"
+
+
+def decode_frame(encoded):
+    """Returns (seq, dropped, channels, samples) or None if the frame is damaged.
+    Each sample is a tuple of the time stamp in microseconds followed by the values."""
+    frame = cobs_decode(encoded)
+    if frame is None or len(frame) < HEADER.size + 4:
+        return None
+    body, crc = frame[:-4], struct.unpack("<I", frame[-4:])[0]
+    if zlib.crc32(body) != crc:
+        return None
+    version, channels, count, seq, dropped, time_low, time_high = HEADER.unpack_from(body)
+    if version != VERSION or channels == 0:
+        return None
+    sample = struct.Struct("<I%df" % channels)
+    if len(body) != HEADER.size + count * sample.size:
+        return None
+    base = (time_high << 32) | time_low
+    samples = []
+    for i in range(count):
+        row = sample.unpack_from(body, HEADER.size + i * sample.size)
+        samples.append((base + row[0],) + row[1:])
+    return seq, dropped, channels, samples
+
+
+def open_port(name):
+    fd = os.open(name, os.O_RDONLY | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    attrs[6][termios.VMIN] = 0          # reads return after at most 0.2 s
+    attrs[6][termios.VTIME] = 2
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+def simulate(fd, rate, channels, seconds):
+    """Writes a sine wave on every channel at the given sample rate, like a GIGA would."""
+    per_frame = (FRAME_BYTES - HEADER.size) // (4 + 4 * channels)
+    seq = 0
+    n = 0
+    start = time.monotonic()
+    base = int(time.time() * 1000000)
+    while time.monotonic() - start < seconds:
+        samples = []
+        for _ in range(per_frame):
+            samples.append([base + n * 1000000 // rate] + [math.sin(2 * math.pi * (c + 1) * n / rate) for c in range(channels)])
+            n += 1
+        os.write(fd, encode_frame(seq, 0, channels, samples))
+        seq += 1
+        time.sleep(max(0.0, start + n / rate - time.monotonic()))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port", nargs="?", help="serial port of the GIGA, such as /dev/ttyACM0")
+    parser.add_argument("--out", default="-", help="CSV file to write, - for standard output")
+    parser.add_argument("--simulate", action="store_true", help="capture test frames through a pseudo-terminal")
+    parser.add_argument("--rate", type=int, default=2000, help="simulated samples per second")
+    parser.add_argument("--channels", type=int, default=4, help="simulated values per sample")
+    parser.add_argument("--seconds", type=float, default=0, help="stop after this long (0 runs until Ctrl-C); default 5 when simulating")
+    parser.add_argument("--driver", help="with --simulate, program that writes the frames, given the name of the pseudo-terminal")
+    args = parser.parse_args()
+
+    driver = None
+    if args.simulate and args.driver:
+        import pty
+        reader, writer = pty.openpty()
+        tty.setraw(writer)
+        tty.setraw(reader)
+        fd = reader
+        driver = subprocess.Popen([args.driver, os.ttyname(writer)], stdout=subprocess.PIPE, text=True)
+        sender = None
+    elif args.simulate:
+        import pty
+        writer, reader = pty.openpty()
+        tty.setraw(writer)
+        fd = open_port(os.ttyname(reader))
+        os.close(reader)
+        seconds = args.seconds or 5.0
+        sender = threading.Thread(target=simulate, args=(writer, args.rate, args.channels, seconds), daemon=True)
+        sender.start()
+    elif args.port:
+        fd = open_port(args.port)
+        sender = None
+    else:
+        parser.error("give a serial port or --simulate")
+
+    out = sys.stdout if args.out == "-" else open(args.out, "w")
+    pending = bytearray()
+    expected = None
+    frames = samples = bad = lost = dropped = total_bytes = 0
+    window_bytes = 0
+    start = window_start = time.monotonic()
+    synced = False
+    try:
+        while True:
+            now = time.monotonic()
+            if sender is None and args.seconds and now - start >= args.seconds:
+                break
+            if driver is not None and not select.select([fd], [], [], 0.2)[0]:
+                if driver.poll() is not None:
+                    break               # The driver is done and everything it wrote has been read
+                continue
+            try:
+                chunk = os.read(fd, 65536)
+            except OSError:
+                break
+            if not chunk and sender is not None and not sender.is_alive():
+                break
+            total_bytes += len(chunk)
+            window_bytes += len(chunk)
+            pending += chunk
+            while True:
+                end = pending.find(b"\0")
+                if end < 0:
+                    break
+                encoded = bytes(pending[:end])
+                del pending[:end + 1]
+                if not synced:          # the first piece may be the tail of a frame
+                    synced = True
+                    if decode_frame(encoded) is None:
+                        continue
+                if not encoded:
+                    continue
+                frame = decode_frame(encoded)
+                if frame is None:
+                    bad += 1
+                    continue
+                seq, dropped, _, rows = frame
+                if expected is not None and seq != expected:
+                    lost += (seq - expected) & 0xFFFFFFFF
+                expected = (seq + 1) & 0xFFFFFFFF
+                for row in rows:
+                    out.write("%d.%06d, %s\n" % (row[0] // 1000000, row[0] % 1000000, ", ".join("%g" % v for v in row[1:])))
+                frames += 1
+                samples += len(rows)
+            if now - window_start >= 1.0:
+                print("frames %d  samples %d  %.1f kB/s  bad frames %d  lost frames %d  dropped on GIGA %d"
+                      % (frames, samples, window_bytes / (now - window_start) / 1000.0, bad, lost, dropped),
+                      file=sys.stderr)
+                window_bytes = 0
+                window_start = now
+    except KeyboardInterrupt:
+        pass
+    finally:
+        os.close(fd)
+        if out is not sys.stdout:
+            out.close()
+    print("total: frames %d  samples %d  bytes %d  bad frames %d  lost frames %d"
+          % (frames, samples, total_bytes, bad, lost), file=sys.stderr)
+    if driver is not None:
+        os.close(writer)
+        report = driver.communicate()[0]
+        sent = None
+        for line in report.splitlines():
+            print("driver: " + line, file=sys.stderr)
+            if line.startswith("samples "):
+                sent = int(line.split()[1])
+        failed = driver.returncode != 0
+        if bad or lost:
+            print("Frames were damaged or missing", file=sys.stderr)
+            failed = True
+        if sent is None or samples + dropped != sent:
+            print("%s samples sent, %d received and %d dropped" % (sent, samples, dropped), file=sys.stderr)
+            failed = True
+        print("FAILED" if failed else "PASSED", file=sys.stderr)
+        sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,208 @@
+/**
+
+@file
+
+streampty - runs the GigaDAQ SerialStreamSink on a desktop computer and writes its frames into a
+pseudo-terminal, where serial_capture.py decodes them as it would from a GIGA.
+
+Build on Linux with the Makefile in extras:
+
+    make -C .. streampty
+
+Usage:
+
+    python3 serial_capture.py --simulate --driver ./streampty --out /dev/null
+
+serial_capture.py opens the pseudo-terminal pair and starts streampty with the name of one end,
+and streampty prints what it sent when it is done. It can also be run on its own with the name of
+a serial device, such as one end of a socat pair:
+
+    streampty device [rate [channels]]
+
+The sink gets rate samples per second (2000 unless changed) of channels values (4), at the times a
+sketch would take them, and service() is called between them as from loop(). The port only takes
+as many bytes as a 64-byte buffer has room for, and the buffer drains at a set speed, as the USB
+link does when the computer is busy:
+
+    0 to 2 s    100 kB/s, so a frame takes 5 ms to drain, and the samples of those 5 ms must go
+                into the next frame meanwhile (double buffering). Nothing may be dropped.
+    2 to 3 s    2 kB/s, a computer that stops reading, so samples must be dropped
+    3 to 5 s    100 kB/s again
+
+streampty checks that the sink never wrote more than availableForWrite() allowed and dropped
+samples only while the port was slow, and prints PASSED or FAILED. serial_capture.py checks that
+every frame arrived intact and in sequence, and that every sample arrived or was counted as dropped.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
+#include "SerialStream.h"
+
+//The library's millis() reads the simulated clock of extras/soak/host, which is kept with the real one here
+static uint64_t hostMicros(void){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	simTime = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	return simTime;
+}
+
+const int PORT_BUFFER = 64;		//Bytes the port takes before it has to send them
+
+/** A Stream that writes to a file descriptor, but only takes what a port buffer draining at bytesPerSecond has room for */
+class ThrottledPort : public Stream {
+public:
+	uint32_t bytesPerSecond;	//Speed the buffer drains at
+	uint32_t overruns;			//Writes of more than availableForWrite() allowed
+	uint64_t bytes;				//Bytes written
+
+	ThrottledPort(int fd){
+		this->fd = fd;
+		bytesPerSecond = 0;
+		overruns = 0;
+		bytes = 0;
+		queued = 0;
+		last = hostMicros();
+	}
+	int availableForWrite(void){
+		drain();
+		return PORT_BUFFER - (int)ceil(queued);
+	}
+	size_t write(const uint8_t *buf, size_t size){
+		size_t done = 0;
+		ssize_t n;
+
+		drain();
+		if(queued + size > PORT_BUFFER){
+			overruns++;
+		}
+		while(done < size){
+			n = ::write(fd, buf + done, size - done);
+			if(n <= 0){
+				break;
+			}
+			done += n;
+		}
+		queued += done;
+		bytes += done;
+		return done;
+	}
+	size_t write(uint8_t c){
+		return write(&c, 1);
+	}
+	//Nothing is received
+	int available(void){ return 0; }
+	int read(void){ return -1; }
+	int peek(void){ return -1; }
+private:
+	int fd;
+	double queued;		//Bytes in the port buffer
+	uint64_t last;
+	void drain(void){
+		uint64_t now = hostMicros();
+
+		queued -= (now - last) * 1e-6 * bytesPerSecond;
+		if(queued < 0){
+			queued = 0;
+		}
+		last = now;
+	}
+};
+
+int main(int argc, char **argv){
+	int rate = (argc > 2) ? atoi(argv[2]) : 2000;
+	int channels = (argc > 3) ? atoi(argv[3]) : 4;
+	const uint64_t END = 5000000, SLOW_START = 2000000, SLOW_END = 3000000;
+	SerialStreamSink stream;
+	float values[SERIAL_MAX_CHANNELS];
+	uint64_t start, now, n = 0, epoch;
+	uint32_t droppedFast = 0, droppedSlow = 0;
+	int fd, c, failures = 0;
+
+	if(argc < 2 || rate <= 0 || channels <= 0 || channels > SERIAL_MAX_CHANNELS){
+		printf("Usage: streampty device [rate [channels]]\n");
+		return 1;
+	}
+	fd = open(argv[1], O_WRONLY | O_NOCTTY);
+	if(fd < 0){
+		printf("Cannot open %s\n", argv[1]);
+		return 1;
+	}
+	simReadTime = 0;
+	ThrottledPort port(fd);
+	stream.begin(port);
+	epoch = 1750000000ULL * 1000000;		//Time stamps count from 1970, as from GigaDAQ::clock
+	start = hostMicros();
+
+	while((now = hostMicros() - start) < END){
+		port.bytesPerSecond = (now >= SLOW_START && now < SLOW_END) ? 2000 : 100000;
+		while(n * 1000000 / rate <= now){
+			for(c = 0; c < channels; c++){
+				values[c] = sinf(2 * M_PI * (c + 1) * n / rate);
+			}
+			stream.write(epoch + n * 1000000 / rate, values, channels);
+			n++;
+		}
+		stream.service();
+		if(now < SLOW_START){
+			droppedFast = stream.samplesDropped;
+		}
+		else if(now < SLOW_END){
+			droppedSlow = stream.samplesDropped - droppedFast;
+		}
+		usleep(50);
+	}
+	start = hostMicros();
+	while(hostMicros() - start < 500000){		//The last frame goes out after maxLatency
+		stream.service();
+		usleep(50);
+	}
+	close(fd);
+
+	printf("%llu samples, %lu frames, %llu bytes, %lu samples dropped (%lu while slow)\n", (unsigned long long)n,
+	       (unsigned long)stream.framesSent, (unsigned long long)port.bytes, (unsigned long)stream.samplesDropped,
+	       (unsigned long)droppedSlow);
+	if(port.overruns > 0){
+		printf("The sink wrote more than availableForWrite() %lu times\n", (unsigned long)port.overruns);
+		failures++;
+	}
+	if(droppedFast > 0){
+		printf("Samples were dropped although the port kept up\n");
+		failures++;
+	}
+	if(droppedSlow == 0){
+		printf("Nothing was dropped while the port was slow\n");
+		failures++;
+	}
+	printf("samples %llu\n", (unsigned long long)n);
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
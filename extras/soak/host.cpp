@@ -0,0 +1,80 @@
+/**
+
+@file
+
+The parts of the stand-in libraries in extras/soak/host that are not in their headers.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "Arduino.h"
+#include "SDRAM.h"
+#include "Arduino_GigaDisplayTouch.h"
+#include "Fonts/FreeMonoBold9pt7b.h"
+#include "Fonts/FreeMonoBold12pt7b.h"
+#include "Fonts/FreeMonoBold18pt7b.h"
+#include "Fonts/FreeMonoBold24pt7b.h"
+
+#undef fopen
+
+uint64_t simTime;
+uint32_t simReadTime = 1;
+const char *simUsbFolder = ".";
+SimSerial Serial;
+SDRAMClass SDRAM;
+GDTpoint_t simTouch[5];
+uint8_t simContacts;
+void (*simTouchCallback)(uint8_t contacts, GDTpoint_t *points);
+
+//Cell sizes of the real fonts, as used by maxFont()
+const GFXfont FreeMonoBold9pt7b = {11, 15};
+const GFXfont FreeMonoBold12pt7b = {14, 20};
+const GFXfont FreeMonoBold18pt7b = {21, 30};
+const GFXfont FreeMonoBold24pt7b = {28, 40};
+
+void *SDRAMClass::malloc(size_t n){
+	const size_t SIZE = 8*1024*1024;
+	static uint8_t memory[SIZE] __attribute__((aligned(32)));
+	void *p;
+
+	n = (n + 31) & ~(size_t)31;
+	if(top + n > SIZE){
+		return nullptr;
+	}
+	p = memory + top;
+	top += n;
+	return p;
+}
+
+FILE *simFopen(const char *path, const char *mode){
+	char name[512];
+
+	if(strncmp(path, "/usb/", 5) == 0){
+		snprintf(name, sizeof(name), "%s/%s", simUsbFolder, path + 5);
+		path = name;
+	}
+	return fopen(path, mode);
+}
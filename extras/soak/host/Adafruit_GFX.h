@@ -0,0 +1,160 @@
+/**
+
+@file
+
+Stand-in for the Adafruit GFX library for the soak test (see extras/soak). Canvases really hold
+their pixels and rectangles are really filled, so drawing costs about what it does on the GIGA.
+Each character is drawn as a filled cell instead of a glyph.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _SOAK_ADAFRUIT_GFX_INCLUDE_
+#define _SOAK_ADAFRUIT_GFX_INCLUDE_
+
+#include "Arduino.h"
+
+struct GFXfont {
+	uint8_t width, height;		//Size of a character cell in pixels
+};
+
+class Adafruit_GFX : public Print {
+public:
+	Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+	virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+	virtual void startWrite(void) {}
+	virtual void endWrite(void) {}
+	virtual void setRotation(uint8_t r){
+		rotation = r & 3;
+		_width = (rotation & 1) ? HEIGHT : WIDTH;
+		_height = (rotation & 1) ? WIDTH : HEIGHT;
+	}
+	virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+		int16_t i, j;
+		for(j = y; j < y + h; j++) for(i = x; i < x + w; i++) drawPixel(i, j, color);
+	}
+	virtual void fillScreen(uint16_t color){ fillRect(0, 0, _width, _height, color); }
+	virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color){ fillRect(x, y, w, 1, color); }
+	virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color){ fillRect(x, y, 1, h, color); }
+	void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+		drawFastHLine(x, y, w, color);
+		drawFastHLine(x, y + h - 1, w, color);
+		drawFastVLine(x, y, h, color);
+		drawFastVLine(x + w - 1, y, h, color);
+	}
+	void setTextWrap(bool w){ wrap = w; }
+	void setTextColor(uint16_t c){ textColor = c; }
+	void setFont(const GFXfont *f){ font = f; }
+	void setCursor(int16_t x, int16_t y){ cursorX = x; cursorY = y; }
+	size_t write(uint8_t c){		//Pixel by pixel like the real fonts, in a pattern that differs from one character to the next
+		uint8_t w = font ? font->width : 6, h = font ? font->height : 8;
+		int16_t i, j;
+		for(j = 0; j < h; j++) for(i = 0; i < w - 1; i++) if((c + i * 3 + j * 5) % 7 < 3) drawPixel(cursorX + i, cursorY - h + j, textColor);
+		cursorX += w;
+		return 1;
+	}
+	using Print::write;
+	int16_t width(void) const { return _width; }
+	int16_t height(void) const { return _height; }
+	uint8_t getRotation(void) const { return rotation; }
+protected:
+	int16_t WIDTH, HEIGHT, _width, _height;
+	uint8_t rotation = 0;
+	int16_t cursorX = 0, cursorY = 0;
+	uint16_t textColor = 0xFFFF;
+	bool wrap = true;
+	const GFXfont *font = nullptr;
+};
+
+class GFXcanvas16 : public Adafruit_GFX {
+public:
+	GFXcanvas16(uint16_t w, uint16_t h, bool allocate_buffer = true) : Adafruit_GFX(w, h){
+		buffer = nullptr;
+		buffer_owned = allocate_buffer;
+		if(allocate_buffer && (buffer = (uint16_t *)malloc((size_t)w * h * 2)) != nullptr){
+			memset(buffer, 0, (size_t)w * h * 2);
+		}
+	}
+	~GFXcanvas16(){ if(buffer && buffer_owned) free(buffer); }
+	void drawPixel(int16_t x, int16_t y, uint16_t color){
+		int16_t t;
+		if(buffer == nullptr || x < 0 || y < 0 || x >= _width || y >= _height) return;
+		switch(rotation){
+			case 1: t = x; x = WIDTH - 1 - y; y = t; break;
+			case 2: x = WIDTH - 1 - x; y = HEIGHT - 1 - y; break;
+			case 3: t = x; x = y; y = HEIGHT - 1 - t; break;
+		}
+		buffer[y * WIDTH + x] = color;
+	}
+	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+		int16_t i, j;
+		if(x < 0){ w += x; x = 0; }
+		if(y < 0){ h += y; y = 0; }
+		if(x + w > _width) w = _width - x;
+		if(y + h > _height) h = _height - y;
+		for(j = y; j < y + h; j++) for(i = x; i < x + w; i++) drawPixel(i, j, color);
+	}
+	uint16_t *getBuffer(void) const { return buffer; }
+protected:
+	uint16_t *buffer;
+	bool buffer_owned;
+};
+
+class GFXcanvas8 : public Adafruit_GFX {
+public:
+	GFXcanvas8(uint16_t w, uint16_t h, bool allocate_buffer = true) : Adafruit_GFX(w, h){
+		buffer = nullptr;
+		buffer_owned = allocate_buffer;
+		if(allocate_buffer && (buffer = (uint8_t *)malloc((size_t)w * h)) != nullptr){
+			memset(buffer, 0, (size_t)w * h);
+		}
+	}
+	~GFXcanvas8(){ if(buffer && buffer_owned) free(buffer); }
+	void drawPixel(int16_t x, int16_t y, uint16_t color){
+		int16_t t;
+		if(buffer == nullptr || x < 0 || y < 0 || x >= _width || y >= _height) return;
+		switch(rotation){
+			case 1: t = x; x = WIDTH - 1 - y; y = t; break;
+			case 2: x = WIDTH - 1 - x; y = HEIGHT - 1 - y; break;
+			case 3: t = x; x = y; y = HEIGHT - 1 - t; break;
+		}
+		buffer[y * WIDTH + x] = (uint8_t)color;
+	}
+	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+		int16_t i, j;
+		if(x < 0){ w += x; x = 0; }
+		if(y < 0){ h += y; y = 0; }
+		if(x + w > _width) w = _width - x;
+		if(y + h > _height) h = _height - y;
+		for(j = y; j < y + h; j++) for(i = x; i < x + w; i++) drawPixel(i, j, color);
+	}
+	uint8_t *getBuffer(void) const { return buffer; }
+protected:
+	uint8_t *buffer;
+	bool buffer_owned;
+};
+
+#endif /* _SOAK_ADAFRUIT_GFX_INCLUDE_ */
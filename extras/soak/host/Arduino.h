@@ -0,0 +1,178 @@
+/**
+
+@file
+
+Stand-in for Arduino.h, so that the GigaDAQ library itself can be built and run on a desktop
+computer for the soak test (see extras/soak) and the other programs in extras. Time is simulated:
+micros() and millis() read simTime, which the test moves forward, and every read of the clock moves
+it on by simReadTime microseconds (1 unless changed) so that loops that wait for the clock still end.
+Programs that move the clock exactly themselves set simReadTime to 0. String behaves like the Arduino String, taking a buffer of
+exactly the right size from the heap whenever it grows, so that it churns the heap the same way.
+
+Files under /usb/ are kept in the folder given by simUsbFolder instead.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _SOAK_ARDUINO_INCLUDE_
+#define _SOAK_ARDUINO_INCLUDE_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+typedef bool boolean;
+typedef int PinName;
+
+extern uint64_t simTime;			//Simulated microseconds since power-up
+extern uint32_t simReadTime;		//Microseconds that reading the clock moves it on
+extern const char *simUsbFolder;	//Folder that stands in for the flash drive
+
+inline unsigned long micros(void){ uint64_t t = simTime; simTime += simReadTime; return (uint32_t)t; }
+inline unsigned long millis(void){ uint64_t t = simTime; simTime += simReadTime; return (uint32_t)(t / 1000); }
+inline void delay(unsigned long ms){ simTime += (uint64_t)ms * 1000; }
+inline void delayMicroseconds(unsigned int us){ simTime += us; }
+inline void yield(void){}
+inline void set_time(time_t){}
+inline void pinMode(int, int){}
+inline void digitalWrite(int, int){}
+inline uint32_t __get_PRIMASK(void){ return 0; }
+inline void __set_PRIMASK(uint32_t){}
+inline void __disable_irq(void){}
+inline void __enable_irq(void){}
+
+#define OUTPUT 1
+#define HIGH 1
+#define LOW 0
+#define PROGMEM
+
+template<class T, class L> auto min(const T &a, const L &b) -> decltype((b < a) ? b : a) { return (b < a) ? b : a; }
+template<class T, class L> auto max(const T &a, const L &b) -> decltype((b < a) ? b : a) { return (a < b) ? b : a; }
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+FILE *simFopen(const char *path, const char *mode);
+#define fopen simFopen
+
+class String {
+public:
+	String(const char *s = ""){ init(); copy(s ? s : "", s ? strlen(s) : 0); }
+	String(const String &s){ init(); copy(s.buf ? s.buf : "", s.len); }
+	String(int v){ char b[16]; snprintf(b, sizeof(b), "%d", v); init(); copy(b, strlen(b)); }
+	String(unsigned int v){ char b[16]; snprintf(b, sizeof(b), "%u", v); init(); copy(b, strlen(b)); }
+	String(long v){ char b[24]; snprintf(b, sizeof(b), "%ld", v); init(); copy(b, strlen(b)); }
+	String(unsigned long v){ char b[24]; snprintf(b, sizeof(b), "%lu", v); init(); copy(b, strlen(b)); }
+	String(float v, unsigned char d = 2){ char b[40]; snprintf(b, sizeof(b), "%.*f", d, v); init(); copy(b, strlen(b)); }
+	String(double v, unsigned char d = 2){ char b[40]; snprintf(b, sizeof(b), "%.*f", d, v); init(); copy(b, strlen(b)); }
+	~String(){ free(buf); }
+	String &operator=(const String &s){ if(this != &s) copy(s.buf ? s.buf : "", s.len); return *this; }
+	String &operator=(const char *s){ copy(s ? s : "", s ? strlen(s) : 0); return *this; }
+	String &operator+=(const String &s){ concat(s.buf ? s.buf : "", s.len); return *this; }
+	String &operator+=(const char *s){ concat(s, strlen(s)); return *this; }
+	unsigned int length(void) const { return len; }
+	const char *c_str(void) const { return buf ? buf : ""; }
+	bool equals(const String &s) const { return len == s.len && strcmp(c_str(), s.c_str()) == 0; }
+	bool equals(const char *s) const { return strcmp(c_str(), s) == 0; }
+	bool operator==(const String &s) const { return equals(s); }
+	bool operator!=(const String &s) const { return !equals(s); }
+	char operator[](unsigned int i) const { return i < len ? buf[i] : 0; }
+	bool reserve(unsigned int size){ return (buf && size <= cap) || grow(size); }
+private:
+	char *buf;
+	unsigned int cap, len;
+	void init(void){ buf = nullptr; cap = 0; len = 0; }
+	bool grow(unsigned int size){		//Exactly the size needed, as the Arduino String does
+		char *b = (char *)realloc(buf, size + 1);
+		if(b == nullptr) return false;
+		if(buf == nullptr) b[0] = 0;
+		buf = b;
+		cap = size;
+		return true;
+	}
+	void copy(const char *s, unsigned int n){
+		if(!reserve(n)){ free(buf); init(); return; }
+		len = n;
+		memmove(buf, s, n);
+		buf[n] = 0;
+	}
+	void concat(const char *s, unsigned int n){
+		if(!reserve(len + n)) return;
+		memmove(buf + len, s, n);
+		len += n;
+		buf[len] = 0;
+	}
+};
+inline String operator+(const String &a, const String &b){ String s(a); s += b; return s; }
+inline String operator+(const String &a, const char *b){ String s(a); s += b; return s; }
+
+class Print {
+public:
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t *b, size_t n){ size_t i; for(i = 0; i < n; i++) write(b[i]); return n; }
+	virtual int availableForWrite(void){ return 0; }
+	virtual void flush(void){}
+	size_t print(const char *s){ return write((const uint8_t *)s, strlen(s)); }
+	size_t print(const String &s){ return print(s.c_str()); }
+	size_t println(const char *s){ return print(s) + print("\n"); }
+	size_t println(const String &s){ return println(s.c_str()); }
+	size_t println(void){ return print("\n"); }
+	virtual ~Print(){}
+};
+class Stream : public Print {
+public:
+	virtual int available(void) = 0;
+	virtual int read(void) = 0;
+	virtual int peek(void) = 0;
+};
+class IPAddress {
+public:
+	IPAddress(){ memset(b, 0, 4); }
+	IPAddress(uint8_t a, uint8_t c, uint8_t d, uint8_t e){ b[0] = a; b[1] = c; b[2] = d; b[3] = e; }
+	uint8_t b[4];
+};
+class UDP : public Stream {
+public:
+	virtual uint8_t begin(uint16_t) = 0;
+	virtual int beginPacket(IPAddress, uint16_t) = 0;
+	virtual int endPacket(void) = 0;
+	virtual int parsePacket(void) = 0;
+	virtual int read(unsigned char *, size_t) = 0;
+	using Stream::read;
+};
+class SimSerial : public Stream {
+public:
+	size_t write(uint8_t c){ return fputc(c, stdout) == EOF ? 0 : 1; }
+	int available(void){ return 0; }
+	int read(void){ return -1; }
+	int peek(void){ return -1; }
+	int availableForWrite(void){ return 4096; }
+};
+extern SimSerial Serial;
+
+#endif /* _SOAK_ARDUINO_INCLUDE_ */
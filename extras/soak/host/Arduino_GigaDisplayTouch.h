@@ -0,0 +1,58 @@
+/**
+
+@file
+
+Stand-in for the Arduino_GigaDisplayTouch library for the soak test (see extras/soak). The test
+plays touches by filling in simTouch and simContacts, or by calling simTouchCallback as the touch
+interrupt would.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _SOAK_GIGA_DISPLAY_TOUCH_INCLUDE_
+#define _SOAK_GIGA_DISPLAY_TOUCH_INCLUDE_
+
+#include "Arduino.h"
+
+typedef struct {
+	uint8_t trackId;
+	uint16_t x;
+	uint16_t y;
+	uint16_t area;
+} GDTpoint_t;
+
+extern GDTpoint_t simTouch[5];
+extern uint8_t simContacts;
+extern void (*simTouchCallback)(uint8_t contacts, GDTpoint_t *points);
+
+class Arduino_GigaDisplayTouch {
+public:
+	bool begin(void){ return true; }
+	uint8_t getTouchPoints(GDTpoint_t *points){ memcpy(points, simTouch, sizeof(simTouch)); return simContacts; }
+	void onDetect(void (*cb)(uint8_t, GDTpoint_t *)){ simTouchCallback = cb; }
+};
+
+#endif /* _SOAK_GIGA_DISPLAY_TOUCH_INCLUDE_ */
@@ -0,0 +1,48 @@
+/**
+
+@file
+
+Stand-in for the Arduino_GigaDisplay_GFX library for the soak test (see extras/soak). The screen is a
+canvas in the simulated SDRAM.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _SOAK_GIGA_DISPLAY_GFX_INCLUDE_
+#define _SOAK_GIGA_DISPLAY_GFX_INCLUDE_
+
+#include "Adafruit_GFX.h"
+#include "SDRAM.h"
+
+class GigaDisplay_GFX : public GFXcanvas16 {
+public:
+	GigaDisplay_GFX() : GFXcanvas16(480, 800, false) {}
+	void begin(void){ buffer = (uint16_t *)SDRAM.malloc(480 * 800 * 2); }
+	void startBuffering(void){}
+	void endBuffering(void){}
+};
+
+#endif /* _SOAK_GIGA_DISPLAY_GFX_INCLUDE_ */
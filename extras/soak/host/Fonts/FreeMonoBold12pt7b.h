@@ -0,0 +1,4 @@
+//Stand-in for the font of the Adafruit GFX library, for the soak test (see extras/soak)
+#pragma once
+#include "../Adafruit_GFX.h"
+extern const GFXfont FreeMonoBold12pt7b;
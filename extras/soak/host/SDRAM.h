@@ -0,0 +1,51 @@
+/**
+
+@file
+
+Stand-in for the SDRAM library for the soak test (see extras/soak): 8 MB that is handed out from
+the start and never given back, which is how GigaDAQ uses it.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _SOAK_SDRAM_INCLUDE_
+#define _SOAK_SDRAM_INCLUDE_
+
+#include <stddef.h>
+#include <stdint.h>
+
+class SDRAMClass {
+public:
+	int begin(uint32_t = 0){ return 1; }
+	void *malloc(size_t n);
+	void free(void *){}
+	size_t used(void){ return top; }
+private:
+	size_t top = 0;
+};
+extern SDRAMClass SDRAM;
+
+#endif /* _SOAK_SDRAM_INCLUDE_ */
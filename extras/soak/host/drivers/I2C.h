@@ -0,0 +1,10 @@
+//Stand-in for the Mbed OS I2C driver, for the soak test (see extras/soak). Only declared, so that
+//GigaDAQ.h builds; the soak test does not use sensor ports.
+#pragma once
+#include "Arduino.h"
+namespace mbed {
+class I2C {
+public:
+	I2C(PinName sda, PinName scl);
+};
+}
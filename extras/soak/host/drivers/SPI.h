@@ -0,0 +1,10 @@
+//Stand-in for the Mbed OS SPI driver, for the soak test (see extras/soak). Only declared, so that
+//GigaDAQ.h builds; the soak test does not use sensor ports.
+#pragma once
+#include "Arduino.h"
+namespace mbed {
+class SPI {
+public:
+	SPI(PinName mosi, PinName miso, PinName sck);
+};
+}
@@ -0,0 +1,18 @@
+//Stand-in for the Mbed OS Ticker, for the soak test (see extras/soak). The soak test does not run
+//control loops, so the timer never fires.
+#pragma once
+#include <chrono>
+namespace mbed {
+template<class T> struct Callback {
+	T *object;
+	void (T::*method)(void);
+};
+template<class T> Callback<T> callback(T *object, void (T::*method)(void)){
+	return Callback<T>{object, method};
+}
+class Ticker {
+public:
+	template<class F> void attach(F, std::chrono::microseconds){}
+	void detach(void){}
+};
+}
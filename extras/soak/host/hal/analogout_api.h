@@ -0,0 +1,9 @@
+//Stand-in for the Mbed OS DAC HAL, for the soak test (see extras/soak). Only declared, so that
+//GigaDAQ.h builds; the soak test does not use control outputs.
+#pragma once
+#include "Arduino.h"
+struct dac_t {
+	int pin;
+};
+void analogout_init(dac_t *obj, PinName pin);
+void analogout_write(dac_t *obj, float value);
@@ -0,0 +1,10 @@
+//Stand-in for the Mbed OS PWM HAL, for the soak test (see extras/soak). Only declared, so that
+//GigaDAQ.h builds; the soak test does not use control outputs.
+#pragma once
+#include "Arduino.h"
+struct pwmout_t {
+	int pin;
+};
+void pwmout_init(pwmout_t *obj, PinName pin);
+void pwmout_period_us(pwmout_t *obj, int us);
+void pwmout_write(pwmout_t *obj, float percent);
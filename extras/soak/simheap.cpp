@@ -0,0 +1,263 @@
+/**
+
+@file
+
+The stand-in heap of the soak test. See simheap.h.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simheap.h"
+
+const size_t HEAP_MAX = 64*1024*1024;
+const size_t HEAD = 16;			//Bookkeeping in front of every block, which also keeps blocks 16-byte aligned
+const size_t MIN_BLOCK = 32;
+
+struct Block {
+	uint32_t size;		//Bytes in the block, including the bookkeeping
+	uint32_t prevSize;	//Bytes in the previous block, 0 for the first
+	uint32_t inUse;
+	uint32_t unused;
+	Block *next, *prev;	//Free list, only while the block is free
+};
+
+static uint8_t region[HEAP_MAX] __attribute__((aligned(16)));
+static size_t heapSize, used, peak;
+static uint64_t allocations, failures;
+static Block *freeList;
+
+static Block *after(Block *b){
+	uint8_t *p = (uint8_t *)b + b->size;
+	return (p < region + heapSize) ? (Block *)p : nullptr;
+}
+static void unlink(Block *b){
+	if(b->prev) b->prev->next = b->next; else freeList = b->next;
+	if(b->next) b->next->prev = b->prev;
+}
+static void push(Block *b){
+	b->inUse = 0;
+	b->prev = nullptr;
+	b->next = freeList;
+	if(freeList) freeList->prev = b;
+	freeList = b;
+}
+static void setup(void){
+	const char *kb = getenv("SOAK_HEAP_KB");		//getenv() does not allocate
+	Block *b = (Block *)region;
+
+	heapSize = (kb != nullptr && atol(kb) > 0) ? (size_t)atol(kb) * 1024 : 512*1024;
+	if(heapSize > HEAP_MAX) heapSize = HEAP_MAX;
+	heapSize &= ~(HEAD - 1);
+	b->size = heapSize;
+	b->prevSize = 0;
+	push(b);
+}
+//Cuts the end of a block off as a free block if it is large enough to be worth it
+static void trim(Block *b, size_t need){
+	Block *rest, *next;
+
+	if(b->size - need < MIN_BLOCK){
+		return;
+	}
+	rest = (Block *)((uint8_t *)b + need);
+	rest->size = b->size - need;
+	rest->prevSize = need;
+	b->size = need;
+	next = after(rest);
+	if(next && !next->inUse){		//Join with a free block behind it
+		unlink(next);
+		rest->size += next->size;
+		next = after(rest);
+	}
+	if(next) next->prevSize = rest->size;
+	push(rest);
+}
+static size_t blockSize(size_t n){
+	if(n > HEAP_MAX) return 0;
+	n = HEAD + ((n + HEAD - 1) & ~(HEAD - 1));
+	return (n < MIN_BLOCK) ? MIN_BLOCK : n;
+}
+
+extern "C" {
+
+void *malloc(size_t n){
+	Block *b, *best = nullptr;
+	size_t need = blockSize(n);
+
+	if(heapSize == 0) setup();
+	for(b = freeList; need && b; b = b->next){
+		if(b->size >= need && (best == nullptr || b->size < best->size)){
+			best = b;
+			if(b->size == need) break;
+		}
+	}
+	if(best == nullptr){
+		failures++;
+		errno = ENOMEM;
+		return nullptr;
+	}
+	unlink(best);
+	best->inUse = 1;
+	trim(best, need);
+	used += best->size;
+	if(used > peak) peak = used;
+	allocations++;
+	return (uint8_t *)best + HEAD;
+}
+void free(void *p){
+	Block *b, *n, *prev;
+
+	if(p == nullptr || (uint8_t *)p < region || (uint8_t *)p >= region + HEAP_MAX){
+		return;
+	}
+	b = (Block *)((uint8_t *)p - HEAD);
+	used -= b->size;
+	n = after(b);
+	if(n && !n->inUse){
+		unlink(n);
+		b->size += n->size;
+	}
+	if(b->prevSize){
+		prev = (Block *)((uint8_t *)b - b->prevSize);
+		if(!prev->inUse){
+			unlink(prev);
+			prev->size += b->size;
+			b = prev;
+		}
+	}
+	n = after(b);
+	if(n) n->prevSize = b->size;
+	push(b);
+}
+void *calloc(size_t count, size_t n){
+	void *p;
+
+	if(n != 0 && count > HEAP_MAX / n) return nullptr;
+	p = malloc(count * n);
+	if(p) memset(p, 0, count * n);
+	return p;
+}
+void *realloc(void *p, size_t n){
+	Block *b, *next;
+	size_t need = blockSize(n), old;
+	void *q;
+
+	if(p == nullptr) return malloc(n);
+	if(n == 0){
+		free(p);
+		return nullptr;
+	}
+	if(need == 0) return nullptr;
+	b = (Block *)((uint8_t *)p - HEAD);
+	old = b->size;
+	if(b->size < need){
+		next = after(b);
+		if(next && !next->inUse && b->size + next->size >= need){		//Grow into the free block behind
+			unlink(next);
+			b->size += next->size;
+			next = after(b);
+			if(next) next->prevSize = b->size;
+		}
+		else{
+			q = malloc(n);
+			if(q == nullptr) return nullptr;
+			memcpy(q, p, b->size - HEAD);
+			free(p);
+			return q;
+		}
+	}
+	trim(b, need);
+	used += b->size;
+	used -= old;
+	if(used > peak) peak = used;
+	return p;
+}
+int posix_memalign(void **out, size_t align, size_t n){
+	uintptr_t p, a;		//As numbers, since the headers are outside the block that malloc() handed out
+	Block *b, *front, *next;
+	size_t lead;
+
+	if(align <= HEAD){
+		*out = malloc(n);
+		return *out ? 0 : ENOMEM;
+	}
+	p = (uintptr_t)malloc(n + align + MIN_BLOCK);
+	if(p == 0) return ENOMEM;
+	a = (p + MIN_BLOCK + align - 1) & ~(uintptr_t)(align - 1);
+	front = (Block *)(p - HEAD);
+	lead = a - p;					//Bytes before the aligned block, at least MIN_BLOCK, given back
+	b = (Block *)(a - HEAD);
+	b->size = front->size - lead;
+	b->prevSize = lead;
+	b->inUse = 1;
+	next = after(b);
+	if(next) next->prevSize = b->size;
+	front->size = lead;
+	free((void *)p);
+	*out = (void *)a;
+	return 0;
+}
+void *aligned_alloc(size_t align, size_t n){
+	void *p;
+	return posix_memalign(&p, align, n) == 0 ? p : nullptr;
+}
+void *memalign(size_t align, size_t n){
+	return aligned_alloc(align, n);
+}
+void *valloc(size_t n){
+	return aligned_alloc(4096, n);
+}
+void *pvalloc(size_t n){
+	return aligned_alloc(4096, (n + 4095) & ~(size_t)4095);
+}
+size_t malloc_usable_size(void *p){
+	return p ? ((Block *)((uint8_t *)p - HEAD))->size - HEAD : 0;
+}
+
+}
+
+void simHeapStats(SimHeapStats &s){
+	Block *b;
+
+	if(heapSize == 0) setup();
+	s.size = heapSize;
+	s.used = used;
+	s.peak = peak;
+	s.largestFree = 0;
+	s.freeBlocks = 0;
+	for(b = freeList; b; b = b->next){
+		s.freeBlocks++;
+		if(b->size - HEAD > s.largestFree) s.largestFree = b->size - HEAD;
+	}
+	s.allocations = allocations;
+	s.failures = failures;
+}
+void simHeapResetPeak(void){
+	peak = used;
+}
@@ -0,0 +1,60 @@
+/**
+
+@file
+
+A stand-in for the heap of the GIGA for the soak test (see extras/soak). Every malloc() and free()
+of the program, including those inside String, stdio and the C++ library, is served from one fixed
+region of SOAK_HEAP_KB kilobytes (environment variable, default 512, about what is left of the
+internal RAM on the GIGA), so that running out and breaking up show as they would on the GIGA.
+
+Free blocks are kept on a list and the smallest one that fits is used, much as in the newlib
+allocator of the Arduino core. Neighboring free blocks are joined.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _SOAK_SIM_HEAP_INCLUDE_
+#define _SOAK_SIM_HEAP_INCLUDE_
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct SimHeapStats {
+	size_t size;			//Bytes in the heap
+	size_t used;			//Bytes in use, including bookkeeping
+	size_t peak;			//Most bytes in use since the last simHeapResetPeak()
+	size_t largestFree;		//Largest block that could be handed out
+	size_t freeBlocks;		//Pieces the free space is broken into
+	uint64_t allocations;	//Blocks handed out so far
+	uint64_t failures;		//Requests that could not be met
+};
+
+/** Fills in the state of the heap */
+void simHeapStats(SimHeapStats &s);
+/** Starts the high-water mark again from the bytes now in use */
+void simHeapResetPeak(void);
+
+#endif /* _SOAK_SIM_HEAP_INCLUDE_ */
@@ -0,0 +1,479 @@
+/**
+
+@file
+
+soak - runs the GigaDAQ library on a desktop computer for simulated days and checks that memory use,
+heap fragmentation and the time taken by each part of the work do not creep up.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. soak
+
+Usage:
+
+    soak [days] [window_hours] [folder]
+
+days is simulated time (default 2). Results are gathered in windows of window_hours simulated hours
+(default 1), and recordings are written to folder (default soak_usb, which must exist). The heap
+is SOAK_HEAP_KB kilobytes (environment variable, default 512) and is the only heap of the program,
+so String, stdio and GigaDAQ all use it as they would on the GIGA (see simheap.h).
+
+The sketch has text boxes whose readings change five times a second with varying lengths, a
+recording of four channels at 20 samples per second that starts a new file every hour, two pages,
+and a slider and a trackpad. The slider is the setpoint of a control loop run every 10 milliseconds.
+A synthetic finger taps the buttons, drags the slider, long-presses and pinches the trackpad now and
+then, reporting through the touch interrupt every 10 milliseconds.
+Time between passes through loop() is simulated, but the time each part of the work takes is
+measured on the computer, so the percentiles show whether the work grows, not how long it takes on
+the GIGA.
+
+For each window, the heap in use, its high-water mark, its largest free block, the SDRAM arena's
+high-water mark and the 50th and 99th percentile times of each part of the work are printed. The
+first tenth of the run is left out as warm-up; of the rest, the last third is compared with the
+first third, and the run fails (exit status 1) if anything grew by more than its tolerance, or if
+any memory request failed.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <chrono>
+#include <sys/stat.h>
+#include "GigaDAQ.h"
+#include "simheap.h"
+
+#undef fopen
+
+enum Phase { PH_INPUT, PH_DISPLAY, PH_RECORD, PH_TEXT, PH_PAGE, NUM_PHASES };
+static const char *phaseName[NUM_PHASES] = {"input", "display", "record", "text", "page"};
+
+const int BUCKETS = 256;
+const int MAX_WINDOWS = 20000;
+const uint64_t STEP = 10000;			//Microseconds per pass through loop()
+const uint64_t MIN_SAMPLES = 100;		//Fewer times than this in a third of the run are too few to find a trend
+
+//Times are kept in a histogram with 8 buckets per doubling, so percentiles are within 12%
+struct Histogram {
+	uint32_t count[BUCKETS];
+	uint64_t samples, max;
+	void add(uint64_t ns){
+		int e, i;
+		if(ns < 8){
+			i = (int)ns;
+		}
+		else{
+			for(e = 3; e < 40 && (ns >> (e + 1)) != 0; e++);
+			i = (e - 2) * 8 + (int)((ns >> (e - 3)) & 7);
+			if(i >= BUCKETS) i = BUCKETS - 1;
+		}
+		count[i]++;
+		samples++;
+		if(ns > max) max = ns;
+	}
+	uint64_t percentile(double p){
+		uint64_t want = (uint64_t)(p * samples), seen = 0;
+		int i;
+		for(i = 0; i < BUCKETS; i++){
+			seen += count[i];
+			if(seen > want){
+				return (i < 8) ? i : (uint64_t)(8 + i % 8) << (i / 8 + 2 - 3);
+			}
+		}
+		return max;
+	}
+};
+
+struct Window {
+	double heapUsed, heapPeak, fragmentation, sdramPeak, logBytes;
+	double p50[NUM_PHASES], p99[NUM_PHASES];
+	uint64_t samples[NUM_PHASES];
+};
+
+GigaDAQ daq;
+static Histogram hist[NUM_PHASES];
+static Window window[MAX_WINDOWS];
+static int windows;
+static char fileName[64];
+static int fileNumber;
+static uint64_t logBytes;
+static bool recording;
+static int controlInput;			//Channel the control loop reads, fed from the first recorded value
+
+static time_t simRtc(time_t *t){
+	time_t now = 1750000000 + (time_t)(simTime / 1000000);
+	if(t) *t = now;
+	return now;
+}
+static uint64_t hostNs(void){
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void startRecording(void){
+	snprintf(fileName, sizeof(fileName), "soak%d.csv", fileNumber++ % 2);
+	daq.startDataRecording(fileName);
+	recording = true;
+}
+//Ends the file and deletes it, so that days of data do not fill the disk
+static void endRecording(void){
+	char path[600];
+	int i;
+
+	logBytes += daq.logOffset;
+	daq.endDataRecording();
+	recording = false;
+	snprintf(path, sizeof(path), "%s/%s", simUsbFolder, fileName);
+	remove(path);
+	for(i = 0; i < LOG_INDEX_LEVELS; i++){
+		snprintf(path, sizeof(path), "%s/%s.ix%d", simUsbFolder, fileName, i);
+		remove(path);
+	}
+}
+
+static void setup(void){
+	int i, n;
+
+	daq.clock.rtc = simRtc;
+	daq.begin();
+	daq.enableTouchInterrupt();
+
+	for(i = 0; i < 6; i++){		//Readings
+		daq.textbox[i] = Textbox(String("Reading ") + String(i), 5 + (i % 2) * 45, 5 + (i / 2) * 12, 40, 10, 0xFFFF, 0x001F);
+		daq.textbox[i].setDisplayText("0.00");
+	}
+	daq.textbox[6] = Textbox("Gain", 5, 42, 40, 8, 0xFFFF, 0x0000);
+	daq.button[0] = Button("Record", 5, 85, 40, 10, 0xFFFF, 0xF800);
+	daq.button[0].setLook(BUTTON_NORMAL, "Record", 0xFFFF, 0xF800);
+	daq.button[0].setLook(BUTTON_ON, "Stop", 0xFFE0, 0xF800);
+	daq.button[0].setLook(BUTTON_PRESSED, "...", 0xF800, 0xFFFF);
+	daq.button[0].setToggle();
+	daq.button[0].setOn(true);
+	daq.button[0].setHandler([](){
+		if(daq.button[0].on){
+			startRecording();
+		}
+		else{
+			endRecording();
+		}
+	}, ACTION_LOW);
+	daq.button[1] = Button("Next page", 55, 85, 40, 10, 0xFFFF, 0x07E0);
+	daq.button[1].setDisplayText("More");
+	daq.button[1].setHandler([](){ daq.showPage(1); });
+	daq.slider[0] = Slider("Gain slider", 5, 52, 90, 8, 0xFFE0, 0x0000);
+	daq.slider[0].setMode(HORIZONTAL);
+	daq.slider[0].setXlimits(0, 10);
+	daq.slider[0].setHandler([](){ daq.textbox[6].setDisplayText(String(daq.slider[0].posX, 2)); }, ACTION_HIGH);
+	daq.slider[0].bindChannel(daq.channels->add("Gain"));
+	controlInput = daq.channels->add("Level");
+	n = daq.control.add(controlInput, daq.slider[0].channelX, daq.channels->add("Drive"), nullptr, 10000);
+	daq.control.loop[n].pid.setGains(0.1f, 0.5f, 0);
+	daq.control.start(n);
+	daq.startControl();		//The host Ticker never fires, so the main loop ticks the loop itself
+
+	daq.slider[1] = Slider("Trackpad", 5, 5, 90, 60, 0x07FF, 0x0000);
+	daq.slider[1].setMode(TRACKPAD);
+	daq.slider[1].setXlimits(-1, 1);
+	daq.slider[1].setYlimits(-1, 1);
+	daq.slider[1].page = 1;
+	daq.slider[1].setHandler([](){ daq.textbox[7].setDisplayText(String(daq.slider[1].posX, 3) + String(", ") + String(daq.slider[1].posY, 3)); });
+	daq.slider[1].setPinchHandler([](){ daq.textbox[8].setDisplayText(String("Zoom ") + String(daq.slider[1].pinchScale, 2)); });
+	daq.textbox[7] = Textbox("Position", 5, 68, 90, 6, 0xFFFF, 0x0000);
+	daq.textbox[8] = Textbox("Zoom", 5, 76, 90, 6, 0xFFFF, 0x0000);
+	daq.textbox[7].page = 1;
+	daq.textbox[8].page = 1;
+	daq.button[2] = Button("Back", 5, 85, 90, 10, 0xFFFF, 0x07E0);
+	daq.button[2].setDisplayText("Back");
+	daq.button[2].page = 1;
+	daq.button[2].setHandler([](){ daq.showPage(0); });
+
+	daq.drawAll();
+	startRecording();
+}
+
+//A finger on the screen: where it goes and for how long
+struct Session {
+	uint64_t start, end;
+	bool planned;				//Where the finger goes is decided when it touches, so it fits the page shown then
+	int kind;					//0 tap, 1 slider drag, 2 trackpad drag, 3 long press, 4 pinch
+	int x0, y0, x1, y1;			//Start and end in pixels
+} session;
+
+static int pixelX(int percent){ return percent * 480 / 100; }
+static int pixelY(int percent){ return percent * 800 / 100; }
+static double uniform(void){ return (rand() + 1.0) / (RAND_MAX + 2.0); }
+
+static void nextSession(uint64_t after){
+	session.start = after + (uint64_t)(-log(uniform()) * 20e6);		//Every 20 seconds on average
+	session.planned = false;
+}
+static void planSession(void){
+	int target;
+
+	session.planned = true;
+	session.kind = rand() % 5;
+	if(!recording && daq.currentPage == 0){
+		session.kind = 0;
+	}
+	switch(session.kind){
+		case 0:
+		case 3:		//A button on the page that is shown
+			target = (daq.currentPage == 1) ? 2 : (recording ? rand() % 2 : 0);
+			session.x0 = session.x1 = pixelX(daq.button[target].x + daq.button[target].w / 2);
+			session.y0 = session.y1 = pixelY(daq.button[target].y + daq.button[target].h / 2);
+			session.end = session.start + ((session.kind == 0) ? 120000 : 900000);
+			break;
+		case 1:
+			session.x0 = pixelX(8 + rand() % 84);
+			session.x1 = pixelX(8 + rand() % 84);
+			session.y0 = session.y1 = pixelY(56);
+			session.end = session.start + 500000 + rand() % 2500000;
+			break;
+		default:
+			session.x0 = pixelX(10 + rand() % 80);
+			session.y0 = pixelY(10 + rand() % 50);
+			session.x1 = pixelX(10 + rand() % 80);
+			session.y1 = pixelY(10 + rand() % 50);
+			session.end = session.start + 500000 + rand() % 2000000;
+	}
+}
+static void touch(uint64_t now){
+	GDTpoint_t p[5];
+	double f;
+
+	if(!session.planned && !recording && daq.currentPage == 0 && session.start > now + 2000000){
+		session.start = now + 2000000;		//Recording is started again soon, so that every window records alike
+	}
+	if(now < session.start || simTouchCallback == nullptr){
+		return;
+	}
+	if(!session.planned){
+		planSession();
+	}
+	memset(p, 0, sizeof(p));
+	if(now >= session.end){
+		simTouchCallback(0, p);
+		nextSession(now);
+		return;
+	}
+	f = (double)(now - session.start) / (session.end - session.start);
+	p[0].x = session.x0 + (session.x1 - session.x0) * f + rand() % 3;
+	p[0].y = session.y0 + (session.y1 - session.y0) * f + rand() % 3;
+	if(session.kind == 4){			//Second finger moving away from the first
+		p[1].x = p[0].x + 20 + 100 * f;
+		p[1].y = p[0].y + 20 + 100 * f;
+		simTouchCallback(2, p);
+	}
+	else{
+		simTouchCallback(1, p);
+	}
+}
+
+static void closeWindow(int n){
+	SimHeapStats h;
+	Window &w = window[windows];
+	int i;
+
+	simHeapStats(h);
+	w.heapUsed = h.used;
+	w.heapPeak = h.peak;
+	w.fragmentation = (h.size > h.used) ? 1.0 - (double)h.largestFree / (h.size - h.used) : 0;
+	w.sdramPeak = daq.sdramArena.peak();
+	w.logBytes = logBytes + daq.logOffset;
+	for(i = 0; i < NUM_PHASES; i++){
+		w.samples[i] = hist[i].samples;
+		w.p50[i] = hist[i].percentile(0.5) / 1000.0;
+		w.p99[i] = hist[i].percentile(0.99) / 1000.0;
+	}
+	printf("%5d %9.0f %9.0f %6.3f %5lu %9.0f", n, w.heapUsed, w.heapPeak, w.fragmentation, (unsigned long)h.freeBlocks, w.sdramPeak);
+	for(i = 0; i < NUM_PHASES; i++){
+		printf("  %7.2f %7.2f", w.p50[i], w.p99[i]);
+	}
+	printf("\n");
+	fflush(stdout);
+
+	simHeapResetPeak();
+	daq.sdramArena.resetPeak();
+	memset(hist, 0, sizeof(hist));
+	if(windows < MAX_WINDOWS - 1) windows++;
+}
+
+//Mean of a value over a range of windows
+static double mean(int a, int b, double Window::*field){
+	double sum = 0;
+	int i;
+	for(i = a; i < b; i++){
+		sum += window[i].*field;
+	}
+	return (b > a) ? sum / (b - a) : 0;
+}
+static bool check(const char *what, double first, double last, double relative, double absolute){
+	bool grew = last > first * (1 + relative) + absolute;
+	printf("%-22s %12.3f -> %12.3f  %s\n", what, first, last, grew ? "GREW" : "ok");
+	return !grew;
+}
+//Compares a percentile of one part of the work, leaving out windows in which it never ran
+static bool checkPhase(const char *what, int a, int b, int c, int d, bool p99, int phase){
+	double first = 0, last = 0;
+	uint64_t firstSamples = 0, lastSamples = 0;
+	int i, n = 0, m = 0;
+
+	for(i = a; i < d; i++){
+		if(window[i].samples[phase] == 0 || (i >= b && i < c)){
+			continue;
+		}
+		if(i < b){
+			first += p99 ? window[i].p99[phase] : window[i].p50[phase];
+			firstSamples += window[i].samples[phase];
+			n++;
+		}
+		else{
+			last += p99 ? window[i].p99[phase] : window[i].p50[phase];
+			lastSamples += window[i].samples[phase];
+			m++;
+		}
+	}
+	if(firstSamples < MIN_SAMPLES || lastSamples < MIN_SAMPLES){
+		printf("%-22s too few samples to compare\n", what);
+		return true;
+	}
+	return check(what, first / n, last / m, p99 ? 0.5 : 0.25, p99 ? 5.0 : 1.0);
+}
+
+int main(int argc, char **argv){
+	double days = (argc > 1) ? atof(argv[1]) : 2;
+	double windowHours = (argc > 2) ? atof(argv[2]) : 1;
+	uint64_t end, windowLength, nextWindow, nextSample, nextText, nextFile, stepEnd, t0;
+	SimHeapStats h;
+	char name[128];
+	float values[4];
+	int i, n, warm, a, b, c;
+	bool ok = true;
+
+	simUsbFolder = (argc > 3) ? argv[3] : "soak_usb";
+	mkdir(simUsbFolder, 0777);
+	srand(1);
+	setup();
+	end = simTime + (uint64_t)(days * 86400e6);
+	windowLength = (uint64_t)(windowHours * 3600e6);
+	nextWindow = simTime + windowLength;
+	nextSample = nextText = simTime;
+	nextFile = simTime + 3600000000ULL;
+	nextSession(simTime);
+
+	printf("Window  heapUsed  heapPeak   frag  free  sdramPeak");
+	for(i = 0; i < NUM_PHASES; i++) printf("  %7s p50/p99(us)", phaseName[i]);
+	printf("\n");
+
+	for(n = 1; simTime < end; ){
+		stepEnd = simTime + STEP;
+		touch(simTime);
+
+		t0 = hostNs();
+		daq.handleInputs();
+		hist[PH_INPUT].add(hostNs() - t0);
+
+		if(simTime >= nextSample){
+			nextSample += 50000;
+			for(i = 0; i < 4; i++){
+				values[i] = sin(simTime / 1e6 * (i + 1)) * 100 + rand() % 100 / 100.0;
+			}
+			t0 = hostNs();
+			daq.recordSample(daq.clock.now(), values, 4);
+			daq.channels->set(controlInput, values[0], daq.clock.now());
+			hist[PH_RECORD].add(hostNs() - t0);
+		}
+		if(simTime >= nextText){
+			nextText += 200000;
+			t0 = hostNs();
+			for(i = 0; i < 6; i++){
+				if(rand() % 50 == 0){
+					daq.textbox[i].setDisplayText("OVERRANGE");
+				}
+				else{
+					daq.textbox[i].setDisplayText(String(values[i % 4] * pow(10, rand() % 4), rand() % 4));
+				}
+			}
+			hist[PH_TEXT].add(hostNs() - t0);
+		}
+		if(simTime >= nextFile){				//A new recording every hour
+			nextFile += 3600000000ULL;
+			if(recording){
+				endRecording();
+				startRecording();
+			}
+		}
+		if(rand() % 60000 == 0){				//Now and then the other page is shown for a while
+			t0 = hostNs();
+			daq.showPage(1 - daq.currentPage);
+			hist[PH_PAGE].add(hostNs() - t0);
+		}
+
+		daq.control.tick(daq.clock.now());
+
+		t0 = hostNs();
+		daq.updateDisplays();
+		hist[PH_DISPLAY].add(hostNs() - t0);
+
+		if(simTime < stepEnd){
+			simTime = stepEnd;
+		}
+		if(simTime >= nextWindow){
+			nextWindow += windowLength;
+			closeWindow(n++);
+		}
+	}
+
+	simHeapStats(h);
+	printf("\n%lu heap blocks handed out, %lu requests failed. SDRAM arena: %lu failures. %.1f MB logged.\n",
+		(unsigned long)h.allocations, (unsigned long)h.failures, (unsigned long)daq.sdramArena.failures,
+		(logBytes + daq.logOffset) / 1e6);
+	daq.control.report(0, name, sizeof(name));
+	printf("Control %s\n", name);
+	if(h.failures != 0 || daq.sdramArena.failures != 0){
+		ok = false;
+	}
+	if(windows < 6){
+		printf("Too few windows to look for trends\n");
+		return ok ? 0 : 1;
+	}
+
+	warm = windows / 10;
+	if(warm < 1) warm = 1;
+	a = warm;
+	b = warm + (windows - warm) / 3;
+	c = windows - (windows - warm) / 3;
+	printf("\nWindows %d-%d compared with %d-%d:\n", a + 1, b, c + 1, windows);
+	ok &= check("heap in use (bytes)", mean(a, b, &Window::heapUsed), mean(c, windows, &Window::heapUsed), 0.02, 1024);
+	ok &= check("heap peak (bytes)", mean(a, b, &Window::heapPeak), mean(c, windows, &Window::heapPeak), 0.02, 1024);
+	ok &= check("fragmentation", mean(a, b, &Window::fragmentation), mean(c, windows, &Window::fragmentation), 0, 0.05);
+	ok &= check("SDRAM peak (bytes)", mean(a, b, &Window::sdramPeak), mean(c, windows, &Window::sdramPeak), 0.02, 1024);
+	for(i = 0; i < NUM_PHASES; i++){
+		snprintf(name, sizeof(name), "%s p50 (us)", phaseName[i]);
+		ok &= checkPhase(name, a, b, c, windows, false, i);
+		snprintf(name, sizeof(name), "%s p99 (us)", phaseName[i]);
+		ok &= checkPhase(name, a, b, c, windows, true, i);
+	}
+	printf("\n%s\n", ok ? "PASSED" : "FAILED");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""
+telemetry_receiver.py - records the UDP telemetry stream of a GigaDAQ TelemetryPublisher.
+
+Usage:
+    python3 telemetry_receiver.py [--port 5005] [--out data.csv]
+    python3 telemetry_receiver.py --simulate [--rate 2000] [--channels 4] [--seconds 5]
+    python3 telemetry_receiver.py --check 10000 [--port 5005] --out /dev/null
+
+Every sample is written as a line of comma-separated values (time in seconds first),
+the same as the data files GigaDAQ writes to the flash drive. Once a second a status
+line reports frames, samples, bytes per second and lost frames (gaps in the sequence
+numbers) on stderr.
+
+--simulate sends frames in the same format from this computer to itself over the
+loopback interface, so the receiver can be tried out without a GIGA or a network.
+
+--check RATE tests a publisher that sends RATE samples per second, such as telepub.cpp,
+which runs the library's TelemetryPublisher on this computer. The receiver stops once
+the stream has been quiet for three seconds, and prints PASSED if every sample either arrived
+or was counted as dropped by the publisher, frames were only missing where the publisher
+said it dropped samples, and every second without drops brought at least 95% of RATE
+samples. Otherwise it prints FAILED and exits with status 1.
+
+Written by David A. Trevas. MIT License, Copyright (c) 2025 David A. Trevas.
+See the LICENSE file of the GigaDAQ library.
+"""
+
+import argparse
+import math
+import socket
+import struct
+import sys
+import threading
+import time
+
+MAGIC = 0x4D544447          # "GDTM", must match TELEMETRY_MAGIC in Telemetry.h
+VERSION = 2
+HEADER = struct.Struct("<IHBBIIHHII")
+FRAME_BYTES = 1400
+
+
+def decode(datagram):
+    """Returns (seq, dropped, channels, samples) or None if the datagram is not telemetry.
+    Each sample is a tuple of the time stamp in microseconds followed by the values."""
+    if len(datagram) < HEADER.size:
+        return None
+    magic, version, channels, _, seq, dropped, count, _, time_low, time_high = HEADER.unpack_from(datagram)
+    if magic != MAGIC or version != VERSION:
+        return None
+    sample = struct.Struct("<I%df" % channels)
+    if len(datagram) < HEADER.size + count * sample.size:
+        return None
+    base = (time_high << 32) | time_low
+    samples = []
+    for i in range(count):
+        row = sample.unpack_from(datagram, HEADER.size + i * sample.size)
+        samples.append((base + row[0],) + row[1:])
+    return seq, dropped, channels, samples
+
+
+def simulate(port, rate, channels, seconds):
+    """Sends a sine wave on every channel at the given sample rate, like a GIGA would."""
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sample = struct.Struct("<I%df" % channels)
+    per_frame = (FRAME_BYTES - HEADER.size) // sample.size
+    seq = 0
+    n = 0
+    start = time.monotonic()
+    base = int(time.time() * 1000000)
+    while time.monotonic() - start < seconds:
+        body = b""
+        first = base + n * 1000000 // rate
+        for _ in range(per_frame):
+            body += sample.pack(base + n * 1000000 // rate - first,
+                                *[math.sin(2 * math.pi * (c + 1) * n / rate) for c in range(channels)])
+            n += 1
+        header = HEADER.pack(MAGIC, VERSION, channels, 0, seq, 0, per_frame, 0, first & 0xFFFFFFFF, first >> 32)
+        sock.sendto(header + body, ("127.0.0.1", port))
+        seq += 1
+        time.sleep(max(0.0, start + n / rate - time.monotonic()))
+    sock.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", type=int, default=5005)
+    parser.add_argument("--out", default="-", help="CSV file to write, - for standard output")
+    parser.add_argument("--simulate", action="store_true", help="also send test frames over loopback")
+    parser.add_argument("--rate", type=int, default=2000, help="simulated samples per second")
+    parser.add_argument("--channels", type=int, default=4, help="simulated values per sample")
+    parser.add_argument("--seconds", type=float, default=5.0, help="length of the simulation")
+    parser.add_argument("--check", type=int, default=0, metavar="RATE", help="check a stream of RATE samples per second, then exit")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1 << 20)
+    sock.bind(("0.0.0.0", args.port))
+    sock.settimeout(0.5)
+
+    if args.simulate:
+        sender = threading.Thread(target=simulate, args=(args.port, args.rate, args.channels, args.seconds), daemon=True)
+        sender.start()
+
+    out = sys.stdout if args.out == "-" else open(args.out, "w")
+    expected = None
+    frames = samples = lost = total_bytes = 0
+    window_bytes = 0
+    window_start = time.monotonic()
+    first_time = last_time = None
+    last_dropped = 0
+    window_samples = window_dropped = 0
+    unexplained = slow = 0
+    last_heard = None
+    try:
+        while True:
+            try:
+                datagram, _ = sock.recvfrom(65536)
+            except socket.timeout:
+                if args.simulate and not sender.is_alive():
+                    break
+                if args.check and last_heard is not None and time.monotonic() - last_heard >= 3.0:
+                    break
+                continue
+            frame = decode(datagram)
+            if frame is None:
+                continue
+            seq, dropped, _, rows = frame
+            if expected is not None and seq != expected:
+                lost += (seq - expected) & 0xFFFFFFFF
+                if dropped == last_dropped:
+                    unexplained += 1    # Lost on the way, not dropped by the publisher
+            expected = (seq + 1) & 0xFFFFFFFF
+            if rows:
+                if first_time is None:
+                    first_time = rows[0][0]
+                last_time = rows[-1][0]
+            last_dropped = dropped
+            if last_heard is None:
+                window_start = time.monotonic()    # Throughput counts from the first frame
+            last_heard = time.monotonic()
+            window_samples += len(rows)
+            for row in rows:
+                out.write("%d.%06d, %s\n" % (row[0] // 1000000, row[0] % 1000000, ", ".join("%g" % v for v in row[1:])))
+            frames += 1
+            samples += len(rows)
+            total_bytes += len(datagram)
+            window_bytes += len(datagram)
+            now = time.monotonic()
+            if now - window_start >= 1.0:
+                print("frames %d  samples %d  %.1f kB/s  lost frames %d  dropped on GIGA %d"
+                      % (frames, samples, window_bytes / (now - window_start) / 1000.0, lost, dropped),
+                      file=sys.stderr)
+                if args.check and dropped == window_dropped and window_samples < 0.95 * args.check * (now - window_start):
+                    slow += 1
+                window_bytes = 0
+                window_samples = 0
+                window_dropped = dropped
+                window_start = now
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if out is not sys.stdout:
+            out.close()
+    print("total: frames %d  samples %d  bytes %d  lost frames %d" % (frames, samples, total_bytes, lost), file=sys.stderr)
+    if args.check:
+        failed = False
+        sent = 0 if first_time is None else (last_time - first_time) * args.check // 1000000 + 1
+        print("%d samples sent, %d received, %d dropped by the publisher" % (sent, samples, last_dropped), file=sys.stderr)
+        if samples == 0 or samples + last_dropped != sent:
+            print("Samples went missing without being counted as dropped", file=sys.stderr)
+            failed = True
+        if unexplained:
+            print("%d gaps in the sequence numbers were not dropped by the publisher" % unexplained, file=sys.stderr)
+            failed = True
+        if slow:
+            print("%d seconds without drops brought less than 95%% of the samples" % slow, file=sys.stderr)
+            failed = True
+        print("FAILED" if failed else "PASSED", file=sys.stderr)
+        sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,201 @@
+/**
+
+@file
+
+telepub - runs the GigaDAQ TelemetryPublisher on a desktop computer and sends its datagrams over
+the loopback interface to telemetry_receiver.py, which checks them.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. telepub
+
+Usage, with the receiver started first:
+
+    python3 telemetry_receiver.py --port 5005 --out /dev/null --check 10000 &
+    ./telepub [port [rate [channels [seconds]]]]
+
+The publisher is given rate samples per second (10000 unless changed) of channels values (8) for
+seconds seconds (5), at the times a sketch would take them, and service() is called between the
+samples as from loop(). For the middle second the network refuses every datagram, as a congested
+WiFi link does, so the publisher has to back off and drop the oldest data.
+
+telepub checks that the publisher backed off instead of trying again at every service(), and that
+it dropped samples while refused and sent the rest, and prints PASSED or FAILED. The receiver checks
+that every sample arrived or was counted as dropped, that frames were only missing where the
+publisher said it dropped samples, and the throughput.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "Telemetry.h"
+
+//The library's millis() reads the simulated clock of extras/soak/host, which is kept with the real one here
+static uint64_t hostMicros(void){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	simTime = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	return simTime;
+}
+
+/** A UDP that sends datagrams with a socket, and refuses them while refusing is set */
+class SocketUDP : public UDP {
+public:
+	bool refusing;		//Refuse every datagram, as a congested link does
+	uint32_t refused;	//Datagrams refused
+	uint32_t sent;		//Datagrams sent
+
+	SocketUDP(){
+		fd = socket(AF_INET, SOCK_DGRAM, 0);
+		len = 0;
+		refusing = false;
+		refused = 0;
+		sent = 0;
+	}
+	~SocketUDP(){
+		close(fd);
+	}
+	int beginPacket(IPAddress ip, uint16_t port){
+		memset(&to, 0, sizeof(to));
+		to.sin_family = AF_INET;
+		to.sin_port = htons(port);
+		memcpy(&to.sin_addr, ip.b, 4);
+		len = 0;
+		return (fd >= 0) ? 1 : 0;
+	}
+	size_t write(const uint8_t *buf, size_t size){
+		if(len + size > sizeof(packet)){
+			return 0;
+		}
+		memcpy(&packet[len], buf, size);
+		len += size;
+		return size;
+	}
+	size_t write(uint8_t c){
+		return write(&c, 1);
+	}
+	int endPacket(void){
+		if(refusing){
+			refused++;
+			return 0;
+		}
+		if(sendto(fd, packet, len, 0, (struct sockaddr *)&to, sizeof(to)) != (ssize_t)len){
+			return 0;		//ENOBUFS and the like, as the WiFi module refusing a packet
+		}
+		sent++;
+		return 1;
+	}
+	//Nothing is received
+	uint8_t begin(uint16_t){ return 1; }
+	int parsePacket(void){ return 0; }
+	int available(void){ return 0; }
+	int read(void){ return -1; }
+	int read(unsigned char *, size_t){ return 0; }
+	int peek(void){ return -1; }
+private:
+	int fd;
+	struct sockaddr_in to;
+	uint8_t packet[TELEMETRY_FRAME_BYTES];
+	size_t len;
+};
+
+int main(int argc, char **argv){
+	int port = (argc > 1) ? atoi(argv[1]) : 5005;
+	int rate = (argc > 2) ? atoi(argv[2]) : 10000;
+	int channels = (argc > 3) ? atoi(argv[3]) : 8;
+	double seconds = (argc > 4) ? atof(argv[4]) : 5;
+	SocketUDP udp;
+	TelemetryPublisher telemetry;
+	float values[TELEMETRY_MAX_CHANNELS];
+	uint64_t start, now, n = 0, epoch, congestStart, congestEnd, droppedBefore = 0;
+	uint32_t failuresBefore = 0, failures, passes = 0;
+	int c, fails = 0;
+
+	if(rate <= 0 || channels <= 0 || channels > TELEMETRY_MAX_CHANNELS || seconds <= 0){
+		printf("Usage: telepub [port [rate [channels [seconds]]]]\n");
+		return 1;
+	}
+	simReadTime = 0;
+	telemetry.begin(udp, IPAddress(127, 0, 0, 1), port);
+	epoch = 1750000000ULL * 1000000;		//Time stamps count from 1970, as from GigaDAQ::clock
+	start = hostMicros();
+	congestStart = (uint64_t)(seconds * 1e6) * 2 / 5;
+	congestEnd = congestStart + 1000000;
+
+	while((now = hostMicros() - start) < seconds * 1e6){
+		while(n * 1000000 / rate <= now){		//The samples that are due, as a sketch takes them
+			for(c = 0; c < channels; c++){
+				values[c] = sinf(2 * M_PI * (c + 1) * n / rate);
+			}
+			telemetry.write(epoch + n * 1000000 / rate, values, channels);
+			n++;
+		}
+		if(now >= congestStart && !udp.refusing && now < congestEnd){
+			udp.refusing = true;
+			failuresBefore = telemetry.sendFailures;
+			droppedBefore = telemetry.samplesDropped;
+		}
+		else if(now >= congestEnd && udp.refusing){
+			udp.refusing = false;
+			failures = telemetry.sendFailures - failuresBefore;
+			printf("Refused for 1 s: %lu attempts, %lu samples dropped\n", (unsigned long)failures,
+			       (unsigned long)(telemetry.samplesDropped - droppedBefore));
+			if(failures > 20){		//10, 20, 40 ... 1000 ms apart, about 9
+				printf("The publisher did not back off\n");
+				fails++;
+			}
+			if(telemetry.samplesDropped == droppedBefore){
+				printf("Nothing was dropped while the network refused the datagrams\n");
+				fails++;
+			}
+		}
+		telemetry.service();
+		passes++;
+	}
+	start = hostMicros();
+	while(hostMicros() - start < 2 * TELEMETRY_MAX_BACKOFF * 1000){		//Sends what is left, the last frame after maxLatency
+		telemetry.service();
+		usleep(100);
+	}
+	printf("%llu samples, %lu datagrams sent (%lu bytes, %.1f kB/s), %lu refused, %lu samples dropped, %lu passes\n",
+	       (unsigned long long)n, (unsigned long)telemetry.framesSent, (unsigned long)telemetry.bytesSent,
+	       telemetry.bytesSent / seconds / 1000, (unsigned long)telemetry.sendFailures,
+	       (unsigned long)telemetry.samplesDropped, (unsigned long)passes);
+	if(telemetry.samplesDropped >= n / 2){
+		printf("Too many samples were dropped\n");
+		fails++;
+	}
+	printf("%s\n", fails ? "FAILED" : "PASSED");
+	return fails ? 1 : 0;
+}
@@ -0,0 +1,169 @@
+/**
+
+@file
+
+timesim - runs the GigaDAQ Timebase for simulated hours against a simulated microsecond counter and
+real-time clock, and checks that its time stamps stay right.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. timesim
+
+Usage:
+
+    timesim
+
+The counter runs a given number of parts per million fast or slow against the real-time clock (RTC),
+and wraps around every 71.6 minutes as the real one does. In some runs it starts just before wrapping,
+so that it wraps while begin() waits for the RTC to tick. In others the RTC is set ahead or back
+partway through. loop() calls service() and now() every 50 to 2050 microseconds. Every run is checked
+for these:
+
+    ticks      ticks() always equals the counter extended to 64 bits, so no wrap is missed
+    backwards  now() never gives a time before one it gave already
+    error      once the clock has had time to settle, now() is within ERROR_LIMIT of the RTC
+
+PASSED is printed if every run passes, otherwise FAILED, and the exit status is 1.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Timebase.h"
+
+const int64_t START = 1750000000LL * 1000000 + 400000;	//RTC time at power-up in microseconds, partway through a second
+const int64_t ERROR_LIMIT = 2000;		//Microseconds the settled clock may be off from the RTC
+const int64_t READ_TIME = 1;			//Microseconds that reading the counter takes
+
+struct Run {
+	const char *name;
+	double ppm;				//How fast the counter runs against the RTC
+	uint32_t counterStart;	//Counter at power-up
+	double hours;			//Length of the run
+	double stepAt;			//Hours into the run that the RTC is set, 0 for never
+	double stepBy;			//Seconds the RTC is set ahead (or back, if negative)
+	double settle;			//Hours after power-up or the step until the clock must be within ERROR_LIMIT
+};
+
+static const Run runs[] = {
+	{"steady", 0, 0, 2, 0, 0, 0.1},
+	{"fast 200 ppm", 200, 0x12345678, 3, 0, 0, 0.1},
+	{"slow 200 ppm", -200, 0x9ABCDEF0, 3, 0, 0, 0.1},
+	{"fast 450 ppm", 450, 0, 3, 0, 0, 0.5},		//Only 50 ppm of correction is left to take out the drift before the first alignment
+	{"wrap in begin", 100, 0xFFFFFFFF - 300000, 2, 0, 0, 0.1},
+	{"RTC set ahead 5 s", 100, 0, 3, 1, 5, 0.1},
+	{"RTC set back 2 s", -100, 0, 4, 1, -2, 1.5}
+};
+const int NUM_RUNS = sizeof(runs) / sizeof(runs[0]);
+
+static const Run *run;
+static int64_t trueTime;	//Microseconds since power-up by the RTC's reckoning
+static int64_t rtcStep;		//Microseconds the RTC has been set ahead
+
+//The counter extended to 64 bits, as ticks() should give it
+static uint64_t counter64(void){
+	return run->counterStart + (uint64_t)(trueTime * (1 + run->ppm / 1e6));
+}
+static uint32_t simCounter(void){
+	trueTime += READ_TIME;
+	return (uint32_t)counter64();
+}
+static int64_t rtcTime(void){
+	return START + trueTime + rtcStep;
+}
+static time_t simRtc(time_t *t){
+	time_t sec = (time_t)(rtcTime() / 1000000);
+
+	if(t != nullptr){
+		*t = sec;
+	}
+	return sec;
+}
+
+static bool simulate(const Run &r){
+	Timebase tb;
+	uint64_t t, last = 0, ticks;
+	int64_t end = (int64_t)(r.hours * 3600e6), stepTime = (int64_t)(r.stepAt * 3600e6), settled, error, maxError = 0;
+	uint32_t badTicks = 0, backwards = 0, wraps = 0, lastCount;
+	bool stepped = false;
+
+	run = &r;
+	trueTime = 0;
+	rtcStep = 0;
+	srand(1);
+	tb.counter = simCounter;
+	tb.rtc = simRtc;
+	tb.begin();
+	settled = (int64_t)(r.settle * 3600e6);
+	lastCount = (uint32_t)counter64();
+
+	while(trueTime < end){
+		trueTime += 50 + rand() % 2001;
+		if(stepTime > 0 && !stepped && trueTime >= stepTime){
+			rtcStep = (int64_t)(r.stepBy * 1e6);
+			settled = trueTime + (int64_t)(r.settle * 3600e6);
+			stepped = true;
+		}
+		tb.service();
+		t = tb.now();
+		if(t < last){
+			backwards++;
+		}
+		last = t;
+		ticks = tb.ticks();
+		if(ticks != counter64()){
+			badTicks++;
+		}
+		if((uint32_t)ticks < lastCount){
+			wraps++;
+		}
+		lastCount = (uint32_t)ticks;
+		error = (int64_t)t - rtcTime();
+		if(trueTime >= settled && llabs(error) > maxError){
+			maxError = llabs(error);
+		}
+	}
+
+	printf("%-18s %7.0f %5u %10d %6u %9u %9lld\n", r.name, r.ppm, wraps, tb.ppb(), tb.alignments, backwards, (long long)maxError);
+	if(badTicks > 0){
+		printf("%-18s ticks() was wrong %u times\n", r.name, badTicks);
+	}
+	return badTicks == 0 && backwards == 0 && maxError <= ERROR_LIMIT && wraps > 0;
+}
+
+int main(void){
+	int i, failures = 0;
+
+	printf("%-18s %7s %5s %10s %6s %9s %9s\n", "run", "ppm", "wraps", "ppb", "aligns", "backwards", "error us");
+	for(i = 0; i < NUM_RUNS; i++){
+		if(!simulate(runs[i])){
+			failures++;
+		}
+	}
+	printf("\n%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
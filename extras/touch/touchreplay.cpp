@@ -0,0 +1,188 @@
+/**
+
+@file
+
+touchreplay - replays recorded touch traces through the GestureDecoder and checks the gestures it
+makes.
+
+Build on a desktop computer with the Makefile in extras:
+
+    make -C .. touchreplay
+
+Usage:
+
+    touchreplay traces/tap.trace traces/drag.trace traces/longpress.trace traces/pinch.trace traces/batch.trace
+
+A trace is a text file with one line for each thing that happened, in order:
+
+    s time contacts [x0 y0 [x1 y1]]    The touch controller reported a sample (time in milliseconds)
+    p time                             loop() ran GigaDAQ::handleInputs(): the queued samples are
+                                       fed to the decoder and it is polled at this time
+    > GESTURE [x y]                    The next gesture expected, such as "> PRESS 100 200" or
+                                       "> RELEASE". Without x and y, the position is not checked.
+    # ...                              A comment
+
+The samples go through a TouchQueue and are fed as handleInputs() feeds them, so a trace with
+several samples before a "p" is a loop() that was busy while the finger moved. Every gesture is
+printed. A trace passes if the decoder makes exactly the expected gestures. PASSED is printed if
+every trace passes, otherwise FAILED, and the exit status is 1.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "TouchInput.h"
+
+const int MAX_GESTURES = 256;		//Most gestures checked in a trace
+
+static const char *NAMES[] = {"NONE", "PRESS", "DRAG", "LONG_PRESS", "RELEASE", "PINCH"};
+
+struct Expected {
+	GestureType type;
+	int x, y;			//-1 if the position is not checked
+};
+
+static GestureType gestureType(const char *name){
+	int i;
+
+	for(i = 0; i < (int)(sizeof(NAMES) / sizeof(NAMES[0])); i++){
+		if(strcmp(name, NAMES[i]) == 0){
+			return (GestureType)i;
+		}
+	}
+	return GESTURE_NONE;
+}
+
+//Feeds the queued samples as GigaDAQ::handleInputs() does, then polls
+static int handle(TouchQueue &queue, GestureDecoder &decoder, uint32_t now, Gesture *made, int n){
+	TouchSample s;
+	Gesture g;
+
+	while(queue.pop(s)){
+		do{
+			if(decoder.feed(s, g) && n < MAX_GESTURES){
+				made[n++] = g;
+			}
+		}while(decoder.refeed());
+	}
+	if(decoder.poll(now, g) && n < MAX_GESTURES){
+		made[n++] = g;
+	}
+	return n;
+}
+
+static bool replay(const char *path){
+	FILE *f;
+	char line[200], name[32];
+	TouchQueue queue;
+	GestureDecoder decoder;
+	TouchSample s;
+	Gesture made[MAX_GESTURES];
+	Expected expected[MAX_GESTURES];
+	unsigned int t, contacts, x0, y0, x1, y1;
+	int i, n = 0, e = 0, lineNum = 0, fields;
+	bool ok = true;
+
+	f = fopen(path, "r");
+	if(f == nullptr){
+		printf("%s: cannot open\n", path);
+		return false;
+	}
+	printf("%s:\n", path);
+	while(fgets(line, sizeof(line), f) != nullptr){
+		lineNum++;
+		if(line[0] == 's'){
+			x0 = y0 = x1 = y1 = 0;
+			fields = sscanf(line + 1, "%u %u %u %u %u %u", &t, &contacts, &x0, &y0, &x1, &y1);
+			if(fields < 2){
+				printf("  line %d: a sample needs a time and contacts\n", lineNum);
+				ok = false;
+				continue;
+			}
+			s.t = t;
+			s.contacts = contacts;
+			s.x[0] = x0;
+			s.y[0] = y0;
+			s.x[1] = x1;
+			s.y[1] = y1;
+			queue.push(s);
+		}
+		else if(line[0] == 'p'){
+			if(sscanf(line + 1, "%u", &t) == 1){
+				n = handle(queue, decoder, t, made, n);
+			}
+		}
+		else if(line[0] == '>' && e < MAX_GESTURES){
+			expected[e].x = expected[e].y = -1;
+			if(sscanf(line + 1, "%31s %d %d", name, &expected[e].x, &expected[e].y) >= 1){
+				expected[e].type = gestureType(name);
+				e++;
+			}
+		}
+	}
+	fclose(f);
+
+	for(i = 0; i < n; i++){
+		printf("  %5lu ms %-10s %4u %4u", (unsigned long)made[i].t, NAMES[made[i].type], made[i].x, made[i].y);
+		if(made[i].type == GESTURE_PINCH){
+			printf("  scale %.2f", made[i].scale);
+		}
+		if(i >= e){
+			printf("  <- not expected");
+			ok = false;
+		}
+		else if(made[i].type != expected[i].type || (expected[i].x >= 0 && (made[i].x != expected[i].x || made[i].y != expected[i].y))){
+			printf("  <- expected %s", NAMES[expected[i].type]);
+			if(expected[i].x >= 0){
+				printf(" %d %d", expected[i].x, expected[i].y);
+			}
+			ok = false;
+		}
+		printf("\n");
+	}
+	for(i = n; i < e; i++){
+		printf("  missing    %-10s\n", NAMES[expected[i].type]);
+		ok = false;
+	}
+	return ok;
+}
+
+int main(int argc, char **argv){
+	int i, failures = 0;
+
+	if(argc < 2){
+		printf("Usage: touchreplay file.trace...\n");
+		return 1;
+	}
+	for(i = 1; i < argc; i++){
+		if(!replay(argv[i])){
+			failures++;
+		}
+	}
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,192 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the action queue of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <string.h>
+#include "ActionQueue.h"
+
+static uint32_t microsCounter(void){
+	return micros();
+}
+
+ActionHandler::ActionHandler(){
+	invoker = nullptr;
+	manager = nullptr;
+}
+ActionHandler::ActionHandler(void (*fn)(void)) : ActionHandler(){
+	if(fn != nullptr){
+		memcpy(storage, &fn, sizeof(fn));
+		invoker = [](void *p){ (*(void (**)(void))p)(); };
+		manager = [](void *dst, const void *src){
+			if(src != nullptr) memcpy(dst, src, sizeof(void (*)(void)));
+		};
+	}
+}
+ActionHandler::ActionHandler(std::nullptr_t) : ActionHandler(){
+}
+ActionHandler::ActionHandler(const ActionHandler &other) : ActionHandler(){
+	*this = other;
+}
+ActionHandler &ActionHandler::operator=(const ActionHandler &other){
+	if(this != &other){
+		clear();
+		if(other.manager != nullptr){
+			other.manager(storage, other.storage);
+		}
+		invoker = other.invoker;
+		manager = other.manager;
+	}
+	return *this;
+}
+ActionHandler::~ActionHandler(){
+	clear();
+}
+void ActionHandler::clear(void){
+	if(manager != nullptr){
+		manager(storage, nullptr);
+	}
+	invoker = nullptr;
+	manager = nullptr;
+}
+ActionHandler::operator bool() const{
+	return invoker != nullptr;
+}
+void ActionHandler::operator()(){
+	if(invoker != nullptr){
+		invoker(storage);
+	}
+}
+
+ActionQueue::ActionQueue(){
+	int i;
+
+	counter = microsCounter;
+	dropped = 0;
+	for(i = 0; i < NUM_ACTION_PRIORITIES; i++){
+		handled[i] = 0;
+		maxTime[i] = 0;
+		maxWait[i] = 0;
+		head[i] = 0;
+		tail[i] = 0;
+	}
+	memset(record, 0, sizeof(record));
+	nextRecord = 0;
+}
+bool ActionQueue::post(const ActionHandler &h, ActionPriority priority, const char *name){
+	uint32_t primask;
+	int p = (int)priority, next;
+	bool queued = false;
+
+	if(!h || p < 0 || p >= NUM_ACTION_PRIORITIES){
+		return false;
+	}
+	primask = __get_PRIMASK();
+	__disable_irq();
+	next = (tail[p] + 1) % ACTION_QUEUE_SIZE;
+	if(next != head[p]){
+		Entry &e = entry[p][tail[p]];
+		e.handler = h;
+		strncpy(e.name, name, ACTION_NAME_LEN - 1);
+		e.name[ACTION_NAME_LEN - 1] = '\0';
+		e.posted = counter();
+		tail[p] = next;
+		queued = true;
+	}
+	else{
+		dropped++;
+	}
+	__set_PRIMASK(primask);
+	return queued;
+}
+bool ActionQueue::take(Entry &e, int &priority){
+	uint32_t primask = __get_PRIMASK();
+	bool found = false;
+	int p;
+
+	__disable_irq();
+	for(p = 0; p < NUM_ACTION_PRIORITIES && !found; p++){
+		if(head[p] != tail[p]){
+			e = entry[p][head[p]];		//Copied out, so the entry can be reused while the action runs
+			entry[p][head[p]].handler = ActionHandler();
+			head[p] = (head[p] + 1) % ACTION_QUEUE_SIZE;
+			priority = p;
+			found = true;
+		}
+	}
+	__set_PRIMASK(primask);
+	return found;
+}
+int ActionQueue::run(uint32_t budget){
+	uint32_t start = counter(), begin, took;
+	int p, n = 0;
+	Entry e;
+
+	do{
+		if(!take(e, p)){
+			break;
+		}
+		begin = counter();
+		e.handler();
+		took = counter() - begin;
+		e.handler = ActionHandler();
+
+		ActionRecord &r = record[nextRecord];
+		memcpy(r.name, e.name, ACTION_NAME_LEN);
+		r.priority = p;
+		r.waited = begin - e.posted;
+		r.took = took;
+		nextRecord = (nextRecord + 1) % NUM_ACTION_RECORDS;
+		handled[p]++;
+		if(took > maxTime[p]) maxTime[p] = took;
+		if(r.waited > maxWait[p]) maxWait[p] = r.waited;
+		n++;
+	} while(counter() - start < budget);
+	return n;
+}
+int ActionQueue::pending(void){
+	int p, n = 0;
+
+	for(p = 0; p < NUM_ACTION_PRIORITIES; p++){
+		n += (tail[p] + ACTION_QUEUE_SIZE - head[p]) % ACTION_QUEUE_SIZE;
+	}
+	return n;
+}
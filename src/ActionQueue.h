@@ -0,0 +1,170 @@
+/**
+
+@file
+
+This contains the action queue of the GigaDAQ project, which runs the actions of controls after touch input has been handled instead of in the middle of it. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _ACTION_QUEUE_INCLUDE_
+#define _ACTION_QUEUE_INCLUDE_
+
+#include "Arduino.h"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+const int ACTION_HANDLER_BYTES = 16;	///< Room for the captured variables of an ActionHandler, such as two pointers
+const int ACTION_QUEUE_SIZE = 16;		///< Actions that can wait at each priority
+const int NUM_ACTION_RECORDS = 16;		///< Recent actions whose times are kept in ActionQueue::record
+const int ACTION_NAME_LEN = 12;			///< Longest action name kept in an ActionRecord, including the terminating zero
+
+/** Order in which queued actions run */
+enum ActionPriority {
+	ACTION_HIGH = 0,	/**< Runs before all others, for actions that must feel instant */
+	ACTION_NORMAL = 1,	/**< The default */
+	ACTION_LOW = 2,		/**< Runs when nothing else is waiting, for slow work such as opening files */
+	NUM_ACTION_PRIORITIES = 3	/**< Number of priorities */
+};
+
+/**
+@brief Something to do, such as a plain function or a lambda that captures the variables it works on.
+
+A lambda may capture up to ACTION_HANDLER_BYTES of variables, which are kept inside the handler itself, so no memory is allocated. That is enough for a pointer and an int, or two pointers. Capture larger things by pointer or by reference.
+
+```cpp
+daq.button[0].setHandler([&](){ daq.textbox[0].setDisplayText(String(count++)); });
+```
+*/
+class ActionHandler {
+public:
+	/** Constructor for a handler that does nothing */
+	ActionHandler();
+	/**
+	@brief Constructor for a plain function.
+
+	@param fn A function of the form void f(void), or nullptr for a handler that does nothing
+	*/
+	ActionHandler(void (*fn)(void));
+	/** Constructor for nullptr, a handler that does nothing */
+	ActionHandler(std::nullptr_t);
+	/**
+	@brief Constructor for a lambda or other function object.
+
+	@param f Called with no arguments. Its captured variables must fit in ACTION_HANDLER_BYTES.
+	*/
+	template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, ActionHandler>::value>::type>
+	ActionHandler(F f){
+		static_assert(sizeof(F) <= ACTION_HANDLER_BYTES, "Too much captured for an ActionHandler: capture by pointer or reference");
+		static_assert(alignof(F) <= alignof(double), "ActionHandler cannot align this");
+		new (storage) F(f);
+		invoker = [](void *p){ (*(F *)p)(); };
+		manager = [](void *dst, const void *src){
+			if(src != nullptr){
+				new (dst) F(*(const F *)src);
+			}
+			else{
+				((F *)dst)->~F();
+			}
+		};
+	}
+	/** Copy constructor */
+	ActionHandler(const ActionHandler &other);
+	/** Copy assignment */
+	ActionHandler &operator=(const ActionHandler &other);
+	/** Destructor */
+	~ActionHandler();
+	/** @returns true if the handler does something */
+	explicit operator bool() const;
+	/** Runs the handler */
+	void operator()();
+private:
+	alignas(double) unsigned char storage[ACTION_HANDLER_BYTES];
+	void (*invoker)(void *);						//Calls the object in storage
+	void (*manager)(void *dst, const void *src);	//Copies the object in storage to dst, or destroys dst when src is nullptr
+	void clear(void);
+};
+
+/**
+@brief Time taken by one action that ran.
+*/
+struct ActionRecord {
+	char name[ACTION_NAME_LEN];	///< Name given when the action was queued, usually the control's name
+	uint8_t priority;			///< An ActionPriority
+	uint32_t waited;			///< Microseconds from being queued to starting
+	uint32_t took;				///< Microseconds the action ran
+};
+
+/**
+@brief Holds actions until there is time to run them, highest priority first and in the order they came at each priority.
+
+GigaDAQ queues the actions of buttons and sliders here while it handles touches, and runs them at the end of GigaDAQ::handleInputs(). A slow action, such as one that opens a file, then no longer holds up the handling of the touch that caused it. Actions can also be queued from anywhere else, including interrupts.
+
+The queue is a fixed array, so it never allocates memory. When ACTION_QUEUE_SIZE - 1 actions are already waiting at a priority, more are dropped and counted in dropped.
+*/
+class ActionQueue {
+public:
+	uint32_t (*counter)(void);	///< Microsecond counter for timing actions, micros() unless changed
+	uint32_t dropped;			///< Actions that did not fit in the queue
+	uint32_t handled[NUM_ACTION_PRIORITIES];	///< Actions run at each priority
+	uint32_t maxTime[NUM_ACTION_PRIORITIES];	///< Longest time an action at each priority ran, in microseconds
+	uint32_t maxWait[NUM_ACTION_PRIORITIES];	///< Longest time an action at each priority waited to start, in microseconds
+	ActionRecord record[NUM_ACTION_RECORDS];	///< The most recent actions that ran. nextRecord is the position of the oldest.
+	int nextRecord;				///< Position in record that the next action that runs is written to
+	/** Constructor for an empty queue */
+	ActionQueue();
+	/**
+	@brief Queues an action. Safe to call from interrupts.
+
+	@param h What to do
+	@param priority When to do it compared with other actions
+	@param name Name for record, such as the control's name. Only the first ACTION_NAME_LEN - 1 characters are kept.
+	@returns true if the action was queued, false if the queue at that priority is full or h does nothing
+	*/
+	bool post(const ActionHandler &h, ActionPriority priority = ACTION_NORMAL, const char *name = "");
+	/**
+	@brief Runs queued actions, highest priority first, until none are left or the time is up. At least one action runs if any is waiting, however long it takes.
+
+	@param budget Microseconds after which no more actions are started
+	@returns Number of actions run
+	*/
+	int run(uint32_t budget);
+	/** @returns Number of actions waiting */
+	int pending(void);
+private:
+	struct Entry {
+		ActionHandler handler;
+		char name[ACTION_NAME_LEN];
+		uint32_t posted;
+	};
+	Entry entry[NUM_ACTION_PRIORITIES][ACTION_QUEUE_SIZE];
+	volatile uint8_t head[NUM_ACTION_PRIORITIES];	//Next entry to run at each priority
+	volatile uint8_t tail[NUM_ACTION_PRIORITIES];	//Next free entry at each priority
+	bool take(Entry &e, int &priority);
+};
+
+#endif /* _ACTION_QUEUE_INCLUDE_ */
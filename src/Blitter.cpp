@@ -0,0 +1,383 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the blitters of the GigaDAQ project, which fill and copy blocks of pixels for the draw methods. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+SoftwareBlitter uses only the C standard library. Dma2dBlitter uses the STM32H7 registers from the Arduino mbed core, and falls back to the CPU where they do not exist.
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <string.h>
+#include "Arduino.h"
+#include "Blitter.h"
+
+Blitter::Blitter(){
+	issued = 0;
+	completed = 0;
+}
+uint32_t Blitter::fill(const BlitSurface &dst, int x, int y, int w, int h, uint16_t color){
+	if(x < 0){ w += x; x = 0; }
+	if(y < 0){ h += y; y = 0; }
+	if(x + w > dst.width) w = dst.width - x;
+	if(y + h > dst.height) h = dst.height - y;
+	if(w <= 0 || h <= 0){
+		return 0;
+	}
+	issued++;
+	startFill(dst.pixels + y * dst.stride + x, dst.stride, w, h, color);
+	return issued;
+}
+uint32_t Blitter::copy(const BlitSurface &dst, int x, int y, const BlitSurface &src){
+	int sx = 0, sy = 0, w = src.width, h = src.height;
+
+	if(x < 0){ sx = -x; w += x; x = 0; }
+	if(y < 0){ sy = -y; h += y; y = 0; }
+	if(x + w > dst.width) w = dst.width - x;
+	if(y + h > dst.height) h = dst.height - y;
+	if(w <= 0 || h <= 0){
+		return 0;
+	}
+	issued++;
+	startCopy(dst.pixels + y * dst.stride + x, dst.stride, src.pixels + sy * src.stride + sx, src.stride, w, h);
+	return issued;
+}
+uint32_t Blitter::expand(const BlitSurface &dst, int x, int y, const IndexedSurface &src){
+	int sx = 0, sy = 0, w = src.width, h = src.height;
+
+	if(src.colors <= 0 || src.colors > NUM_PALETTE_COLORS){
+		return 0;
+	}
+	if(x < 0){ sx = -x; w += x; x = 0; }
+	if(y < 0){ sy = -y; h += y; y = 0; }
+	if(x + w > dst.width) w = dst.width - x;
+	if(y + h > dst.height) h = dst.height - y;
+	if(w <= 0 || h <= 0){
+		return 0;
+	}
+	issued++;
+	startExpand(dst.pixels + y * dst.stride + x, dst.stride, src.pixels + sy * src.stride + sx, src.stride, w, h, src.palette, src.colors);
+	return issued;
+}
+bool Blitter::done(uint32_t fence){
+	return (int32_t)(completed - fence) >= 0;	//Still right when the count wraps around
+}
+void Blitter::wait(uint32_t fence){
+	while(!done(fence)){
+		poll();
+		yield();
+	}
+}
+void Blitter::finish(void){
+	wait(issued);
+}
+
+void SoftwareBlitter::startFill(uint16_t *dst, int dstStride, int w, int h, uint16_t color){
+	int i, j;
+
+	for(i = 0; i < w; i++){
+		dst[i] = color;
+	}
+	for(j = 1; j < h; j++){		//Every other row is a copy of the first
+		memcpy(dst + j * dstStride, dst, w * sizeof(uint16_t));
+	}
+	completed = issued;
+}
+void SoftwareBlitter::startCopy(uint16_t *dst, int dstStride, const uint16_t *src, int srcStride, int w, int h){
+	int j;
+
+	if(dstStride == w && srcStride == w){
+		memmove(dst, src, w * h * sizeof(uint16_t));
+	}
+	else{
+		for(j = 0; j < h; j++){
+			memmove(dst + j * dstStride, src + j * srcStride, w * sizeof(uint16_t));
+		}
+	}
+	completed = issued;
+}
+void SoftwareBlitter::startExpand(uint16_t *dst, int dstStride, const uint8_t *src, int srcStride, int w, int h, const uint16_t *palette, int){
+	int i, j;
+
+	for(j = 0; j < h; j++){
+		for(i = 0; i < w; i++){
+			dst[i] = palette[src[i]];
+		}
+		dst += dstStride;
+		src += srcStride;
+	}
+	completed = issued;
+}
+
+#if defined(DMA2D)
+
+static Dma2dBlitter *dma2dOwner = nullptr;		//Object that receives the DMA2D interrupt
+
+static void dma2dInterrupt(void){
+	if(dma2dOwner != nullptr){
+		dma2dOwner->interrupt();
+	}
+}
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+//The cache works on 32-byte lines, so the range is widened to whole lines. bytes is the size of a pixel.
+static void cacheRange(const void *p, int stride, int w, int h, int bytes, uintptr_t &start, int32_t &size){
+	uintptr_t end = (uintptr_t)p + ((h - 1) * stride + w) * bytes;
+
+	start = (uintptr_t)p & ~(uintptr_t)31;
+	size = (int32_t)(((end + 31) & ~(uintptr_t)31) - start);
+}
+static void flushCache(const void *p, int stride, int w, int h, int bytes){
+	uintptr_t start;
+	int32_t size;
+
+	cacheRange(p, stride, w, h, bytes, start, size);
+	SCB_CleanInvalidateDCache_by_Addr((uint32_t *)start, size);
+}
+static void invalidateCache(const void *p, int stride, int w, int h, int bytes){
+	uintptr_t start;
+	int32_t size;
+
+	cacheRange(p, stride, w, h, bytes, start, size);
+	SCB_InvalidateDCache_by_Addr((uint32_t *)start, size);
+}
+#else
+static void flushCache(const void *, int, int, int, int){
+}
+static void invalidateCache(const void *, int, int, int, int){
+}
+#endif
+
+Dma2dBlitter::Dma2dBlitter(){
+	started = 0;
+	head = 0;
+	tail = 0;
+	running = false;
+	loadingClut = false;
+	ready = false;
+	clutColors = 0;
+}
+void Dma2dBlitter::push(const BlitOp &op){
+	uint32_t primask;
+
+	if(!ready){
+		RCC->AHB3ENR |= RCC_AHB3ENR_DMA2DEN;
+		dma2dOwner = this;
+		NVIC_SetVector(DMA2D_IRQn, (uintptr_t)&dma2dInterrupt);
+		NVIC_EnableIRQ(DMA2D_IRQn);
+		ready = true;
+	}
+	while((tail + 1) % NUM_BLITS == head){		//Queue full: wait for the engine to take one
+		poll();
+		yield();
+	}
+	queue[tail] = op;
+	primask = __get_PRIMASK();
+	__disable_irq();
+	tail = (tail + 1) % NUM_BLITS;
+	startNext();
+	__set_PRIMASK(primask);
+}
+void Dma2dBlitter::startNext(void){		//Called with interrupts disabled, or from the interrupt
+	const BlitOp *op;
+
+	if(running || head == tail || (DMA2D->CR & DMA2D_CR_START) || (DMA2D->FGPFCCR & DMA2D_FGPFCCR_START)){	//Busy, nothing to do, or the display library is using the engine
+		return;
+	}
+	op = &queue[head];
+	if(op->colors > 0 && (op->colors != clutColors || memcmp(op->clut, clut, op->colors * sizeof(uint32_t)) != 0)){
+		//The palette goes into the lookup table first, and the interrupt starts the pixels once it is in
+		memcpy(clut, op->clut, op->colors * sizeof(uint32_t));
+		clutColors = op->colors;
+		flushCache(clut, 0, op->colors, 1, sizeof(uint32_t));
+		DMA2D->IFCR = DMA2D_IFCR_CCTCIF | DMA2D_IFCR_CAECIF;
+		DMA2D->FGCMAR = (uintptr_t)clut;
+		DMA2D->FGPFCCR = DMA2D_FGPFCCR_CM_0 | DMA2D_FGPFCCR_CM_2 | ((uint32_t)(op->colors - 1) << DMA2D_FGPFCCR_CS_Pos);	//L8, ARGB8888 table
+		DMA2D->CR = DMA2D_CR_CTCIE | DMA2D_CR_CAEIE;
+		running = true;
+		loadingClut = true;
+		DMA2D->FGPFCCR |= DMA2D_FGPFCCR_START;
+		return;
+	}
+	flushCache(op->dst, op->dstStride, op->w, op->h, sizeof(uint16_t));
+	DMA2D->IFCR = DMA2D_IFCR_CTCIF | DMA2D_IFCR_CTEIF | DMA2D_IFCR_CCEIF;
+	DMA2D->OPFCCR = DMA2D_OPFCCR_CM_1;					//RGB565
+	DMA2D->OMAR = (uintptr_t)op->dst;
+	DMA2D->OOR = op->dstStride - op->w;
+	DMA2D->NLR = ((uint32_t)op->w << DMA2D_NLR_PL_Pos) | (uint32_t)op->h;
+	if(op->src == nullptr){
+		DMA2D->OCOLR = op->color;
+		DMA2D->CR = DMA2D_CR_MODE_0 | DMA2D_CR_MODE_1 | DMA2D_CR_TCIE | DMA2D_CR_TEIE;	//Register to memory
+	}
+	else if(op->colors > 0){
+		flushCache(op->src, op->srcStride, op->w, op->h, sizeof(uint8_t));
+		DMA2D->FGPFCCR = DMA2D_FGPFCCR_CM_0 | DMA2D_FGPFCCR_CM_2 | ((uint32_t)(op->colors - 1) << DMA2D_FGPFCCR_CS_Pos);	//L8, through the table loaded above
+		DMA2D->FGMAR = (uintptr_t)op->src;
+		DMA2D->FGOR = op->srcStride - op->w;
+		DMA2D->CR = DMA2D_CR_MODE_0 | DMA2D_CR_TCIE | DMA2D_CR_TEIE;	//Memory to memory with pixel format conversion
+	}
+	else{
+		flushCache(op->src, op->srcStride, op->w, op->h, sizeof(uint16_t));
+		DMA2D->FGPFCCR = DMA2D_FGPFCCR_CM_1;			//RGB565
+		DMA2D->FGMAR = (uintptr_t)op->src;
+		DMA2D->FGOR = op->srcStride - op->w;
+		DMA2D->CR = DMA2D_CR_TCIE | DMA2D_CR_TEIE;		//Memory to memory
+	}
+	running = true;
+	started++;
+	DMA2D->CR |= DMA2D_CR_START;
+}
+void Dma2dBlitter::interrupt(void){
+	const BlitOp *op;
+
+	if(running && loadingClut){
+		if((DMA2D->ISR & (DMA2D_ISR_CTCIF | DMA2D_ISR_CAEIF)) == 0){
+			return;
+		}
+		DMA2D->CR &= ~(DMA2D_CR_CTCIE | DMA2D_CR_CAEIE);
+		DMA2D->IFCR = DMA2D_IFCR_CCTCIF | DMA2D_IFCR_CAECIF;
+		loadingClut = false;
+		running = false;
+		startNext();		//The same operation, now with its palette in place
+		return;
+	}
+	if(!running || (DMA2D->ISR & (DMA2D_ISR_TCIF | DMA2D_ISR_TEIF)) == 0){
+		return;
+	}
+	//Interrupts off again, so that operations of the display library cannot end up here
+	DMA2D->CR &= ~(DMA2D_CR_TCIE | DMA2D_CR_TEIE);
+	DMA2D->IFCR = DMA2D_IFCR_CTCIF | DMA2D_IFCR_CTEIF;
+	op = &queue[head];
+	invalidateCache(op->dst, op->dstStride, op->w, op->h, sizeof(uint16_t));
+	head = (head + 1) % NUM_BLITS;
+	running = false;
+	completed = completed + 1;
+	startNext();
+}
+void Dma2dBlitter::poll(void){
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if(running){
+		interrupt();		//In case the interrupt is held up
+	}
+	else{
+		startNext();		//In case the engine was busy for the display library
+	}
+	__set_PRIMASK(primask);
+}
+bool Dma2dBlitter::done(uint32_t fence){
+	if(!Blitter::done(fence)){
+		poll();
+		return Blitter::done(fence);
+	}
+	return true;
+}
+void Dma2dBlitter::startFill(uint16_t *dst, int dstStride, int w, int h, uint16_t color){
+	BlitOp op = {};
+
+	op.dst = dst;
+	op.dstStride = dstStride;
+	op.w = w;
+	op.h = h;
+	op.color = color;
+	push(op);
+}
+void Dma2dBlitter::startCopy(uint16_t *dst, int dstStride, const uint16_t *src, int srcStride, int w, int h){
+	BlitOp op = {};
+
+	op.dst = dst;
+	op.src = src;
+	op.dstStride = dstStride;
+	op.srcStride = srcStride;
+	op.w = w;
+	op.h = h;
+	push(op);
+}
+void Dma2dBlitter::startExpand(uint16_t *dst, int dstStride, const uint8_t *src, int srcStride, int w, int h, const uint16_t *palette, int colors){
+	BlitOp op = {};
+	uint32_t r, g, b;
+	int i;
+
+	op.dst = dst;
+	op.src = src;
+	op.dstStride = dstStride;
+	op.srcStride = srcStride;
+	op.w = w;
+	op.h = h;
+	op.colors = colors;
+
+	//RGB565 to ARGB8888 with the top bits repeated below, which the engine turns back into exactly the same RGB565
+	for(i = 0; i < colors; i++){
+		r = (palette[i] >> 11) & 0x1F;
+		g = (palette[i] >> 5) & 0x3F;
+		b = palette[i] & 0x1F;
+		op.clut[i] = 0xFF000000 | ((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2);
+	}
+	push(op);
+}
+
+#else
+
+Dma2dBlitter::Dma2dBlitter(){
+	started = 0;
+	head = 0;
+	tail = 0;
+	running = false;
+	loadingClut = false;
+	ready = false;
+	clutColors = 0;
+}
+void Dma2dBlitter::interrupt(void){
+}
+void Dma2dBlitter::poll(void){
+}
+bool Dma2dBlitter::done(uint32_t fence){
+	return Blitter::done(fence);
+}
+void Dma2dBlitter::startFill(uint16_t *dst, int dstStride, int w, int h, uint16_t color){
+	SoftwareBlitter::startFill(dst, dstStride, w, h, color);
+}
+void Dma2dBlitter::startCopy(uint16_t *dst, int dstStride, const uint16_t *src, int srcStride, int w, int h){
+	SoftwareBlitter::startCopy(dst, dstStride, src, srcStride, w, h);
+}
+void Dma2dBlitter::startExpand(uint16_t *dst, int dstStride, const uint8_t *src, int srcStride, int w, int h, const uint16_t *palette, int colors){
+	SoftwareBlitter::startExpand(dst, dstStride, src, srcStride, w, h, palette, colors);
+}
+
+#endif
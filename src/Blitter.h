@@ -0,0 +1,180 @@
+/**
+
+@file
+
+This contains the blitters of the GigaDAQ project, which fill and copy blocks of pixels for the draw methods, either with the CPU or with the DMA2D graphics engine of the STM32H7. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _BLITTER_INCLUDE_
+#define _BLITTER_INCLUDE_
+
+#include <stdint.h>
+
+const int NUM_BLITS = 8;	///< Operations a Dma2dBlitter can hold waiting for the engine
+const int NUM_PALETTE_COLORS = 16;	///< Most colors in the palette of an IndexedSurface
+
+/**
+@brief A block of RGB565 pixels in memory that a Blitter can draw into, such as the screen buffer of GigaDisplay_GFX or a GFXcanvas16.
+*/
+struct BlitSurface {
+	uint16_t *pixels;	///< First pixel of the top row
+	int width;			///< Pixels per row
+	int height;			///< Rows
+	int stride;			///< Pixels from the start of one row to the start of the next, at least width
+};
+
+/**
+@brief A block of 8-bit pixels that are numbers in a palette of RGB565 colors, such as a GFXcanvas8 that a control was drawn on. A Blitter turns them into colors as it copies them.
+*/
+struct IndexedSurface {
+	const uint8_t *pixels;		///< First pixel of the top row. Every pixel must be less than colors.
+	int width;					///< Pixels per row
+	int height;					///< Rows
+	int stride;					///< Pixels from the start of one row to the start of the next, at least width
+	const uint16_t *palette;	///< RGB565 color of each pixel value
+	int colors;					///< Colors in palette, up to NUM_PALETTE_COLORS
+};
+
+/**
+@brief Base class for moving blocks of pixels. GigaDAQ draws every control through one of these.
+
+fill() and copy() clip the block to the destination and hand the visible part to the implementation, which may finish it later. Each returns a *fence*: a number that done() and wait() accept to check on that operation and all the ones before it. Operations are carried out in the order they were given. A fence of 0 means there was nothing to do.
+
+Until an operation is done, its source must not be freed or changed and its destination must not be read or drawn on by the CPU.
+*/
+class Blitter {
+public:
+	/** Constructor with no operations yet */
+	Blitter();
+	/**
+	@brief Fills a rectangle with one color.
+
+	@param dst Surface to draw in
+	@param x Left edge in pixels
+	@param y Top edge in pixels
+	@param w Width in pixels
+	@param h Height in pixels
+	@param color RGB565 color
+	@returns Fence of the operation
+	*/
+	uint32_t fill(const BlitSurface &dst, int x, int y, int w, int h, uint16_t color);
+	/**
+	@brief Copies a block of pixels.
+
+	@param dst Surface to draw in
+	@param x Left edge of the block in dst
+	@param y Top edge of the block in dst
+	@param src Pixels to copy. Its width and height are the size of the block. It must not overlap the block in dst.
+	@returns Fence of the operation
+	*/
+	uint32_t copy(const BlitSurface &dst, int x, int y, const BlitSurface &src);
+	/**
+	@brief Copies a block of palette pixels, turning each into its RGB565 color.
+
+	@param dst Surface to draw in
+	@param x Left edge of the block in dst
+	@param y Top edge of the block in dst
+	@param src Pixels and palette. Its width and height are the size of the block. The palette may be changed as soon as this returns.
+	@returns Fence of the operation, 0 if the palette has no colors or more than NUM_PALETTE_COLORS
+	*/
+	uint32_t expand(const BlitSurface &dst, int x, int y, const IndexedSurface &src);
+	/** @returns true if the operation with the fence, and every one before it, has finished */
+	virtual bool done(uint32_t fence);
+	/** Waits until the operation with the fence, and every one before it, has finished */
+	void wait(uint32_t fence);
+	/** Waits until every operation has finished */
+	void finish(void);
+	virtual ~Blitter() {}
+protected:
+	uint32_t issued;				//Fence of the last operation given
+	volatile uint32_t completed;	//Fence of the last operation finished
+	/** Fills rows of pixels. The rectangle has already been clipped. */
+	virtual void startFill(uint16_t *dst, int dstStride, int w, int h, uint16_t color) = 0;
+	/** Copies rows of pixels. The block has already been clipped. */
+	virtual void startCopy(uint16_t *dst, int dstStride, const uint16_t *src, int srcStride, int w, int h) = 0;
+	/** Copies rows of palette pixels as colors. The block has already been clipped. */
+	virtual void startExpand(uint16_t *dst, int dstStride, const uint8_t *src, int srcStride, int w, int h, const uint16_t *palette, int colors) = 0;
+	/** Called while waiting, to move unfinished operations along */
+	virtual void poll(void) {}
+};
+
+/**
+@brief A Blitter that uses the CPU. Every operation is finished before fill() or copy() returns.
+
+This is the reference for the Dma2dBlitter: both must leave exactly the same pixels. It also works on a computer, which is how the two are compared (see extras/blitter).
+*/
+class SoftwareBlitter : public Blitter {
+protected:
+	void startFill(uint16_t *dst, int dstStride, int w, int h, uint16_t color) override;
+	void startCopy(uint16_t *dst, int dstStride, const uint16_t *src, int srcStride, int w, int h) override;
+	void startExpand(uint16_t *dst, int dstStride, const uint8_t *src, int srcStride, int w, int h, const uint16_t *palette, int colors) override;
+};
+
+/**
+@brief A Blitter that uses the DMA2D graphics engine of the STM32H7, so the CPU can go on with other work while pixels are moved.
+
+Operations are queued, up to NUM_BLITS of them, and the engine's interrupt starts each one as soon as the one before it finishes. Palette pixels are handed to the engine as they are (its L8 format), with the palette loaded into its color lookup table first, so the colors are filled in on the way to the screen at no cost to the CPU. The table is only loaded again when the palette changes. The data cache is cleaned before the engine reads memory and invalidated after it writes, so the CPU and the engine always see the same pixels.
+
+The GigaDisplay_GFX library also uses DMA2D to send its buffer to the screen. An operation is only started when the engine is idle, and GigaDAQ waits for its operations to finish before letting the library refresh the screen, so the two never get in each other's way.
+
+@note On boards without DMA2D, and on a computer, the operations are done by the CPU as in SoftwareBlitter.
+*/
+class Dma2dBlitter : public SoftwareBlitter {
+public:
+	uint32_t started;	///< Operations given to the engine so far
+	/** Constructor for an engine that is set up on first use */
+	Dma2dBlitter();
+	bool done(uint32_t fence) override;
+	/** Called by the DMA2D interrupt when an operation finishes. Not for use in sketches. */
+	void interrupt(void);
+protected:
+	void startFill(uint16_t *dst, int dstStride, int w, int h, uint16_t color) override;
+	void startCopy(uint16_t *dst, int dstStride, const uint16_t *src, int srcStride, int w, int h) override;
+	void startExpand(uint16_t *dst, int dstStride, const uint8_t *src, int srcStride, int w, int h, const uint16_t *palette, int colors) override;
+	void poll(void) override;
+private:
+	struct BlitOp {
+		uint16_t *dst;
+		const void *src;		//nullptr for a fill
+		int dstStride, srcStride, w, h;
+		uint16_t color;
+		int colors;				//0 unless src is palette pixels
+		uint32_t clut[NUM_PALETTE_COLORS];	//The palette in the engine's ARGB8888 format
+	};
+	BlitOp queue[NUM_BLITS];
+	volatile int head, tail;	//Operations waiting are queue[head] up to but not including queue[tail]
+	volatile bool running;		//True while the engine works on queue[head]
+	volatile bool loadingClut;	//True while the engine loads the palette of queue[head], before its pixels
+	bool ready;					//True once the engine and its interrupt are set up
+	uint32_t clut[NUM_PALETTE_COLORS];	//Palette in the engine's lookup table
+	int clutColors;						//Colors in clut, 0 if none was loaded
+	void push(const BlitOp &op);
+	void startNext(void);
+};
+
+#endif /* _BLITTER_INCLUDE_ */
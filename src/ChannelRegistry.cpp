@@ -0,0 +1,168 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the channel registry of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+Compiler:
+GCC (the __atomic built-in functions)
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "ChannelRegistry.h"
+
+ChannelRegistry::ChannelRegistry(){
+	memset(info, 0, sizeof(info));
+	memset(value, 0, sizeof(value));
+	count = 0;
+}
+int ChannelRegistry::add(const char *name, const char *units, float rate, ChannelType type, int decimals){
+	if(count >= NUM_CHANNELS){
+		return -1;
+	}
+	ChannelInfo &c = info[count];
+	strncpy(c.name, name, CHANNEL_NAME_LEN - 1);
+	c.name[CHANNEL_NAME_LEN - 1] = '\0';
+	strncpy(c.units, units ? units : "", CHANNEL_UNITS_LEN - 1);
+	c.units[CHANNEL_UNITS_LEN - 1] = '\0';
+	c.rate = rate;
+	c.type = type;
+	c.decimals = (decimals < 0) ? 0 : (decimals > 9) ? 9 : decimals;
+	memset(&value[count], 0, sizeof(ChannelValue));
+	return count++;
+}
+int ChannelRegistry::find(const char *name){
+	int i;
+
+	for(i = 0; i < count; i++){
+		if(strcmp(info[i].name, name) == 0){
+			return i;
+		}
+	}
+	return -1;
+}
+void ChannelRegistry::set(int channel, float v, uint64_t t){
+	uint32_t seq, bits;
+
+	if(channel < 0 || channel >= count){
+		return;
+	}
+	ChannelValue &c = value[channel];
+	memcpy(&bits, &v, 4);
+	seq = __atomic_load_n(&c.seq, __ATOMIC_RELAXED);
+	__atomic_store_n(&c.seq, seq + 1, __ATOMIC_RELAXED);		//Odd: readers keep off
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&c.bits, bits, __ATOMIC_RELAXED);
+	__atomic_store_n(&c.timeLow, (uint32_t)t, __ATOMIC_RELAXED);
+	__atomic_store_n(&c.timeHigh, (uint32_t)(t >> 32), __ATOMIC_RELAXED);
+	__atomic_store_n(&c.seq, seq + 2, __ATOMIC_RELEASE);		//Even again, after everything else is written
+}
+void ChannelRegistry::setRow(int first, const float *values, int n, uint64_t t){
+	int i;
+
+	for(i = 0; i < n; i++){
+		set(first + i, values[i], t);
+	}
+}
+bool ChannelRegistry::get(int channel, float &v, uint64_t &t){
+	uint32_t before, after, bits, low, high;
+	int i;
+
+	if(channel < 0 || channel >= count){
+		return false;
+	}
+	ChannelValue &c = value[channel];
+	for(i = 0; i < CHANNEL_READ_TRIES; i++){
+		before = __atomic_load_n(&c.seq, __ATOMIC_ACQUIRE);
+		if(before == 0){
+			return false;
+		}
+		bits = __atomic_load_n(&c.bits, __ATOMIC_RELAXED);
+		low = __atomic_load_n(&c.timeLow, __ATOMIC_RELAXED);
+		high = __atomic_load_n(&c.timeHigh, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		after = __atomic_load_n(&c.seq, __ATOMIC_RELAXED);
+		if(before == after && (before & 1) == 0){
+			memcpy(&v, &bits, 4);
+			t = ((uint64_t)high << 32) | low;
+			return true;
+		}
+	}
+	return false;
+}
+uint32_t ChannelRegistry::version(int channel){
+	if(channel < 0 || channel >= count){
+		return 0;
+	}
+	return __atomic_load_n(&value[channel].seq, __ATOMIC_ACQUIRE) / 2;	//A value still being written does not count yet
+}
+bool ChannelRegistry::changed(int channel, uint32_t &seen){
+	uint32_t v = version(channel);
+
+	if(v == seen){
+		return false;
+	}
+	seen = v;
+	return true;
+}
+int ChannelRegistry::format(int channel, char *buf, int len){
+	uint64_t t;
+	float v;
+	int n;
+
+	if(!get(channel, v, t) || len < 1){
+		return -1;
+	}
+	const ChannelInfo &c = info[channel];
+	switch(c.type){
+		case CHANNEL_INT:
+			n = snprintf(buf, len, "%ld", (long)v);
+			break;
+		case CHANNEL_BOOL:
+			n = snprintf(buf, len, "%s", (v != 0) ? "ON" : "OFF");
+			break;
+		default:
+			n = snprintf(buf, len, "%.*f", c.decimals, (double)v);
+	}
+	if(c.units[0] != '\0' && n >= 0 && n < len){
+		n += snprintf(buf + n, len - n, " %s", c.units);
+	}
+	return (n < len) ? n : len - 1;
+}
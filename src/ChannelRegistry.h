@@ -0,0 +1,151 @@
+/**
+
+@file
+
+This contains the channel registry of the GigaDAQ project, which keeps the newest value of every measured quantity in one place, with its name, units and time stamp, for the display, the data file and the data sinks to read. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _CHANNEL_REGISTRY_INCLUDE_
+#define _CHANNEL_REGISTRY_INCLUDE_
+
+#include <stdint.h>
+
+const int NUM_CHANNELS = 32;			///< Maximum number of channels in a ChannelRegistry
+const int CHANNEL_NAME_LEN = 16;		///< Longest channel name, including the terminating zero
+const int CHANNEL_UNITS_LEN = 8;		///< Longest units, including the terminating zero
+const int CHANNEL_READ_TRIES = 4;		///< Times get() tries before giving up on a channel that is being written
+
+/** Kind of value a channel holds, which decides how it is shown */
+enum ChannelType {
+	CHANNEL_FLOAT = 0,	/**< Measured value, shown with the channel's decimals */
+	CHANNEL_INT = 1,	/**< Count or code, shown without decimals */
+	CHANNEL_BOOL = 2	/**< On or off, shown as ON or OFF */
+};
+
+/**
+@brief Description of a channel.
+*/
+struct ChannelInfo {
+	char name[CHANNEL_NAME_LEN];	///< Name, such as "Tank temp"
+	char units[CHANNEL_UNITS_LEN];	///< Units, such as "degC", empty if none
+	float rate;						///< Expected new values per second, 0 if irregular
+	ChannelType type;				///< Kind of value
+	uint8_t decimals;				///< Digits after the decimal point when shown
+};
+
+/**
+@brief Newest value of a channel, guarded by a sequence number. The sequence number is odd while the value is being written and goes up by 2 with every new value.
+*/
+struct ChannelValue {
+	uint32_t seq;		///< Sequence number, 0 until the first value
+	uint32_t bits;		///< The float value's bits
+	uint32_t timeLow;	///< Low 32 bits of the time stamp in microseconds
+	uint32_t timeHigh;	///< High 32 bits of the time stamp
+};
+
+/**
+@brief The newest value of every channel, which any part of the sketch can read without waiting for, or disturbing, the part that writes it.
+
+Each channel is written by one writer, such as the sensor code, and read by any number of readers, such as text boxes bound to it (Textbox::bindChannel()), recordChannels() and the data sinks. Every value is kept with a sequence number (a seqlock): the writer makes it odd, writes the value and time stamp, and makes it even again, and a reader that finds it odd or changed while reading simply reads again. Writers never wait, and a reader finishes in at most CHANNEL_READ_TRIES attempts, so a reader in loop(), in an interrupt or on the other core can never hold up the writer, and never sees a value with another value's time stamp.
+
+The registry holds no pointers and can be placed at any address, so it can be shared with a sketch on the M4 core: construct one in memory both cores reach and that the M7's data cache does not hold (for example with placement new at an address the MPU makes non-cacheable) and point GigaDAQ::channels at it.
+*/
+class ChannelRegistry {
+public:
+	ChannelInfo info[NUM_CHANNELS];		///< Description of every channel
+	ChannelValue value[NUM_CHANNELS];	///< Newest value of every channel. Use get() and set() rather than reading them directly.
+	int count;							///< Number of channels
+	/** Constructor for a registry without channels */
+	ChannelRegistry();
+	/**
+	@brief Adds a channel.
+
+	@param name Name, up to CHANNEL_NAME_LEN - 1 characters
+	@param units Units, up to CHANNEL_UNITS_LEN - 1 characters
+	@param rate Expected new values per second, 0 if irregular
+	@param type Kind of value
+	@param decimals Digits after the decimal point when shown
+	@returns Number of the channel, or -1 if there are already NUM_CHANNELS channels
+	*/
+	int add(const char *name, const char *units = "", float rate = 0, ChannelType type = CHANNEL_FLOAT, int decimals = 2);
+	/**
+	@param name Name of a channel
+	@returns Number of the channel, or -1 if there is none with that name
+	*/
+	int find(const char *name);
+	/**
+	@brief Sets the newest value of a channel. Only one part of the sketch may write each channel, but it may be an interrupt.
+
+	@param channel Number of the channel
+	@param v The value
+	@param t Time stamp in microseconds, as from GigaDAQ::clock.now()
+	*/
+	void set(int channel, float v, uint64_t t);
+	/**
+	@brief Sets several channels in a row with one time stamp, such as all the values of one sensor reading.
+
+	@param first Number of the first channel
+	@param values Array of values
+	@param n Number of values
+	@param t Time stamp in microseconds
+	*/
+	void setRow(int first, const float *values, int n, uint64_t t);
+	/**
+	@brief Reads the newest value of a channel.
+
+	@param channel Number of the channel
+	@param v Receives the value
+	@param t Receives its time stamp
+	@returns false if the channel has no value yet, does not exist, or was rewritten during every one of CHANNEL_READ_TRIES attempts. v and t are left alone then.
+	*/
+	bool get(int channel, float &v, uint64_t &t);
+	/**
+	@param channel Number of the channel
+	@returns Number of values written to the channel so far
+	*/
+	uint32_t version(int channel);
+	/**
+	@brief Checks whether a channel has had a new value since a reader last looked.
+
+	@param channel Number of the channel
+	@param seen The reader's version of the channel, updated when there is a new value
+	@returns true if there is a new value
+	*/
+	bool changed(int channel, uint32_t &seen);
+	/**
+	@brief Writes the newest value of a channel as text, as a text box shows it, such as "21.06 degC".
+
+	@param channel Number of the channel
+	@param buf Receives the text
+	@param len Size of buf
+	@returns Length of the text, or -1 if the channel has no value or does not exist
+	*/
+	int format(int channel, char *buf, int len);
+};
+
+#endif /* _CHANNEL_REGISTRY_INCLUDE_ */
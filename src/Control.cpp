@@ -46,7 +46,10 @@ SOFTWARE.
 
 #include "Control.h"
 
-Control::Control(){}
+Control::Control(){
+    page = 0;
+    stale = false;
+}
 void Control::setDisplayText(String txt){
     prevDispText = dispText; 	//Place existing dispText string into previous
     							//Difference between the two indicates change
@@ -60,6 +63,7 @@ Event::Event(){
     x = 0;
     y = 0;
     t = 0;
+    gesture = GESTURE_NONE;
 }
 
 MonoBoundingBox maxFont(String dString, unsigned int containerWidth, unsigned int containerHeight){
@@ -98,7 +102,7 @@ MonoBoundingBox maxFont(String dString, unsigned int containerWidth, unsigned in
 		//It was found that a small pad between the string and container is required.
 		//1.5 pixels per side seems to work.
 		
-		if(w < containerWidth - 3 && h < containerHeight - 3){
+		if(w < (int)containerWidth - 3 && h < (int)containerHeight - 3){
 		
 			switch(i){
 				case 1:
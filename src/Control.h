@@ -41,6 +41,7 @@ SOFTWARE.
 #include <Fonts/FreeMonoBold12pt7b.h>
 #include <Fonts/FreeMonoBold18pt7b.h>
 #include <Fonts/FreeMonoBold24pt7b.h>
+#include "TouchInput.h"
 
 /** Pre-defined colors */
 const uint16_t CYAN  = 0x07FF;	///< cyan color (16-bit unsigned integer, 5-6-5 format)
@@ -83,6 +84,8 @@ public:
     String prevDispText; ///< Previous text, useful for detecting changes
     uint16_t fgColor;	///< Foreground color (text color) in 5-6-5 format
     uint16_t bgColor;	///< Background color in 5-6-5 format
+    uint8_t page;		///< Page (screen) the control belongs to. Only controls on the shown page are drawn and touched.
+    bool stale;			///< A redraw was requested while the control's page was not shown
     /**
     Default constructor of a Control
     Initializes objects with safe values
@@ -109,6 +112,7 @@ public:
     unsigned int x;	  ///< x-position of touch point
     unsigned int y;	  ///< y-position of touch point
     uint32_t t;		  ///< Time stamp of when touch occurred
+    GestureType gesture; ///< Gesture that produced the event. GESTURE_NONE when the screen is polled.
     /**
     Constructor for an Event object
     */
@@ -0,0 +1,313 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the closed-loop control tasks of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "ControlLoop.h"
+
+PidController::PidController(){
+	kp = 0;
+	ki = 0;
+	kd = 0;
+	kff = 0;
+	bias = 0;
+	outMin = 0;
+	outMax = 1;
+	filter = 0;
+	antiWindup = true;
+	integral = 0;
+	derivative = 0;
+	lastInput = 0;
+	saturated = false;
+	started = false;
+	startOutput = 0;
+}
+void PidController::setGains(float kp, float ki, float kd, float kff){
+	this->kp = kp;
+	this->ki = ki;
+	this->kd = kd;
+	this->kff = kff;
+}
+void PidController::setLimits(float lo, float hi){
+	outMin = lo;
+	outMax = hi;
+}
+void PidController::reset(float output){
+	started = false;
+	startOutput = output;
+	integral = 0;
+	derivative = 0;
+	saturated = false;
+}
+float PidController::update(float setpoint, float input, float dt){
+	float error = setpoint - input, ff = bias + kff * setpoint, next, u;
+
+	if(!started){
+		started = true;
+		lastInput = input;
+		derivative = 0;
+		//Whatever the integral has to be for this step to give startOutput. It is kept in range with the others below.
+		integral = (ki != 0) ? startOutput - ff - kp * error : 0;
+	}
+	if(dt > 0){
+		u = (input - lastInput) / dt;
+		derivative += (filter > 0) ? (u - derivative) * dt / (filter + dt) : u - derivative;
+	}
+	lastInput = input;
+
+	next = integral + ki * error * dt;
+	u = ff + kp * error + next - kd * derivative;
+	saturated = true;
+	if(u > outMax){
+		u = outMax;
+		if(!antiWindup || error < 0){		//Only let the integral grow back toward the range
+			integral = next;
+		}
+	}
+	else if(u < outMin){
+		u = outMin;
+		if(!antiWindup || error > 0){
+			integral = next;
+		}
+	}
+	else{
+		saturated = false;
+		integral = next;
+	}
+	if(antiWindup){		//Added to the feed-forward, the integral alone never asks for more than the whole range
+		integral = (integral > outMax - ff) ? outMax - ff : (integral < outMin - ff) ? outMin - ff : integral;
+	}
+	return u;
+}
+
+ControlLoop::ControlLoop(){
+	inputChannel = -1;
+	setpointChannel = -1;
+	outputChannel = -1;
+	output = nullptr;
+	interval = 0;
+	enabled = false;
+	lastOutput = 0;
+	setpointBits = 0;
+	inputVersion = 0;
+	due = 0;
+	restart = true;
+	clearStats = false;
+	memset(&stats, 0, sizeof(stats));
+	statSeq = 0;
+}
+
+static uint32_t microsCounter(void){
+	return micros();
+}
+
+ControlScheduler::ControlScheduler(){
+	channels = nullptr;
+	counter = microsCounter;
+	tickInterval = CONTROL_TICK;
+}
+int ControlScheduler::add(int inputChannel, int setpointChannel, int outputChannel, ControlOutput *output, uint32_t interval){
+	int i;
+
+	if(interval == 0){
+		return -1;
+	}
+	for(i = 0; i < NUM_CONTROL_LOOPS; i++){
+		if(loop[i].interval == 0){
+			loop[i] = ControlLoop();
+			loop[i].inputChannel = inputChannel;
+			loop[i].setpointChannel = setpointChannel;
+			loop[i].outputChannel = outputChannel;
+			loop[i].output = output;
+			loop[i].interval = interval;
+			return i;
+		}
+	}
+	return -1;
+}
+void ControlScheduler::start(int n){
+	if(n < 0 || n >= NUM_CONTROL_LOOPS || loop[n].enabled){
+		return;
+	}
+	loop[n].restart = true;
+	loop[n].due = 0;
+	__atomic_store_n(&loop[n].enabled, true, __ATOMIC_RELEASE);		//Last, so the timer sees the rest first
+}
+void ControlScheduler::stop(int n){
+	if(n >= 0 && n < NUM_CONTROL_LOOPS){
+		__atomic_store_n(&loop[n].enabled, false, __ATOMIC_RELEASE);
+	}
+}
+void ControlScheduler::setSetpoint(int n, float v){
+	uint32_t bits;
+
+	if(n >= 0 && n < NUM_CONTROL_LOOPS){
+		memcpy(&bits, &v, 4);
+		__atomic_store_n(&loop[n].setpointBits, bits, __ATOMIC_RELEASE);
+	}
+}
+float ControlScheduler::setpoint(int n){
+	uint32_t bits;
+	float v = 0;
+
+	if(n >= 0 && n < NUM_CONTROL_LOOPS){
+		bits = __atomic_load_n(&loop[n].setpointBits, __ATOMIC_ACQUIRE);
+		memcpy(&v, &bits, 4);
+	}
+	return v;
+}
+void ControlScheduler::run(ControlLoop &c, uint64_t now){
+	uint32_t start = counter(), jitter, exec;
+	uint64_t t, missed = 0;
+	float input, sp;
+	bool fresh, ready;
+
+	if(c.due == 0){
+		c.due = now;
+	}
+	jitter = (uint32_t)((now >= c.due) ? now - c.due : c.due - now);
+
+	//Fixed rate: the next run is due one interval after this one was due, not after it happened
+	c.due += c.interval;
+	if(c.due <= now){
+		missed = (now - c.due) / c.interval + 1;
+		c.due += missed * c.interval;
+	}
+
+	fresh = channels->changed(c.inputChannel, c.inputVersion);
+	ready = channels->get(c.inputChannel, input, t) && !isnan(input);
+	if(c.setpointChannel >= 0){
+		ready = ready && channels->get(c.setpointChannel, sp, t) && !isnan(sp);
+	}
+	else{
+		sp = setpoint(&c - loop);
+	}
+	if(ready){
+		if(c.restart){
+			c.pid.reset(c.lastOutput);		//Bumpless: carries on from where the output is
+			c.restart = false;
+		}
+		c.lastOutput = c.pid.update(sp, input, c.interval * 1e-6f);
+		if(c.output != nullptr){
+			c.output->write(c.lastOutput);
+		}
+		if(c.outputChannel >= 0){
+			channels->set(c.outputChannel, c.lastOutput, now);
+		}
+	}
+	exec = counter() - start;
+
+	//Seqlock, as in ChannelRegistry, so that readStats() never copies half an update
+	__atomic_store_n(&c.statSeq, c.statSeq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	if(c.clearStats){
+		memset(&c.stats, 0, sizeof(c.stats));
+		c.clearStats = false;
+	}
+	c.stats.missed += missed;
+	if(ready){
+		c.stats.runs++;
+		c.stats.lastJitter = jitter;
+		c.stats.totalJitter += jitter;
+		if(jitter > c.stats.maxJitter){
+			c.stats.maxJitter = jitter;
+		}
+		c.stats.lastExec = exec;
+		if(exec > c.stats.maxExec){
+			c.stats.maxExec = exec;
+		}
+	}
+	if(!fresh || !ready){
+		c.stats.stale++;
+	}
+	__atomic_store_n(&c.statSeq, c.statSeq + 1, __ATOMIC_RELEASE);
+}
+void ControlScheduler::tick(uint64_t now){
+	int i;
+
+	if(channels == nullptr){
+		return;
+	}
+	for(i = 0; i < NUM_CONTROL_LOOPS; i++){
+		ControlLoop &c = loop[i];
+		//The ticks come a little late by varying amounts, so a run that is due a little after this tick belongs to it, not the next
+		if(c.interval > 0 && __atomic_load_n(&c.enabled, __ATOMIC_ACQUIRE) && (c.due == 0 || c.due < now + tickInterval / 2)){
+			run(c, now);
+		}
+	}
+}
+bool ControlScheduler::readStats(int n, ControlStats &s){
+	uint32_t before, after;
+	int i;
+
+	if(n < 0 || n >= NUM_CONTROL_LOOPS || loop[n].interval == 0){
+		return false;
+	}
+	ControlLoop &c = loop[n];
+	for(i = 0; i < CHANNEL_READ_TRIES; i++){
+		before = __atomic_load_n(&c.statSeq, __ATOMIC_ACQUIRE);
+		memcpy(&s, &c.stats, sizeof(s));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		after = __atomic_load_n(&c.statSeq, __ATOMIC_RELAXED);
+		if(before == after && (before & 1) == 0){
+			return true;
+		}
+	}
+	return false;
+}
+void ControlScheduler::resetStats(int n){
+	if(n >= 0 && n < NUM_CONTROL_LOOPS){
+		__atomic_store_n(&loop[n].clearStats, true, __ATOMIC_RELEASE);		//The timer clears them, since only it writes them
+	}
+}
+int ControlScheduler::report(int n, char *buf, size_t len){
+	ControlStats s;
+
+	if(!readStats(n, s)){
+		return -1;
+	}
+	return snprintf(buf, len, "loop %d: %lu runs, jitter mean %lu max %lu us, exec max %lu us, %lu missed, %lu stale", n,
+	                (unsigned long)s.runs, (unsigned long)(s.runs ? s.totalJitter / s.runs : 0), (unsigned long)s.maxJitter,
+	                (unsigned long)s.maxExec, (unsigned long)s.missed, (unsigned long)s.stale);
+}
@@ -0,0 +1,239 @@
+/**
+
+@file
+
+This contains the closed-loop control tasks of the GigaDAQ project, which run PID controllers at a fixed rate from a timer, reading their inputs and setpoints from channels and driving outputs such as PWM pins and DACs. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _CONTROL_LOOP_INCLUDE_
+#define _CONTROL_LOOP_INCLUDE_
+
+#include "Arduino.h"
+#include "ChannelRegistry.h"
+
+const int NUM_CONTROL_LOOPS = 8;		///< Maximum number of loops in a ControlScheduler
+const uint32_t CONTROL_TICK = 1000;		///< Default microseconds between ticks of the control timer (1 kHz)
+
+/**
+@brief A PID controller with feed-forward, output limits and anti-windup.
+
+The output is bias + kff * setpoint + kp * error + the integral of ki * error + kd * the rate of change of the input, limited to outMin to outMax. The derivative acts on the input rather than the error, so a step of the setpoint does not kick the output. While the output is held at a limit, the integral stops growing in the direction of that limit, and the integral is kept within the range that, added to bias + kff * setpoint, gives outMin to outMax (anti-windup), so the controller comes off the limit as soon as the error changes sign instead of first unwinding what it piled up.
+*/
+class PidController {
+public:
+	float kp;			///< Proportional gain: output per unit of error
+	float ki;			///< Integral gain: output per unit of error per second
+	float kd;			///< Derivative gain: output per unit of input change per second, with the sign that opposes the change
+	float kff;			///< Feed-forward gain: output per unit of setpoint
+	float bias;			///< Added to the output, such as the output that holds the process at rest
+	float outMin;		///< Smallest output
+	float outMax;		///< Largest output
+	float filter;		///< Time constant in seconds of the low-pass filter on the derivative, 0 for none
+	bool antiWindup;	///< True (the default) to stop the integral growing while the output is held at a limit, and beyond the output range
+	float integral;		///< Integral term, part of the output
+	float derivative;	///< Filtered rate of change of the input, per second
+	float lastInput;	///< Input at the last update()
+	bool saturated;		///< True if the last output was held at a limit
+	/** Constructor for a controller with no gains, limited to 0 to 1 */
+	PidController();
+	/**
+	@brief Sets the gains.
+
+	@param kp Proportional gain
+	@param ki Integral gain, per second
+	@param kd Derivative gain, in seconds
+	@param kff Feed-forward gain
+	*/
+	void setGains(float kp, float ki, float kd, float kff = 0);
+	/**
+	@brief Sets the range of the output, such as 0 to 1 for a PWM duty cycle.
+
+	@param lo Smallest output
+	@param hi Largest output
+	*/
+	void setLimits(float lo, float hi);
+	/**
+	@brief Clears the derivative and the integral, so that the next update() starts afresh.
+
+	@param output Output to continue from, for a bumpless start: the next update() sets the integral so that its output is this value. Without an integral gain the integral stays 0.
+	*/
+	void reset(float output = 0);
+	/**
+	@brief Calculates the output for one step.
+
+	@param setpoint Wanted value of the input
+	@param input Measured value
+	@param dt Seconds since the last step
+	@returns The output, between outMin and outMax
+	*/
+	float update(float setpoint, float input, float dt);
+private:
+	bool started;
+	float startOutput;
+};
+
+/**
+@brief Base class for something a control loop drives, such as MbedPwmOutput or MbedDacOutput.
+*/
+class ControlOutput {
+public:
+	/**
+	@brief Sets the output. Called from the control timer's interrupt, so it must not wait or allocate.
+
+	@param value Output of the controller
+	*/
+	virtual void write(float value) = 0;
+	virtual ~ControlOutput() {}
+};
+
+/**
+@brief How well a control loop has kept to its rate. Jitter is how far from when it was due a run started, early or late, mostly the varying delay before the timer interrupt is served.
+*/
+struct ControlStats {
+	uint32_t runs;			///< Times the controller ran
+	uint32_t missed;		///< Runs skipped because the loop fell more than an interval behind
+	uint32_t stale;			///< Ticks that found no new input value since the run before. The old value is used again, and until the input and setpoint have a value, the controller does not run.
+	uint32_t lastJitter;	///< Jitter of the last run in microseconds
+	uint32_t maxJitter;		///< Largest jitter in microseconds
+	uint64_t totalJitter;	///< Sum of the jitter of all runs in microseconds, for the mean
+	uint32_t lastExec;		///< Microseconds the last run took
+	uint32_t maxExec;		///< Microseconds the longest run took
+};
+
+/**
+@brief One control task: a PidController with its input, setpoint and output, run every interval microseconds.
+*/
+class ControlLoop {
+public:
+	PidController pid;			///< The controller
+	int inputChannel;			///< Channel of the measured value
+	int setpointChannel;		///< Channel the setpoint is read from, such as one a slider is bound to, -1 to use setSetpoint()
+	int outputChannel;			///< Channel the output is written to for display and recording, -1 for none
+	ControlOutput *output;		///< What the output drives, nullptr for none
+	uint32_t interval;			///< Microseconds between runs, best a multiple of the timer tick, 0 for a free loop
+	bool enabled;				///< False while the loop is stopped, with its output left as it was
+	float lastOutput;			///< Output of the last run
+	/** Constructor for a free loop */
+	ControlLoop();
+private:
+	friend class ControlScheduler;
+	uint32_t setpointBits;		//The setpoint from setSetpoint(), as float bits, so that it is handed over in one store
+	uint32_t inputVersion;		//Version of the input channel at the last run
+	uint64_t due;				//When the next run should start, 0 to start at the next tick
+	bool restart;				//Reset the controller at the next run
+	bool clearStats;			//Clear stats at the next run
+	ControlStats stats;
+	uint32_t statSeq;			//Odd while stats are being changed
+};
+
+/**
+@brief Runs control loops at fixed rates from a timer interrupt.
+
+tick() is called from a timer every few hundred microseconds to a few milliseconds (GigaDAQ::startControl() uses an mbed Ticker), and runs each loop that is due. A loop reads its input and setpoint from channels, which the sensor code and sliders (Slider::bindChannel()) write from loop(), so nothing is shared but the seqlocked channel values, and neither side ever waits for the other. The output goes to the loop's ControlOutput and to its output channel, where text boxes and recordChannels() can pick it up.
+
+Loops keep a fixed rate: each run is due one interval after the last was due, however late that one was, and if a loop falls more than an interval behind, the runs that can no longer be on time are skipped and counted. The controller always uses the nominal interval as its time step.
+
+Everything that is changed from loop() while the timer runs (setSetpoint(), start(), stop(), resetStats()) is handed over in single stores, and the statistics are read with readStats(), which retries if the timer changed them while they were being copied.
+*/
+class ControlScheduler {
+public:
+	ControlLoop loop[NUM_CONTROL_LOOPS];	///< The loops
+	ChannelRegistry *channels;				///< Channels the loops read and write. Set by GigaDAQ::startControl().
+	uint32_t (*counter)(void);				///< Free-running 32-bit microsecond counter for timing the runs, micros() unless changed
+	uint32_t tickInterval;					///< Microseconds between calls of tick(). A run starts at the tick nearest to when it is due. Set by GigaDAQ::startControl().
+	/** Constructor for a scheduler without loops */
+	ControlScheduler();
+	/**
+	@brief Adds a loop, stopped. Set its gains and limits with loop[n].pid, then start() it.
+
+	@param inputChannel Channel of the measured value
+	@param setpointChannel Channel the setpoint is read from, -1 to set it with setSetpoint()
+	@param outputChannel Channel the output is written to, -1 for none
+	@param output What the output drives, nullptr for none. It must exist for as long as the loop runs.
+	@param interval Microseconds between runs
+	@returns Number of the loop, or -1 if there are already NUM_CONTROL_LOOPS loops
+	*/
+	int add(int inputChannel, int setpointChannel, int outputChannel, ControlOutput *output, uint32_t interval);
+	/**
+	@brief Starts a loop at the next tick. The controller continues from the loop's last output, so the output does not jump.
+
+	@param n Number of the loop
+	*/
+	void start(int n);
+	/**
+	@brief Stops a loop. Its output stays where it was.
+
+	@param n Number of the loop
+	*/
+	void stop(int n);
+	/**
+	@brief Sets the setpoint of a loop that has no setpoint channel. Safe to call while the timer runs.
+
+	@param n Number of the loop
+	@param v The setpoint
+	*/
+	void setSetpoint(int n, float v);
+	/**
+	@param n Number of the loop
+	@returns The setpoint given with setSetpoint()
+	*/
+	float setpoint(int n);
+	/**
+	@brief Runs the loops that are due. Called from the timer interrupt.
+
+	@param now Current time in microseconds, as from GigaDAQ::clock.now()
+	*/
+	void tick(uint64_t now);
+	/**
+	@brief Copies the statistics of a loop.
+
+	@param n Number of the loop
+	@param s Receives the statistics
+	@returns false if n is not a loop, or the timer kept changing the statistics while they were copied
+	*/
+	bool readStats(int n, ControlStats &s);
+	/**
+	@brief Starts the statistics of a loop over, at its next run.
+
+	@param n Number of the loop
+	*/
+	void resetStats(int n);
+	/**
+	@brief Writes a one-line summary of a loop's statistics, such as "loop 0: 60000 runs, jitter mean 3 max 41 us, exec max 6 us, 0 missed, 12 stale".
+
+	@param n Number of the loop
+	@param buf Receives the text
+	@param len Size of buf
+	@returns Length of the text, as snprintf(), or -1 if n is not a loop
+	*/
+	int report(int n, char *buf, size_t len);
+private:
+	void run(ControlLoop &c, uint64_t now);
+};
+
+#endif /* _CONTROL_LOOP_INCLUDE_ */
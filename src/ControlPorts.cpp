@@ -0,0 +1,74 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the outputs of the GigaDAQ control loops. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+Arduino mbed core (the PWM and DAC functions of the mbed HAL)
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "ControlPorts.h"
+
+//Controller output from lo to hi as a fraction from 0 to 1
+static float fraction(float value, float lo, float hi){
+	float f = (hi != lo) ? (value - lo) / (hi - lo) : 0;
+
+	return (f < 0) ? 0 : (f > 1) ? 1 : f;
+}
+
+MbedPwmOutput::MbedPwmOutput(PinName pin, int period, float lo, float hi){
+	this->lo = lo;
+	this->hi = hi;
+	pwmout_init(&pwm, pin);
+	pwmout_period_us(&pwm, period);
+	pwmout_write(&pwm, 0);
+}
+void MbedPwmOutput::write(float value){		//Called from an interrupt
+	pwmout_write(&pwm, fraction(value, lo, hi));
+}
+
+MbedDacOutput::MbedDacOutput(PinName pin, float lo, float hi){
+	this->lo = lo;
+	this->hi = hi;
+	analogout_init(&dac, pin);
+	analogout_write(&dac, 0);
+}
+void MbedDacOutput::write(float value){		//Called from an interrupt
+	analogout_write(&dac, fraction(value, lo, hi));
+}
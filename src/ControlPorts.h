@@ -0,0 +1,84 @@
+/**
+
+@file
+
+This contains the outputs of the GigaDAQ control loops, which drive PWM pins and the DAC from the control timer's interrupt. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _CONTROL_PORTS_INCLUDE_
+#define _CONTROL_PORTS_INCLUDE_
+
+#include "Arduino.h"
+#include "hal/pwmout_api.h"
+#include "hal/analogout_api.h"
+#include "ControlLoop.h"
+
+/**
+@brief A PWM pin driven by a control loop. The controller's output from lo to hi becomes a duty cycle from 0 to 1.
+
+The pin is written through the mbed HAL directly, which takes no locks, so it is safe from the control timer's interrupt. Do not use analogWrite() on the same pin.
+*/
+class MbedPwmOutput : public ControlOutput {
+public:
+	/**
+	@brief Constructor. The pin starts at duty cycle 0.
+
+	@param pin PWM pin, such as digitalPinToPinName(D5)
+	@param period Microseconds per PWM period, such as 50 for 20 kHz
+	@param lo Controller output for duty cycle 0
+	@param hi Controller output for duty cycle 1
+	*/
+	MbedPwmOutput(PinName pin, int period = 1000, float lo = 0, float hi = 1);
+	void write(float value) override;
+private:
+	pwmout_t pwm;
+	float lo, hi;
+};
+
+/**
+@brief A DAC pin (A12 or A13 on the GIGA R1) driven by a control loop. The controller's output from lo to hi becomes 0 to 3.3 V.
+
+The DAC is written through the mbed HAL directly, which takes no locks, so it is safe from the control timer's interrupt. mbed::AnalogOut locks a mutex, which an interrupt may not.
+*/
+class MbedDacOutput : public ControlOutput {
+public:
+	/**
+	@brief Constructor. The pin starts at 0 V.
+
+	@param pin DAC pin, such as digitalPinToPinName(A12)
+	@param lo Controller output for 0 V
+	@param hi Controller output for full scale
+	*/
+	MbedDacOutput(PinName pin, float lo = 0, float hi = 1);
+	void write(float value) override;
+private:
+	dac_t dac;
+	float lo, hi;
+};
+
+#endif /* _CONTROL_PORTS_INCLUDE_ */
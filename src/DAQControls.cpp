@@ -55,6 +55,19 @@ Button::Button(){
     w = 0;
     h = 0;
     this->buttonUp = nullptr;
+    this->buttonHeld = nullptr;
+    held = false;
+    priority = ACTION_NORMAL;
+    for(int i = 0; i < NUM_BUTTON_STATES; i++){
+        look[i].fgColor = 0;
+        look[i].bgColor = 0;
+        look[i].declared = false;
+    }
+    toggle = false;
+    on = false;
+    enabled = true;
+    pressed = false;
+    drawnState = -1;
 }
 Button::Button(String nm, unsigned int x, unsigned int y, unsigned int w, unsigned int h, uint16_t c1,  uint16_t c2){
     name = nm;
@@ -66,15 +79,106 @@ Button::Button(String nm, unsigned int x, unsigned int y, unsigned int w, unsign
     fgColor = c1;
     bgColor = c2;
     this->buttonUp = nullptr;
+    this->buttonHeld = nullptr;
+    held = false;
+    priority = ACTION_NORMAL;
+    for(int i = 0; i < NUM_BUTTON_STATES; i++){
+        look[i].fgColor = 0;
+        look[i].bgColor = 0;
+        look[i].declared = false;
+    }
+    toggle = false;
+    on = false;
+    enabled = true;
+    pressed = false;
+    drawnState = -1;
 }
 void Button::setAction(void (*du)()){
 	this->buttonUp = du;
 }
+void Button::setHandler(const ActionHandler &h, ActionPriority p){
+	upHandler = h;
+	priority = p;
+}
 void Button::release(){
-	if(buttonUp != nullptr){
+	if(upHandler){
+		upHandler();
+	}
+	else if(buttonUp != nullptr){
 		(*buttonUp)();
 	}
 }
+void Button::setHoldAction(void (*dh)()){
+	this->buttonHeld = dh;
+}
+void Button::setHoldHandler(const ActionHandler &h){
+	heldHandler = h;
+}
+void Button::hold(){
+	if(heldHandler){
+		heldHandler();
+	}
+	else if(buttonHeld != nullptr){
+		(*buttonHeld)();
+	}
+}
+void Button::setLook(ButtonState s, String text, uint16_t fg, uint16_t bg){
+	if(s == BUTTON_NORMAL){
+		setDisplayText(text);
+		fgColor = fg;
+		bgColor = bg;
+		return;
+	}
+	look[s].text = text;
+	look[s].fgColor = fg;
+	look[s].bgColor = bg;
+	look[s].declared = true;
+}
+void Button::setToggle(bool t){
+	toggle = t;
+}
+void Button::setOn(bool o){
+	on = o;
+}
+void Button::setEnabled(bool e){
+	enabled = e;
+	if(!e){
+		pressed = false;
+	}
+}
+ButtonState Button::state(void){
+	if(!enabled){
+		return BUTTON_DISABLED;
+	}
+	if(pressed && look[BUTTON_PRESSED].declared){
+		return BUTTON_PRESSED;
+	}
+	if(on){
+		return BUTTON_ON;
+	}
+	return BUTTON_NORMAL;
+}
+ButtonLook Button::lookOf(ButtonState s){
+	ButtonLook l;
+	uint16_t f, b;
+	
+	if(s != BUTTON_NORMAL && look[s].declared){
+		return look[s];
+	}
+	if(s == BUTTON_DISABLED){
+		l = lookOf(on ? BUTTON_ON : BUTTON_NORMAL);
+		f = l.fgColor;
+		b = l.bgColor;
+		//Halfway between the text and background colors, one channel at a time
+		l.fgColor = (((f >> 11) + (b >> 11)) / 2) << 11 | (((f >> 5 & 0x3F) + (b >> 5 & 0x3F)) / 2) << 5 | ((f & 0x1F) + (b & 0x1F)) / 2;
+		return l;
+	}
+	l.text = dispText;
+	l.fgColor = fgColor;
+	l.bgColor = bgColor;
+	l.declared = false;
+	return l;
+}
 
 Slider::Slider(){
     type = SLIDER;
@@ -88,7 +192,20 @@ Slider::Slider(){
     maxY = 1.0;
     posX = 0.5;
     posY = 0.5;
+    pinchScale = 1.0;
+    moved = false;
+    drawnX = -1;
+    drawnY = -1;
+    actionInterval = 0;
+    lastAction = 0;
+    actionPending = false;
     this->slide = nullptr;
+    this->pinch = nullptr;
+    priority = ACTION_NORMAL;
+    slideQueued = false;
+    pinchQueued = false;
+    channelX = -1;
+    channelY = -1;
 }
 Slider::Slider(String nm, unsigned int x, unsigned int y, unsigned int w, unsigned int h, uint16_t c1,  uint16_t c2){
     name = nm;
@@ -106,7 +223,20 @@ Slider::Slider(String nm, unsigned int x, unsigned int y, unsigned int w, unsign
     maxY = 1.0;
     posX = 0.5;
     posY = 0.5;
+    pinchScale = 1.0;
+    moved = false;
+    drawnX = -1;
+    drawnY = -1;
+    actionInterval = 0;
+    lastAction = 0;
+    actionPending = false;
     this->slide = nullptr;
+    this->pinch = nullptr;
+    priority = ACTION_NORMAL;
+    slideQueued = false;
+    pinchQueued = false;
+    channelX = -1;
+    channelY = -1;
 }
 void Slider::setXlimits(float minimumX, float maximumX){
     minX = minimumX;
@@ -119,6 +249,7 @@ void Slider::setYlimits(float minimumY, float maximumY){
 void Slider::setPosition(float px, float py){
 	posX = px;
 	posY = py;
+	moved = true;
 }
 void Slider::setMode(SliderMode md){
 	mode = md;
@@ -126,17 +257,52 @@ void Slider::setMode(SliderMode md){
 void Slider::setAction(void(*sf)()){
 	this->slide = sf;
 }
+void Slider::bindChannel(int chX, int chY){
+	channelX = chX;
+	channelY = chY;
+}
+void Slider::setActionRate(unsigned int perSecond){
+	if(perSecond == 0){
+		actionInterval = 0;
+	}
+	else{
+		actionInterval = 1000/perSecond;
+	}
+}
+void Slider::setHandler(const ActionHandler &h, ActionPriority p){
+	slideHandler = h;
+	priority = p;
+}
 void Slider::sliderMotion(){
-	if(slide != nullptr){
+	if(slideHandler){
+		slideHandler();
+	}
+	else if(slide != nullptr){
 		(*slide)();
 	}
 }
+void Slider::setPinchAction(void(*pf)()){
+	this->pinch = pf;
+}
+void Slider::setPinchHandler(const ActionHandler &h){
+	pinchHandler = h;
+}
+void Slider::pinchMotion(){
+	if(pinchHandler){
+		pinchHandler();
+	}
+	else if(pinch != nullptr){
+		(*pinch)();
+	}
+}
     
 Textbox::Textbox(){
     type = TEXTBOX;
     name = "";
     w = 0;
     h = 0;
+    channel = -1;
+    shownVersion = 0;
 }
 Textbox::Textbox(String nm, unsigned int x, unsigned int y, unsigned int w, unsigned int h, uint16_t c1,  uint16_t c2){
     name = nm;
@@ -147,4 +313,10 @@ Textbox::Textbox(String nm, unsigned int x, unsigned int y, unsigned int w, unsi
     this->h = h;
     fgColor = c1;
     bgColor = c2;
+    channel = -1;
+    shownVersion = 0;
+}
+void Textbox::bindChannel(int ch){
+    channel = ch;
+    shownVersion = 0;		//Shown at the next update
 }
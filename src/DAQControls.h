@@ -35,6 +35,7 @@ SOFTWARE.
 
 #include <stdio.h>
 #include "Control.h"
+#include "ActionQueue.h"
 
 
 /** Slider modes */
@@ -44,12 +45,42 @@ enum SliderMode {
 	TRACKPAD		/**< Two-dimensional trackpad, x- and y-values available */
 };
 
+/** Looks of a button. GigaDAQ draws each look once and keeps it, so changing between them is a single copy. */
+enum ButtonState {
+	BUTTON_NORMAL = 0,	/**< Not touched. For a toggle switch, switched off. */
+	BUTTON_PRESSED,		/**< A finger is on the button */
+	BUTTON_ON,			/**< A toggle switch that is switched on */
+	BUTTON_DISABLED		/**< Ignores touches */
+};
+const int NUM_BUTTON_STATES = 4;	///< Number of ButtonState values
+
+/**
+@brief Text and colors of a button in one ButtonState.
+*/
+struct ButtonLook {
+	String text;		///< Text shown
+	uint16_t fgColor;	///< Text color in 5-6-5 format
+	uint16_t bgColor;	///< Background color in 5-6-5 format
+	bool declared;		///< True once set with Button::setLook()
+};
+
 /**
 @brief Button class can be used for buttons and toggle switches.
 */
 class Button : public Control {
 public:
     void (*buttonUp)(void); ///< Function to execute once finger leaves button
+    void (*buttonHeld)(void); ///< Function to execute when a finger stays on the button for a long press
+    bool held;			///< True after a long press action ran, so the following release is not also a button up
+    ActionHandler upHandler;	///< Handler to run once finger leaves button, used instead of buttonUp when set
+    ActionHandler heldHandler;	///< Handler to run for a long press, used instead of buttonHeld when set
+    ActionPriority priority;	///< Priority of the button's actions in GigaDAQ::actions
+    ButtonLook look[NUM_BUTTON_STATES];	///< Looks set with setLook(). The normal look is always dispText, fgColor and bgColor.
+    bool toggle;		///< True for a toggle switch, whose release flips on before the action runs
+    bool on;			///< True while a toggle switch is switched on, shown with the BUTTON_ON look
+    bool enabled;		///< False to ignore touches and show the BUTTON_DISABLED look
+    bool pressed;		///< True while a finger is on the button
+    int drawnState;		///< ButtonState when the button was last drawn, -1 if never drawn
     /** Default constructor of a Button object. Initializes with safe values */
     Button();
     /**
@@ -71,9 +102,72 @@ public:
     */
     void setAction(void (*du)());
     /**
+    @brief Sets the UI action which happens when a button is released, as a handler that can carry its own variables.
+    
+    @param h A function or a lambda, such as [&](){ count++; }
+    @param p Priority of the button's actions in GigaDAQ::actions
+    */
+    void setHandler(const ActionHandler &h, ActionPriority p = ACTION_NORMAL);
+    /**
     @brief Execute the action set as the buttonUp action.
     */
     void release();
+    /**
+    @brief Sets the UI action which happens when a finger stays on the button for a long press. Long presses are only detected when touch interrupts are enabled (see GigaDAQ::enableTouchInterrupt()).
+    
+    @param dh A function pointer where the function must be of the form void f(void)
+    */
+    void setHoldAction(void (*dh)());
+    /**
+    @brief Sets the UI action which happens when a finger stays on the button for a long press, as a handler that can carry its own variables.
+    
+    @param h A function or a lambda
+    */
+    void setHoldHandler(const ActionHandler &h);
+    /**
+    @brief Execute the action set as the buttonHeld action.
+    */
+    void hold();
+    /**
+    @brief Sets the text and colors of the button in one of its states.
+    
+    Looks that are not set follow the normal look: BUTTON_ON shows the normal look, BUTTON_DISABLED shows the current look with its text faded into the background, and BUTTON_PRESSED is not shown at all. Setting a BUTTON_PRESSED look gives feedback as soon as a finger lands on the button.
+    
+    @param s State to set the look of. For BUTTON_NORMAL, dispText, fgColor and bgColor are set.
+    @param text Text shown
+    @param fg Foreground color (text color) in 5-6-5 format
+    @param bg Background color in 5-6-5 format
+    */
+    void setLook(ButtonState s, String text, uint16_t fg, uint16_t bg);
+    /**
+    @brief Makes the button a toggle switch. Every release flips on, and the action runs afterward, so it can read on to know which way the switch went.
+    
+    @param t true for a toggle switch
+    */
+    void setToggle(bool t = true);
+    /**
+    @brief Switches a toggle switch on or off without running its action.
+    
+    @param o true for on
+    
+    @note The button is redrawn by the next GigaDAQ::updateDisplays().
+    */
+    void setOn(bool o);
+    /**
+    @brief Lets the button respond to touches or not.
+    
+    @param e false to ignore touches and show the BUTTON_DISABLED look
+    
+    @note The button is redrawn by the next GigaDAQ::updateDisplays().
+    */
+    void setEnabled(bool e);
+    /** @returns The state whose look is shown now */
+    ButtonState state(void);
+    /**
+    @param s A state
+    @returns Text and colors shown in that state, after following the normal look where none was set
+    */
+    ButtonLook lookOf(ButtonState s);
 };
 
 /**
@@ -89,6 +183,21 @@ public:
     float posX;		///< Scaled x-value at current touch point (float)
     float posY;		///< Scaled y-value at current touch point (float)
     void (*slide)(); ///< Action taken after two consecutive events take place within a slider
+    float pinchScale;	///< TRACKPAD only: finger spacing relative to when the current pinch began
+    void (*pinch)(); ///< Action taken when two fingers pinch within a trackpad
+    bool moved;		///< Position changed since the slider was last drawn
+    int drawnX;		///< Width of the fill bar in pixels when last drawn, -1 if never drawn
+    int drawnY;		///< Height of the fill bar in pixels when last drawn, -1 if never drawn
+    uint32_t actionInterval; ///< Minimum milliseconds between slide actions, 0 for no limit
+    uint32_t lastAction;	///< Time stamp of the last slide action
+    bool actionPending;	///< A slide action was held back by actionInterval and still has to run
+    ActionHandler slideHandler;	///< Handler for finger drags, used instead of slide when set
+    ActionHandler pinchHandler;	///< Handler for pinches, used instead of pinch when set
+    ActionPriority priority;	///< Priority of the slider's actions in GigaDAQ::actions
+    bool slideQueued;	///< A slide action is waiting in GigaDAQ::actions. It reads the latest position when it runs, so no other is queued.
+    bool pinchQueued;	///< A pinch action is waiting in GigaDAQ::actions
+    int channelX;		///< Channel of GigaDAQ::channels that receives posX, -1 for none
+    int channelY;		///< Channel of GigaDAQ::channels that receives posY, -1 for none
     /** Default constructor of a Slider object. Initializes with safe values */
     Slider();
     /**
@@ -122,6 +231,8 @@ public:
     
     @param px floating-point value of x-point of slider.
     @param py floating-point value of y-point of slider.
+    
+    @note The slider is redrawn by the next GigaDAQ::updateDisplays().
     */
     void setPosition(float px, float py);
     /**
@@ -137,9 +248,45 @@ public:
     */
     void setAction(void(*sf)());
     /**
+    @brief Sets the UI action which happens when finger is dragged within a slider, as a handler that can carry its own variables.
+    
+    @param h A function or a lambda, such as [&](){ motor.setSpeed(daq.slider[0].posX); }
+    @param p Priority of the slider's actions in GigaDAQ::actions
+    */
+    void setHandler(const ActionHandler &h, ActionPriority p = ACTION_NORMAL);
+    /**
+    @brief Limits how often the slide action runs while a finger is dragged. Positions that arrive in between are not lost: the action runs once more with the latest position when the interval has passed.
+    
+    @param perSecond Maximum number of slide actions per second. 0 removes the limit.
+    */
+    void setActionRate(unsigned int perSecond);
+    /**
+    @brief Publishes the slider's position in channels, such as the setpoint channel of a control loop (see ControlScheduler). GigaDAQ writes the new position as soon as a finger moves the slider, and after setPosition() at the next GigaDAQ::updateDisplays(), so a control loop picks it up without waiting for the slide action.
+    
+    @param chX Number of the channel in GigaDAQ::channels for posX, -1 for none
+    @param chY Number of the channel in GigaDAQ::channels for posY, -1 for none
+    */
+    void bindChannel(int chX, int chY = -1);
+    /**
     @brief Execute the action set as the slide action.
     */
     void sliderMotion();
+    /**
+    @brief Sets the UI action which happens when two fingers pinch within a trackpad. Pinches are only detected when touch interrupts are enabled (see GigaDAQ::enableTouchInterrupt()).
+    
+    @param pf A function pointer where the function must be of the form void f(void)
+    */
+    void setPinchAction(void(*pf)());
+    /**
+    @brief Sets the UI action which happens when two fingers pinch within a trackpad, as a handler that can carry its own variables.
+    
+    @param h A function or a lambda
+    */
+    void setPinchHandler(const ActionHandler &h);
+    /**
+    @brief Execute the action set as the pinch action.
+    */
+    void pinchMotion();
 };
 
 /**
@@ -147,6 +294,8 @@ public:
 */
 class Textbox : public Control {
 public: 
+    int channel;		///< Channel of GigaDAQ::channels shown in the box, -1 when the text is set with setDisplayText()
+    uint32_t shownVersion;	///< Version of the channel that was last put into the display text
 	/** Default constructor of a Textbox object. Initializes with safe values */
     Textbox();
     /**
@@ -161,5 +310,11 @@ public:
     @param c2 Background color in 5-6-5 format
     */
     Textbox(String nm, unsigned int x, unsigned int y, unsigned int w, unsigned int h, uint16_t c1,  uint16_t c2);
+    /**
+    @brief Shows the newest value of a channel, with its units. GigaDAQ::updateDisplays() updates the text whenever the channel gets a new value, so the sketch no longer needs to call setDisplayText().
+    
+    @param ch Number of the channel in GigaDAQ::channels, -1 to go back to setDisplayText()
+    */
+    void bindChannel(int ch);
 };
 #endif /* _DAQ_CONTROLS_INCLUDE_ */
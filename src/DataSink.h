@@ -0,0 +1,60 @@
+/**
+
+@file
+
+This defines the interface for destinations of recorded data in the GigaDAQ project. Samples passed to GigaDAQ::recordSample() are written to the data file on the flash drive and handed to every attached DataSink, such as a TelemetryPublisher. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _DATA_SINK_INCLUDE_
+#define _DATA_SINK_INCLUDE_
+
+#include <stdint.h>
+
+/**
+@brief Base class for anything that receives recorded samples.
+
+write() is called for every sample and must return quickly, so a sink only copies the sample into its own buffer. service() is called from loop() (through GigaDAQ::serviceSinks()) to move buffered data on without waiting.
+*/
+class DataSink {
+public:
+	/**
+	@brief Accepts one sample.
+
+	@param t Time stamp of the sample in microseconds, as from GigaDAQ::clock.now()
+	@param values Array of channel values
+	@param count Number of values in the array
+	*/
+	virtual void write(uint64_t t, const float *values, int count) = 0;
+	/**
+	@brief Moves buffered data on. Must never wait for the other end.
+	*/
+	virtual void service(void) {}
+	virtual ~DataSink() {}
+};
+
+#endif /* _DATA_SINK_INCLUDE_ */
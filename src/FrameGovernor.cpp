@@ -0,0 +1,247 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the frame governor of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include "FrameGovernor.h"
+
+static uint32_t microsCounter(void){
+	return micros();
+}
+
+FrameGovernor::FrameGovernor(){
+	counter = microsCounter;
+	budget = 0;
+	maxInterval = FRAME_MAX_INTERVAL;
+	reserve = FRAME_RESERVE;
+	maxDefer = FRAME_MAX_DEFER;
+	interval = 0;
+	pixelCost = 0;
+	minInterval = 0;
+	frameStart = 0;
+	lastStart = 0;
+	deadline = 0;
+	drawStart = 0;
+	drawPixels = 0;
+	waiting = 0;
+	waitingAge = 0;
+	owed = 0;
+	drawn = 0;
+	deferredNow = 0;
+	deferredLast = 0;
+	leftover = 0;
+	squeezed = false;
+	agedNow = false;
+	inFrame = false;
+	started = false;
+	rateStart = 0;
+	rateFrames = 0;
+	rate = 0;
+	resetStats();
+}
+bool FrameGovernor::start(uint32_t minInterval, uint32_t headroom){
+	uint32_t now = counter(), room, gone;
+	float need;
+
+	this->minInterval = minInterval;
+	if(budget == 0 || interval < minInterval){
+		interval = minInterval;
+	}
+	room = (headroom > reserve) ? headroom - reserve : 0;
+	gone = now - lastStart;
+	if(!started){
+		started = true;
+		rateStart = now;
+	}
+	else if(gone < interval * 1000){
+		return false;
+	}
+	//Room for what was left over, up to the budget, and at least for the redraw that has waited longest
+	need = pixelCost * leftover;
+	if(need > budget){
+		need = budget;
+	}
+	if(need < pixelCost * waiting){
+		need = pixelCost * waiting;
+	}
+	if(budget > 0 && room < need && gone < 2 * interval * 1000){
+		return false;		//Acquisition is due too soon for what was left over: wait for a gap, but not for more than another interval
+	}
+	squeezed = budget > 0 && room < need;		//No gap came in time
+	if(now - rateStart >= 1000000){
+		rate = (uint64_t)rateFrames * 1000000000 / (now - rateStart);
+		rateStart = now;
+		rateFrames = 0;
+	}
+	frames++;
+	rateFrames++;
+	lastStart = frameStart = now;
+	lastHeadroom = headroom;
+	deadline = now + ((budget < room) ? budget : room);
+	owed = (waiting > 0 && waitingAge + 1 >= maxDefer) ? pixelCost * waiting : 0;	//Room kept for a redraw that is now due whatever the budget
+	drawn = 0;
+	deferredLast = deferredNow;
+	deferredNow = 0;
+	leftover = 0;
+	drawPixels = 0;
+	waiting = 0;
+	waitingAge = 0;
+	agedNow = false;
+	inFrame = true;
+	return true;
+}
+void FrameGovernor::measure(uint32_t now){
+	float cost;
+
+	if(drawPixels == 0){
+		return;
+	}
+	cost = (float)(now - drawStart) / drawPixels;
+	pixelCost = (pixelCost == 0) ? cost : pixelCost + (cost - pixelCost) / 4;
+	drawPixels = 0;
+}
+bool FrameGovernor::allow(int waited, uint32_t pixels){
+	uint32_t now = counter();
+	float left;
+
+	if(!inFrame){
+		return false;
+	}
+	measure(now);
+	left = (float)(int32_t)(deadline - now);
+	if(budget > 0 && waited >= maxDefer && !agedNow){		//Waited long enough: drawn even if it doesn't fit, so nothing waits for ever
+		agedNow = true;
+		owed = 0;
+		if(left < pixels * pixelCost){
+			forced++;
+		}
+	}
+	else if(budget > 0 && left - owed < pixels * pixelCost){	//Doesn't fit in what is left of the frame
+		deferred++;
+		deferredNow++;
+		leftover += pixels;
+		if(waiting == 0 || waited > waitingAge){
+			waiting = pixels;
+			waitingAge = waited;
+		}
+		return false;
+	}
+	if(waited > maxWait){
+		maxWait = waited;
+	}
+	drawn++;
+	redraws++;
+	drawStart = counter();
+	drawPixels = pixels;
+	return true;
+}
+void FrameGovernor::finish(void){
+	uint32_t now, step;
+
+	if(!inFrame){
+		return;
+	}
+	now = counter();
+	measure(now);
+	inFrame = false;
+	lastWork = now - frameStart;
+	if(lastWork > maxWork){
+		maxWork = lastWork;
+	}
+	if(budget == 0){
+		return;
+	}
+	if(drawn > 0 && (int32_t)(now - deadline) > 0){		//Took longer than it had: fewer frames, so that acquisition is delayed less often
+		overruns++;
+		step = interval / 2 + 1;
+	}
+	else if((deferredNow > 0 && deferredNow >= deferredLast && deferredLast > 0) || squeezed){
+		//More to draw than fits between the acquisition work, and not getting less: fewer frames, each with more to do
+		step = interval / 4 + 1;
+	}
+	else{
+		step = 0;
+	}
+	if(step > 0){
+		interval = (interval + step < maxInterval) ? interval + step : maxInterval;
+	}
+	else if(interval > minInterval){	//Keeping up: more frames again
+		step = interval / 4 + 1;
+		interval = (interval - minInterval > step) ? interval - step : minInterval;
+	}
+}
+uint32_t FrameGovernor::inputBudget(uint32_t want, uint32_t headroom){
+	uint32_t room;
+
+	if(budget == 0){
+		return want;
+	}
+	room = (headroom > reserve) ? headroom - reserve : 0;
+	return (want < room) ? want : room;
+}
+uint32_t FrameGovernor::untilFrame(void){
+	uint32_t gone = counter() - lastStart;
+
+	if(!started || gone >= interval * 1000){
+		return 0;
+	}
+	return interval * 1000 - gone;
+}
+float FrameGovernor::frameRate(void){
+	return rate / 1000.0f;
+}
+int FrameGovernor::report(char *buf, size_t len){
+	return snprintf(buf, len, "frames %.1f/s every %lu ms, %lu redraws, %lu deferred, %lu forced, wait max %d frames, frame max %lu us, %lu overruns, %.3f us/pixel",
+	                (double)frameRate(), (unsigned long)interval, (unsigned long)redraws, (unsigned long)deferred, (unsigned long)forced,
+	                maxWait, (unsigned long)maxWork, (unsigned long)overruns, (double)pixelCost);
+}
+void FrameGovernor::resetStats(void){
+	frames = 0;
+	redraws = 0;
+	deferred = 0;
+	forced = 0;
+	overruns = 0;
+	maxWait = 0;
+	lastHeadroom = 0;
+	lastWork = 0;
+	maxWork = 0;
+}
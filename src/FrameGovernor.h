@@ -0,0 +1,127 @@
+/**
+
+@file
+
+This contains the frame governor of the GigaDAQ project, which keeps drawing the screen from delaying data acquisition by giving display and input work a time budget in every frame. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _FRAME_GOVERNOR_INCLUDE_
+#define _FRAME_GOVERNOR_INCLUDE_
+
+#include "Arduino.h"
+
+const uint32_t FRAME_MAX_INTERVAL = 250;	///< Default most milliseconds between frames under load (4 per second)
+const uint32_t FRAME_RESERVE = 200;			///< Default microseconds kept free before acquisition work is due
+const int FRAME_MAX_DEFER = 4;				///< Default frames a redraw may be put off before room is kept for it
+
+/**
+@brief Gives the drawing of the screen a time budget in every frame, so that it fits between the data acquisition work, and slows the frames down when drawing still gets in the way.
+
+GigaDAQ::updateDisplays() draws in frames, at most one every GigaDAQ::frameInterval milliseconds. At the start of a frame, the governor is told the headroom: the microseconds until acquisition work is next due, as known from the timers of GigaDAQ::power and the devices of GigaDAQ::sensors. The frame may then draw for budget microseconds, or until reserve microseconds before the work is due, whichever comes first. The governor learns how long drawing takes per pixel, and a redraw is only started if the control is expected to be finished in time. When redraws were left over from the last frame and the work is due too soon for the one that has waited longest, the frame waits for a gap it fits in, but not for more than one more interval.
+
+Feedback to a finger (buttons being pressed) is always drawn at once. Sliders that moved and then text boxes that changed are drawn while they fit, and the rest are deferred to the next frame, which starts with the first control that was deferred, so that all get their turn. Once a redraw has been deferred maxDefer times, the next frame keeps room for it, and the first such redraw in a frame is done even if it does not fit, so nothing waits for ever. When more redraws are waiting than fit between the acquisition work, as with a dozen readings changing all the time, they take turns, and a redraw may wait up to maxDefer frames plus one for each control that is waiting.
+
+When a frame takes longer than it had, because a redraw had to be done anyway or took longer than expected, the frames are spread out by half as much again, up to maxInterval, so acquisition is delayed less often. When frames in a row defer redraws and the number deferred is not getting smaller, or a frame has to start without the headroom for what was left over because none came for a whole interval, they are spread out by a quarter, so that under load there are fewer frames that each do more. Every frame that draws everything it has to in its time brings them closer again, down to GigaDAQ::frameInterval.
+
+With a budget of 0 (the default), nothing is deferred and text boxes are drawn as soon as they change, as without a governor. The frames are still counted.
+*/
+class FrameGovernor {
+public:
+	uint32_t (*counter)(void);	///< Free-running 32-bit microsecond counter, micros() unless changed
+	uint32_t budget;			///< Most microseconds of drawing in a frame, 0 for no limit
+	uint32_t maxInterval;		///< Most milliseconds between frames under load
+	uint32_t reserve;			///< Microseconds kept free before acquisition work is due
+	int maxDefer;				///< Frames a redraw may be put off before room is kept for it, and it is done even if it does not fit
+	uint32_t interval;			///< Milliseconds between frames at present
+	float pixelCost;			///< Microseconds of drawing per pixel, learned from the redraws
+	uint32_t frames;			///< Frames started
+	uint32_t redraws;			///< Redraws done in frames
+	uint32_t deferred;			///< Redraws put off to a later frame
+	uint32_t forced;			///< Redraws done although they did not fit, because they had waited maxDefer frames
+	uint32_t overruns;			///< Frames that took longer than they had
+	int maxWait;				///< Most frames a redraw waited
+	uint32_t lastHeadroom;		///< Microseconds until acquisition work was due at the start of the last frame
+	uint32_t lastWork;			///< Microseconds the last frame took
+	uint32_t maxWork;			///< Microseconds the longest frame took
+	/** Constructor for a governor without a budget */
+	FrameGovernor();
+	/**
+	@brief Starts a frame if it is time for one. Called by GigaDAQ::updateDisplays().
+
+	@param minInterval Least milliseconds between frames
+	@param headroom Microseconds until acquisition work is next due
+	@returns true if a frame was started
+	*/
+	bool start(uint32_t minInterval, uint32_t headroom);
+	/**
+	@brief Decides whether a redraw may be done in the frame that was started. If not, it is counted as deferred. The time until the next call, or finish(), is taken as the time the redraw took.
+
+	@param waited Frames the redraw has been deferred already
+	@param pixels Size of the control in pixels
+	@returns true to draw now, false to leave it for the next frame
+	*/
+	bool allow(int waited, uint32_t pixels);
+	/** Ends the frame that was started and adapts the interval. Called by GigaDAQ::updateDisplays(). */
+	void finish(void);
+	/**
+	@param want Microseconds handleInputs() would like to spend starting queued actions (GigaDAQ::actionBudget)
+	@param headroom Microseconds until acquisition work is next due
+	@returns The microseconds it may spend: want, limited by the headroom less reserve while there is a budget
+	*/
+	uint32_t inputBudget(uint32_t want, uint32_t headroom);
+	/** @returns Microseconds until the next frame is due, 0 if it is due now */
+	uint32_t untilFrame(void);
+	/** @returns Frames per second, averaged over the last second or so */
+	float frameRate(void);
+	/**
+	@brief Writes a one-line summary, such as "frames 12.0/s every 83 ms, 520 redraws, 311 deferred, 40 forced, wait max 9 frames, frame max 2650 us, 38 overruns, 0.100 us/pixel".
+
+	@param buf Receives the text
+	@param len Size of buf
+	@returns Length of the text, as snprintf()
+	*/
+	int report(char *buf, size_t len);
+	/** Starts the statistics over */
+	void resetStats(void);
+private:
+	uint32_t frameStart, lastStart, deadline;
+	uint32_t minInterval;
+	uint32_t drawStart, drawPixels;		//The redraw allowed last, until it is measured
+	uint32_t waiting;					//Pixels of the redraw deferred in the last frame that has waited longest
+	uint32_t leftover;					//Pixels of all the redraws deferred in the last frame
+	int waitingAge;
+	float owed;							//Microseconds kept free in this frame for a redraw that has waited maxDefer frames
+	int drawn;
+	int deferredNow, deferredLast;		//Redraws deferred in this frame and in the one before
+	bool squeezed;						//This frame started without the headroom for what was left over, after waiting an interval for it
+	bool agedNow, inFrame, started;		//agedNow: a redraw that waited maxDefer frames was forced in this frame
+	uint32_t rateStart, rateFrames, rate;
+	void measure(uint32_t now);
+};
+
+#endif /* _FRAME_GOVERNOR_INCLUDE_ */
@@ -0,0 +1,180 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the framebuffers of the GigaDAQ project, which let controls be drawn straight into the buffer that is sent to the screen. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+Libraries:
+Adafruit_GFX.h
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <string.h>
+#include "Framebuffer.h"
+
+Framebuffer::Framebuffer(){
+	frames = 0;
+	pixels = 0;
+	x0 = y0 = x1 = y1 = 0;
+}
+void Framebuffer::mark(int x, int y, int w, int h){
+	if(w <= 0 || h <= 0){
+		return;
+	}
+	if(x1 <= x0){
+		x0 = x;
+		y0 = y;
+		x1 = x + w;
+		y1 = y + h;
+		return;
+	}
+	if(x < x0) x0 = x;
+	if(y < y0) y0 = y;
+	if(x + w > x1) x1 = x + w;
+	if(y + h > y1) y1 = y + h;
+}
+bool Framebuffer::dirty(void){
+	return x1 > x0;
+}
+void Framebuffer::flip(void){
+	BlitSurface b = back();
+
+	if(x0 < 0) x0 = 0;
+	if(y0 < 0) y0 = 0;
+	if(x1 > b.width) x1 = b.width;
+	if(y1 > b.height) y1 = b.height;
+	if(x1 > x0 && y1 > y0){
+		show(x0, y0, x1 - x0, y1 - y0);
+		frames++;
+		pixels += (x1 - x0) * (y1 - y0);
+	}
+	x0 = y0 = x1 = y1 = 0;
+}
+
+MemoryFramebuffer::MemoryFramebuffer(uint16_t *back, uint16_t *front, int width, int height){
+	image.pixels = back;
+	image.width = width;
+	image.height = height;
+	image.stride = width;
+	this->front = image;
+	this->front.pixels = front;
+}
+BlitSurface MemoryFramebuffer::back(void){
+	return image;
+}
+void MemoryFramebuffer::show(int x, int y, int w, int h){
+	int row;
+
+	if(front.pixels == nullptr){
+		return;
+	}
+	for(row = y; row < y + h; row++){
+		memcpy(front.pixels + row * front.stride + x, image.pixels + row * image.stride + x, w * sizeof(uint16_t));
+	}
+}
+
+FramebufferCanvas::FramebufferCanvas(const BlitSurface &fb, uint8_t rotation, int x, int y, int w, int h) : Adafruit_GFX(w, h){
+	this->fb = fb;
+	turn = rotation & 3;
+	left = x;
+	top = y;
+}
+void FramebufferCanvas::drawPixel(int16_t x, int16_t y, uint16_t color){
+	fillRect(x, y, 1, 1, color);
+}
+void FramebufferCanvas::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+	int bx, by, bw, bh, row, i;
+	uint16_t *p;
+
+	//Clip to the window, as a canvas of its size would
+	if(x < 0){ w += x; x = 0; }
+	if(y < 0){ h += y; y = 0; }
+	if(x + w > _width) w = _width - x;
+	if(y + h > _height) h = _height - y;
+	if(w <= 0 || h <= 0){
+		return;
+	}
+
+	//Same turn as GigaDAQ::toScreen(), from the rotated screen to the buffer
+	bx = left + x;
+	by = top + y;
+	bw = w;
+	bh = h;
+	switch(turn){
+		case 1:
+			bx = fb.width - (top + y) - h;
+			by = left + x;
+			bw = h;
+			bh = w;
+			break;
+		case 2:
+			bx = fb.width - (left + x) - w;
+			by = fb.height - (top + y) - h;
+			break;
+		case 3:
+			bx = top + y;
+			by = fb.height - (left + x) - w;
+			bw = h;
+			bh = w;
+			break;
+	}
+
+	//Then to the buffer, as the blitter would
+	if(bx < 0){ bw += bx; bx = 0; }
+	if(by < 0){ bh += by; by = 0; }
+	if(bx + bw > fb.width) bw = fb.width - bx;
+	if(by + bh > fb.height) bh = fb.height - by;
+	if(bw <= 0 || bh <= 0){
+		return;
+	}
+	for(row = 0; row < bh; row++){
+		p = fb.pixels + (by + row) * fb.stride + bx;
+		for(i = 0; i < bw; i++){
+			p[i] = color;
+		}
+	}
+}
+void FramebufferCanvas::fillScreen(uint16_t color){
+	fillRect(0, 0, _width, _height, color);
+}
+void FramebufferCanvas::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color){
+	fillRect(x, y, w, 1, color);
+}
+void FramebufferCanvas::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color){
+	fillRect(x, y, 1, h, color);
+}
@@ -0,0 +1,136 @@
+/**
+
+@file
+
+This contains the framebuffers of the GigaDAQ project, which let controls be drawn straight into the buffer that is sent to the screen instead of on a canvas that is copied there afterwards. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _FRAMEBUFFER_INCLUDE_
+#define _FRAMEBUFFER_INCLUDE_
+
+#include <stdint.h>
+#include <Adafruit_GFX.h>
+#include "Blitter.h"
+
+/**
+@brief Base class for a screen image that is drawn in a back buffer and then shown all at once, such as a DisplayFramebuffer for the Display Shield or a MemoryFramebuffer on a computer.
+
+Drawing code calls mark() for every rectangle it changes in the back buffer. flip() then shows the smallest rectangle that holds all of them, once, however many controls were drawn. Coordinates are those of the back buffer, which for the Display Shield is always in portrait orientation.
+*/
+class Framebuffer {
+public:
+	uint32_t frames;	///< Number of times flip() showed something
+	uint32_t pixels;	///< Pixels shown by all the flips together
+	/** Constructor with nothing marked */
+	Framebuffer();
+	/** @returns The buffer that is drawn in */
+	virtual BlitSurface back(void) = 0;
+	/**
+	@brief Notes that a rectangle of the back buffer was drawn in.
+
+	@param x Left edge in pixels
+	@param y Top edge in pixels
+	@param w Width in pixels
+	@param h Height in pixels
+	*/
+	void mark(int x, int y, int w, int h);
+	/** @returns true if something was marked since the last flip() */
+	bool dirty(void);
+	/** Shows everything marked since the last flip(). Nothing happens if nothing was marked. */
+	void flip(void);
+	virtual ~Framebuffer() {}
+protected:
+	/**
+	@brief Makes a rectangle of the back buffer visible.
+
+	@param x Left edge in pixels
+	@param y Top edge in pixels
+	@param w Width in pixels
+	@param h Height in pixels
+	*/
+	virtual void show(int x, int y, int w, int h) = 0;
+private:
+	int x0, y0, x1, y1;		//Rectangle marked so far, empty when x1 <= x0
+};
+
+/**
+@brief A framebuffer made of plain memory, for trying the drawing code on a computer (see extras/framebuffer).
+
+flip() copies the rectangle that changed from the back image to the front image, which then holds what a screen would show.
+*/
+class MemoryFramebuffer : public Framebuffer {
+public:
+	BlitSurface front;	///< Image that flip() copies to. Its pixels may be nullptr to keep only the back image.
+	/**
+	@brief Constructor for a framebuffer in memory the caller owns.
+
+	@param back Back image, width * height pixels
+	@param front Front image, width * height pixels, or nullptr
+	@param width Pixels per row
+	@param height Rows
+	*/
+	MemoryFramebuffer(uint16_t *back, uint16_t *front, int width, int height);
+	BlitSurface back(void) override;
+protected:
+	void show(int x, int y, int w, int h) override;
+private:
+	BlitSurface image;
+};
+
+/**
+@brief A window of a framebuffer that is drawn on with the usual Adafruit GFX functions, like a canvas, except that the pixels go straight into the back buffer.
+
+The window has its own coordinates, with (0, 0) at its top left corner in the rotation of the screen, and nothing is drawn outside it. The pixels land exactly where a GFXcanvas16 of the same size, with the same rotation, would put them when copied to the window's place on the screen.
+
+@note The back buffer is drawn on by the CPU. Wait for the blitter to finish with it first.
+*/
+class FramebufferCanvas : public Adafruit_GFX {
+public:
+	/**
+	@brief Constructor for a window.
+
+	@param fb Back buffer to draw in, in the screen's own orientation
+	@param rotation Rotation of the screen, 0 to 3 as in Adafruit_GFX::setRotation()
+	@param x Left edge of the window on the rotated screen, in pixels
+	@param y Top edge of the window on the rotated screen, in pixels
+	@param w Width of the window in pixels
+	@param h Height of the window in pixels
+	*/
+	FramebufferCanvas(const BlitSurface &fb, uint8_t rotation, int x, int y, int w, int h);
+	void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+	void fillScreen(uint16_t color) override;
+	void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+	void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+private:
+	BlitSurface fb;
+	uint8_t turn;
+	int left, top;
+};
+
+#endif /* _FRAMEBUFFER_INCLUDE_ */
@@ -48,16 +48,135 @@ SOFTWARE.
 
 */
 
+#include <SDRAM.h>
 #include "GigaDAQ.h"
+
+static GigaDAQ *touchOwner = nullptr;	//Object that receives touch reports from the interrupt
+static Timebase *powerClock = nullptr;	//Clock that GigaDAQ::power reads
+
+static void touchDetected(uint8_t contacts, GDTpoint_t *points){
+	TouchSample s;
+	int i;
+	
+	s.t = millis();
+	s.contacts = contacts;
+	for(i = 0; i < 2 && i < contacts; i++){	//The gestures only need the first two fingers
+		s.x[i] = points[i].x;
+		s.y[i] = points[i].y;
+	}
+	if(touchOwner != nullptr){
+		touchOwner->touchQueue.push(s);
+		touchOwner->power.wake();		//In case loop() is asleep in sleepIfIdle()
+	}
+}
+static uint64_t powerTicks(void){
+	return powerClock->ticks();
+}
       
-GigaDAQ::GigaDAQ(){
-    screenW = GIGA_DS_WIDTH;
-    screenH = GIGA_DS_HEIGHT;
-    rotation = PORTRAIT_USBDOWN;
-    
+ArenaCanvas16::ArenaCanvas16(uint16_t w, uint16_t h, MemoryArena &arena) : GFXcanvas16(w, h, false), arena(arena){
+	size_t bytes = (size_t)w * h * sizeof(uint16_t);
+	
+	buffer = (uint16_t *)arena.alloc(bytes);
+	if(buffer == nullptr){
+		buffer = (uint16_t *)malloc(bytes);
+		buffer_owned = true;		//GFXcanvas16 frees it
+	}
+	if(buffer != nullptr){
+		memset(buffer, 0, bytes);
+	}
+}
+ArenaCanvas16::~ArenaCanvas16(){
+	if(!buffer_owned){
+		arena.release(buffer);
+		buffer = nullptr;
+	}
+}
+
+ArenaCanvas8::ArenaCanvas8(uint16_t w, uint16_t h, MemoryArena &arena) : GFXcanvas8(w, h, false), arena(arena){
+	size_t bytes = (size_t)w * h;
+	
+	buffer = (uint8_t *)arena.alloc(bytes);
+	if(buffer == nullptr){
+		buffer = (uint8_t *)malloc(bytes);
+		buffer_owned = true;		//GFXcanvas8 frees it
+	}
+	if(buffer != nullptr){
+		memset(buffer, 0, bytes);
+	}
+}
+ArenaCanvas8::~ArenaCanvas8(){
+	if(!buffer_owned){
+		arena.release(buffer);
+		buffer = nullptr;
+	}
+}
+
+BufferCanvas16::BufferCanvas16(uint16_t w, uint16_t h, uint16_t *pixels) : GFXcanvas16(w, h, false){
+	buffer = pixels;
+}
+
+BufferCanvas8::BufferCanvas8(uint16_t w, uint16_t h, uint8_t *pixels) : GFXcanvas8(w, h, false){
+	buffer = pixels;
 }
-GigaDAQ::GigaDAQ(DisplayOrientation rotation){
+
+DisplayFramebuffer::DisplayFramebuffer(GigaDisplay_GFX &graph) : graph(graph){
+}
+BlitSurface DisplayFramebuffer::back(void){
+	BlitSurface s = {graph.getBuffer(), (int)GIGA_DS_WIDTH, (int)GIGA_DS_HEIGHT, (int)GIGA_DS_WIDTH};
+	
+	return s;
+}
+void DisplayFramebuffer::show(int, int, int, int){
+	graph.startWrite();		//The library sends the whole buffer, whatever the rectangle
+	graph.endWrite();
+}
+
+GigaDAQ::GigaDAQ() : GigaDAQ(PORTRAIT_USBDOWN){
+}
+GigaDAQ::GigaDAQ(DisplayOrientation rotation) : displayFramebuffer(graph){
     this->rotation = rotation;
+    touchInterrupt = false;
+    pinchSlider = -1;
+    powerClock = &clock;		//The timers and clock then count the same wraps of the counter
+    power.clock = powerTicks;
+    frameInterval = FRAME_INTERVAL;
+    lastFrame = 0;
+    currentPage = 0;
+    for(int i = 0; i < NUM_PAGES; i++){
+        pageCache[i] = nullptr;
+        pageCached[i] = false;
+    }
+    fp = NULL;
+    logOffset = 0;
+    compressor = nullptr;
+    for(int i = 0; i < NUM_SINKS; i++){
+        sink[i] = nullptr;
+    }
+    blitter = &dma2dBlitter;
+    framebuffer = nullptr;
+    frameDepth = 0;
+    indexedCanvases = false;
+    for(int i = 0; i < NUM_BUTTONS; i++){
+        for(int j = 0; j < NUM_BUTTON_STATES; j++){
+            sprite[i][j].pixels = nullptr;
+        }
+    }
+    pressedButton = -1;
+    mirror = nullptr;
+    for(int i = 0; i < NUM_TEXTBOXES; i++){
+        textboxWait[i] = 0;
+    }
+    for(int i = 0; i < NUM_SLIDERS; i++){
+        sliderWait[i] = 0;
+    }
+    nextTextbox = 0;
+    nextSlider = 0;
+    channels = &channelTable;
+    sensorChannel = -1;
+    actionBudget = ACTION_BUDGET;
+    sdramArenaSize = SDRAM_ARENA_SIZE;
+    logBufferSize = LOG_BUFFER_SIZE;
+    logBuffer = nullptr;
     if(rotation == PORTRAIT_USBDOWN || rotation == PORTRAIT_USBUP){
         screenW = GIGA_DS_WIDTH;
         screenH = GIGA_DS_HEIGHT;
@@ -73,6 +192,9 @@ void GigaDAQ::begin(void){
 	
 	graph.begin();
 	touch.begin();
+	if(!sdramArena.ready() && sdramArenaSize > 0){
+		sdramArena.begin("sdram", SDRAM.malloc(sdramArenaSize), sdramArenaSize);
+	}
 	graph.setRotation(rotation);
 	
 	tmStr = time(NULL);				//From the standard C time.h library
@@ -92,164 +214,666 @@ void GigaDAQ::begin(void){
 		set_time(mktime(&timeBD));
 		tmStr = mktime(&timeBD);
 	}
+	clock.begin();
+	power.activity();		//The dimming timeout starts now
+}
+void GigaDAQ::enableTouchInterrupt(void){
+	touchOwner = this;
+	gestures.reset();
+	touchInterrupt = true;
+	touch.onDetect(touchDetected);
+}
+PanelAction::PanelAction(){
+	name = "";
+	fn = nullptr;
+}
+int GigaDAQ::registerAction(String name, void (*fn)(void)){
+	int i;
+	
+	for(i = 0; i < NUM_ACTIONS; i++){		//Replace an action of the same name, otherwise take a free spot
+		if(panelAction[i].fn != nullptr && panelAction[i].name.equals(name)){
+			panelAction[i].fn = fn;
+			return i;
+		}
+	}
+	for(i = 0; i < NUM_ACTIONS; i++){
+		if(panelAction[i].fn == nullptr){
+			panelAction[i].name = name;
+			panelAction[i].fn = fn;
+			return i;
+		}
+	}
+	return -1;
+}
+void (*GigaDAQ::findAction(const char *name))(void){
+	int i;
+	
+	if(name == nullptr || name[0] == '\0'){
+		return nullptr;
+	}
+	for(i = 0; i < NUM_ACTIONS; i++){
+		if(panelAction[i].fn != nullptr && panelAction[i].name.equals(name)){
+			return panelAction[i].fn;
+		}
+	}
+	return nullptr;
+}
+void GigaDAQ::clearControls(void){
+	int i;
+	
+	for(i = 0; i < NUM_BUTTONS; i++){
+		button[i] = Button();
+	}
+	releaseSprites();
+	pressedButton = -1;
+	for(i = 0; i < NUM_SLIDERS; i++){
+		slider[i] = Slider();
+	}
+	for(i = 0; i < NUM_TEXTBOXES; i++){
+		textbox[i] = Textbox();
+	}
+	currentEvent = Event();
+	previousEvent = Event();
+	pinchSlider = -1;
+	for(i = 0; i < NUM_PAGES; i++){
+		invalidatePage(i);
+	}
+}
+bool GigaDAQ::applyPanelRecord(const PanelRecord &r){
+	switch(r.type){
+		case BUTTON:
+			if(r.slot >= NUM_BUTTONS) return false;
+			button[r.slot] = Button(String(r.name), r.x, r.y, r.w, r.h, r.fgColor, r.bgColor);
+			button[r.slot].setDisplayText(String(r.text));
+			button[r.slot].setAction(findAction(r.action));
+			button[r.slot].setHoldAction(findAction(r.action2));
+			button[r.slot].page = r.page;
+			return true;
+		case SLIDER:
+			if(r.slot >= NUM_SLIDERS || r.mode > TRACKPAD) return false;
+			slider[r.slot] = Slider(String(r.name), r.x, r.y, r.w, r.h, r.fgColor, r.bgColor);
+			slider[r.slot].setMode((SliderMode)r.mode);
+			slider[r.slot].setXlimits(r.minX, r.maxX);
+			slider[r.slot].setYlimits(r.minY, r.maxY);
+			slider[r.slot].setPosition(r.posX, r.posY);
+			slider[r.slot].setAction(findAction(r.action));
+			slider[r.slot].setPinchAction(findAction(r.action2));
+			slider[r.slot].page = r.page;
+			return true;
+		case TEXTBOX:
+			if(r.slot >= NUM_TEXTBOXES) return false;
+			textbox[r.slot] = Textbox(String(r.name), r.x, r.y, r.w, r.h, r.fgColor, r.bgColor);
+			textbox[r.slot].setDisplayText(String(r.text));
+			textbox[r.slot].page = r.page;
+			return true;
+		default:
+			return false;
+	}
+}
+int GigaDAQ::loadPanel(String fileName){
+	const int CHUNK = 8;			//Records read per fread(), about 1 kB of stack
+	FILE *pf;
+	char fBuf[256];
+	PanelHeader header;
+	PanelRecord rec[CHUNK];
+	int i, n, remaining, loaded = 0;
+	
+	snprintf(fBuf, 255, "/usb/%s", fileName.c_str());
+	pf = fopen(fBuf, "rb");
+	if(pf == NULL){
+		return -1;
+	}
+	if(fread(&header, sizeof(header), 1, pf) != 1 || header.magic != PANEL_MAGIC || header.version != PANEL_VERSION){
+		fclose(pf);
+		return -1;
+	}
+	
+	clearControls();
+	remaining = header.count;
+	while(remaining > 0){
+		n = fread(rec, sizeof(PanelRecord), min(remaining, CHUNK), pf);
+		if(n <= 0){
+			break;					//Truncated file. Keep what was read.
+		}
+		for(i = 0; i < n; i++){
+			rec[i].name[PANEL_NAME_LEN-1] = '\0';	//Never trust a file to terminate its strings
+			rec[i].text[PANEL_TEXT_LEN-1] = '\0';
+			rec[i].action[PANEL_ACTION_LEN-1] = '\0';
+			rec[i].action2[PANEL_ACTION_LEN-1] = '\0';
+			if(applyPanelRecord(rec[i])){
+				loaded++;
+			}
+		}
+		remaining -= n;
+	}
+	fclose(pf);
+	return loaded;
 }
 //
 // The method behind drawing all of the controls is to draw to a buffer in memory called the "canvas" first and when
 // the canvas is completed, transfer it to the screen as a bitmap in a single function.
 //
+// The screen buffer is always in portrait orientation. The canvas is made with the same rotation as the screen, with
+// its width and height swapped in landscape, so that its pixels are in the same order as the screen buffer's and the
+// transfer is a plain block copy that the blitter (and the DMA2D engine) can do.
+//
+// With indexedCanvases, the canvas holds numbers in a palette of the control's colors instead (black, background and
+// text for buttons and text boxes, background and bar for sliders), and the blitter looks up the colors as it copies.
+//
+// With a framebuffer, the canvas is skipped: controls are drawn through a FramebufferCanvas straight into the back
+// buffer, which puts every pixel where the canvas copy would have, and the changed rectangles are shown together by one
+// flip at the end of the frame.
+//
+BlitSurface GigaDAQ::screenSurface(void){
+	BlitSurface s = {graph.getBuffer(), (int)GIGA_DS_WIDTH, (int)GIGA_DS_HEIGHT, (int)GIGA_DS_WIDTH};
+	
+	if(framebuffer != nullptr){
+		return framebuffer->back();
+	}
+	return s;
+}
+void GigaDAQ::toScreen(int &x, int &y, int &w, int &h){
+	int t;
+	
+	switch(rotation){
+		case PORTRAIT_USBDOWN:
+			break;
+		case LANDSCAPE_USBRIGHT:
+			t = x;
+			x = GIGA_DS_WIDTH - y - h;
+			y = t;
+			t = w;
+			w = h;
+			h = t;
+			break;
+		case PORTRAIT_USBUP:
+			x = GIGA_DS_WIDTH - x - w;
+			y = GIGA_DS_HEIGHT - y - h;
+			break;
+		case LANDSCAPE_USBLEFT:
+			t = y;
+			y = GIGA_DS_HEIGHT - x - w;
+			x = t;
+			t = w;
+			w = h;
+			h = t;
+			break;
+	}
+}
+void GigaDAQ::present(GFXcanvas16 &canvas, int x, int y){
+	int w = canvas.width(), h = canvas.height();
+	BlitSurface src;
+	
+	toScreen(x, y, w, h);
+	src.pixels = canvas.getBuffer();
+	src.width = w;
+	src.height = h;
+	src.stride = w;
+	blitter->copy(screenSurface(), x, y, src);
+	markDirty(x, y, w, h);
+	endBlits();			//The canvas is freed when the caller returns
+}
+void GigaDAQ::presentIndexed(GFXcanvas8 &canvas, const uint16_t *palette, int colors, int x, int y){
+	int w = canvas.width(), h = canvas.height();
+	IndexedSurface src;
+	
+	toScreen(x, y, w, h);
+	src.pixels = canvas.getBuffer();
+	src.width = w;
+	src.height = h;
+	src.stride = w;
+	src.palette = palette;
+	src.colors = colors;
+	blitter->expand(screenSurface(), x, y, src);
+	markDirty(x, y, w, h);
+	endBlits();
+}
+void GigaDAQ::presentSprite(const ButtonSprite &sp, int x, int y){
+	int w = sp.w, h = sp.h;
+	BlitSurface src;
+	IndexedSurface isrc;
+	const uint16_t palette[3] = {0x0000, sp.look.bgColor, sp.look.fgColor};
+	
+	toScreen(x, y, w, h);
+	if(sp.indexed){
+		isrc.pixels = (const uint8_t *)sp.pixels;
+		isrc.width = w;
+		isrc.height = h;
+		isrc.stride = w;
+		isrc.palette = palette;
+		isrc.colors = 3;
+		blitter->expand(screenSurface(), x, y, isrc);
+	}
+	else{
+		src.pixels = (uint16_t *)sp.pixels;
+		src.width = w;
+		src.height = h;
+		src.stride = w;
+		blitter->copy(screenSurface(), x, y, src);
+	}
+	markDirty(x, y, w, h);
+	endBlits();
+}
+void GigaDAQ::endBlits(void){
+	blitter->finish();
+	if(framebuffer != nullptr){
+		if(frameDepth == 0){
+			framebuffer->flip();		//Otherwise endFrame() flips once for the whole frame
+		}
+		return;
+	}
+	graph.startWrite();	//Lets the display library know its buffer changed
+	graph.endWrite();
+}
+void GigaDAQ::markDirty(int x, int y, int w, int h){
+	if(framebuffer != nullptr){
+		framebuffer->mark(x, y, w, h);
+	}
+	if(mirror != nullptr){
+		mirror->mark(x, y, w, h);
+	}
+}
+void GigaDAQ::presentDirect(int x, int y, int w, int h){
+	toScreen(x, y, w, h);
+	markDirty(x, y, w, h);
+	endBlits();
+}
+void GigaDAQ::beginFrame(void){
+	frameDepth++;
+}
+void GigaDAQ::endFrame(void){
+	if(frameDepth > 0 && --frameDepth == 0 && framebuffer != nullptr){
+		blitter->finish();
+		framebuffer->flip();
+	}
+}
+void GigaDAQ::drawLabel(Adafruit_GFX &canvas, const String &text, int cw, int ch, uint16_t fg, uint16_t bg){
+	MonoBoundingBox mbb;
+	
+	canvas.fillScreen(0x0000);
+	canvas.fillRect(0, 0, cw, ch, bg);
+	canvas.setTextWrap(false);
+	canvas.setTextColor(fg);
+	mbb = maxFont(text, cw, ch); //Find the largest font that will fit in the control
+	
+	switch(mbb.fontSize){
+		case MONO9PT:
+			canvas.setFont(&FreeMonoBold9pt7b);
+			break;
+		case MONO12PT:
+			canvas.setFont(&FreeMonoBold12pt7b);
+			break;
+		case MONO18PT:
+			canvas.setFont(&FreeMonoBold18pt7b);
+			break;
+		case MONO24PT:
+			canvas.setFont(&FreeMonoBold24pt7b);
+			break;
+		default:
+			canvas.setFont(&FreeMonoBold9pt7b);
+			break;
+	}
+	canvas.setCursor((cw-mbb.w)/2, ch - (ch-mbb.h)/2);  //Center the text within the control
+	canvas.print(text);
+}
+ButtonSprite *GigaDAQ::buttonSprite(int num, ButtonState s, int cw, int ch){
+	ButtonSprite &sp = sprite[num][s];
+	ButtonLook look = button[num].lookOf(s);
+	size_t bytes = (size_t)cw * ch * (indexedCanvases ? 1 : sizeof(uint16_t));
+	
+	if(sp.pixels != nullptr && sp.w == cw && sp.h == ch && sp.indexed == indexedCanvases){
+		if(sp.look.fgColor == look.fgColor && sp.look.bgColor == look.bgColor && sp.look.text.equals(look.text)){
+			return &sp;			//Drawn before, so only a copy is needed
+		}
+	}
+	else if(sp.pixels != nullptr){
+		blitter->finish();		//It may still be copied from
+		sdramArena.release(sp.pixels);
+		sp.pixels = nullptr;
+	}
+	if(sp.pixels == nullptr){
+		sp.pixels = sdramArena.alloc(bytes);
+		if(sp.pixels == nullptr){
+			return nullptr;
+		}
+	}
+	else{
+		blitter->finish();		//The CPU draws over the old look next
+	}
+	
+	//Canvases on the sprite's pixels, in the same order as the screen buffer, like the canvases in present()
+	if(indexedCanvases){
+		BufferCanvas8 canvas((rotation & 1) ? ch : cw, (rotation & 1) ? cw : ch, (uint8_t *)sp.pixels);
+		canvas.setRotation(rotation);
+		drawLabel(canvas, look.text, cw, ch, 2, 1);
+	}
+	else{
+		BufferCanvas16 canvas((rotation & 1) ? ch : cw, (rotation & 1) ? cw : ch, (uint16_t *)sp.pixels);
+		canvas.setRotation(rotation);
+		drawLabel(canvas, look.text, cw, ch, look.fgColor, look.bgColor);
+	}
+	sp.w = cw;
+	sp.h = ch;
+	sp.indexed = indexedCanvases;
+	sp.look = look;
+	return &sp;
+}
+void GigaDAQ::releaseSprites(void){
+	int i, j;
+	
+	blitter->finish();
+	for(i = 0; i < NUM_BUTTONS; i++){
+		for(j = 0; j < NUM_BUTTON_STATES; j++){
+			sdramArena.release(sprite[i][j].pixels);
+			sprite[i][j].pixels = nullptr;
+		}
+	}
+}
 void GigaDAQ::drawButton(int num){
 	int cw, ch, cx, cy;
-	int fontNo;
-	uint16_t bboxw, bboxh;
-	MonoBoundingBox mbb;
+	ButtonState s;
+	ButtonSprite *sp;
+	ButtonLook look;
+	
+	if(!onCurrentPage(button[num])){		//Drawn when its page is shown
+		button[num].stale = true;
+		return;
+	}
 	
 	cw = button[num].w * screenW / 100; //Convert percentages to pixels
 	ch = button[num].h * screenH / 100;
 	
 	if(cw > 0 && ch > 0){					//Only attempt this if the button has non-zero width and height
-		GFXcanvas16 canvas(cw, ch);
 		cx = button[num].x * screenW / 100;
 		cy = button[num].y * screenH / 100;
+		s = button[num].state();
+		sp = buttonSprite(num, s, cw, ch);
+		look = button[num].lookOf(s);
 		
-		canvas.fillScreen(0x0000);
-		canvas.fillRect(0, 0, cw, ch, button[num].bgColor);
-		canvas.setTextWrap(false);
-		canvas.setTextColor(button[num].fgColor);
-		mbb = maxFont(button[num].dispText, cw, ch); //Find the largest font that will fit in the button
-		
-		switch(mbb.fontSize){
-			case MONO9PT:
-				canvas.setFont(&FreeMonoBold9pt7b);
-				break;
-			case MONO12PT:
-				canvas.setFont(&FreeMonoBold12pt7b);
-				break;
-			case MONO18PT:
-				canvas.setFont(&FreeMonoBold18pt7b);
-				break;
-			case MONO24PT:
-				canvas.setFont(&FreeMonoBold24pt7b);
-				break;
-			default:
-				canvas.setFont(&FreeMonoBold9pt7b);
-				break;
-		}
-		canvas.setCursor((cw-mbb.w)/2, ch - (ch-mbb.h)/2);  //Center the text within the button
-		canvas.print(button[num].dispText);
-		graph.drawRGBBitmap(cx, cy, canvas.getBuffer(), cw, ch);
+		if(sp != nullptr){
+			presentSprite(*sp, cx, cy);
+		}
+		else if(framebuffer != nullptr){
+			blitter->finish();				//The CPU draws on the buffer next
+			FramebufferCanvas canvas(framebuffer->back(), rotation, cx, cy, cw, ch);
+			drawLabel(canvas, look.text, cw, ch, look.fgColor, look.bgColor);
+			presentDirect(cx, cy, cw, ch);
+		}
+		else if(indexedCanvases){
+			const uint16_t palette[3] = {0x0000, look.bgColor, look.fgColor};
+			ArenaCanvas8 canvas((rotation & 1) ? ch : cw, (rotation & 1) ? cw : ch, sdramArena);
+			canvas.setRotation(rotation);
+			drawLabel(canvas, look.text, cw, ch, 2, 1);
+			presentIndexed(canvas, palette, 3, cx, cy);
+		}
+		else{
+			ArenaCanvas16 canvas((rotation & 1) ? ch : cw, (rotation & 1) ? cw : ch, sdramArena);
+			canvas.setRotation(rotation);
+			drawLabel(canvas, look.text, cw, ch, look.fgColor, look.bgColor);
+			present(canvas, cx, cy);
+		}
 		button[num].prevDispText = button[num].dispText;
+		button[num].drawnState = s;
+		button[num].stale = false;
 	}
 }
-void GigaDAQ::drawSlider(int num){  //see drawButton() method for ideas that are similar
-	int cw, ch, cx, cy, smx, smy;
+void GigaDAQ::sliderFill(int num, int cw, int ch, int &smx, int &smy){
 	float fracx, fracy;
 	
+	if(slider[num].mode == VERTICAL){
+		fracx = 1.0;
+	}
+	else{
+		fracx = (slider[num].posX - slider[num].minX)/(slider[num].maxX - slider[num].minX);
+	}
+	smx = (int)(fracx * cw);
+	
+	if(slider[num].mode == HORIZONTAL){
+		fracy = 1.0;
+	}
+	else{
+		fracy = (slider[num].posY - slider[num].minY)/(slider[num].maxY - slider[num].minY);
+	}
+	smy = (int)(fracy * ch);
+	
+	if(smx < 0) smx = 0;			//Positions outside the limits are drawn at the edge
+	if(smx > cw) smx = cw;
+	if(smy < 0) smy = 0;
+	if(smy > ch) smy = ch;
+}
+void GigaDAQ::drawSliderRegion(int num, int rx, int ry, int rw, int rh){  //see drawButton() method for ideas that are similar
+	int cw, ch, cx, cy, smx, smy;
+	
 	cw = slider[num].w * screenW / 100;
 	ch = slider[num].h * screenH / 100;
 	
-	if(cw > 0 && ch > 0){
-		GFXcanvas16 canvas(cw, ch);
+	if(rw > 0 && rh > 0){
 		cx = slider[num].x * screenW / 100;
 		cy = slider[num].y * screenH / 100;
 		
-		canvas.fillScreen(slider[num].bgColor);
-		canvas.drawRect(0, 0, cw, ch, slider[num].fgColor);
+		sliderFill(num, cw, ch, smx, smy);
 		
-		if(slider[num].mode == VERTICAL){
-			fracx = 1.0;
+		//Draw the whole slider shifted so that only the requested piece lands on the canvas
+		if(framebuffer != nullptr){
+			blitter->finish();
+			FramebufferCanvas canvas(framebuffer->back(), rotation, cx+rx, cy+ry, rw, rh);
+			canvas.fillScreen(slider[num].bgColor);
+			canvas.drawRect(-rx, -ry, cw, ch, slider[num].fgColor);
+			canvas.fillRect(-rx, ch-smy-ry, smx, smy, slider[num].fgColor);
+			presentDirect(cx+rx, cy+ry, rw, rh);
 		}
-		else{
-			fracx = (slider[num].posX - slider[num].minX)/(slider[num].maxX - slider[num].minX);
-		}
-		smx = (int)(fracx * cw);
-		
-		if(slider[num].mode == HORIZONTAL){
-			fracy = 1.0;
+		else if(indexedCanvases){
+			const uint16_t palette[2] = {slider[num].bgColor, slider[num].fgColor};
+			ArenaCanvas8 canvas((rotation & 1) ? rh : rw, (rotation & 1) ? rw : rh, sdramArena);
+			canvas.setRotation(rotation);
+			canvas.fillScreen(0);
+			canvas.drawRect(-rx, -ry, cw, ch, 1);
+			canvas.fillRect(-rx, ch-smy-ry, smx, smy, 1);
+			presentIndexed(canvas, palette, 2, cx+rx, cy+ry);
 		}
 		else{
-			fracy = (slider[num].posY - slider[num].minY)/(slider[num].maxY - slider[num].minY);
+			ArenaCanvas16 canvas((rotation & 1) ? rh : rw, (rotation & 1) ? rw : rh, sdramArena);
+			canvas.setRotation(rotation);
+			canvas.fillScreen(slider[num].bgColor);
+			canvas.drawRect(-rx, -ry, cw, ch, slider[num].fgColor);
+			canvas.fillRect(-rx, ch-smy-ry, smx, smy, slider[num].fgColor);
+			present(canvas, cx+rx, cy+ry);
 		}
-		smy = (int)(fracy * ch);
-		
-		canvas.fillRect(0, ch-smy, smx, smy, slider[num].fgColor);
-		
-		
-		graph.drawRGBBitmap(cx, cy, canvas.getBuffer(), cw, ch);
 	}
 }
+void GigaDAQ::drawSlider(int num){
+	int cw, ch;
+	
+	if(!onCurrentPage(slider[num])){
+		slider[num].stale = true;
+		return;
+	}
+	
+	cw = slider[num].w * screenW / 100;
+	ch = slider[num].h * screenH / 100;
+	
+	if(cw > 0 && ch > 0){
+		drawSliderRegion(num, 0, 0, cw, ch);
+		sliderFill(num, cw, ch, slider[num].drawnX, slider[num].drawnY);
+		slider[num].moved = false;
+		slider[num].stale = false;
+	}
+}
+void GigaDAQ::updateSlider(int num){
+	int cw, ch, smx, smy, lo, hi;
+	
+	cw = slider[num].w * screenW / 100;
+	ch = slider[num].h * screenH / 100;
+	
+	if(cw <= 0 || ch <= 0 || !onCurrentPage(slider[num])){
+		return;
+	}
+	if(slider[num].stale || slider[num].drawnX < 0 || slider[num].drawnY < 0){
+		drawSlider(num);
+		return;
+	}
+	
+	sliderFill(num, cw, ch, smx, smy);
+	
+	//Only the strips between the old and new edges of the fill bar change color.
+	if(smx != slider[num].drawnX){
+		lo = min(smx, slider[num].drawnX);
+		hi = max(smx, slider[num].drawnX);
+		drawSliderRegion(num, lo, 0, hi - lo, ch);
+	}
+	if(smy != slider[num].drawnY){
+		lo = ch - max(smy, slider[num].drawnY);
+		hi = ch - min(smy, slider[num].drawnY);
+		drawSliderRegion(num, 0, lo, cw, hi - lo);
+	}
+	slider[num].drawnX = smx;
+	slider[num].drawnY = smy;
+	slider[num].moved = false;
+}
 void GigaDAQ::drawTextbox(int num){ //see drawButton() method for ideas that are similar
-	int cw, ch, cx, cy, fontNo;
-	uint16_t bboxw, bboxh;
-	MonoBoundingBox mbb;
+	int cw, ch, cx, cy;
+	
+	if(!onCurrentPage(textbox[num])){
+		textbox[num].stale = true;
+		return;
+	}
 	
 	cw = textbox[num].w * screenW / 100;
 	ch = textbox[num].h * screenH / 100;
 	
 	if(cw > 0 && ch > 0){
-		GFXcanvas16 canvas(cw, ch);
 		cx = textbox[num].x * screenW / 100;
 		cy = textbox[num].y * screenH / 100;
 		
-		canvas.fillScreen(0x0000);
-		canvas.fillRect(0, 0, cw, ch, textbox[num].bgColor);
-		canvas.setTextWrap(false);
-		canvas.setTextColor(textbox[num].fgColor);
-		
-		mbb = maxFont(textbox[num].dispText, cw, ch);
-		
-		switch(mbb.fontSize){
-			case MONO9PT:
-				canvas.setFont(&FreeMonoBold9pt7b);
-				break;
-			case MONO12PT:
-				canvas.setFont(&FreeMonoBold12pt7b);
-				break;
-			case MONO18PT:
-				canvas.setFont(&FreeMonoBold18pt7b);
-				break;
-			case MONO24PT:
-				canvas.setFont(&FreeMonoBold24pt7b);
-				break;
-			default:
-				canvas.setFont(&FreeMonoBold9pt7b);
-				break;
-		}
-		canvas.setCursor((cw-mbb.w)/2, ch - (ch-mbb.h)/2);
-		
-		canvas.print(textbox[num].dispText);
-		graph.drawRGBBitmap(cx, cy, canvas.getBuffer(), cw, ch);
+		if(framebuffer != nullptr){
+			blitter->finish();
+			FramebufferCanvas canvas(framebuffer->back(), rotation, cx, cy, cw, ch);
+			drawLabel(canvas, textbox[num].dispText, cw, ch, textbox[num].fgColor, textbox[num].bgColor);
+			presentDirect(cx, cy, cw, ch);
+		}
+		else if(indexedCanvases){
+			const uint16_t palette[3] = {0x0000, textbox[num].bgColor, textbox[num].fgColor};
+			ArenaCanvas8 canvas((rotation & 1) ? ch : cw, (rotation & 1) ? cw : ch, sdramArena);
+			canvas.setRotation(rotation);
+			drawLabel(canvas, textbox[num].dispText, cw, ch, 2, 1);
+			presentIndexed(canvas, palette, 3, cx, cy);
+		}
+		else{
+			ArenaCanvas16 canvas((rotation & 1) ? ch : cw, (rotation & 1) ? cw : ch, sdramArena);
+			canvas.setRotation(rotation);
+			drawLabel(canvas, textbox[num].dispText, cw, ch, textbox[num].fgColor, textbox[num].bgColor);
+			present(canvas, cx, cy);
+		}
 		textbox[num].prevDispText = textbox[num].dispText;
+		textbox[num].stale = false;
+	}
+}
+bool GigaDAQ::onCurrentPage(const Control &c){
+	return c.page == currentPage;
+}
+uint32_t GigaDAQ::controlPixels(const Control &c){
+	return (uint32_t)(c.w * screenW / 100) * (c.h * screenH / 100);
+}
+void GigaDAQ::invalidatePage(int num){
+	if(num >= 0 && num < NUM_PAGES){
+		pageCached[num] = false;
+	}
+}
+void GigaDAQ::showPage(int num){
+	const size_t PAGE_BYTES = GIGA_DS_WIDTH * GIGA_DS_HEIGHT * sizeof(uint16_t);
+	BlitSurface cache = screenSurface();
+	int i;
+	
+	if(num < 0 || num >= NUM_PAGES || num == currentPage){
+		return;
+	}
+	
+	//Keep the image of the page being left. Pages that are never shown never use SDRAM.
+	if(pageCache[currentPage] == nullptr){
+		pageCache[currentPage] = (uint16_t *)sdramArena.alloc(PAGE_BYTES);
+		if(pageCache[currentPage] == nullptr){
+			pageCache[currentPage] = (uint16_t *)SDRAM.malloc(PAGE_BYTES);
+		}
+	}
+	if(pageCache[currentPage] != nullptr){
+		cache.pixels = pageCache[currentPage];
+		blitter->copy(cache, 0, 0, screenSurface());	//Done in order, before anything below draws on the screen
+		pageCached[currentPage] = true;
+	}
+	
+	currentPage = num;
+	currentEvent = Event();		//A finger on the old page must not act on the new one
+	previousEvent = Event();
+	pinchSlider = -1;
+	if(pressedButton >= 0){
+		button[pressedButton].pressed = false;
+		pressedButton = -1;
+	}
+	gestures.reset();
+	
+	if(!pageCached[num]){
+		drawAll();
+		return;
+	}
+	
+	beginFrame();
+	graph.startBuffering();		//Nothing reaches the screen until the page is complete
+	cache.pixels = pageCache[num];
+	blitter->copy(screenSurface(), 0, 0, cache);	//The first control's canvas is drawn while this runs
+	markDirty(0, 0, GIGA_DS_WIDTH, GIGA_DS_HEIGHT);
+	
+	//Only controls that changed while the page was hidden need drawing on top of the image
+	for(i = 0; i < NUM_BUTTONS; i++){
+		if(button[i].w > 0 && button[i].h > 0 && onCurrentPage(button[i]) &&
+		   (button[i].stale || button[i].drawnState != button[i].state() || button[i].dispText.equals(button[i].prevDispText) == false)){
+			drawButton(i);
+		}
+	}
+	for(i = 0; i < NUM_SLIDERS; i++){
+		if(slider[i].w > 0 && slider[i].h > 0 && onCurrentPage(slider[i]) && (slider[i].stale || slider[i].moved)){
+			updateSlider(i);
+		}
 	}
+	for(i = 0; i < NUM_TEXTBOXES; i++){
+		if(textbox[i].w > 0 && textbox[i].h > 0 && onCurrentPage(textbox[i]) &&
+		   (textbox[i].stale || textbox[i].dispText.equals(textbox[i].prevDispText) == false)){
+			drawTextbox(i);
+		}
+	}
+	endBlits();
+	endFrame();
+	graph.endBuffering();
 }
 void GigaDAQ::drawAll(){
     int i;
     
-    graph.fillScreen(0x0000);
+    beginFrame();
+    blitter->fill(screenSurface(), 0, 0, GIGA_DS_WIDTH, GIGA_DS_HEIGHT, 0x0000);	//The first control's canvas is drawn while this runs
+    markDirty(0, 0, GIGA_DS_WIDTH, GIGA_DS_HEIGHT);
     
     for(i = 0; i < NUM_BUTTONS; i++){
-        if(button[i].w > 0 && button[i].h > 0){
+        if(button[i].w > 0 && button[i].h > 0 && onCurrentPage(button[i])){
         	drawButton(i);
         }
     }
     
     for(i = 0; i < NUM_SLIDERS; i++){
-        if(slider[i].w > 0 && slider[i].h > 0){
+        if(slider[i].w > 0 && slider[i].h > 0 && onCurrentPage(slider[i])){
             drawSlider(i);
         }
     }
     
     for(i = 0; i < NUM_TEXTBOXES; i++){
-        if(textbox[i].w > 0 && textbox[i].h > 0){
+        if(textbox[i].w > 0 && textbox[i].h > 0 && onCurrentPage(textbox[i])){
             drawTextbox(i);
         }
     }
+    endBlits();
+    endFrame();
 }
-void GigaDAQ::locate(int touchX, int touchY){
-    unsigned px=0, py=0, cx, cy, cw, ch;
-    float fracx, fracy, slidx, slidy;
-    
-    int i;
-    bool matchFound = false;
+void GigaDAQ::touchToPercent(int touchX, int touchY, unsigned int &px, unsigned int &py){
+    px = 0;
+    py = 0;
     
     switch(rotation){				//Convert pixels to percentages. Touch screen values do not vary with rotation.
         case PORTRAIT_USBDOWN:
@@ -269,6 +893,15 @@ void GigaDAQ::locate(int touchX, int touchY){
             py = touchX * 100 / screenH;
             break;
     }
+}
+void GigaDAQ::locate(int touchX, int touchY){
+    unsigned px=0, py=0, cx, cy, cw, ch;
+    float fracx, fracy, slidx, slidy;
+    
+    int i;
+    bool matchFound = false;
+    
+    touchToPercent(touchX, touchY, px, py);
     
     //Once the touch point is translated to percentages, find out which control, if any, contains the point.
     i = 0;
@@ -276,7 +909,7 @@ void GigaDAQ::locate(int touchX, int touchY){
     do{	//Cycle though buttons to see if touch point is within a button.
         cw = button[i].w;
         ch = button[i].h;
-        if(cw > 0 && ch > 0){
+        if(cw > 0 && ch > 0 && onCurrentPage(button[i]) && button[i].enabled){
             cx = button[i].x;
             cy = button[i].y;
             if(cx < px && px <= cx+cw && cy < py && py <= cy+ch){
@@ -296,7 +929,7 @@ void GigaDAQ::locate(int touchX, int touchY){
         do{
             cw = slider[i].w;
             ch = slider[i].h;
-            if(cw > 0 && ch > 0){
+            if(cw > 0 && ch > 0 && onCurrentPage(slider[i])){
                 cx = slider[i].x;
                 cy = slider[i].y;
                 if(cx < px && px <= cx+cw && cy < py && py <= cy+ch){
@@ -312,7 +945,8 @@ void GigaDAQ::locate(int touchX, int touchY){
                     slidy = slider[i].minY + fracy*(slider[i].maxY - slider[i].minY);
                     slider[i].posX = slidx;
                     slider[i].posY = slidy;
-                    drawSlider(i);
+                    slider[i].moved = true;		//Redrawn by updateDisplays(), so fast drags don't pile up redraws
+                    publishSlider(i);			//Control loops get it right away
                 }
             }
             i++;
@@ -370,38 +1004,203 @@ int GigaDAQ::arrayPosition(ControlType type, String name){
 }
 void GigaDAQ::takeAction(void){
     int num;
-    float fracx, fracy, slidx, slidy;
     
-    //Button action when finger lifts from button
+    //Button action when finger lifts from button. A long press that ran a hold action uses up the release.
     if(previousEvent.type == BUTTON && currentEvent.type == NOTHING){
         num = arrayPosition(BUTTON, previousEvent.name);
         if(num >= 0){
-            button[num].release();
+            if(button[num].held){
+                button[num].held = false;
+            }
+            else{
+                if(button[num].toggle){
+                    button[num].on = !button[num].on;	//Before the action, which reads it
+                }
+                actions.post([this, num](){ runAction(BUTTON, num, false); }, button[num].priority, button[num].name.c_str());
+            }
         }
     }
     
+    showPressed();		//Right away, before any action runs
+    
     //Slider responds if finger stays in slider
     
     if(previousEvent.type == SLIDER && currentEvent.type == SLIDER && previousEvent.name == currentEvent.name){
         num = arrayPosition(SLIDER, currentEvent.name);
         if(num >= 0){
-            slider[num].sliderMotion();
+            slideAction(num);
+        }
+    }
+    //A decoded press already knows the finger landed, so there is no need to wait for a second event.
+    else if(currentEvent.type == SLIDER && currentEvent.gesture == GESTURE_PRESS){
+        num = arrayPosition(SLIDER, currentEvent.name);
+        if(num >= 0){
+            slideAction(num);
         }
     }
     
     //Other actions will go here
 }
+void GigaDAQ::showPressed(void){
+	int num = -1;
+	
+	if(currentEvent.type == BUTTON){
+		num = arrayPosition(BUTTON, currentEvent.name);
+	}
+	if(num == pressedButton && (num < 0 || button[num].drawnState == button[num].state())){
+		return;
+	}
+	beginFrame();		//The button left and the button pressed appear together
+	if(pressedButton >= 0 && pressedButton != num){
+		button[pressedButton].pressed = false;
+		if(button[pressedButton].drawnState != button[pressedButton].state()){
+			drawButton(pressedButton);
+		}
+	}
+	pressedButton = num;
+	if(num >= 0){
+		button[num].pressed = true;
+		if(button[num].drawnState != button[num].state()){
+			drawButton(num);
+		}
+	}
+	endFrame();
+}
+void GigaDAQ::runAction(ControlType type, int num, bool alternate){
+	Event saved = previousEvent;
+
+	//Actions written before the queue read previousEvent to tell which control called them
+	previousEvent.type = type;
+	previousEvent.name = (type == BUTTON) ? button[num].name : slider[num].name;
+	if(type == BUTTON){
+		if(alternate) button[num].hold();
+		else button[num].release();
+	}
+	else if(type == SLIDER){
+		if(alternate) slider[num].pinchMotion();
+		else slider[num].sliderMotion();
+	}
+	previousEvent = saved;
+}
+void GigaDAQ::slideAction(int num){
+	uint32_t now = millis();
+	
+	if(now - slider[num].lastAction >= slider[num].actionInterval){
+		slider[num].lastAction = now;
+		slider[num].actionPending = false;
+		if(!slider[num].slideQueued){		//One waiting action is enough: it reads the latest position when it runs
+			slider[num].slideQueued = actions.post([this, num](){
+				slider[num].slideQueued = false;
+				runAction(SLIDER, num, false);
+			}, slider[num].priority, slider[num].name.c_str());
+		}
+	}
+	else{
+		slider[num].actionPending = true;	//posX and posY keep the latest values until it runs
+	}
+}
+void GigaDAQ::handleGesture(const Gesture &g){
+	int i, num;
+	unsigned int px, py;
+	
+	switch(g.type){
+		case GESTURE_PRESS:
+			for(i = 0; i < NUM_BUTTONS; i++){	//A new touch starts with no long press in effect
+				button[i].held = false;
+			}
+			locate(g.x, g.y);
+			break;
+		case GESTURE_DRAG:
+			locate(g.x, g.y);
+			break;
+		case GESTURE_LONG_PRESS:
+			locate(g.x, g.y);
+			if(currentEvent.type == BUTTON){
+				num = arrayPosition(BUTTON, currentEvent.name);
+				if(num >= 0 && (button[num].heldHandler || button[num].buttonHeld != nullptr)){
+					button[num].held = true;
+					actions.post([this, num](){ runAction(BUTTON, num, true); }, button[num].priority, button[num].name.c_str());
+				}
+			}
+			break;
+		case GESTURE_PINCH:	//Pinches belong to the trackpad where they started and do not move its position
+			if(pinchSlider < 0){
+				touchToPercent(g.x, g.y, px, py);
+				for(i = 0; i < NUM_SLIDERS && pinchSlider < 0; i++){
+					if(slider[i].mode == TRACKPAD && slider[i].w > 0 && slider[i].h > 0 && onCurrentPage(slider[i]) &&
+					   slider[i].x < px && px <= slider[i].x + slider[i].w &&
+					   slider[i].y < py && py <= slider[i].y + slider[i].h){
+						pinchSlider = i;
+					}
+				}
+			}
+			if(pinchSlider >= 0){
+				num = pinchSlider;
+				slider[num].pinchScale = g.scale;
+				if(!slider[num].pinchQueued){
+					slider[num].pinchQueued = actions.post([this, num](){
+						slider[num].pinchQueued = false;
+						runAction(SLIDER, num, true);
+					}, slider[num].priority, slider[num].name.c_str());
+				}
+			}
+			currentEvent = Event();
+			currentEvent.gesture = GESTURE_PINCH;
+			previousEvent = currentEvent;	//Two fingers never count as a button press or a slide
+			return;
+		case GESTURE_RELEASE:
+			currentEvent = Event();
+			pinchSlider = -1;
+			break;
+		default:
+			return;
+	}
+	if(currentEvent.type != NOTHING){
+		currentEvent.t = g.t;				//Time of the touch, not of when it was handled
+	}
+	currentEvent.gesture = g.type;
+	takeAction();
+	previousEvent = currentEvent;
+}
 void GigaDAQ::handleInputs(void){
 	uint8_t contacts;
 	GDTpoint_t points[5];
 	int tpx, tpy;
+	TouchSample sample;
+	Gesture g;
+	
+	clock.service();		//Keeps the sample clock in step with the RTC
+	if(touchInterrupt){		//Only do UI work when the touch screen has reported something
+		while(touchQueue.pop(sample) || (mirror != nullptr && mirror->touches.pop(sample))){
+			power.activity();
+			do{
+				if(gestures.feed(sample, g)){
+					handleGesture(g);
+				}
+			}while(gestures.refeed());		//A tap queued behind an earlier one is only told apart by the gap between them
+		}
+		if(gestures.poll(millis(), g)){
+			handleGesture(g);
+		}
+		actions.run(governor.inputBudget(actionBudget, acquisitionHeadroom()));	//Actions run once the touches are dealt with
+		return;
+	}
 	
 	contacts = touch.getTouchPoints(points);
+	if(mirror != nullptr){		//The viewer's finger, if none is on the screen. It is polled like the screen, so only where it is now counts.
+		while(mirror->touches.pop(sample)){}
+		if(contacts == 0 && mirror->remote.contacts > 0){
+			contacts = 1;
+			points[0].x = mirror->remote.x[0];
+			points[0].y = mirror->remote.y[0];
+		}
+	}
 	
 	if(contacts > 0){  //If multiple fingers are used, only the first one is considered. 
 						//Do not use more than one finger.
 		tpx = points[0].x;
 		tpy = points[0].y;
+		power.activity();
 	}
 	else{
 		tpx = 0;
@@ -410,29 +1209,337 @@ void GigaDAQ::handleInputs(void){
 	locate(tpx, tpy);
 	takeAction();
 	previousEvent = currentEvent;
-	
-	
+	actions.run(governor.inputBudget(actionBudget, acquisitionHeadroom()));
 }
 void GigaDAQ::updateDisplays(void){
-	int i;
+	int i, n, first;
+	uint32_t now = millis();
+	bool frame;
+	
+	frame = governor.start(frameInterval, (governor.budget > 0) ? acquisitionHeadroom() : 0xFFFFFFFF);
+	beginFrame();
+	for(i=0; i<NUM_BUTTONS; i++){	//Buttons switched on, off, enabled or disabled by the sketch. Feedback to a finger is never deferred.
+		if(button[i].w > 0 && button[i].h > 0 && onCurrentPage(button[i]) &&
+		   button[i].drawnState >= 0 && button[i].drawnState != button[i].state()){
+			drawButton(i);
+		}
+	}
+	for(i=0; i<NUM_SLIDERS; i++){	//Slide actions that were held back by the action rate
+		if(slider[i].actionPending && now - slider[i].lastAction >= slider[i].actionInterval){
+			slideAction(i);
+		}
+		if(slider[i].moved){		//Positions set by the sketch
+			publishSlider(i);
+		}
+	}
 	for(i=0; i<NUM_TEXTBOXES; i++){
-		if(textbox[i].w > 0 && textbox[i].h > 0 && textbox[i].dispText.equals(textbox[i].prevDispText) == false){
-			drawTextbox(i);
-			textbox[i].prevDispText = textbox[i].dispText;
+		if(textbox[i].channel >= 0){
+			showChannel(i);
 		}
 	}
+	
+	//However many touches landed in a slider, only the latest position is drawn, once per frame.
+	//Sliders go first, then text boxes, each starting with the first one that was deferred last time.
+	if(frame){
+		lastFrame = now;
+		first = -1;
+		for(n=0; n<NUM_SLIDERS; n++){
+			i = (nextSlider + n) % NUM_SLIDERS;
+			if(slider[i].w > 0 && slider[i].h > 0 && onCurrentPage(slider[i]) && slider[i].moved){
+				if(governor.allow(sliderWait[i], controlPixels(slider[i]))){
+					updateSlider(i);
+					sliderWait[i] = 0;
+				}
+				else{
+					sliderWait[i]++;
+					first = (first < 0) ? i : first;
+				}
+			}
+		}
+		nextSlider = (first >= 0) ? first : (nextSlider + 1) % NUM_SLIDERS;
+	}
+	if(frame || governor.budget == 0){		//Without a budget, text boxes are drawn as soon as they change
+		first = -1;
+		for(n=0; n<NUM_TEXTBOXES; n++){
+			i = (nextTextbox + n) % NUM_TEXTBOXES;
+			if(textbox[i].w > 0 && textbox[i].h > 0 && onCurrentPage(textbox[i]) && textbox[i].dispText.equals(textbox[i].prevDispText) == false){
+				if(governor.budget == 0 || governor.allow(textboxWait[i], controlPixels(textbox[i]))){
+					drawTextbox(i);
+					textbox[i].prevDispText = textbox[i].dispText;
+					textboxWait[i] = 0;
+				}
+				else{
+					textboxWait[i]++;
+					first = (first < 0) ? i : first;
+				}
+			}
+		}
+		nextTextbox = (first >= 0) ? first : (nextTextbox + 1) % NUM_TEXTBOXES;
+	}
+	endFrame();
+	governor.finish();
+}
+uint32_t GigaDAQ::acquisitionHeadroom(void){
+	uint32_t timers = power.untilNext(power.ticks()), bus = sensors.untilNext(clock.now());
+	
+	return (timers < bus) ? timers : bus;
 }
 
-void GigaDAQ::startDataRecording(String fileName){
-	int i;
+void GigaDAQ::startDataRecording(String fileName, LogCompressor *compressor){
 	const char *strConv;
   	char fBuf[256];
   	
   	strConv = fileName.c_str();
   	snprintf(fBuf, 255, "/usb/%s", strConv);
-  	fp = fopen(fBuf, "at"); 	
+  	fp = fopen(fBuf, compressor ? "ab" : "at"); 	
+  	if(fp != NULL){
+  		if(logBuffer == nullptr && logBufferSize > 0){
+  			logBuffer = (char *)sdramArena.alloc(logBufferSize);
+  		}
+  		if(logBuffer != nullptr){
+  			setvbuf(fp, logBuffer, _IOFBF, logBufferSize);	//Must come before anything else is done with the file
+  		}
+  		fseek(fp, 0, SEEK_END);		//Lines are indexed by where they start in the file
+  		logOffset = ftell(fp);
+  		logIndex.begin(fBuf);
+  		this->compressor = compressor;
+  		if(compressor != nullptr){
+  			compressor->begin(fp, logOffset);
+  		}
+  	}
+}
+void GigaDAQ::recordSample(uint64_t t, const float *values, int count){
+	int i, n;
+	
+	if(fp != NULL && compressor != nullptr){
+		compressor->add(t, values, count);		//Writes out the block first if the sample starts a new one
+		logOffset = compressor->blockOffset();
+		logIndex.add(t, logOffset, values, count);	//So the sample is in the block that starts here
+	}
+	else if(fp != NULL){
+		logIndex.add(t, logOffset, values, count);
+		n = fprintf(fp, "%lu.%06lu", (unsigned long)(t / 1000000), (unsigned long)(t % 1000000));	//Exact, unlike a float
+		for(i = 0; i < count; i++){
+			n += fprintf(fp, ", %g", (double)values[i]);
+		}
+		fputc('\n', fp);
+		logOffset += n + 1;
+	}
+	for(i = 0; i < NUM_SINKS; i++){
+		if(sink[i] != nullptr){
+			sink[i]->write(t, values, count);
+		}
+	}
+}
+int GigaDAQ::drawOverview(LogIndexReader &log, int channel, uint64_t t0, uint64_t t1, float yMin, float yMax,
+                          int x, int y, int w, int h, uint16_t fg, uint16_t bg){
+	static float lo[GIGA_DS_HEIGHT], hi[GIGA_DS_HEIGHT];	//One pair per pixel column, for the widest possible area
+	int cw, ch, cx, cy, c, top, bottom, read, bx, by, bw, bh;
+	float scale;
+	
+	cw = w * screenW / 100;
+	ch = h * screenH / 100;
+	cx = x * screenW / 100;
+	cy = y * screenH / 100;
+	if(cw <= 0 || ch <= 0 || cw > (int)GIGA_DS_HEIGHT || yMax <= yMin){
+		return -1;
+	}
+	read = log.summarize(t0, t1, channel, cw, lo, hi);
+	if(read < 0){
+		return -1;
+	}
+	
+	bx = cx;
+	by = cy;
+	bw = cw;
+	bh = ch;
+	toScreen(bx, by, bw, bh);
+	blitter->fill(screenSurface(), bx, by, bw, bh, bg);
+	markDirty(bx, by, bw, bh);		//The bars are all inside the background
+	scale = (ch - 1) / (yMax - yMin);
+	for(c = 0; c < cw; c++){
+		if(lo[c] > hi[c]){		//No data in this slice
+			continue;
+		}
+		top = ch - 1 - (int)((constrain(hi[c], yMin, yMax) - yMin) * scale);
+		bottom = ch - 1 - (int)((constrain(lo[c], yMin, yMax) - yMin) * scale);
+		bx = cx + c;
+		by = cy + top;
+		bw = 1;
+		bh = bottom - top + 1;
+		toScreen(bx, by, bw, bh);
+		blitter->fill(screenSurface(), bx, by, bw, bh, fg);	//Queued behind the background
+	}
+	endBlits();
+	return read;
+}
+int GigaDAQ::addSink(DataSink *s){
+	int i;
+	
+	for(i = 0; i < NUM_SINKS; i++){
+		if(sink[i] == nullptr){
+			sink[i] = s;
+			return i;
+		}
+	}
+	return -1;
+}
+void GigaDAQ::removeSink(DataSink *s){
+	int i;
+	
+	for(i = 0; i < NUM_SINKS; i++){
+		if(sink[i] == s){
+			sink[i] = nullptr;
+		}
+	}
+}
+void GigaDAQ::serviceSinks(void){
+	int i;
+	
+	for(i = 0; i < NUM_SINKS; i++){
+		if(sink[i] != nullptr){
+			sink[i]->service();
+		}
+	}
+}
+void GigaDAQ::serviceSensors(void){
+	SensorSlot *s;
+	
+	if(sensors.service(clock.now())){
+		if(sensorChannel >= 0){		//Only the device that finished has new values
+			s = &sensors.slot[sensors.sampleSlot];
+			channels->setRow(sensorChannel + s->channel, &sensors.values[s->channel], s->device->channels(), sensors.sampleTime);
+		}
+		recordSample(sensors.sampleTime, sensors.values, sensors.count);
+	}
+}
+bool GigaDAQ::recordChannels(int first, int count){
+	float values[NUM_CHANNELS];
+	uint64_t t, newest = 0;
+	int i;
+	bool any = false;
+	
+	if(count < 0 || first + count > channels->count){
+		count = channels->count - first;
+	}
+	if(first < 0 || count <= 0){
+		return false;
+	}
+	for(i = 0; i < count; i++){
+		if(channels->get(first + i, values[i], t)){
+			any = true;
+			if(t > newest){
+				newest = t;
+			}
+		}
+		else{
+			values[i] = NAN;		//No value yet
+		}
+	}
+	if(any){
+		recordSample(newest, values, count);
+	}
+	return any;
+}
+void GigaDAQ::showChannel(int n){
+	Textbox &tb = textbox[n];
+	char text[40];
+	
+	if(channels->changed(tb.channel, tb.shownVersion) && channels->format(tb.channel, text, sizeof(text)) >= 0){
+		tb.setDisplayText(text);
+	}
+}
+void GigaDAQ::startControl(uint32_t tick){
+	control.channels = channels;
+	control.tickInterval = tick;
+	controlTicker.attach(mbed::callback(this, &GigaDAQ::controlTick), std::chrono::microseconds(tick));
+}
+void GigaDAQ::stopControl(void){
+	controlTicker.detach();
+}
+void GigaDAQ::controlTick(void){
+	control.tick(clock.now());
+}
+void GigaDAQ::publishSlider(int num){
+	Slider &s = slider[num];
+	uint64_t t, now = clock.now();
+	float v;
+	
+	if(s.channelX >= 0 && !(channels->get(s.channelX, v, t) && v == s.posX)){
+		channels->set(s.channelX, s.posX, now);
+	}
+	if(s.channelY >= 0 && !(channels->get(s.channelY, v, t) && v == s.posY)){
+		channels->set(s.channelY, s.posY, now);
+	}
+}
+void GigaDAQ::startMirror(ScreenMirror &m, Stream &port){
+	m.begin(port, GIGA_DS_WIDTH, GIGA_DS_HEIGHT, rotation);
+	mirror = &m;
+}
+void GigaDAQ::stopMirror(void){
+	if(mirror != nullptr){
+		mirror->end();
+	}
+	mirror = nullptr;
+}
+void GigaDAQ::serviceMirror(void){
+	if(mirror != nullptr){
+		mirror->service(screenSurface());
+	}
+}
+uint32_t GigaDAQ::sleepIfIdle(void){
+	int i;
+	uint32_t limit = sensors.untilNext(clock.now());
+	bool redraw = false;
+	
+	if(actions.pending() > 0 || !touchQueue.empty() || gestures.touching()){
+		return 0;
+	}
+	if(mirror != nullptr && (mirror->busy() || !mirror->touches.empty() || mirror->remote.contacts > 0)){
+		return 0;
+	}
+	for(i=0; i<NUM_SLIDERS; i++){
+		if(slider[i].actionPending){
+			return 0;
+		}
+		if(slider[i].moved && slider[i].w > 0 && slider[i].h > 0 && onCurrentPage(slider[i])){
+			redraw = true;
+		}
+	}
+	for(i=0; i<NUM_TEXTBOXES; i++){		//Same test as updateDisplays()
+		if(textbox[i].channel >= 0 && channels->version(textbox[i].channel) != textbox[i].shownVersion){
+			return 0;
+		}
+		if(textbox[i].w > 0 && textbox[i].h > 0 && onCurrentPage(textbox[i]) && textbox[i].dispText.equals(textbox[i].prevDispText) == false){
+			redraw = true;
+		}
+	}
+	if(redraw){		//With a budget, redraws wait for the next frame, so there is time to sleep until then
+		if(governor.budget == 0 || governor.untilFrame() == 0){
+			return 0;
+		}
+		limit = min(limit, governor.untilFrame());
+	}
+	return power.idle(limit);
 }
 void GigaDAQ::endDataRecording(){
+	if(compressor != nullptr){
+		compressor->end();		//The last block goes into the file before it is closed
+		compressor = nullptr;
+	}
+	logIndex.end();
 	if(fp) fclose(fp);
-
+	fp = NULL;		//So that later writes are skipped instead of crashing
+	sdramArena.release(logBuffer);		//Only once the file no longer uses it
+	logBuffer = nullptr;
+}
+void GigaDAQ::memoryReport(Print &out){
+	char line[160];
+	
+	sdramArena.report(line, sizeof(line));
+	out.println(line);
+	if(fastArena.ready()){
+		fastArena.report(line, sizeof(line));
+		out.println(line);
+	}
 }
\ No newline at end of file
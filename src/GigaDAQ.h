@@ -35,10 +35,32 @@ SOFTWARE.
 
 #include <stdio.h>
 #include "DAQControls.h"
+#include "PanelFormat.h"
+#include "DataSink.h"
+#include "Telemetry.h"
+#include "SerialStream.h"
+#include "ScreenMirror.h"
+#include "FrameGovernor.h"
+#include "LogIndex.h"
+#include "LogCompress.h"
+#include "ChannelRegistry.h"
+#include "Blitter.h"
+#include "Framebuffer.h"
+#include "Timebase.h"
+#include "SensorBus.h"
+#include "SensorPorts.h"
+#include "ControlLoop.h"
+#include "ControlPorts.h"
+#include "drivers/Ticker.h"
+#include "PowerManager.h"
+#include "MemoryArena.h"
 
 const int NUM_BUTTONS = 20;		///< Maximum number of buttons in a GigaDAQ object
 const int NUM_SLIDERS =	10;		///< Maximum number of sliders in a GigaDAQ object
 const int NUM_TEXTBOXES = 15;	///< Maximum number of text boxes in a GigaDAQ object
+const int NUM_PAGES = 4;		///< Number of pages (screens) of controls in a GigaDAQ object
+const int NUM_ACTIONS = 20;		///< Maximum number of actions that panel files can refer to by name
+const int NUM_SINKS = 4;		///< Maximum number of data sinks attached to a GigaDAQ object
 
 /** Orientation of Arduino GIGA Display Shield (DS) */
 enum DisplayOrientation {
@@ -48,9 +70,121 @@ enum DisplayOrientation {
 	LANDSCAPE_USBLEFT =	3	/**< DS held with USB ports facing left. W = 800, H = 480 pixels (unusual use) */
 };
 
+const uint32_t FRAME_INTERVAL = 16;		///< Default milliseconds between display frames (about 60 frames per second)
+const uint32_t ACTION_BUDGET = 10000;	///< Default microseconds that handleInputs() spends starting queued actions
+
+const size_t SDRAM_ARENA_SIZE = 4*1024*1024;	///< Default bytes of SDRAM that begin() sets aside for canvases, page images and the data file buffer
+const size_t LOG_BUFFER_SIZE = 8192;		///< Default bytes of the data file buffer
+
 const unsigned int GIGA_DS_WIDTH = 480;		///< In default rotation, screen width in pixels
 const unsigned int GIGA_DS_HEIGHT = 800;	///< In default rotation, screen height in pixels
 
+/**
+@brief An action function that panel files can refer to by name.
+*/
+class PanelAction {
+public:
+	String name;			///< Name used for the action in panel files
+	void (*fn)(void);		///< Function to execute
+	/** Constructor for an empty PanelAction */
+	PanelAction();
+};
+
+/**
+@brief A GFXcanvas16 whose pixels come from a MemoryArena, such as GigaDAQ::sdramArena, instead of the heap. If the arena is full or was never set up, the pixels come from the heap as before.
+*/
+class ArenaCanvas16 : public GFXcanvas16 {
+public:
+	/**
+	@brief Constructor for a canvas, cleared to black.
+	
+	@param w Width in pixels
+	@param h Height in pixels
+	@param arena Arena to take the pixels from. The pixels are given back when the canvas goes away.
+	*/
+	ArenaCanvas16(uint16_t w, uint16_t h, MemoryArena &arena);
+	~ArenaCanvas16();
+private:
+	MemoryArena &arena;
+};
+
+/**
+@brief A GFXcanvas8 whose pixels come from a MemoryArena, like ArenaCanvas16. Its pixels are numbers in a palette rather than colors, so it takes half the memory of an ArenaCanvas16, and the blitter turns them into colors on the way to the screen.
+*/
+class ArenaCanvas8 : public GFXcanvas8 {
+public:
+	/**
+	@brief Constructor for a canvas, cleared to 0.
+	
+	@param w Width in pixels
+	@param h Height in pixels
+	@param arena Arena to take the pixels from. The pixels are given back when the canvas goes away.
+	*/
+	ArenaCanvas8(uint16_t w, uint16_t h, MemoryArena &arena);
+	~ArenaCanvas8();
+private:
+	MemoryArena &arena;
+};
+
+/**
+@brief A GFXcanvas16 that draws on pixels it is given, such as a button sprite. The pixels are not freed with the canvas.
+*/
+class BufferCanvas16 : public GFXcanvas16 {
+public:
+	/**
+	@brief Constructor for a canvas on existing pixels, which are left as they are.
+	
+	@param w Width in pixels
+	@param h Height in pixels
+	@param pixels w * h pixels
+	*/
+	BufferCanvas16(uint16_t w, uint16_t h, uint16_t *pixels);
+};
+
+/**
+@brief A GFXcanvas8 that draws on pixels it is given, like BufferCanvas16.
+*/
+class BufferCanvas8 : public GFXcanvas8 {
+public:
+	/**
+	@brief Constructor for a canvas on existing pixels, which are left as they are.
+	
+	@param w Width in pixels
+	@param h Height in pixels
+	@param pixels w * h pixels
+	*/
+	BufferCanvas8(uint16_t w, uint16_t h, uint8_t *pixels);
+};
+
+/**
+@brief One look of a button, drawn once and kept in GigaDAQ::sdramArena so that showing it again is a single copy.
+*/
+struct ButtonSprite {
+	void *pixels;		///< Pixels in the order of the screen buffer, nullptr until drawn
+	int w;				///< Width of the button in pixels when it was drawn
+	int h;				///< Height of the button in pixels when it was drawn
+	bool indexed;		///< True if pixels are numbers in the palette {0x0000, bgColor, fgColor} of look, false for RGB565 colors
+	ButtonLook look;	///< Text and colors that were drawn
+};
+
+/**
+@brief The Display Shield's screen buffer as a Framebuffer. flip() has the GigaDisplay_GFX library send the buffer to the screen, which it does as a page flip.
+*/
+class DisplayFramebuffer : public Framebuffer {
+public:
+	/**
+	@brief Constructor for the buffer of a display.
+	
+	@param graph The display. Its buffer is only looked up when it is needed, so the display may be started later.
+	*/
+	DisplayFramebuffer(GigaDisplay_GFX &graph);
+	BlitSurface back(void) override;
+protected:
+	void show(int x, int y, int w, int h) override;
+private:
+	GigaDisplay_GFX &graph;
+};
+
 class GigaDAQ {
 public:
     unsigned int screenW;		///< Screen width in pixels
@@ -63,8 +197,48 @@ public:
     Event previousEvent;		///< Touch event prior to current one
     GigaDisplay_GFX graph;		///< Object for screen drawing functions
 	Arduino_GigaDisplayTouch touch; ///< Object for touch screen functions
+	TouchQueue touchQueue;		///< Touch samples waiting to be handled when touch interrupts are enabled
+	GestureDecoder gestures;	///< Turns queued touch samples into presses, drags, long presses, releases and pinches
+	bool touchInterrupt;		///< True when the touch screen reports through enableTouchInterrupt() instead of polling
+	int pinchSlider;			///< Array position of the trackpad being pinched, -1 when there is no pinch
+	uint32_t frameInterval;		///< Minimum milliseconds between frames, in which moving sliders are redrawn (and changed text boxes, with a governor budget)
+	PanelAction panelAction[NUM_ACTIONS];	///< Actions available to panel files
+	uint8_t currentPage;		///< Page whose controls are shown and respond to touch
+	uint16_t *pageCache[NUM_PAGES];	///< Full-screen images of pages in SDRAM, nullptr until first needed
+	bool pageCached[NUM_PAGES];	///< True when pageCache holds a usable image of the page
+	uint32_t lastFrame;			///< Time stamp of the last frame
+	ActionQueue actions;		///< Actions of buttons and sliders waiting to run
+	uint32_t actionBudget;		///< Microseconds after which handleInputs() starts no more queued actions. 0 runs one at a time.
+	PowerManager power;			///< Timers for loop() work, sleeping while idle and dimming the backlight
+	MemoryArena sdramArena;		///< Large buffers in the 8 MB SDRAM: control canvases, page images and the data file buffer
+	MemoryArena fastArena;		///< Small data that is used all the time, such as filter state, in a part of the DTCM that the sketch gives it with MemoryArena::begin(). Not set up by begin().
+	size_t sdramArenaSize;		///< Bytes begin() sets aside for sdramArena. Change before begin().
+	size_t logBufferSize;		///< Bytes of the data file buffer taken from sdramArena by startDataRecording(), 0 for the standard buffer
+	char *logBuffer;			///< Data file buffer, nullptr when not recording or when the standard buffer is used
 	
 	FILE *fp;					///< File pointer for data-logging operations
+	LogIndexWriter logIndex;	///< Writes the index files of the data file as recordSample() adds lines
+	uint32_t logOffset;			///< Position in the data file where the next line from recordSample() starts, or the next block with a compressor
+	LogCompressor *compressor;	///< Packs the samples of the data file into compressed blocks, nullptr for a text file
+	DataSink *sink[NUM_SINKS];	///< Other destinations of recorded samples, such as a TelemetryPublisher
+	SoftwareBlitter softwareBlitter;	///< Moves pixels with the CPU
+	Dma2dBlitter dma2dBlitter;			///< Moves pixels with the DMA2D graphics engine while the CPU does other work
+	Blitter *blitter;					///< Moves pixels to the screen for all the draw methods, dma2dBlitter unless changed
+	DisplayFramebuffer displayFramebuffer;	///< The Display Shield's buffer, for framebuffer
+	Framebuffer *framebuffer;			///< Controls are drawn straight into its back buffer, which is shown once per frame. nullptr (the default) draws each control on a canvas and copies it to the screen.
+	bool indexedCanvases;				///< True to draw controls on 8-bit canvases with a palette of their few colors instead of RGB565 canvases, which halves their memory. False by default.
+	ChannelRegistry channelTable;		///< The channels, unless channels is pointed elsewhere
+	ChannelRegistry *channels;			///< Newest value of every measured quantity, read by bound text boxes and recordChannels(). channelTable unless changed.
+	int sensorChannel;					///< Channel that serviceSensors() puts the first sensor value into, -1 to leave the channels alone
+	int frameDepth;						///< Number of beginFrame() calls not yet matched by endFrame()
+	ButtonSprite sprite[NUM_BUTTONS][NUM_BUTTON_STATES];	///< Each look of each button that has been shown, drawn in the format of the canvases (see indexedCanvases)
+	int pressedButton;					///< Array position of the button under the finger, -1 if none
+	ScreenMirror *mirror;				///< Shows the screen on a computer and takes touches from it, nullptr (the default) for none. Set by startMirror().
+	FrameGovernor governor;				///< Time budget of each frame of updateDisplays(), so that drawing leaves room for acquisition. Off until governor.budget is set.
+	int textboxWait[NUM_TEXTBOXES];		///< Frames the redraw of each text box has been deferred by governor
+	int sliderWait[NUM_SLIDERS];		///< Frames the redraw of each slider has been deferred by governor
+	int nextTextbox;					///< Array position of the text box the next frame starts with, so that all get their turn
+	int nextSlider;						///< Array position of the slider the next frame starts with
     /** Constructor for object. Initializes object with safe values */
     GigaDAQ();
     /** Constructor with user-selected orientation
@@ -74,31 +248,263 @@ public:
     GigaDAQ(DisplayOrientation rotation);
     /**
     @brief Starts graph and touch objects and checks real-time clock. If real-time clock (RTC) has a reasonable value, that is accepted. Otherwise, an arbitrary value is inserted to give data files a reasonable timestamp.
+    
+    The microsecond clock, clock, is then set from the RTC. This waits up to a second for the RTC to tick over.
+    
+    sdramArena is given sdramArenaSize bytes of SDRAM here, unless it was already given a region with MemoryArena::begin(). fastArena is left as it is: only the sketch knows which part of the DTCM it does not use.
     */
     void begin(void);
     /**
-    @brief Draws all objects (where the width and height are both greater than zero) regardless if they are current or stale.
+    @brief Has the touch screen report touches as they happen instead of waiting to be polled.
+    
+    Each report is placed in touchQueue with a time stamp. handleInputs() then decodes the queued samples into gestures, so it returns immediately when nobody is touching the screen and can be called on every pass through loop(). This also enables long presses on buttons (Button::setHoldAction()) and two-finger pinches on trackpads (Slider::setPinchAction()).
+    
+    @note Call after begin().
+    */
+    void enableTouchInterrupt(void);
+    /**
+    @brief Makes an action function available to panel files under the given name.
+    
+    @param name Name used for the action in panel files (at most 15 characters)
+    @param fn A function pointer where the function must be of the form void f(void)
+    @returns Array position in panelAction on success, -1 if all NUM_ACTIONS positions are taken
+    */
+    int registerAction(String name, void (*fn)(void));
+    /**
+    @brief Replaces all controls with the ones in a panel file on the flash drive.
+    
+    Panel files are made from a text description with the panelc tool in the extras folder. The records in the file have the same layout as they have in memory, so they are copied into the control arrays without any parsing. Actions are looked up by the names given to registerAction(), so register them before loading a panel. Call drawAll() afterwards to show the new panel.
+    
+    @param fileName Name of the panel file. The string "/usb/" will be placed before the given name, as with startDataRecording().
+    @returns Number of controls loaded on success
+    @returns -1 if the file could not be opened or is not a panel file. The existing controls are left alone in that case.
+    */
+    int loadPanel(String fileName);
+    /**
+    @brief Places one panel file record into the control arrays.
+    
+    @param r Record read from a panel file
+    @returns true if the record described a valid control
+    @note Internal use only.
+    */
+    bool applyPanelRecord(const PanelRecord &r);
+    /**
+    @brief Find the function registered under the given action name.
+    
+    @param name Name given to registerAction()
+    @returns Function pointer, or nullptr if the name is empty or was not registered
+    */
+    void (*findAction(const char *name))(void);
+    /**
+    @brief Sets all buttons, sliders and text boxes back to zero width and height, with no actions.
+    */
+    void clearControls(void);
+    /**
+    @brief Draws all objects on the current page (where the width and height are both greater than zero) regardless if they are current or stale.
     */
     void drawAll();
     /**
-    @brief Forces the drawing of a button at the given array position.
+    @brief Shows a different page (screen) of controls.
+    
+    Every control has a page member (0 by default). Only the controls on the shown page are drawn and respond to touch. Controls on the other pages keep their values: setDisplayText(), setPosition() and so on work as usual, and the changes are drawn when their page is shown.
+    
+    The image of a page is kept in SDRAM when the page is left. Showing it again copies that image to the screen and redraws only the controls that changed in the meantime, which takes less than a frame. The first time a page is shown, it is drawn with drawAll().
+    
+    @param num Page to be shown. Must be an integer between 0 and NUM_PAGES-1.
+    */
+    void showPage(int num);
+    /**
+    @brief Discards the saved image of a page so that it is drawn from scratch the next time it is shown. Use this after changing something that does not mark a control for redrawing, like its colors, while its page is not shown.
+    
+    @param num Page to be discarded. Must be an integer between 0 and NUM_PAGES-1.
+    */
+    void invalidatePage(int num);
+    /**
+    @brief Checks whether a control is on the page being shown.
+    
+    @param c Button, slider or text box
+    @returns true if the control is on currentPage
+    */
+    bool onCurrentPage(const Control &c);
+    /**
+    @brief Gives the size of a control on the screen, for the frame budget.
+    
+    @param c Button, slider or text box
+    @returns Width times height in pixels
+    @note Internal use only.
+    */
+    uint32_t controlPixels(const Control &c);
+    /**
+    @brief Forces the drawing of a button at the given array position, in the look of its state(). If it is not on the current page, it is drawn when its page is shown.
+    
+    Each look is drawn once into a sprite in sdramArena, and later drawings of the same look only copy the sprite. If sdramArena has no room, the button is drawn on a canvas every time as before.
     
     @param num Array position of button to be drawn. Must be an integer between 0 and NUM_BUTTONS-1.
     */
     void drawButton(int num);
     /**
-    @brief Forces the drawing of a slider at the given array position.
+    @brief Finds the sprite of one look of a button, drawing it first if it was never drawn or the look or size changed since.
+    
+    @param num Array position of button. Must be an integer between 0 and NUM_BUTTONS-1.
+    @param s State whose look is needed
+    @param cw Width of button in pixels
+    @param ch Height of button in pixels
+    @returns The sprite, or nullptr if sdramArena has no room for it
+    @note Internal use only.
+    */
+    ButtonSprite *buttonSprite(int num, ButtonState s, int cw, int ch);
+    /**
+    @brief Gives the memory of every button sprite back to sdramArena. They are drawn again when needed.
+    */
+    void releaseSprites(void);
+    /**
+    @brief Shows the pressed look of the button under the finger and takes it away from the button the finger left, after currentEvent changed.
+    
+    @note Internal use only.
+    */
+    void showPressed(void);
+    /**
+    @brief Forces the drawing of a slider at the given array position. If it is not on the current page, it is drawn when its page is shown.
     
     @param num Array position of slider to be drawn. Must be an integer between 0 and NUM_SLIDERS-1.
     */
     void drawSlider(int num);
     /**
-    @brief Forces the drawing of a text box at the given array position.
+    @brief Redraws only the part of a slider's fill bar that changed since it was last drawn.
+    
+    @param num Array position of slider to be drawn. Must be an integer between 0 and NUM_SLIDERS-1.
+    */
+    void updateSlider(int num);
+    /**
+    @brief Draws a rectangular piece of a slider.
+    
+    @param num Array position of slider to be drawn. Must be an integer between 0 and NUM_SLIDERS-1.
+    @param rx Left edge of the piece in pixels from the left edge of the slider
+    @param ry Top edge of the piece in pixels from the top edge of the slider
+    @param rw Width of the piece in pixels
+    @param rh Height of the piece in pixels
+    @note Internal use only.
+    */
+    void drawSliderRegion(int num, int rx, int ry, int rw, int rh);
+    /**
+    @brief Calculates the size of a slider's fill bar in pixels.
+    
+    @param num Array position of slider. Must be an integer between 0 and NUM_SLIDERS-1.
+    @param cw Width of slider in pixels
+    @param ch Height of slider in pixels
+    @param smx Receives the width of the fill bar, between 0 and cw
+    @param smy Receives the height of the fill bar, between 0 and ch
+    @note Internal use only.
+    */
+    void sliderFill(int num, int cw, int ch, int &smx, int &smy);
+    /**
+    @brief Describes the screen buffer of graph for blitter.
+    
+    @returns The buffer, in the Display Shield's own (portrait) orientation
+    @note Internal use only.
+    */
+    BlitSurface screenSurface(void);
+    /**
+    @brief Turns a rectangle in rotated screen coordinates into the same rectangle in the screen buffer, which is always in portrait orientation.
+    
+    @param x Left edge in pixels. Receives the left edge in the buffer.
+    @param y Top edge in pixels. Receives the top edge in the buffer.
+    @param w Width in pixels. Receives the width in the buffer.
+    @param h Height in pixels. Receives the height in the buffer.
+    @note Internal use only.
+    */
+    void toScreen(int &x, int &y, int &w, int &h);
+    /**
+    @brief Copies a finished canvas to the screen with blitter and waits for it.
+    
+    @param canvas Canvas made with its width and height swapped for landscape rotations and then given the same rotation as the screen, so that its pixels are in the same order as the screen buffer's
+    @param x Left edge on the screen in pixels
+    @param y Top edge on the screen in pixels
+    @note Internal use only.
+    */
+    void present(GFXcanvas16 &canvas, int x, int y);
+    /**
+    @brief Copies a finished 8-bit canvas to the screen with blitter, turning its pixels into colors, and waits for it.
+    
+    @param canvas Canvas made like the one given to present(), whose pixels are numbers in palette
+    @param palette RGB565 color of each pixel value
+    @param colors Colors in palette, up to NUM_PALETTE_COLORS
+    @param x Left edge on the screen in pixels
+    @param y Top edge on the screen in pixels
+    @note Internal use only.
+    */
+    void presentIndexed(GFXcanvas8 &canvas, const uint16_t *palette, int colors, int x, int y);
+    /**
+    @brief Copies a button sprite to the screen with blitter.
+    
+    @param sp Sprite from buttonSprite()
+    @param x Left edge on the screen in pixels
+    @param y Top edge on the screen in pixels
+    @note Internal use only.
+    */
+    void presentSprite(const ButtonSprite &sp, int x, int y);
+    /**
+    @brief Waits for blitter to finish and has graph send its buffer to the display. With a framebuffer, it is flipped instead, unless a frame is being drawn.
+    
+    @note Internal use only.
+    */
+    void endBlits(void);
+    /**
+    @brief Notes that a rectangle of the screen buffer changed, so that the next flip of framebuffer shows it and mirror sends it to the viewer.
+    
+    @param x Left edge in the buffer, in pixels
+    @param y Top edge in the buffer, in pixels
+    @param w Width in the buffer, in pixels
+    @param h Height in the buffer, in pixels
+    @note Internal use only.
+    */
+    void markDirty(int x, int y, int w, int h);
+    /**
+    @brief Shows a control drawn straight into framebuffer: marks its rectangle and flips, unless a frame is being drawn.
+    
+    @param x Left edge on the screen in pixels
+    @param y Top edge on the screen in pixels
+    @param w Width in pixels
+    @param h Height in pixels
+    @note Internal use only.
+    */
+    void presentDirect(int x, int y, int w, int h);
+    /**
+    @brief Draws the background and centered text of a button or text box.
+    
+    @param canvas Canvas or framebuffer window the size of the control
+    @param text Text to show in the largest font that fits
+    @param cw Width of the control in pixels
+    @param ch Height of the control in pixels
+    @param fg Color of the text, or its number in the palette of an 8-bit canvas
+    @param bg Color of the background, or its number in the palette of an 8-bit canvas
+    @note Internal use only.
+    */
+    void drawLabel(Adafruit_GFX &canvas, const String &text, int cw, int ch, uint16_t fg, uint16_t bg);
+    /**
+    @brief Starts a frame. With a framebuffer, the controls drawn until the matching endFrame() reach the screen together in one flip. Frames may be nested, and only the outermost endFrame() flips.
+    
+    drawAll(), showPage() and updateDisplays() draw their controls as a frame. Use this around other drawing that should appear at once.
+    */
+    void beginFrame(void);
+    /**
+    @brief Ends a frame started with beginFrame(), and flips framebuffer if this was the outermost frame.
+    */
+    void endFrame(void);
+    /**
+    @brief Forces the drawing of a text box at the given array position. If it is not on the current page, it is drawn when its page is shown.
     
     @param num Array position of text box to be drawn. Must be an integer between 0 and NUM_TEXTBOXES-1.
     */
     void drawTextbox(int num);
     /**
+    @brief Puts the newest value of a text box's channel into its display text, if the channel has a new value.
+    
+    @param n Array position of a text box bound with Textbox::bindChannel()
+    @note Internal use only.
+    */
+    void showChannel(int n);
+    /**
     @brief Creates an event based on where a touch point is. Determines if touch point is in an input control.
     
     @param touchX x-pixel of touch Event
@@ -106,6 +512,23 @@ public:
     @note Internal use only.
     */
     void locate(int touchX, int touchY);
+    /**
+    @brief Converts a touch point in pixels to percentages of the screen width and height for the current rotation.
+    
+    @param touchX x-pixel of touch point
+    @param touchY y-pixel of touch point
+    @param px Receives the position as a percentage of screen width
+    @param py Receives the position as a percentage of screen height
+    @note Internal use only.
+    */
+    void touchToPercent(int touchX, int touchY, unsigned int &px, unsigned int &py);
+    /**
+    @brief Creates an event from a decoded gesture and takes action if needed.
+    
+    @param g Gesture from the gesture decoder
+    @note Internal use only.
+    */
+    void handleGesture(const Gesture &g);
     
     /**
     @brief Find array index of control given its type and name
@@ -120,36 +543,198 @@ public:
     /**
     @brief Interprets action based on current and previous events.
     If the previous event is in a button and the current is in nothing, a button up action is triggered.
-    If both events are in one slider, a slide motion action takes place.
+    If both events are in one slider, a slide motion action takes place. A press decoded from touch interrupts also moves a slider right away.
     */
     void takeAction(void);
     /**
+    @brief Runs a queued action of a button or slider. While it runs, previousEvent names the control, as it did when actions ran straight from takeAction().
+
+    @param type BUTTON or SLIDER
+    @param num Array position of the control
+    @param alternate true for the hold action of a button or the pinch action of a slider
+    @note Internal use only.
+    */
+    void runAction(ControlType type, int num, bool alternate);
+    /**
+    @brief Queues the slide action of a slider in actions unless it already ran within the slider's actionInterval. In that case the action is marked pending and updateDisplays() queues it later.
+    
+    @param num Array position of slider. Must be an integer between 0 and NUM_SLIDERS-1.
+    @note Internal use only.
+    */
+    void slideAction(int num);
+    /**
     @brief Polls the touch screen for a touch point, creates an event and takes action if needed. It is recommended that this function be called at intervals between 100 and 200 milliseconds. Use judgment if going outside this range.
+    
+    When touch interrupts are enabled, the queued touch samples are decoded instead of polling, and this function may be called as often as you like.
+    
+    This also lets clock align itself with the real-time clock (Timebase::service()).
+    
+    The actions of the buttons and sliders that were touched are queued in actions and run at the end, once the touches are dealt with, highest priority first. Actions stop being started after actionBudget microseconds, or with a governor budget when acquisition work is due (FrameGovernor::inputBudget()), and the rest run on the next call.
     */
     void handleInputs(void);
     /**
     @brief Redraw text boxes where the display text and previous display text are different
+    
+    Sliders that moved are redrawn here as well, at most once every frameInterval milliseconds and only where the fill bar changed. Slide actions held back by Slider::setActionRate() are also queued here.
+    
+    With a governor budget, text boxes are also only redrawn in frames, and a frame only draws for as long as its budget and the time until acquisition work is due allow. Sliders, and then text boxes, that don't fit are left for the next frame, and frames come less often while they still take longer than they had (see FrameGovernor). Buttons are always redrawn at once.
     */
     void updateDisplays(void);
     /**
+    @brief How long drawing may take without delaying acquisition. Used by governor.
+    
+    @returns Microseconds until the next timer of power or the next reading of sensors is due, 0 if one is due now
+    */
+    uint32_t acquisitionHeadroom(void);
+    /**
     @brief Attempts to open a file with the given name on the flash drive.
     
     A flash drive (thumb drive) must be successfully connected and mounted for this function to succeed. If this function succeeds, the file pointer, fp, will be non-NULL. Before using any of the C file writing functions like fprintf, fputs, fwrite, etc., test to make sure that fp is non-NULL and skip if it is NULL.
     
     @param fileName Desired name of file to record to. The string "/usb/" will be placed before the given name to ensure it records to the drive.
     
+    Samples written with recordSample() are also indexed in files with the same name followed by .ix0, .ix1 and so on (see LogIndexWriter), so the recording can be reviewed quickly with LogIndexReader and drawOverview().
+    
+    The data file is buffered in logBufferSize bytes of sdramArena, so the flash drive is written in larger pieces.
+    
     @note The file is opened in append mode. If the file does not exist, it is created. If the file does exist, it is opened and data is added to the end of the file, that is, it does not overwrite the old data.
     
     @note If you want to place the file anywhere other than the top level of the flash drive directory structure, you will have to write the path explicitly and it will only work if the folders exist. Folders that don't exist will not be automatically created.
+    
+    @param compressor If not nullptr, recordSample() gives the samples to this LogCompressor, which writes them to the file in compressed blocks instead of text lines, usually taking a tenth of the space or less. Use a different file name, such as one ending in .gdl, than for text recordings. The index then points to the block holding each sample.
+    */
+    void startDataRecording(String fileName, LogCompressor *compressor = nullptr);
+    /**
+    @brief Records one sample: a time stamp and a set of channel values.
+    
+    If a data file is open, a line with the time in seconds and the values separated by commas is written to it, or the sample is given to the compressor. The sample is also handed to every attached data sink.
+    
+    @param t Time stamp of the sample in microseconds, as from clock.now()
+    @param values Array of channel values
+    @param count Number of values in the array
+    */
+    void recordSample(uint64_t t, const float *values, int count);
+    /**
+    @brief Records the newest values of a run of channels as one sample, so that the data file and the data sinks read the same values as the display.
+    
+    The values are read from channels without waiting for their writers. The sample is time stamped with the newest time stamp among them.
+    
+    @param first Number of the first channel
+    @param count Number of channels, -1 for all from first on
+    @returns false if none of the channels has a value yet
+    */
+    bool recordChannels(int first = 0, int count = -1);
+    /**
+    @brief Draws an overview of one channel of a recording from its index files, without reading the data file.
+    
+    Each pixel column gets a vertical line from the smallest to the largest value recorded during its slice of time, so short spikes are never missed however far the view is zoomed out.
+    
+    @param log Index of the recording, opened with LogIndexReader::open()
+    @param channel Channel to draw, 0 for the first value of each sample
+    @param t0 Start of the time span in microseconds
+    @param t1 End of the time span in microseconds
+    @param yMin Value drawn at the bottom edge
+    @param yMax Value drawn at the top edge
+    @param x Left edge as a percentage of the screen width
+    @param y Top edge as a percentage of the screen height
+    @param w Width as a percentage of the screen width
+    @param h Height as a percentage of the screen height
+    @param fg Color of the data
+    @param bg Background color
+    @returns Number of index records read, or -1 if nothing could be drawn
+    */
+    int drawOverview(LogIndexReader &log, int channel, uint64_t t0, uint64_t t1, float yMin, float yMax,
+                     int x, int y, int w, int h, uint16_t fg, uint16_t bg);
+    /**
+    @brief Attaches another destination for recorded samples.
+    
+    @param s Data sink, such as a TelemetryPublisher. It must exist for as long as it is attached.
+    @returns Array position in sink on success, -1 if all NUM_SINKS positions are taken
+    */
+    int addSink(DataSink *s);
+    /**
+    @brief Detaches a data sink.
+    
+    @param s Data sink that was given to addSink()
+    */
+    void removeSink(DataSink *s);
+    /**
+    @brief Lets every attached data sink move its buffered data on, for example by sending a network packet. Call this on every pass through loop(). It never waits.
+    */
+    void serviceSinks(void);
+    /**
+    @brief Lets the sensors on sensors take their turns on the bus, and records a sample with recordSample() each time one of them finishes a reading. Call this on every pass through loop(). It never waits.
+    
+    Each sample holds the newest values of all the sensors, in the order they were added with SensorBus::addDevice(), time stamped with clock when the reading was taken.
+    
+    If sensorChannel is set, the values of each reading are also put into channels, the first sensor value into channel sensorChannel and the rest after it, so text boxes can be bound to them.
     */
-    void startDataRecording(String fileName);
+    void serviceSensors(void);
+    /**
+    @brief Starts the control timer, which runs the loops of control at their rates from an interrupt, with channels for their inputs, setpoints and outputs.
+    
+    @param tick Microseconds between timer interrupts. Each loop's interval is best a multiple of it.
+    */
+    void startControl(uint32_t tick = CONTROL_TICK);
+    /**
+    @brief Stops the control timer. The outputs stay where they are.
+    */
+    void stopControl(void);
+    /**
+    @brief Runs the control loops that are due. Called from the control timer's interrupt.
+    
+    @note Internal use only.
+    */
+    void controlTick(void);
+    /**
+    @brief Writes a slider's position into the channels it is bound to (Slider::bindChannel()), if it changed.
+    
+    @param num Array position of slider. Must be an integer between 0 and NUM_SLIDERS-1.
+    @note Internal use only.
+    */
+    void publishSlider(int num);
+    /**
+    @brief Starts showing the screen on a computer, through a serial port or a network connection, and taking touches from it as if they came from the touch screen.
+    
+    Everything GigaDAQ draws from now on is sent as it changes, and the whole screen is sent first. Drawing done on graph by the sketch is only sent once it is marked with ScreenMirror::mark().
+    
+    @param m The mirror. It must exist for as long as it is used.
+    @param port Serial port or network connection to the viewer (extras/mirror/mirror_viewer.py). Start it first. Don't use it for a SerialStreamSink as well.
+    */
+    void startMirror(ScreenMirror &m, Stream &port);
+    /**
+    @brief Stops showing the screen on the computer.
+    */
+    void stopMirror(void);
+    /**
+    @brief Sends as much of the changed screen to the viewer as the port takes, and takes in its touches for handleInputs(). Call this on every pass through loop(). It never waits.
+    */
+    void serviceMirror(void);
+    /**
+    @brief Lets the processor sleep if there is nothing to do. Call at the end of loop().
+    
+    Nothing is to do when no actions are queued, no text box or slider on the page needs redrawing (or, with a governor budget, the next frame is not yet due), no finger is on the screen or the viewer of mirror, no touch report is waiting and mirror has sent everything. The processor then sleeps until the next timer of power is due or a sensor on sensors needs the bus, and at most PowerManager::maxSleep. With enableTouchInterrupt(), a touch wakes it up at once. The backlight is dimmed after PowerManager::dimTimeout without a touch.
+    
+    @returns Microseconds slept, 0 if the sketch was busy
+    */
+    uint32_t sleepIfIdle(void);
     /**
     @brief Closes the data file.
     
     Failure to close the file properly will result in a loss of data.
     */
     void endDataRecording();
+    /**
+    @brief Prints one line per memory arena that has a region, with its use, high-water mark, largest free block and failed requests.
+    
+    @param out Where to print, such as Serial
+    */
+    void memoryReport(Print &out);
 
+	Timebase clock;	///< Microsecond clock for time stamping samples, set from the real-time clock by begin()
+	SensorBus sensors;	///< I2C or SPI sensors read in the background by serviceSensors()
+	ControlScheduler control;	///< Closed-loop control tasks run by startControl()
+	mbed::Ticker controlTicker;	///< Timer that runs control
 	tm timeBD;		///< Time structure containing elements of "broken-down" time
 	time_t tmStr;	///< Integer representation of time. Use localtime() to interpret value.
 };
@@ -0,0 +1,445 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the log compressor of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <string.h>
+#include "LogCompress.h"
+
+const int LZ_MIN_MATCH = 4;
+const int LZ_LAST_LITERALS = 5;		//The LZ4 format ends every block with at least this many literal bytes
+const int LZ_MATCH_LIMIT = 12;		//...and starts no match closer than this to the end
+const int MAX_SAMPLE_BYTES = 10 + 6 * LOG_BLOCK_MAX_CHANNELS;	//Longest coded sample
+
+static uint32_t adler32(const uint8_t *data, int len){
+	uint32_t a = 1, b = 0;
+	int i, n;
+
+	while(len > 0){
+		n = (len < 5552) ? len : 5552;		//Most bytes before the sums must be reduced
+		len -= n;
+		for(i = 0; i < n; i++){
+			a += data[i];
+			b += a;
+		}
+		data += n;
+		a %= 65521;
+		b %= 65521;
+	}
+	return (b << 16) | a;
+}
+static int putVarint(uint8_t *p, uint64_t v){
+	int n = 0;
+
+	while(v >= 0x80){
+		p[n++] = (uint8_t)v | 0x80;
+		v >>= 7;
+	}
+	p[n++] = (uint8_t)v;
+	return n;
+}
+//Returns the bytes read, 0 if the code runs past end
+static int getVarint(const uint8_t *p, const uint8_t *end, uint64_t &v){
+	int n = 0, shift = 0;
+
+	v = 0;
+	while(p + n < end && shift < 64){
+		v |= (uint64_t)(p[n] & 0x7F) << shift;
+		if((p[n++] & 0x80) == 0){
+			return n;
+		}
+		shift += 7;
+	}
+	return 0;
+}
+static int varintLength(uint64_t v){
+	int n = 1;
+
+	while(v >= 0x80){
+		v >>= 7;
+		n++;
+	}
+	return n;
+}
+static uint64_t zigzag(int64_t v){
+	return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+static int64_t unzigzag(uint64_t v){
+	return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+//Differing bits without their trailing zeros, with the number of zeros in the low 5 bits. 0 if nothing differs.
+static uint64_t xorCode(uint32_t x){
+	int tz = 0;
+
+	if(x == 0){
+		return 0;
+	}
+	while((x & 1) == 0){
+		x >>= 1;
+		tz++;
+	}
+	return ((uint64_t)x << 5) | tz;
+}
+static uint32_t deltaCode(uint32_t bits, uint32_t prev){
+	return (uint32_t)zigzag((int32_t)(bits - prev));
+}
+
+LogCompressor::LogCompressor(){
+	int i;
+
+	lz = true;
+	maxAge = LOG_BLOCK_MAX_AGE;
+	blocks = 0;
+	writeErrors = 0;
+	rawBytes = 0;
+	storedBytes = 0;
+	file = nullptr;
+	offset = 0;
+	rawLen = 0;
+	count = 0;
+	channels = 0;
+	first = 0;
+	last = 0;
+	lastStep = 0;
+	xorMask = 0;
+	for(i = 0; i < LOG_BLOCK_MAX_CHANNELS; i++){
+		prev[i] = 0;
+		costDelta[i] = 0;
+		costXor[i] = 0;
+		coding[i] = CODING_AUTO;
+	}
+}
+void LogCompressor::setCoding(int channel, ChannelCoding coding){
+	if(channel >= 0 && channel < LOG_BLOCK_MAX_CHANNELS){
+		this->coding[channel] = coding;
+	}
+}
+void LogCompressor::begin(FILE *file, uint32_t offset){
+	this->file = file;
+	this->offset = offset;
+	count = 0;
+	rawLen = 0;
+}
+uint32_t LogCompressor::blockOffset(void){
+	return offset;
+}
+float LogCompressor::ratio(void){
+	return storedBytes ? (float)rawBytes / (float)storedBytes : 0;
+}
+void LogCompressor::startBlock(uint64_t t, int channels){
+	int i;
+
+	for(i = 0; i < LOG_BLOCK_MAX_CHANNELS; i++){
+		if(coding[i] == CODING_XOR){
+			xorMask |= 1 << i;
+		}
+		else if(coding[i] == CODING_DELTA){
+			xorMask &= ~(1 << i);
+		}
+		prev[i] = 0;
+		costDelta[i] = 0;
+		costXor[i] = 0;
+	}
+	this->channels = channels;
+	first = t;
+	last = t;
+	lastStep = 0;
+	rawLen = 0;
+	count = 0;
+}
+bool LogCompressor::add(uint64_t t, const float *values, int count){
+	uint32_t bits;
+	int64_t step;
+	int i;
+	bool ok = true;
+
+	if(file == nullptr || count < 1 || count > LOG_BLOCK_MAX_CHANNELS){
+		return false;
+	}
+	if(this->count > 0 && (count != channels || rawLen + MAX_SAMPLE_BYTES > LOG_BLOCK_BYTES ||
+	   t - first >= (uint64_t)maxAge * 1000)){
+		ok = flush();
+	}
+	if(this->count == 0){
+		startBlock(t, count);
+	}
+
+	step = (int64_t)(t - last);
+	rawLen += putVarint(&raw[rawLen], zigzag(step - lastStep));		//0 while the sampling interval stays the same
+	lastStep = step;
+	last = t;
+	for(i = 0; i < count; i++){
+		memcpy(&bits, &values[i], 4);
+		costDelta[i] += varintLength(deltaCode(bits, prev[i]));
+		costXor[i] += varintLength(xorCode(bits ^ prev[i]));
+		if(xorMask & (1 << i)){
+			rawLen += putVarint(&raw[rawLen], xorCode(bits ^ prev[i]));
+		}
+		else{
+			rawLen += putVarint(&raw[rawLen], deltaCode(bits, prev[i]));
+		}
+		prev[i] = bits;
+	}
+	this->count++;
+	rawBytes += 8 + 4 * count;
+	return ok;
+}
+bool LogCompressor::flush(void){
+	LogBlockHeader h;
+	const uint8_t *stored = raw;
+	int n;
+	bool ok;
+
+	if(file == nullptr || count == 0){
+		return true;
+	}
+	memset(&h, 0, sizeof(h));
+	h.magic = LOG_BLOCK_MAGIC;
+	h.version = LOG_BLOCK_VERSION;
+	h.channels = channels;
+	h.count = count;
+	h.rawLen = rawLen;
+	h.storedLen = rawLen;
+	h.xorMask = xorMask & ((1 << channels) - 1);
+	h.timeLow = (uint32_t)first;
+	h.timeHigh = (uint32_t)(first >> 32);
+	if(lz){
+		n = lzCompress(raw, rawLen, packed, sizeof(packed), table);
+		if(n > 0 && n < rawLen){		//Stored as it is when compression does not help
+			h.flags = LOG_BLOCK_LZ;
+			h.storedLen = n;
+			stored = packed;
+		}
+	}
+	h.check = adler32(stored, h.storedLen);
+
+	ok = fwrite(&h, sizeof(h), 1, file) == 1 && fwrite(stored, 1, h.storedLen, file) == h.storedLen;
+	if(!ok){
+		writeErrors++;
+	}
+	offset += sizeof(h) + h.storedLen;
+	storedBytes += sizeof(h) + h.storedLen;
+	blocks++;
+
+	//Automatic channels take the coding that would have been shorter in this block
+	for(n = 0; n < channels; n++){
+		if(coding[n] == CODING_AUTO){
+			if(costXor[n] < costDelta[n]){
+				xorMask |= 1 << n;
+			}
+			else{
+				xorMask &= ~(1 << n);
+			}
+		}
+	}
+	count = 0;
+	return ok;
+}
+void LogCompressor::end(void){
+	flush();
+	file = nullptr;
+}
+
+static uint32_t read32(const uint8_t *p){
+	uint32_t v;
+
+	memcpy(&v, p, 4);
+	return v;
+}
+static int putLength(uint8_t *out, int op, int n){
+	while(n >= 255){
+		out[op++] = 255;
+		n -= 255;
+	}
+	out[op++] = n;
+	return op;
+}
+int lzCompress(const uint8_t *in, int len, uint8_t *out, int outSize, uint16_t *table){
+	int ip = 0, anchor = 0, op = 0, ref, match, lit, token;
+	uint32_t seq, h;
+
+	if(len < 0 || len > 65535){
+		return -1;
+	}
+	memset(table, 0, sizeof(uint16_t) << LOG_LZ_HASH_BITS);
+	while(ip < len - LZ_MATCH_LIMIT){
+		seq = read32(&in[ip]);
+		h = (seq * 2654435761u) >> (32 - LOG_LZ_HASH_BITS);
+		ref = table[h] - 1;			//Positions are kept plus 1, so 0 is an empty entry
+		table[h] = ip + 1;
+		if(ref < 0 || read32(&in[ref]) != seq){
+			ip++;
+			continue;
+		}
+		match = LZ_MIN_MATCH;
+		while(ip + match < len - LZ_LAST_LITERALS && in[ref + match] == in[ip + match]){
+			match++;
+		}
+
+		lit = ip - anchor;
+		if(op + 1 + lit / 255 + 1 + lit + 2 + (match - LZ_MIN_MATCH) / 255 + 1 > outSize){
+			return -1;
+		}
+		token = op++;
+		out[token] = ((lit < 15) ? lit : 15) << 4;
+		if(lit >= 15){
+			op = putLength(out, op, lit - 15);
+		}
+		memcpy(&out[op], &in[anchor], lit);
+		op += lit;
+		out[op++] = (uint8_t)(ip - ref);
+		out[op++] = (uint8_t)((ip - ref) >> 8);
+		match -= LZ_MIN_MATCH;
+		out[token] |= (match < 15) ? match : 15;
+		if(match >= 15){
+			op = putLength(out, op, match - 15);
+		}
+		ip += match + LZ_MIN_MATCH;
+		anchor = ip;
+	}
+
+	lit = len - anchor;		//The rest goes as literals
+	if(op + 1 + lit / 255 + 1 + lit > outSize){
+		return -1;
+	}
+	token = op++;
+	out[token] = ((lit < 15) ? lit : 15) << 4;
+	if(lit >= 15){
+		op = putLength(out, op, lit - 15);
+	}
+	memcpy(&out[op], &in[anchor], lit);
+	return op + lit;
+}
+int lzDecompress(const uint8_t *in, int len, uint8_t *out, int outSize){
+	int ip = 0, op = 0, lit, match, distance, b, i;
+	uint8_t token;
+
+	while(ip < len){
+		token = in[ip++];
+		lit = token >> 4;
+		if(lit == 15){
+			do{
+				if(ip >= len) return -1;
+				b = in[ip++];
+				lit += b;
+			} while(b == 255);
+		}
+		if(lit > len - ip || lit > outSize - op){
+			return -1;
+		}
+		memcpy(&out[op], &in[ip], lit);
+		ip += lit;
+		op += lit;
+		if(ip == len){		//The last sequence has no match
+			break;
+		}
+
+		if(ip + 2 > len){
+			return -1;
+		}
+		distance = in[ip] | (in[ip + 1] << 8);
+		ip += 2;
+		match = token & 15;
+		if(match == 15){
+			do{
+				if(ip >= len) return -1;
+				b = in[ip++];
+				match += b;
+			} while(b == 255);
+		}
+		match += LZ_MIN_MATCH;
+		if(distance == 0 || distance > op || match > outSize - op){
+			return -1;
+		}
+		for(i = 0; i < match; i++, op++){		//Byte by byte, since the match may overlap what it copies
+			out[op] = out[op - distance];
+		}
+	}
+	return op;
+}
+int decodeLogBlock(const LogBlockHeader &h, const uint8_t *stored, uint8_t *work, uint64_t *t, float *values){
+	const uint8_t *p, *end;
+	uint32_t prev[LOG_BLOCK_MAX_CHANNELS], bits;
+	uint64_t time, code;
+	int64_t step = 0;
+	int i, c, n;
+
+	if(h.magic != LOG_BLOCK_MAGIC || h.version != LOG_BLOCK_VERSION || h.channels < 1 ||
+	   h.channels > LOG_BLOCK_MAX_CHANNELS || h.rawLen > LOG_BLOCK_BYTES || adler32(stored, h.storedLen) != h.check){
+		return -1;
+	}
+	if(h.flags & LOG_BLOCK_LZ){
+		if(lzDecompress(stored, h.storedLen, work, LOG_BLOCK_BYTES) != h.rawLen){
+			return -1;
+		}
+		p = work;
+	}
+	else{
+		if(h.storedLen != h.rawLen){
+			return -1;
+		}
+		p = stored;
+	}
+	end = p + h.rawLen;
+
+	memset(prev, 0, sizeof(prev));
+	time = ((uint64_t)h.timeHigh << 32) | h.timeLow;
+	for(i = 0; i < h.count; i++){
+		if((n = getVarint(p, end, code)) == 0) return -1;
+		p += n;
+		step += unzigzag(code);
+		time += step;
+		t[i] = time;
+		for(c = 0; c < h.channels; c++){
+			if((n = getVarint(p, end, code)) == 0) return -1;
+			p += n;
+			if(h.xorMask & (1 << c)){
+				bits = prev[c] ^ (code ? (uint32_t)(code >> 5) << (code & 31) : 0);
+			}
+			else{
+				bits = prev[c] + (uint32_t)unzigzag(code);
+			}
+			prev[c] = bits;
+			memcpy(&values[i * h.channels + c], &bits, 4);
+		}
+	}
+	return (p == end) ? h.count : -1;
+}
@@ -0,0 +1,179 @@
+/**
+
+@file
+
+This contains the log compressor of the GigaDAQ project, which packs recorded samples into small, self-contained binary blocks so that a slow flash drive can keep up with faster recording. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _LOG_COMPRESS_INCLUDE_
+#define _LOG_COMPRESS_INCLUDE_
+
+#include <stdio.h>
+#include <stdint.h>
+
+const uint32_t LOG_BLOCK_MAGIC = 0x4B4C4447;	///< "GDLK" at the start of every block
+const uint8_t LOG_BLOCK_VERSION = 1;			///< Layout version of LogBlockHeader and the coding of the samples
+const int LOG_BLOCK_BYTES = 4096;				///< Most bytes of coded samples in one block, before LZ compression
+const int LOG_BLOCK_MAX_CHANNELS = 16;			///< Most values per sample
+const uint32_t LOG_BLOCK_MAX_AGE = 10000;		///< Default milliseconds of samples a block may hold before it is written
+const uint8_t LOG_BLOCK_LZ = 0x01;				///< LogBlockHeader::flags: the coded samples are LZ-compressed
+const int LOG_LZ_HASH_BITS = 12;				///< Size of the LZ match table, as a power of 2
+
+/** How the values of a channel are coded, see LogCompressor::setCoding() */
+enum ChannelCoding {
+	CODING_AUTO = 0,	/**< Whichever of the other two took fewer bytes in the previous block */
+	CODING_DELTA = 1,	/**< Difference from the previous value. Best for values that change smoothly. */
+	CODING_XOR = 2		/**< Bits that differ from the previous value. Best for values that jump between a few levels or have few significant digits. */
+};
+
+/**
+@brief Start of every block. It is followed by storedLen bytes: the coded samples, LZ-compressed if flags has LOG_BLOCK_LZ. All values are little-endian.
+
+Every block can be decoded on its own, so a recording can be read from any block, and a damaged block costs only its own samples.
+*/
+struct LogBlockHeader {
+	uint32_t magic;		///< Must be LOG_BLOCK_MAGIC
+	uint8_t version;	///< Must be LOG_BLOCK_VERSION
+	uint8_t channels;	///< Values per sample
+	uint8_t flags;		///< LOG_BLOCK_LZ or 0
+	uint8_t reserved;	///< Always 0
+	uint16_t count;		///< Samples in the block
+	uint16_t rawLen;	///< Bytes of coded samples
+	uint16_t storedLen;	///< Bytes following the header
+	uint16_t xorMask;	///< Bit i set if channel i is coded with CODING_XOR, otherwise CODING_DELTA
+	uint32_t check;		///< Adler-32 checksum of the bytes following the header
+	uint32_t timeLow;	///< Low 32 bits of the time stamp of the first sample in microseconds
+	uint32_t timeHigh;	///< High 32 bits of the same time stamp
+};
+
+static_assert(sizeof(LogBlockHeader) == 28, "LogBlockHeader layout changed");
+
+/**
+@brief Packs samples into compressed blocks as they are recorded. Give one to GigaDAQ::startDataRecording() to record in blocks instead of text lines.
+
+Each sample is coded against the one before it: the time as the change in the sampling interval, which is 0 for regular sampling, and each value as the difference (CODING_DELTA) or the differing bits (CODING_XOR) of its 32 bits. Both are exact, so the recording holds the same numbers as a text file would. The codes are written in as few bytes as they need, so a slowly changing temperature takes one or two bytes per value instead of four. With lz set, each block is then compressed with a fast LZ compressor (the LZ4 block format), which catches repeated patterns.
+
+Memory use is fixed at about 16 KB, in the object itself. Blocks are written when LOG_BLOCK_BYTES of coded samples are collected or the oldest sample is maxAge milliseconds old, so a power cut loses at most one block.
+
+Use extras/logcompress/gdlog_decode.py on a computer to turn a recording back into the usual comma-separated text, or decodeLogBlock() on the GIGA.
+*/
+class LogCompressor {
+public:
+	bool lz;					///< true to LZ-compress every block, false to store the coded samples as they are
+	uint32_t maxAge;			///< Milliseconds of samples (by their time stamps) a block may hold before it is written
+	uint32_t blocks;			///< Blocks written
+	uint32_t writeErrors;		///< Blocks the file did not take completely
+	uint64_t rawBytes;			///< Bytes the samples would take as plain binary: 8 for the time and 4 per value
+	uint64_t storedBytes;		///< Bytes written, with the block headers
+	/** Constructor for a compressor without a file, with every channel on CODING_AUTO and lz on */
+	LogCompressor();
+	/**
+	@brief Chooses how the values of a channel are coded.
+
+	@param channel Channel number, from 0
+	@param coding CODING_AUTO, CODING_DELTA or CODING_XOR
+	*/
+	void setCoding(int channel, ChannelCoding coding);
+	/**
+	@brief Starts writing blocks to a file. GigaDAQ::startDataRecording() calls this.
+
+	@param file File opened for writing in binary
+	@param offset Position in the file where the first block will start
+	*/
+	void begin(FILE *file, uint32_t offset);
+	/**
+	@brief Adds a sample, writing the block first if the sample does not fit in it.
+
+	@param t Time stamp in microseconds
+	@param values Array of channel values
+	@param count Number of values, at most LOG_BLOCK_MAX_CHANNELS. A change in the number starts a new block.
+	@returns false if there is no file, count is bad or a block could not be written
+	*/
+	bool add(uint64_t t, const float *values, int count);
+	/**
+	@brief Writes the samples collected so far as a block.
+
+	@returns false if the block could not be written
+	*/
+	bool flush(void);
+	/** Writes the last block and lets go of the file, which the caller closes */
+	void end(void);
+	/** @returns Position in the file where the block being collected will start, so a LogIndexWriter can point to it */
+	uint32_t blockOffset(void);
+	/** @returns rawBytes divided by storedBytes, 0 before the first block */
+	float ratio(void);
+private:
+	FILE *file;
+	uint32_t offset;
+	uint8_t raw[LOG_BLOCK_BYTES];		//Coded samples of the block being collected
+	uint8_t packed[LOG_BLOCK_BYTES + LOG_BLOCK_BYTES/255 + 16];	//The same after LZ compression
+	uint16_t table[1 << LOG_LZ_HASH_BITS];	//LZ match table
+	int rawLen, count, channels;
+	uint64_t first, last;
+	int64_t lastStep;
+	uint32_t prev[LOG_BLOCK_MAX_CHANNELS];
+	uint32_t costDelta[LOG_BLOCK_MAX_CHANNELS], costXor[LOG_BLOCK_MAX_CHANNELS];	//Bytes each coding would have taken in this block
+	uint16_t xorMask;
+	ChannelCoding coding[LOG_BLOCK_MAX_CHANNELS];
+	void startBlock(uint64_t t, int channels);
+};
+
+/**
+@brief Compresses bytes in the LZ4 block format.
+
+@param in Bytes to compress, at most 65535
+@param len Number of bytes
+@param out Receives the compressed bytes
+@param outSize Room in out. len + len/255 + 16 is always enough.
+@param table Match table of 1 << LOG_LZ_HASH_BITS entries, used as scratch space
+@returns Number of compressed bytes, or -1 if out is too small
+*/
+int lzCompress(const uint8_t *in, int len, uint8_t *out, int outSize, uint16_t *table);
+/**
+@brief Decompresses bytes in the LZ4 block format.
+
+@param in Compressed bytes
+@param len Number of compressed bytes
+@param out Receives the decompressed bytes
+@param outSize Room in out
+@returns Number of decompressed bytes, or -1 if the data is damaged or out is too small
+*/
+int lzDecompress(const uint8_t *in, int len, uint8_t *out, int outSize);
+/**
+@brief Decodes the samples of one block.
+
+@param h Header of the block
+@param stored The storedLen bytes following the header
+@param work Scratch space of LOG_BLOCK_BYTES bytes
+@param t Receives the time stamp of every sample in microseconds. Must have room for h.count values.
+@param values Receives the values of every sample, h.channels per sample. Must have room for h.count * h.channels values.
+@returns Number of samples, or -1 if the block is damaged
+*/
+int decodeLogBlock(const LogBlockHeader &h, const uint8_t *stored, uint8_t *work, uint64_t *t, float *values);
+
+#endif /* _LOG_COMPRESS_INCLUDE_ */
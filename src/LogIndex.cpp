@@ -0,0 +1,339 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the index of recorded data files of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <string.h>
+#include "LogIndex.h"
+
+static void indexName(char *buf, const char *dataName, int level){
+	snprintf(buf, LOG_INDEX_PATH_LEN + 8, "%s.ix%d", dataName, level);
+}
+static bool readHeader(FILE *f, LogIndexHeader &h, int level){
+	return fseek(f, 0, SEEK_SET) == 0 && fread(&h, sizeof(h), 1, f) == 1 &&
+		h.magic == LOG_INDEX_MAGIC && h.version == LOG_INDEX_VERSION && h.level == level;
+}
+
+LogIndexWriter::LogIndexWriter(){
+	int i;
+
+	path[0] = '\0';
+	for(i = 0; i < LOG_INDEX_LEVELS; i++){
+		file[i] = NULL;
+		merged[i] = 0;
+	}
+	channels = 0;
+}
+void LogIndexWriter::begin(const char *dataName){
+	end();
+	strncpy(path, dataName, LOG_INDEX_PATH_LEN - 1);
+	path[LOG_INDEX_PATH_LEN - 1] = '\0';
+}
+bool LogIndexWriter::openFiles(int count){
+	char name[LOG_INDEX_PATH_LEN + 8];
+	LogIndexHeader h;
+	FILE *f;
+	int i;
+
+	channels = (count > LOG_INDEX_MAX_CHANNELS) ? LOG_INDEX_MAX_CHANNELS : count;
+	for(i = 0; i < LOG_INDEX_LEVELS; i++){
+		indexName(name, path, i);
+		f = fopen(name, "rb");
+		if(f != NULL && readHeader(f, h, i) && h.channels == channels){
+			fclose(f);
+			file[i] = fopen(name, "ab");		//Same kind of samples as before: carry on
+		}
+		else{
+			if(f != NULL) fclose(f);
+			file[i] = fopen(name, "wb");		//New or unusable index: start over
+			h.magic = LOG_INDEX_MAGIC;
+			h.version = LOG_INDEX_VERSION;
+			h.channels = channels;
+			h.level = i;
+			if(file[i] != NULL && fwrite(&h, sizeof(h), 1, file[i]) != 1){
+				fclose(file[i]);
+				file[i] = NULL;
+			}
+		}
+		merged[i] = 0;
+	}
+	return file[0] != NULL;
+}
+void LogIndexWriter::closeRecord(int level){
+	LogIndexRecord &r = partial[level];
+	LogIndexRecord *up;
+	int i;
+
+	if(merged[level] == 0){
+		return;
+	}
+	if(file[level] != NULL){
+		fwrite(&r, sizeof(r), 1, file[level]);
+	}
+	merged[level] = 0;
+
+	if(level + 1 < LOG_INDEX_LEVELS){
+		up = &partial[level + 1];
+		if(merged[level + 1] == 0){
+			*up = r;
+		}
+		else{
+			up->tEnd = r.tEnd;
+			up->count += r.count;
+			for(i = 0; i < channels; i++){
+				if(r.min[i] < up->min[i]) up->min[i] = r.min[i];
+				if(r.max[i] > up->max[i]) up->max[i] = r.max[i];
+			}
+		}
+		if(++merged[level + 1] == LOG_INDEX_FANOUT){
+			closeRecord(level + 1);
+		}
+	}
+}
+void LogIndexWriter::add(uint64_t t, uint32_t offset, const float *values, int count){
+	LogIndexRecord &r = partial[0];
+	int i;
+
+	if(path[0] == '\0' || count <= 0){
+		return;
+	}
+	if(channels == 0 && !openFiles(count)){
+		path[0] = '\0';		//No index for this file, but recording goes on
+		return;
+	}
+
+	if(merged[0] == 0){
+		memset(&r, 0, sizeof(r));
+		r.tStart = t;
+		r.offset = offset;
+		for(i = 0; i < channels && i < count; i++){
+			r.min[i] = values[i];
+			r.max[i] = values[i];
+		}
+	}
+	else{
+		for(i = 0; i < channels && i < count; i++){
+			if(values[i] < r.min[i]) r.min[i] = values[i];
+			if(values[i] > r.max[i]) r.max[i] = values[i];
+		}
+	}
+	r.tEnd = t;
+	r.count++;
+	if(++merged[0] == LOG_INDEX_BLOCK){
+		closeRecord(0);
+	}
+}
+void LogIndexWriter::end(void){
+	int i;
+
+	for(i = 0; i < LOG_INDEX_LEVELS; i++){		//Finer levels first, so their last records reach the coarser ones
+		closeRecord(i);
+	}
+	for(i = 0; i < LOG_INDEX_LEVELS; i++){
+		if(file[i] != NULL) fclose(file[i]);
+		file[i] = NULL;
+		merged[i] = 0;
+	}
+	channels = 0;
+	path[0] = '\0';
+}
+
+LogIndexReader::LogIndexReader(){
+	int i;
+
+	for(i = 0; i < LOG_INDEX_LEVELS; i++){
+		file[i] = NULL;
+		count[i] = 0;
+	}
+	numChannels = 0;
+}
+LogIndexReader::~LogIndexReader(){
+	close();
+}
+bool LogIndexReader::open(const char *dataName){
+	char name[LOG_INDEX_PATH_LEN + 8];
+	LogIndexHeader h;
+	long size;
+	int i;
+
+	close();
+	for(i = 0; i < LOG_INDEX_LEVELS; i++){
+		indexName(name, dataName, i);
+		file[i] = fopen(name, "rb");
+		if(file[i] == NULL){
+			continue;
+		}
+		if(!readHeader(file[i], h, i) || (i > 0 && h.channels != numChannels) ||
+		   fseek(file[i], 0, SEEK_END) != 0 || (size = ftell(file[i])) < (long)sizeof(h)){
+			fclose(file[i]);
+			file[i] = NULL;
+			continue;
+		}
+		if(i == 0){
+			numChannels = h.channels;
+		}
+		count[i] = (size - sizeof(h)) / sizeof(LogIndexRecord);
+	}
+	if(file[0] == NULL){
+		close();
+		return false;
+	}
+	return true;
+}
+void LogIndexReader::close(void){
+	int i;
+
+	for(i = 0; i < LOG_INDEX_LEVELS; i++){
+		if(file[i] != NULL) fclose(file[i]);
+		file[i] = NULL;
+		count[i] = 0;
+	}
+	numChannels = 0;
+}
+int LogIndexReader::channels(void){
+	return numChannels;
+}
+uint32_t LogIndexReader::records(int level){
+	return (level >= 0 && level < LOG_INDEX_LEVELS) ? count[level] : 0;
+}
+bool LogIndexReader::readRecord(int level, uint32_t i, LogIndexRecord &r){
+	if(level < 0 || level >= LOG_INDEX_LEVELS || i >= count[level]){
+		return false;
+	}
+	return fseek(file[level], sizeof(LogIndexHeader) + i * sizeof(LogIndexRecord), SEEK_SET) == 0 &&
+		fread(&r, sizeof(r), 1, file[level]) == 1;
+}
+uint32_t LogIndexReader::find(int level, uint64_t t){
+	uint32_t lo = 0, hi = records(level), mid;
+	LogIndexRecord r;
+
+	while(lo < hi){
+		mid = lo + (hi - lo) / 2;
+		if(!readRecord(level, mid, r)){
+			return records(level);
+		}
+		if(r.tEnd < t){
+			lo = mid + 1;
+		}
+		else{
+			hi = mid;
+		}
+	}
+	return lo;
+}
+bool LogIndexReader::seek(uint64_t t, uint32_t &offset){
+	LogIndexRecord r;
+
+	if(!readRecord(0, find(0, t), r)){
+		return false;
+	}
+	offset = r.offset;
+	return true;
+}
+bool LogIndexReader::timeSpan(uint64_t &first, uint64_t &last){
+	LogIndexRecord r;
+
+	if(!readRecord(0, 0, r)){
+		return false;
+	}
+	first = r.tStart;
+	if(!readRecord(0, count[0] - 1, r)){
+		return false;
+	}
+	last = r.tEnd;
+	return true;
+}
+int LogIndexReader::summarize(uint64_t t0, uint64_t t1, int channel, int columns, float *lo, float *hi){
+	const int CHUNK = 32;
+	LogIndexRecord buf[CHUNK];
+	uint64_t span;
+	uint32_t i, start, n;
+	int level, c, c0, c1, read = 0, got, j;
+
+	if(file[0] == NULL || channel < 0 || channel >= numChannels || columns <= 0 || t1 < t0){
+		return -1;
+	}
+	for(c = 0; c < columns; c++){
+		lo[c] = 1.0f;
+		hi[c] = -1.0f;
+	}
+
+	//Coarsest level that still has a record for every column
+	for(level = LOG_INDEX_LEVELS - 1; level > 0; level--){
+		if(file[level] != NULL && find(level, t1) - find(level, t0) >= (uint32_t)columns){
+			break;
+		}
+	}
+
+	span = t1 - t0 + 1;
+	start = find(level, t0);
+	if(start >= count[level] ||
+	   fseek(file[level], sizeof(LogIndexHeader) + start * sizeof(LogIndexRecord), SEEK_SET) != 0){
+		return 0;
+	}
+	for(i = start; i < count[level]; i += got){		//Records are read in chunks to keep the number of reads small
+		n = count[level] - i;
+		got = fread(buf, sizeof(LogIndexRecord), (n < CHUNK) ? n : CHUNK, file[level]);
+		if(got <= 0){
+			break;
+		}
+		for(j = 0; j < got; j++){
+			LogIndexRecord &r = buf[j];
+			if(r.tStart > t1){
+				return read;
+			}
+			read++;
+			c0 = (r.tStart <= t0) ? 0 : (int)((r.tStart - t0) * columns / span);
+			c1 = (r.tEnd >= t1) ? columns - 1 : (int)((r.tEnd - t0) * columns / span);
+			for(c = c0; c <= c1; c++){
+				if(lo[c] > hi[c]){
+					lo[c] = r.min[channel];
+					hi[c] = r.max[channel];
+				}
+				else{
+					if(r.min[channel] < lo[c]) lo[c] = r.min[channel];
+					if(r.max[channel] > hi[c]) hi[c] = r.max[channel];
+				}
+			}
+		}
+	}
+	return read;
+}
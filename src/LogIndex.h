@@ -0,0 +1,185 @@
+/**
+
+@file
+
+This contains the index of recorded data files of the GigaDAQ project, which lets a recording be searched by time and summarized for display without reading the data file itself. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _LOG_INDEX_INCLUDE_
+#define _LOG_INDEX_INCLUDE_
+
+#include <stdio.h>
+#include <stdint.h>
+
+const uint32_t LOG_INDEX_MAGIC = 0x58494447;	///< "GDIX" at the start of every index file
+const uint16_t LOG_INDEX_VERSION = 2;			///< Layout version of LogIndexHeader and LogIndexRecord
+const int LOG_INDEX_LEVELS = 3;					///< Index files per data file, from finest (.ix0) to coarsest
+const int LOG_INDEX_BLOCK = 256;				///< Samples summarized by one record of the finest level
+const int LOG_INDEX_FANOUT = 32;				///< Records of one level summarized by one record of the next coarser level
+const int LOG_INDEX_MAX_CHANNELS = 8;			///< Channels that get minimum and maximum summaries
+const int LOG_INDEX_PATH_LEN = 256;				///< Longest data file path, including the terminating zero
+const uint64_t LOG_INDEX_MAX_BYTES = 0x100000000ULL;	///< Data files must be smaller than this (4 GiB), since offsets are 32 bits. A file on a FAT32 flash drive cannot be larger anyway.
+
+/**
+@brief Start of every index file.
+*/
+struct LogIndexHeader {
+	uint32_t magic;		///< Must be LOG_INDEX_MAGIC
+	uint16_t version;	///< Must be LOG_INDEX_VERSION
+	uint8_t channels;	///< Channels summarized in each record
+	uint8_t level;		///< 0 for the finest level
+};
+
+/**
+@brief Summary of a run of samples in the data file. Index files hold these back-to-back after the header, in time order, so any one of them can be read by its position.
+*/
+struct LogIndexRecord {
+	uint64_t tStart;	///< Time stamp of the first sample in microseconds
+	uint64_t tEnd;		///< Time stamp of the last sample in microseconds
+	uint32_t offset;	///< Position in the data file of the line holding the first sample, which must be before LOG_INDEX_MAX_BYTES
+	uint32_t count;		///< Number of samples summarized
+	float min[LOG_INDEX_MAX_CHANNELS];	///< Smallest value of each channel
+	float max[LOG_INDEX_MAX_CHANNELS];	///< Largest value of each channel
+};
+
+static_assert(sizeof(LogIndexHeader) == 8, "LogIndexHeader layout changed");
+static_assert(sizeof(LogIndexRecord) == 24 + 8*LOG_INDEX_MAX_CHANNELS, "LogIndexRecord layout changed");
+
+/**
+@brief Writes the index files of a data file while it is being recorded. GigaDAQ::recordSample() does this automatically.
+
+Every LOG_INDEX_BLOCK samples, a record with the time span, the position in the data file and the minimum and maximum of each channel is added to the finest index file (the data file name followed by .ix0). Every LOG_INDEX_FANOUT of those are combined into one record of the next file (.ix1), and so on. Index files are only appended to, so a data file that is recorded in several sessions keeps a single index.
+*/
+class LogIndexWriter {
+public:
+	/** Constructor for a writer that has no data file yet */
+	LogIndexWriter();
+	/**
+	@brief Starts indexing a data file. The index files are opened when the first sample arrives.
+
+	@param dataName Full path of the data file, such as "/usb/run1.csv"
+	*/
+	void begin(const char *dataName);
+	/**
+	@brief Adds a sample to the index.
+
+	@param t Time stamp in microseconds
+	@param offset Position in the data file where the sample's line starts
+	@param values Array of channel values
+	@param count Number of values. Only the first LOG_INDEX_MAX_CHANNELS are summarized.
+	*/
+	void add(uint64_t t, uint32_t offset, const float *values, int count);
+	/** Writes the partly filled records and closes the index files */
+	void end(void);
+private:
+	char path[LOG_INDEX_PATH_LEN];
+	FILE *file[LOG_INDEX_LEVELS];
+	LogIndexRecord partial[LOG_INDEX_LEVELS];	//Record being built at each level
+	int merged[LOG_INDEX_LEVELS];				//Samples (level 0) or records (other levels) in partial
+	int channels;								//0 until the index files are open
+	bool openFiles(int count);
+	void closeRecord(int level);
+};
+
+/**
+@brief Reads the index files of a recording to find times and draw overviews quickly, however large the data file is.
+
+Finding a time is a binary search of the records, so it reads only a handful of them. Summaries are read from the coarsest index file that still gives enough detail, so an overview of a whole multi-gigabyte recording reads a few kilobytes.
+*/
+class LogIndexReader {
+public:
+	/** Constructor for a reader that has no files open */
+	LogIndexReader();
+	/** Destructor that closes the index files */
+	~LogIndexReader();
+	/**
+	@brief Opens the index files of a data file.
+
+	@param dataName Full path of the data file, such as "/usb/run1.csv"
+	@returns true if at least the finest index file could be opened
+	*/
+	bool open(const char *dataName);
+	/** Closes the index files */
+	void close(void);
+	/** @returns Channels summarized in the index, 0 if it is not open */
+	int channels(void);
+	/**
+	@param level Index level, 0 for the finest
+	@returns Number of records at the level
+	*/
+	uint32_t records(int level);
+	/**
+	@brief Reads one record.
+
+	@param level Index level, 0 for the finest
+	@param i Position of the record
+	@param r Receives the record
+	@returns true on success
+	*/
+	bool readRecord(int level, uint32_t i, LogIndexRecord &r);
+	/**
+	@brief Finds the first record that ends at or after a given time.
+
+	@param level Index level, 0 for the finest
+	@param t Time stamp in microseconds
+	@returns Position of the record, or records(level) if every record ends earlier
+	*/
+	uint32_t find(int level, uint64_t t);
+	/**
+	@brief Finds where to start reading the data file to get the samples from a given time on.
+
+	@param t Time stamp in microseconds
+	@param offset Receives the position in the data file. No more than LOG_INDEX_BLOCK lines need to be skipped from there to reach time t.
+	@returns true if the recording reaches time t
+	*/
+	bool seek(uint64_t t, uint32_t &offset);
+	/**
+	@brief Gets the time stamps of the first and last samples in the recording.
+
+	@returns true if the index holds any records
+	*/
+	bool timeSpan(uint64_t &first, uint64_t &last);
+	/**
+	@brief Finds the minimum and maximum of one channel over equal slices of a time span, such as one slice per pixel column of a graph.
+
+	@param t0 Start of the span in microseconds
+	@param t1 End of the span in microseconds
+	@param channel Channel to summarize
+	@param columns Number of slices
+	@param lo Receives the minimum of each slice. Must have room for columns values.
+	@param hi Receives the maximum of each slice. Slices without data are left with lo greater than hi.
+	@returns Number of index records read, or -1 if the index is not open or the arguments are bad
+	*/
+	int summarize(uint64_t t0, uint64_t t1, int channel, int columns, float *lo, float *hi);
+private:
+	FILE *file[LOG_INDEX_LEVELS];
+	uint32_t count[LOG_INDEX_LEVELS];
+	int numChannels;
+};
+
+#endif /* _LOG_INDEX_INCLUDE_ */
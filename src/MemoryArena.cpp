@@ -0,0 +1,220 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the memory arenas of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include "MemoryArena.h"
+
+const uint32_t BLOCK_MAGIC = 0x4B4C4241;	//"ABLK", to catch blocks that did not come from the arena
+
+//Bookkeeping in front of every block. Blocks follow each other through the whole region, so the next one is size bytes on and the previous one prevSize bytes back.
+struct ArenaBlock {
+	uint32_t size;		//Bytes in the block, including this header
+	uint32_t prevSize;	//Bytes in the previous block, 0 for the first block
+	uint32_t magic;
+	uint32_t inUse;
+};
+
+static_assert(sizeof(ArenaBlock) <= ARENA_ALIGN, "ArenaBlock must fit in front of an aligned block");
+
+MemoryArena::MemoryArena(){
+	name = "";
+	allocations = 0;
+	failures = 0;
+	base = nullptr;
+	bytes = 0;
+	inUse = 0;
+	highWater = 0;
+}
+bool MemoryArena::begin(const char *name, void *base, size_t size){
+	uintptr_t start = (uintptr_t)base, aligned = (start + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1);
+	ArenaBlock *b;
+
+	this->name = name;
+	this->base = nullptr;
+	bytes = 0;
+	inUse = 0;
+	highWater = 0;
+	allocations = 0;
+	failures = 0;
+	if(base == nullptr || size < aligned - start + 2*ARENA_ALIGN){
+		return false;
+	}
+	size = (size - (aligned - start)) & ~(ARENA_ALIGN - 1);
+	if(size > 0xFFFFFFE0){
+		size = 0xFFFFFFE0;
+	}
+	this->base = (uint8_t *)aligned;
+	bytes = size;
+	b = (ArenaBlock *)this->base;		//One free block covers the whole region
+	b->size = bytes;
+	b->prevSize = 0;
+	b->magic = BLOCK_MAGIC;
+	b->inUse = 0;
+	return true;
+}
+bool MemoryArena::ready(void){
+	return base != nullptr;
+}
+void *MemoryArena::alloc(size_t n){
+	ArenaBlock *b, *best = nullptr, *rest, *after;
+	size_t need;
+	uint8_t *p;
+
+	if(base == nullptr || n > bytes){
+		failures++;
+		return nullptr;
+	}
+	need = ARENA_ALIGN + ((n + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1));
+	if(n == 0){
+		need += ARENA_ALIGN;
+	}
+
+	//The smallest free block that fits leaves the large ones for large requests, such as canvases
+	for(p = base; p < base + bytes; p += b->size){
+		b = (ArenaBlock *)p;
+		if(!b->inUse && b->size >= need && (best == nullptr || b->size < best->size)){
+			best = b;
+		}
+	}
+	if(best == nullptr){
+		failures++;
+		return nullptr;
+	}
+
+	if(best->size - need >= 2*ARENA_ALIGN){		//Split off the rest as a free block
+		rest = (ArenaBlock *)((uint8_t *)best + need);
+		rest->size = best->size - need;
+		rest->prevSize = need;
+		rest->magic = BLOCK_MAGIC;
+		rest->inUse = 0;
+		after = (ArenaBlock *)((uint8_t *)rest + rest->size);
+		if((uint8_t *)after < base + bytes){
+			after->prevSize = rest->size;
+		}
+		best->size = need;
+	}
+	best->inUse = 1;
+	inUse += best->size;
+	if(inUse > highWater){
+		highWater = inUse;
+	}
+	allocations++;
+	return (uint8_t *)best + ARENA_ALIGN;
+}
+void MemoryArena::release(void *p){
+	ArenaBlock *b, *next, *prev;
+
+	if(p == nullptr || !owns(p) || ((uintptr_t)p & (ARENA_ALIGN - 1)) != 0){
+		return;
+	}
+	b = (ArenaBlock *)((uint8_t *)p - ARENA_ALIGN);
+	if(b->magic != BLOCK_MAGIC || !b->inUse){
+		return;			//Not a block, or given back twice
+	}
+	b->inUse = 0;
+	inUse -= b->size;
+
+	next = (ArenaBlock *)((uint8_t *)b + b->size);
+	if((uint8_t *)next < base + bytes && !next->inUse){
+		b->size += next->size;
+		next->magic = 0;
+	}
+	if(b->prevSize != 0){
+		prev = (ArenaBlock *)((uint8_t *)b - b->prevSize);
+		if(!prev->inUse){
+			prev->size += b->size;
+			b->magic = 0;
+			b = prev;
+		}
+	}
+	next = (ArenaBlock *)((uint8_t *)b + b->size);
+	if((uint8_t *)next < base + bytes){
+		next->prevSize = b->size;
+	}
+}
+bool MemoryArena::owns(const void *p){
+	return base != nullptr && (const uint8_t *)p >= base && (const uint8_t *)p < base + bytes;
+}
+size_t MemoryArena::size(void){
+	return bytes;
+}
+size_t MemoryArena::used(void){
+	return inUse;
+}
+size_t MemoryArena::peak(void){
+	return highWater;
+}
+size_t MemoryArena::largestFree(void){
+	ArenaBlock *b;
+	size_t largest = 0;
+	uint8_t *p;
+
+	if(base == nullptr){
+		return 0;
+	}
+	for(p = base; p < base + bytes; p += b->size){
+		b = (ArenaBlock *)p;
+		if(!b->inUse && b->size - ARENA_ALIGN > largest){
+			largest = b->size - ARENA_ALIGN;
+		}
+	}
+	return largest;
+}
+void MemoryArena::resetPeak(void){
+	highWater = inUse;
+}
+int MemoryArena::report(char *buf, size_t len){
+	ArenaBlock *b;
+	unsigned blocks = 0;
+	uint8_t *p;
+
+	for(p = base; base != nullptr && p < base + bytes; p += b->size){
+		b = (ArenaBlock *)p;
+		if(b->inUse){
+			blocks++;
+		}
+	}
+	return snprintf(buf, len, "%s: %lu of %lu bytes used, peak %lu, largest free %lu, %u blocks, %lu failures",
+		name, (unsigned long)inUse, (unsigned long)bytes, (unsigned long)highWater,
+		(unsigned long)largestFree(), blocks, (unsigned long)failures);
+}
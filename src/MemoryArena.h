@@ -0,0 +1,104 @@
+/**
+
+@file
+
+This contains the memory arenas of the GigaDAQ project, which keep large buffers in the external SDRAM and small, busy data in the fast internal RAM, and keep track of how much of each is used. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _MEMORY_ARENA_INCLUDE_
+#define _MEMORY_ARENA_INCLUDE_
+
+#include <stddef.h>
+#include <stdint.h>
+
+const size_t ARENA_ALIGN = 32;		///< Alignment of every block, the size of a cache line, so that cache maintenance for DMA never touches a neighboring block
+
+/**
+@brief A fixed region of memory that blocks are taken from and given back to, with a record of how full it has been.
+
+The region is given once with begin() and never grows, so running out shows up as alloc() returning nullptr and being counted in failures, not as the whole heap running out. Blocks may be given back in any order; neighboring free blocks are joined again. Each block starts on an ARENA_ALIGN boundary and takes ARENA_ALIGN bytes of bookkeeping in front of it.
+
+@note Not safe to use from interrupts.
+*/
+class MemoryArena {
+public:
+	const char *name;		///< Name shown in reports
+	uint32_t allocations;	///< Blocks handed out so far
+	uint32_t failures;		///< Requests that could not be met
+	/** Constructor for an arena without a region */
+	MemoryArena();
+	/**
+	@brief Sets the region the arena hands out. Anything handed out before is forgotten.
+
+	@param name Name shown in reports. It must exist for as long as the arena.
+	@param base Start of the region
+	@param size Bytes in the region
+	@returns true if the region is large enough to be used
+	*/
+	bool begin(const char *name, void *base, size_t size);
+	/** @returns true once begin() has been given a usable region */
+	bool ready(void);
+	/**
+	@brief Takes a block from the arena.
+
+	@param bytes Size of the block
+	@returns The block, aligned to ARENA_ALIGN, or nullptr if there is no free block that large
+	*/
+	void *alloc(size_t bytes);
+	/**
+	@brief Gives a block back.
+
+	@param p Block from alloc(). nullptr is ignored.
+	*/
+	void release(void *p);
+	/** @returns true if p points into the arena's region */
+	bool owns(const void *p);
+	/** @returns Bytes in the region */
+	size_t size(void);
+	/** @returns Bytes in use, including bookkeeping */
+	size_t used(void);
+	/** @returns Most bytes that have been in use at once (the high-water mark) */
+	size_t peak(void);
+	/** @returns Size of the largest block that alloc() could hand out now. Much less than size() - used() means the free space is broken up. */
+	size_t largestFree(void);
+	/** Starts the high-water mark again from the bytes now in use */
+	void resetPeak(void);
+	/**
+	@brief Writes a one-line summary, such as "sdram: 1572928 of 4194304 bytes used, peak 2359360, largest free 2621376, 12 blocks, 0 failures".
+
+	@param buf Receives the text
+	@param len Size of buf
+	@returns Length of the text, as snprintf()
+	*/
+	int report(char *buf, size_t len);
+private:
+	uint8_t *base;
+	size_t bytes, inUse, highWater;
+};
+
+#endif /* _MEMORY_ARENA_INCLUDE_ */
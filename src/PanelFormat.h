@@ -0,0 +1,86 @@
+/**
+
+@file
+
+This describes the binary panel layout files of the GigaDAQ project. A panel file holds the controls of a user interface (names, geometry, colors, text and the names of their actions) so that a layout can be changed by copying a file to the flash drive instead of uploading a new sketch. Panel files are made from a text description with the panelc tool in the extras folder. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+This header only depends on stdint.h so that panelc can use the same definitions on a desktop computer.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _PANEL_FORMAT_INCLUDE_
+#define _PANEL_FORMAT_INCLUDE_
+
+#include <stdint.h>
+
+const uint32_t PANEL_MAGIC = 0x4C4E5047;	///< "GPNL" at the start of every panel file
+const uint16_t PANEL_VERSION = 1;			///< Layout version of PanelHeader and PanelRecord
+const int PANEL_NAME_LEN = 24;				///< Bytes reserved for a control name, including the terminating zero
+const int PANEL_TEXT_LEN = 32;				///< Bytes reserved for the initial display text, including the terminating zero
+const int PANEL_ACTION_LEN = 16;			///< Bytes reserved for an action name, including the terminating zero
+
+/**
+@brief Start of a panel file. It is followed by count PanelRecord structures.
+
+All values are stored little-endian, which is the native byte order of the GIGA and of desktop computers, so the file is read straight into these structures.
+*/
+struct PanelHeader {
+	uint32_t magic;		///< Must be PANEL_MAGIC
+	uint16_t version;	///< Must be PANEL_VERSION
+	uint16_t count;		///< Number of PanelRecord structures that follow
+};
+
+/**
+@brief One control in a panel file.
+*/
+struct PanelRecord {
+	uint8_t type;		///< ControlType of the control (BUTTON, SLIDER or TEXTBOX)
+	uint8_t slot;		///< Array position of the control in the GigaDAQ object
+	uint8_t mode;		///< SliderMode of a slider, 0 otherwise
+	uint8_t page;		///< Page the control belongs to
+	uint8_t x;			///< Left position of control as a percentage of screen width
+	uint8_t y;			///< Top position of control as a percentage of screen height
+	uint8_t w;			///< Width of control as a percentage of screen width
+	uint8_t h;			///< Height of control as a percentage of screen height
+	uint16_t fgColor;	///< Foreground color in 5-6-5 format
+	uint16_t bgColor;	///< Background color in 5-6-5 format
+	float minX;			///< Slider only: value at left edge
+	float maxX;			///< Slider only: value at right edge
+	float minY;			///< Slider only: value at bottom edge
+	float maxY;			///< Slider only: value at top edge
+	float posX;			///< Slider only: starting x-value
+	float posY;			///< Slider only: starting y-value
+	char name[PANEL_NAME_LEN];		///< Unique identifier of the control
+	char text[PANEL_TEXT_LEN];		///< Initial display text
+	char action[PANEL_ACTION_LEN];	///< Name of the button up or slide action, empty for none
+	char action2[PANEL_ACTION_LEN];	///< Name of the button hold or trackpad pinch action, empty for none
+};
+
+static_assert(sizeof(PanelHeader) == 8, "PanelHeader must match the file layout");
+static_assert(sizeof(PanelRecord) == 124, "PanelRecord must match the file layout");
+
+#endif /* _PANEL_FORMAT_INCLUDE_ */
@@ -0,0 +1,197 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the power manager of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+Sleeping uses the event flags of Mbed OS. Elsewhere, such as on a computer with a simulated clock (see extras/power), a sleep function must be supplied.
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "PowerManager.h"
+
+#if defined(MBED_CONF_RTOS_PRESENT)
+#include "rtos/EventFlags.h"
+
+static rtos::EventFlags wakeFlags;
+
+//Waiting on event flags lets the RTOS halt the processor until the timeout or an interrupt sets the flag
+static void rtosSleep(uint32_t us){
+	wakeFlags.wait_any_for(1, rtos::Kernel::Clock::duration_u32(us / 1000));
+}
+#endif
+
+static Timebase counterClock;		//For a PowerManager on its own. GigaDAQ points clock at GigaDAQ::clock instead.
+
+static uint64_t counterTicks(void){
+	return counterClock.ticks();
+}
+
+PowerManager::PowerManager(){
+	int i;
+
+	clock = counterTicks;
+#if defined(MBED_CONF_RTOS_PRESENT)
+	sleep = rtosSleep;
+#else
+	sleep = nullptr;
+#endif
+	backlight = nullptr;
+	maxSleep = POWER_MAX_SLEEP;
+	dimTimeout = DIM_TIMEOUT;
+	dimLevel = DIM_LEVEL;
+	brightLevel = BRIGHT_LEVEL;
+	dimmed = false;
+	sleeps = 0;
+	for(i = 0; i < NUM_POWER_TIMERS; i++){
+		next[i] = 0;
+		interval[i] = 0;
+	}
+	lastActivity = 0;
+	statStart = 0;
+	asleep = 0;
+}
+uint64_t PowerManager::ticks(void){
+	return clock();
+}
+int PowerManager::addTimer(uint32_t interval){
+	int i;
+
+	if(interval == 0){
+		return -1;
+	}
+	for(i = 0; i < NUM_POWER_TIMERS; i++){
+		if(this->interval[i] == 0){
+			this->interval[i] = (uint64_t)interval * 1000;
+			next[i] = ticks();		//The first run is due at once
+			return i;
+		}
+	}
+	return -1;
+}
+void PowerManager::setInterval(int timer, uint32_t interval){
+	if(timer < 0 || timer >= NUM_POWER_TIMERS || this->interval[timer] == 0 || interval == 0){
+		return;
+	}
+	this->interval[timer] = (uint64_t)interval * 1000;
+	next[timer] = ticks() + this->interval[timer];
+}
+bool PowerManager::due(int timer){
+	uint64_t now;
+
+	if(timer < 0 || timer >= NUM_POWER_TIMERS || interval[timer] == 0){
+		return false;
+	}
+	now = ticks();
+	if(now < next[timer]){
+		return false;
+	}
+	next[timer] += interval[timer];
+	if(next[timer] <= now){		//Fell behind: start counting again from now rather than running several times in a row
+		next[timer] = now + interval[timer];
+	}
+	return true;
+}
+uint32_t PowerManager::untilNext(uint64_t now){
+	uint64_t wait = (uint64_t)maxSleep * 1000;
+	int i;
+
+	for(i = 0; i < NUM_POWER_TIMERS; i++){
+		if(interval[i] == 0){
+			continue;
+		}
+		if(next[i] <= now){
+			return 0;
+		}
+		if(next[i] - now < wait){
+			wait = next[i] - now;
+		}
+	}
+	return (uint32_t)wait;
+}
+void PowerManager::setBacklight(int percent){
+	if(backlight != nullptr){
+		backlight(percent);
+	}
+}
+void PowerManager::activity(void){
+	lastActivity = ticks();
+	if(dimmed){
+		dimmed = false;
+		setBacklight(brightLevel);
+	}
+}
+uint32_t PowerManager::idle(uint32_t limit){
+	uint64_t now = ticks();
+	uint32_t us;
+
+	if(dimTimeout > 0 && !dimmed && now - lastActivity >= (uint64_t)dimTimeout * 1000){
+		dimmed = true;
+		setBacklight(dimLevel);
+	}
+	us = untilNext(now);
+	if(us > limit){
+		us = limit;
+	}
+	if(sleep == nullptr || us < POWER_MIN_SLEEP){
+		return 0;
+	}
+	sleep(us);
+	sleeps++;
+	us = (uint32_t)(ticks() - now);
+	asleep += us;
+	return us;
+}
+void PowerManager::wake(void){
+#if defined(MBED_CONF_RTOS_PRESENT)
+	wakeFlags.set(1);
+#endif
+}
+float PowerManager::sleepFraction(void){
+	uint64_t now = ticks();
+
+	if(now <= statStart){
+		return 0;
+	}
+	return (float)asleep / (float)(now - statStart);
+}
+void PowerManager::resetStats(void){
+	statStart = ticks();
+	asleep = 0;
+	sleeps = 0;
+}
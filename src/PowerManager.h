@@ -0,0 +1,122 @@
+/**
+
+@file
+
+This contains the power manager of the GigaDAQ project, which lets the processor sleep while there is nothing to do and dims the screen when nobody is using it. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _POWER_MANAGER_INCLUDE_
+#define _POWER_MANAGER_INCLUDE_
+
+#include "Arduino.h"
+#include "Timebase.h"
+
+const int NUM_POWER_TIMERS = 8;				///< Maximum number of timers in a PowerManager
+const uint32_t POWER_MAX_SLEEP = 1000;		///< Default longest sleep in milliseconds, so that the clock and sensors are still looked after regularly
+const uint32_t POWER_MIN_SLEEP = 1000;		///< Microseconds below which it is not worth going to sleep
+const uint32_t DIM_TIMEOUT = 60000;			///< Default milliseconds without a touch before the screen is dimmed
+const int DIM_LEVEL = 10;					///< Default backlight brightness when dimmed, in percent
+const int BRIGHT_LEVEL = 100;				///< Default backlight brightness in use, in percent
+
+/**
+@brief Lets the processor sleep until there is something to do, and dims the backlight when the screen has not been touched for a while.
+
+Sketches usually run loop() as fast as they can, although most passes find nothing to do. With a PowerManager, the work that happens at intervals is timed with timers (addTimer() and due()) instead of comparing millis() by hand, so the PowerManager always knows when the next piece of work is due. When the sketch is idle, idle() sleeps until then, or until wake() is called, for example by the touch screen interrupt. GigaDAQ::sleepIfIdle() decides whether the sketch is idle and does this for GigaDAQ::power.
+
+@note The clock is a Timebase counter extended to 64 bits, so it must be read at least once every 71 minutes. Calling due() or idle() on every pass through loop() takes care of this.
+*/
+class PowerManager {
+public:
+	uint64_t (*clock)(void);		///< Microseconds since power-up, extended to 64 bits. Reads GigaDAQ::clock.ticks() in GigaDAQ::power, otherwise a Timebase of its own.
+	void (*sleep)(uint32_t us);		///< Sleeps for up to us microseconds, returning early when wake() is called. On the GIGA it lets the processor halt until an interrupt.
+	void (*backlight)(int percent);	///< Sets the backlight brightness from 0 (off) to 100, nullptr if the backlight is not controlled
+	uint32_t maxSleep;				///< Longest sleep in milliseconds
+	uint32_t dimTimeout;			///< Milliseconds without activity() before the backlight is dimmed, 0 never to dim it
+	int dimLevel;					///< Backlight brightness when dimmed, in percent
+	int brightLevel;				///< Backlight brightness in use, in percent
+	bool dimmed;					///< True while the backlight is dimmed
+	uint32_t sleeps;				///< Number of times the processor went to sleep
+	/** Constructor for a power manager without timers */
+	PowerManager();
+	/**
+	@brief Adds a timer for work that is done at regular intervals.
+
+	@param interval Milliseconds between runs
+	@returns Number of the timer to pass to due(), or -1 if there are already NUM_POWER_TIMERS timers
+	*/
+	int addTimer(uint32_t interval);
+	/**
+	@brief Changes the interval of a timer. The next run is one new interval from now.
+
+	@param timer Number of the timer, from addTimer()
+	@param interval Milliseconds between runs
+	*/
+	void setInterval(int timer, uint32_t interval);
+	/**
+	@brief Checks whether it is time for the work of a timer. Call on every pass through loop().
+
+	@param timer Number of the timer, from addTimer()
+	@returns true once every interval. If the sketch fell behind by more than an interval, the missed runs are skipped.
+	*/
+	bool due(int timer);
+	/**
+	@param now Microseconds, as from ticks()
+	@returns Microseconds until the next timer is due, 0 if one is already due, and never more than maxSleep
+	*/
+	uint32_t untilNext(uint64_t now);
+	/**
+	@brief Notes that somebody is using the screen, which restores the backlight and restarts the dimming timeout. GigaDAQ::handleInputs() calls this on every touch.
+	*/
+	void activity(void);
+	/**
+	@brief Dims the backlight if dimTimeout has passed and then sleeps until the next timer is due, or for at most limit microseconds.
+
+	@param limit Most microseconds to sleep, for example until a sensor is due
+	@returns Microseconds slept
+	*/
+	uint32_t idle(uint32_t limit = 0xFFFFFFFF);
+	/** Ends a sleep early. Safe to call from interrupts. */
+	void wake(void);
+	/** @returns Fraction of the time since power-up or resetStats() spent asleep, from 0 to 1 */
+	float sleepFraction(void);
+	/** Starts the sleep statistics over */
+	void resetStats(void);
+	/**
+	@brief Reads the clock.
+
+	@returns Microseconds since power-up
+	*/
+	uint64_t ticks(void);
+private:
+	uint64_t next[NUM_POWER_TIMERS];		//When each timer is due
+	uint64_t interval[NUM_POWER_TIMERS];	//Microseconds between runs, 0 for a free timer
+	uint64_t lastActivity, statStart, asleep;
+	void setBacklight(int percent);
+};
+
+#endif /* _POWER_MANAGER_INCLUDE_ */
@@ -0,0 +1,482 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the screen mirror of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <string.h>
+#include "ScreenMirror.h"
+#include "SerialStream.h"
+
+//Colors with 0 to MIRROR_MAX_DEPTH low bits of red, green and blue dropped
+static const uint16_t depthMask[MIRROR_MAX_DEPTH + 1] = {0xFFFF, 0xF7DE, 0xE79C, 0xC718};
+static const int MERGE_SLACK = 1024;		//Pixels a merged rectangle may cover that neither part did
+
+static int64_t area(int x0, int y0, int x1, int y1){
+	return (x1 > x0 && y1 > y0) ? (int64_t)(x1 - x0) * (y1 - y0) : 0;
+}
+//Pixels that the rectangle around a and b covers and they don't
+static int64_t waste(int ax0, int ay0, int ax1, int ay1, int bx0, int by0, int bx1, int by1){
+	int64_t covered = area(ax0, ay0, ax1, ay1) + area(bx0, by0, bx1, by1) -
+	                  area(max(ax0, bx0), max(ay0, by0), min(ax1, bx1), min(ay1, by1));
+	return area(min(ax0, bx0), min(ay0, by0), max(ax1, bx1), max(ay1, by1)) - covered;
+}
+static int paletteRow(const uint16_t *px, int w, uint16_t mask, uint16_t *palette, int &colors, uint8_t *out, int room){
+	int i = 0, n = colors, len = 0, k, run;
+	uint16_t c;
+
+	while(i < w){
+		c = px[i] & mask;
+		for(run = 1; i + run < w && (px[i + run] & mask) == c && run < 287; run++){}
+		for(k = 0; k < n && palette[k] != c; k++){}
+		if(k == n){
+			if(n == MIRROR_PALETTE_COLORS){
+				return -1;
+			}
+			palette[n++] = c;
+		}
+		if(len + ((run < 32) ? 1 : 2) > room){
+			return -1;
+		}
+		if(run < 32){
+			out[len++] = (k << 5) | (run - 1);
+		}
+		else{
+			out[len++] = (k << 5) | 31;
+			out[len++] = run - 32;
+		}
+		i += run;
+	}
+	colors = n;		//Only a row that fitted adds its colors
+	return len;
+}
+static int rleRow(const uint16_t *px, int w, uint16_t mask, uint8_t *out, int room){
+	int i = 0, len = 0, run;
+	uint16_t c;
+
+	while(i < w){
+		c = px[i] & mask;
+		for(run = 1; i + run < w && (px[i + run] & mask) == c && run < 256; run++){}
+		if(len + 3 > room){
+			return -1;
+		}
+		out[len] = run - 1;
+		memcpy(&out[len + 1], &c, 2);
+		len += 3;
+		i += run;
+	}
+	return len;
+}
+static int rawRow(const uint16_t *px, int w, uint16_t mask, uint8_t *out, int room){
+	uint16_t c;
+	int i;
+
+	if(2 * w > room){
+		return -1;
+	}
+	for(i = 0; i < w; i++){
+		c = px[i] & mask;
+		memcpy(&out[2 * i], &c, 2);
+	}
+	return 2 * w;
+}
+
+ScreenMirror::ScreenMirror(){
+	minInterval = MIRROR_INTERVAL;
+	maxRate = 0;
+	adaptive = true;
+	depth = 0;
+	updatesSent = 0;
+	framesSent = 0;
+	bytesSent = 0;
+	pixelsSent = 0;
+	badFrames = 0;
+	touchReports = 0;
+	port = nullptr;
+	coarse = Rect{0, 0, 0, 0};
+	pendingCount = 0;
+	sendingCount = 0;
+	current = 0;
+	row = 0;
+	needInfo = false;
+	width = 0;
+	height = 0;
+	rotation = 0;
+	outLen = 0;
+	outPos = 0;
+	inLen = 0;
+	seq = 0;
+	updateStart = 0;
+	lastUpdate = 0;
+	lastHeard = 0;
+	lastRepeat = 0;
+	lastSlow = 0;
+	allowance = 0;
+	lastRefill = 0;
+	rateStart = 0;
+	rateBytes = 0;
+	rate = 0;
+	rateUpdates = 0;
+	updateRate = 0;
+}
+void ScreenMirror::begin(Stream &port, int width, int height, uint8_t rotation){
+	this->port = &port;
+	this->width = width;
+	this->height = height;
+	this->rotation = rotation;
+	pendingCount = 0;
+	sendingCount = 0;
+	outLen = 0;
+	outPos = 0;
+	inLen = 0;
+	depth = 0;
+	coarse = Rect{0, 0, 0, 0};
+	remote = TouchSample();
+	needInfo = true;
+	mark(0, 0, width, height);
+	rateStart = lastRefill = lastSlow = millis();
+}
+void ScreenMirror::end(void){
+	port = nullptr;
+}
+void ScreenMirror::addRect(Rect *list, int &count, Rect r){
+	Rect all[MIRROR_RECTS + 1];
+	int64_t w, best = -1;
+	int i, j, bi = 0, bj = 0;
+
+	//Swallow every rectangle the new one overlaps or nearly touches, growing it as it goes
+	for(i = 0; i < count; ){
+		Rect &a = list[i];
+		if(waste(a.x0, a.y0, a.x1, a.y1, r.x0, r.y0, r.x1, r.y1) <= MERGE_SLACK){
+			r = Rect{min(a.x0, r.x0), min(a.y0, r.y0), max(a.x1, r.x1), max(a.y1, r.y1)};
+			list[i] = list[--count];
+			i = 0;
+		}
+		else{
+			i++;
+		}
+	}
+	if(count < MIRROR_RECTS){
+		list[count++] = r;
+		return;
+	}
+	//Too many apart: merge the two that waste least together
+	memcpy(all, list, count * sizeof(Rect));
+	all[count] = r;
+	for(i = 0; i <= count; i++){
+		for(j = i + 1; j <= count; j++){
+			w = waste(all[i].x0, all[i].y0, all[i].x1, all[i].y1, all[j].x0, all[j].y0, all[j].x1, all[j].y1);
+			if(best < 0 || w < best){
+				best = w;
+				bi = i;
+				bj = j;
+			}
+		}
+	}
+	all[bi] = Rect{min(all[bi].x0, all[bj].x0), min(all[bi].y0, all[bj].y0), max(all[bi].x1, all[bj].x1), max(all[bi].y1, all[bj].y1)};
+	all[bj] = all[count];
+	memcpy(list, all, count * sizeof(Rect));
+}
+void ScreenMirror::mark(int x, int y, int w, int h){
+	Rect r = {max(x, 0), max(y, 0), min(x + w, width), min(y + h, height)};
+
+	if(port == nullptr || r.x1 <= r.x0 || r.y1 <= r.y0){
+		return;
+	}
+	addRect(pending, pendingCount, r);
+}
+void ScreenMirror::receive(void){
+	uint8_t buf[sizeof(in)];
+	MirrorTouch m;
+	uint32_t crc;
+	int c, n;
+
+	while(port->available() > 0 && (c = port->read()) >= 0){
+		if(c != 0){
+			if(inLen < (int)sizeof(in)){
+				in[inLen] = c;
+			}
+			inLen++;		//Past the end means the frame is too long and is thrown away
+			continue;
+		}
+		n = (inLen <= (int)sizeof(in)) ? cobsDecode(in, inLen, buf) : -1;
+		if(inLen == 0){
+			continue;		//Zeros between frames
+		}
+		inLen = 0;
+		if(n != sizeof(MirrorTouch) + sizeof(crc)){
+			badFrames++;
+			continue;
+		}
+		memcpy(&m, buf, sizeof(m));
+		memcpy(&crc, &buf[sizeof(m)], sizeof(crc));
+		if(crc != crc32(buf, sizeof(m)) || m.version != MIRROR_VERSION){
+			badFrames++;
+			continue;
+		}
+		if(m.type == MIRROR_REFRESH){
+			needInfo = true;
+			mark(0, 0, width, height);
+		}
+		else if(m.type == MIRROR_TOUCH){
+			touchReports++;
+			remote.contacts = m.contacts;
+			for(n = 0; n < 2; n++){
+				remote.x[n] = m.x[n];
+				remote.y[n] = m.y[n];
+			}
+			remote.t = millis();
+			touches.push(remote);
+			lastHeard = lastRepeat = remote.t;
+		}
+		else{
+			badFrames++;
+		}
+	}
+}
+void ScreenMirror::repeatTouch(uint32_t now){
+	if(remote.contacts == 0){
+		return;
+	}
+	if(now - lastHeard >= MIRROR_TOUCH_TIMEOUT){	//The viewer went away with the finger down
+		remote.contacts = 0;
+		remote.t = now;
+		touches.push(remote);
+		return;
+	}
+	if(now - lastRepeat >= MIRROR_TOUCH_REPEAT){	//The touch controller keeps reporting a finger that is held still, and so does this
+		lastRepeat = now;
+		remote.t = now;
+		touches.push(remote);
+	}
+}
+bool ScreenMirror::drain(uint32_t now){
+	int room, n;
+	uint64_t refill;
+
+	if(outPos >= outLen){
+		return true;
+	}
+	room = port->availableForWrite();	//Only what fits in the port's buffer, so this never waits
+	if(maxRate > 0){
+		refill = allowance + (uint64_t)(now - lastRefill) * maxRate / 1000;
+		lastRefill = now;
+		allowance = (refill > maxRate / 4 + MIRROR_FRAME_BYTES) ? maxRate / 4 + MIRROR_FRAME_BYTES : (uint32_t)refill;
+		if(room > (int)allowance){
+			room = allowance;
+		}
+	}
+	if(room > outLen - outPos){
+		room = outLen - outPos;
+	}
+	if(room <= 0){
+		return false;
+	}
+	n = port->write(&out[outPos], room);
+	outPos += n;
+	bytesSent += n;
+	rateBytes += n;
+	if(maxRate > 0){
+		allowance -= n;
+	}
+	if(outPos < outLen){
+		return false;
+	}
+	framesSent++;
+	return true;
+}
+void ScreenMirror::closeFrame(int len){
+	MirrorHeader *hd = (MirrorHeader *)frame;
+	uint32_t crc;
+
+	hd->seq = seq++;
+	crc = crc32(frame, len);
+	memcpy(&frame[len], &crc, sizeof(crc));
+	outLen = cobsEncode(frame, len + sizeof(crc), out);
+	out[outLen++] = 0;			//Frame delimiter
+	outPos = 0;
+}
+int ScreenMirror::packRows(const BlitSurface &screen, const Rect &r){
+	MirrorHeader *hd = (MirrorHeader *)frame;
+	uint16_t mask = depthMask[depth], palette[MIRROR_PALETTE_COLORS];
+	int w = r.x1 - r.x0, y = row, len = sizeof(MirrorHeader), end, n, colors = 0;
+	uint8_t enc = MIRROR_PALETTE;
+	const uint16_t *px;
+
+	end = len + 1 + sizeof(palette);
+	while(y < r.y1){
+		px = screen.pixels + y * screen.stride + r.x0;
+		if(enc == MIRROR_PALETTE){
+			n = paletteRow(px, w, mask, palette, colors, &frame[end], MIRROR_FRAME_BYTES - end);
+		}
+		else if(enc == MIRROR_RLE){		//The first row must be smaller than it is raw, or the runs don't help
+			n = rleRow(px, w, mask, &frame[end], (y == row) ? 2 * w - 1 : MIRROR_FRAME_BYTES - end);
+		}
+		else{
+			n = rawRow(px, w, mask, &frame[end], MIRROR_FRAME_BYTES - end);
+		}
+		if(n >= 0){
+			end += n;
+			y++;
+		}
+		else if(y > row){		//Full, or this row needs another encoding: it starts the next frame
+			break;
+		}
+		else if(enc == MIRROR_PALETTE){		//Too many colors in the first row
+			enc = MIRROR_RLE;
+			end = len;
+		}
+		else{
+			enc = MIRROR_RAW;
+		}
+	}
+
+	hd->version = MIRROR_VERSION;
+	hd->type = MIRROR_RECT;
+	hd->encoding = enc;
+	hd->depth = depth;
+	hd->x = r.x0;
+	hd->y = row;
+	hd->w = w;
+	hd->h = y - row;
+	if(enc == MIRROR_PALETTE){
+		frame[len] = colors;
+		memcpy(&frame[len + 1], palette, sizeof(palette));
+	}
+	pixelsSent += w * (y - row);
+	row = y;
+	return end;
+}
+void ScreenMirror::finishUpdate(uint32_t now){
+	sendingCount = 0;
+	updatesSent++;
+	rateUpdates++;
+	if(adaptive && now - updateStart > MIRROR_SLOW_UPDATE){
+		lastSlow = now;
+		if(depth < MIRROR_MAX_DEPTH){
+			depth++;
+		}
+	}
+}
+bool ScreenMirror::nextFrame(const BlitSurface &screen, uint32_t now){
+	MirrorHeader *hd = (MirrorHeader *)frame;
+	int i;
+
+	if(needInfo){
+		needInfo = false;
+		memset(hd, 0, sizeof(MirrorHeader));
+		hd->version = MIRROR_VERSION;
+		hd->type = MIRROR_INFO;
+		hd->encoding = rotation;
+		hd->w = width;
+		hd->h = height;
+		closeFrame(sizeof(MirrorHeader));
+		return true;
+	}
+	if(sendingCount == 0){
+		if(adaptive && depth > 0 && now - lastSlow >= MIRROR_SHARPEN_TIME){
+			depth--;
+			lastSlow = now;			//One bit at a time
+			if(depth == 0 && coarse.x1 > coarse.x0){
+				addRect(pending, pendingCount, coarse);		//Everything that is not exact is sent again
+				coarse = Rect{0, 0, 0, 0};
+			}
+		}
+		if(pendingCount == 0 || now - lastUpdate < minInterval){
+			return false;
+		}
+		//A new update: everything that changed since the last one started
+		memcpy(sending, pending, pendingCount * sizeof(Rect));
+		sendingCount = pendingCount;
+		pendingCount = 0;
+		current = 0;
+		row = sending[0].y0;
+		updateStart = lastUpdate = now;
+		if(depth > 0){
+			for(i = 0; i < sendingCount; i++){
+				if(coarse.x1 <= coarse.x0){
+					coarse = sending[i];
+				}
+				else{
+					coarse = Rect{min(coarse.x0, sending[i].x0), min(coarse.y0, sending[i].y0),
+					              max(coarse.x1, sending[i].x1), max(coarse.y1, sending[i].y1)};
+				}
+			}
+		}
+	}
+	closeFrame(packRows(screen, sending[current]));
+	if(row >= sending[current].y1){
+		if(++current < sendingCount){
+			row = sending[current].y0;
+		}
+		else{
+			finishUpdate(now);
+		}
+	}
+	return true;
+}
+void ScreenMirror::service(const BlitSurface &screen){
+	uint32_t now;
+
+	if(port == nullptr){
+		return;
+	}
+	receive();
+	now = millis();		//After receive() stamps the reports, so none is newer than now
+	repeatTouch(now);
+	while(drain(now) && nextFrame(screen, now)){}
+
+	if(now - rateStart >= 1000){
+		rate = rateBytes * 1000 / (now - rateStart);
+		updateRate = rateUpdates * 1000000 / (now - rateStart);
+		rateStart = now;
+		rateBytes = 0;
+		rateUpdates = 0;
+	}
+}
+bool ScreenMirror::busy(void){
+	return port != nullptr && (needInfo || pendingCount > 0 || sendingCount > 0 || outPos < outLen);
+}
+uint32_t ScreenMirror::bytesPerSecond(void){
+	return rate;
+}
+float ScreenMirror::updatesPerSecond(void){
+	return updateRate / 1000.0f;
+}
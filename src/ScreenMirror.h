@@ -0,0 +1,185 @@
+/**
+
+@file
+
+This contains the screen mirror of the GigaDAQ project, which shows the screen on a computer and lets the computer touch it, sending only the parts of the screen that changed. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _SCREEN_MIRROR_INCLUDE_
+#define _SCREEN_MIRROR_INCLUDE_
+
+#include "Arduino.h"
+#include "Blitter.h"
+#include "TouchInput.h"
+
+const uint8_t MIRROR_VERSION = 1;			///< Layout version of MirrorHeader and the pixels after it
+const int MIRROR_FRAME_BYTES = 1024;		///< Largest frame before CRC and COBS encoding. Holds a whole row of the screen buffer uncompressed.
+const int MIRROR_RECTS = 16;				///< Changed rectangles kept apart before the closest ones are merged
+const int MIRROR_PALETTE_COLORS = 8;		///< Most colors in a MIRROR_PALETTE frame
+const int MIRROR_MAX_DEPTH = 3;				///< Most bits dropped from each color channel when the connection is slow
+const uint32_t MIRROR_INTERVAL = 33;		///< Default least milliseconds between updates (about 30 per second)
+const uint32_t MIRROR_SLOW_UPDATE = 250;	///< Milliseconds above which an update is too slow, and colors are sent with fewer bits
+const uint32_t MIRROR_SHARPEN_TIME = 1000;	///< Milliseconds without a slow update after which colors are sent with a bit more again
+const uint32_t MIRROR_TOUCH_REPEAT = 10;	///< Milliseconds between the reports of a finger held down on the viewer, as from the touch controller
+const uint32_t MIRROR_TOUCH_TIMEOUT = 500;	///< Milliseconds without word from the viewer after which its finger is lifted
+
+/** Kinds of mirror frames, in MirrorHeader::type */
+enum MirrorType {
+	MIRROR_INFO = 1,	/**< To the viewer: size of the screen buffer in w and h, rotation of the screen in encoding */
+	MIRROR_RECT = 2,	/**< To the viewer: pixels of a rectangle of the screen buffer */
+	MIRROR_TOUCH = 3,	/**< From the viewer: a report of the fingers, as a MirrorTouch */
+	MIRROR_REFRESH = 4	/**< From the viewer: asks for MIRROR_INFO and the whole screen, for example after a bad frame */
+};
+
+/** How the pixels of a MIRROR_RECT frame are packed, in MirrorHeader::encoding */
+enum MirrorEncoding {
+	MIRROR_RAW = 0,		/**< w * h RGB565 pixels */
+	MIRROR_RLE = 1,		/**< Runs within each row: a byte of length - 1 (1 to 256), then the RGB565 color */
+	MIRROR_PALETTE = 2	/**< A byte of the number of colors, MIRROR_PALETTE_COLORS RGB565 colors, then runs within each row: a byte with the color number in the top 3 bits and length - 1 (1 to 31) in the low 5 bits, or 31 followed by a byte of length - 32 (32 to 287) */
+};
+
+/**
+@brief Start of every mirror frame the GIGA sends. For MIRROR_RECT it is followed by the packed pixels of the rows y to y + h - 1 of the screen buffer, then a CRC-32 of everything before it. All values are little-endian.
+
+Frames are COBS-encoded and end with a zero byte, like those of SerialStreamSink.
+*/
+struct MirrorHeader {
+	uint8_t version;	///< Must be MIRROR_VERSION
+	uint8_t type;		///< A MirrorType
+	uint8_t encoding;	///< MIRROR_RECT: a MirrorEncoding. MIRROR_INFO: rotation of the screen, 0 to 3.
+	uint8_t depth;		///< MIRROR_RECT: low bits dropped from each color channel, 0 for exact colors
+	uint32_t seq;		///< Frame sequence number. A gap means frames were lost.
+	uint16_t x;			///< Left edge in the screen buffer, in pixels
+	uint16_t y;			///< Top edge in the screen buffer, in pixels
+	uint16_t w;			///< Width in pixels
+	uint16_t h;			///< Rows
+};
+
+/**
+@brief A frame from the viewer: MIRROR_TOUCH with the fingers in the coordinates of the screen buffer, which are those the touch controller reports, or MIRROR_REFRESH with the rest 0. It is followed by a CRC-32 and COBS-encoded like the frames to the viewer.
+*/
+struct MirrorTouch {
+	uint8_t version;	///< Must be MIRROR_VERSION
+	uint8_t type;		///< MIRROR_TOUCH or MIRROR_REFRESH
+	uint8_t contacts;	///< Fingers on the screen, 0 when they were lifted
+	uint8_t reserved;	///< Always 0
+	uint32_t seq;		///< Frame sequence number of the viewer
+	uint16_t x[2];		///< x-pixels of the first two fingers
+	uint16_t y[2];		///< y-pixels of the first two fingers
+};
+
+/**
+@brief Shows the screen on a computer through a serial port or a network connection, and takes touches from it.
+
+GigaDAQ tells the mirror every rectangle of the screen it changes (GigaDAQ::mirror). The rectangles are collected and merged, and GigaDAQ::serviceMirror() sends them as an update: the pixels of each are read from the screen buffer when they are sent, so a text box that changed ten times while the connection was busy is sent once, as it is now. The pixels are packed row by row, as runs of a few palette colors when there are 8 or fewer (which suits controls, mostly two colors), as runs of colors otherwise, and as they are when runs do not help.
+
+service() only writes what the port takes without waiting, and a new update is only started when the last one has gone out, so the updates come as often as the connection allows, up to one every minInterval milliseconds. When an update still takes longer than MIRROR_SLOW_UPDATE, colors are sent with one bit fewer per channel, down to MIRROR_MAX_DEPTH, which makes longer runs and fewer palette colors. After MIRROR_SHARPEN_TIME without a slow update, a bit comes back, and once the colors are exact again, everything that was sent with fewer bits is sent again in full.
+
+The viewer sends MIRROR_TOUCH frames while a finger is on its picture. They are put in touches with the time they arrived, and repeated every MIRROR_TOUCH_REPEAT milliseconds while the finger is down, so GigaDAQ::handleInputs() sees them as if they came from the touch screen. Use extras/mirror/mirror_viewer.py on the computer.
+*/
+class ScreenMirror {
+public:
+	uint32_t minInterval;	///< Least milliseconds between updates
+	uint32_t maxRate;		///< Most bytes per second to send, for sharing a connection, 0 for as many as the port takes
+	bool adaptive;			///< True (the default) to send colors with fewer bits when the connection is slow
+	int depth;				///< Low bits dropped from each color channel at present
+	TouchQueue touches;		///< Reports of the viewer's fingers, taken by GigaDAQ::handleInputs()
+	TouchSample remote;		///< Newest report of the viewer's fingers
+	uint32_t updatesSent;	///< Updates completely sent
+	uint32_t framesSent;	///< Frames completely written to the port
+	uint32_t bytesSent;		///< Bytes written to the port
+	uint32_t pixelsSent;	///< Pixels in the frames sent
+	uint32_t badFrames;		///< Frames from the viewer that failed the CRC check or made no sense
+	uint32_t touchReports;	///< MIRROR_TOUCH frames received
+	/** Constructor for a mirror that has no port yet */
+	ScreenMirror();
+	/**
+	@brief Sets the port the mirror talks through, and sends the whole screen.
+
+	@param port Serial port, such as Serial or SerialUSB, or a network connection, such as a WiFiClient. Start it first. The port must tell how much it can take without waiting (availableForWrite()).
+	@param width Pixels per row of the screen buffer
+	@param height Rows of the screen buffer
+	@param rotation Rotation of the screen, 0 to 3, so the viewer can turn the picture the same way
+	*/
+	void begin(Stream &port, int width, int height, uint8_t rotation);
+	/** Stops using the port. */
+	void end(void);
+	/**
+	@brief Notes that a rectangle of the screen buffer changed. Called by GigaDAQ for everything it draws.
+
+	@param x Left edge in the buffer, in pixels
+	@param y Top edge in the buffer, in pixels
+	@param w Width in the buffer, in pixels
+	@param h Height in the buffer, in pixels
+	*/
+	void mark(int x, int y, int w, int h);
+	/**
+	@brief Takes in frames from the viewer, and sends as much of the changed screen as the port takes without waiting. Called by GigaDAQ::serviceMirror().
+
+	@param screen The screen buffer, whose pixels are sent
+	*/
+	void service(const BlitSurface &screen);
+	/** @returns true if changes are waiting to be sent or still being sent */
+	bool busy(void);
+	/** @returns Bytes per second written to the port, averaged over the last second or so */
+	uint32_t bytesPerSecond(void);
+	/** @returns Updates per second, averaged over the last second or so */
+	float updatesPerSecond(void);
+private:
+	struct Rect {
+		int x0, y0, x1, y1;		//x1 and y1 are just outside
+	};
+	Stream *port;
+	Rect pending[MIRROR_RECTS];		//Changed since the update being sent was started
+	Rect sending[MIRROR_RECTS];		//The update being sent
+	Rect coarse;					//Everything sent with depth above 0 since colors were last exact
+	int pendingCount, sendingCount, current, row;
+	bool needInfo;
+	int width, height;
+	uint8_t rotation;
+	alignas(4) uint8_t frame[MIRROR_FRAME_BYTES + 4];			//Frame being packed, with room for the CRC
+	uint8_t out[MIRROR_FRAME_BYTES + 4 + (MIRROR_FRAME_BYTES + 4)/254 + 2];	//Encoded frame being sent
+	int outLen, outPos;
+	uint8_t in[32];					//Encoded frame from the viewer
+	int inLen;
+	uint32_t seq;
+	uint32_t updateStart, lastUpdate;
+	uint32_t lastHeard, lastRepeat, lastSlow;
+	uint32_t allowance, lastRefill;
+	uint32_t rateStart, rateBytes, rate, rateUpdates, updateRate;
+	static void addRect(Rect *list, int &count, Rect r);
+	void receive(void);
+	void repeatTouch(uint32_t now);
+	bool drain(uint32_t now);
+	bool nextFrame(const BlitSurface &screen, uint32_t now);
+	int packRows(const BlitSurface &screen, const Rect &r);
+	void finishUpdate(uint32_t now);
+	void closeFrame(int len);
+};
+
+#endif /* _SCREEN_MIRROR_INCLUDE_ */
@@ -0,0 +1,283 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the sensor bus scheduler of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <math.h>
+#include <string.h>
+#include "SensorBus.h"
+
+RegisterSensor::RegisterSensor(uint16_t address, uint8_t reg, int count, float scale, float offset, bool bigEndian){
+	this->address = address;
+	this->reg = reg;
+	this->count = (count > BUS_MAX_BYTES / 2) ? BUS_MAX_BYTES / 2 : count;
+	this->scale = scale;
+	this->offset = offset;
+	this->bigEndian = bigEndian;
+	trigger = false;
+	triggerReg = 0;
+	triggerValue = 0;
+	conversion = 0;
+}
+void RegisterSensor::setTrigger(uint8_t reg, uint8_t value, uint32_t conversion){
+	trigger = true;
+	triggerReg = reg;
+	triggerValue = value;
+	this->conversion = conversion;
+}
+int RegisterSensor::channels(void){
+	return count;
+}
+void RegisterSensor::request(int step, BusTransaction &t){
+	t.address = address;
+	if(trigger && step == 0){
+		t.tx[0] = triggerReg;
+		t.tx[1] = triggerValue;
+		t.txLen = 2;
+		t.delayAfter = conversion;
+		return;
+	}
+	t.tx[0] = reg;
+	t.txLen = 1;
+	t.rxLen = count * 2;
+}
+int RegisterSensor::complete(int step, const BusTransaction &t, float *values){
+	int i;
+	int16_t raw;
+
+	if(trigger && step == 0){
+		return SENSOR_NEXT;
+	}
+	for(i = 0; i < count; i++){
+		if(bigEndian){
+			raw = (int16_t)((t.rx[2*i] << 8) | t.rx[2*i + 1]);
+		}
+		else{
+			raw = (int16_t)((t.rx[2*i + 1] << 8) | t.rx[2*i]);
+		}
+		values[i] = raw * scale + offset;
+	}
+	return SENSOR_READY;
+}
+
+SensorSlot::SensorSlot(){
+	device = nullptr;
+	interval = 0;
+	channel = 0;
+	readings = 0;
+	errors = 0;
+	late = 0;
+	maxDelay = 0;
+	due = 0;
+	waitUntil = 0;
+	started = 0;
+	step = -1;
+}
+
+SensorBus::SensorBus(){
+	int i;
+
+	for(i = 0; i < SENSOR_MAX_CHANNELS; i++){
+		values[i] = NAN;
+	}
+	count = 0;
+	sampleTime = 0;
+	sampleSlot = -1;
+	port = nullptr;
+	active = -1;
+	txnStart = 0;
+	busyTime = 0;
+	startTime = 0;
+	memset(&txn, 0, sizeof(txn));
+}
+void SensorBus::begin(BusPort &port){
+	this->port = &port;
+	active = -1;
+	busyTime = 0;
+	startTime = 0;
+}
+int SensorBus::addDevice(SensorDevice *device, uint32_t interval){
+	int i, n = device->channels();
+
+	if(interval == 0 || n < 0 || count + n > SENSOR_MAX_CHANNELS){
+		return -1;
+	}
+	for(i = 0; i < NUM_SENSORS; i++){
+		if(slot[i].device == nullptr){
+			slot[i] = SensorSlot();
+			slot[i].device = device;
+			slot[i].interval = interval;
+			slot[i].channel = count;
+			count += n;
+			return i;
+		}
+	}
+	return -1;
+}
+void SensorBus::schedule(SensorSlot &s, uint64_t now){
+	uint64_t missed;
+
+	s.step = -1;
+	s.due += s.interval;
+	if(s.due <= now){		//Fell behind: skip the readings that can no longer be on time rather than rushing through them
+		missed = (now - s.due) / s.interval + 1;
+		s.late += missed;
+		s.due += missed * s.interval;
+	}
+}
+bool SensorBus::finish(uint64_t now, BusStatus st){
+	SensorSlot &s = slot[active];
+	int result;
+
+	active = -1;
+	busyTime += now - txnStart;
+	result = (st == BUS_DONE) ? s.device->complete(s.step, txn, &values[s.channel]) : SENSOR_FAILED;
+
+	if(result == SENSOR_NEXT){
+		s.step++;
+		s.waitUntil = now + txn.delayAfter;
+		return false;
+	}
+	if(result == SENSOR_READY){
+		s.readings++;
+		if(now - s.due > s.maxDelay){
+			s.maxDelay = now - s.due;
+		}
+		sampleTime = s.started;		//The data was captured when the last transaction began
+		sampleSlot = &s - slot;
+		schedule(s, now);
+		return true;
+	}
+	s.errors++;
+	s.device->reset();
+	schedule(s, now);
+	return false;
+}
+void SensorBus::startNext(uint64_t now){
+	int i, best = -1;
+	uint64_t bestTime = 0, ready;
+
+	//Whoever has waited longest goes first. A reading in progress is ready at waitUntil, a new one at due.
+	for(i = 0; i < NUM_SENSORS; i++){
+		if(slot[i].device == nullptr){
+			continue;
+		}
+		ready = (slot[i].step >= 0) ? slot[i].waitUntil : slot[i].due;
+		if(ready <= now && (best < 0 || ready < bestTime)){
+			best = i;
+			bestTime = ready;
+		}
+	}
+	if(best < 0){
+		return;
+	}
+
+	SensorSlot &s = slot[best];
+	if(s.step < 0){
+		s.step = 0;
+	}
+	memset(&txn, 0, sizeof(txn));
+	s.device->request(s.step, txn);
+	s.started = now;
+	txnStart = now;
+	active = best;
+	if(!port->start(txn)){
+		finish(now, BUS_ERROR);
+	}
+}
+bool SensorBus::service(uint64_t now){
+	BusStatus st;
+	bool ready = false;
+	int i;
+
+	if(port == nullptr){
+		return false;
+	}
+	if(startTime == 0){
+		startTime = now;
+	}
+	for(i = 0; i < NUM_SENSORS; i++){
+		if(slot[i].device != nullptr && slot[i].due == 0){
+			slot[i].due = now;		//The first reading is due when the bus is first serviced after the device was added
+		}
+	}
+	if(active >= 0){
+		st = port->status();
+		if(st == BUS_BUSY){
+			return false;
+		}
+		ready = finish(now, st);
+	}
+	if(active < 0){
+		startNext(now);		//Keep the bus busy while the caller records the reading
+	}
+	return ready;
+}
+uint32_t SensorBus::untilNext(uint64_t now){
+	uint64_t ready, wait = 0xFFFFFFFF;
+	int i;
+
+	if(port == nullptr){
+		return wait;
+	}
+	if(active >= 0){
+		return 0;
+	}
+	for(i = 0; i < NUM_SENSORS; i++){
+		if(slot[i].device == nullptr){
+			continue;
+		}
+		ready = (slot[i].step >= 0) ? slot[i].waitUntil : slot[i].due;
+		if(ready <= now){
+			return 0;
+		}
+		if(ready - now < wait){
+			wait = ready - now;
+		}
+	}
+	return (uint32_t)wait;
+}
+float SensorBus::utilization(uint64_t now){
+	if(now <= startTime){
+		return 0;
+	}
+	return (float)busyTime / (float)(now - startTime);
+}
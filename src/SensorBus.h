@@ -0,0 +1,226 @@
+/**
+
+@file
+
+This contains the sensor bus scheduler of the GigaDAQ project, which reads several I2C or SPI sensors at their own rates without making loop() wait for the bus. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _SENSOR_BUS_INCLUDE_
+#define _SENSOR_BUS_INCLUDE_
+
+#include <stdint.h>
+
+const int NUM_SENSORS = 8;				///< Maximum number of devices on a SensorBus
+const int BUS_MAX_BYTES = 32;			///< Most bytes sent or received in one bus transaction
+const int SENSOR_MAX_CHANNELS = 16;		///< Most values from all the devices on a SensorBus together
+
+const int SENSOR_NEXT = 1;		///< SensorDevice::complete(): another transaction is needed for this reading
+const int SENSOR_READY = 0;		///< SensorDevice::complete(): the reading is finished and the values are filled in
+const int SENSOR_FAILED = -1;	///< SensorDevice::complete(): the data made no sense. The device is reset.
+
+/** State of a bus transfer, as reported by BusPort::status() */
+enum BusStatus {
+	BUS_BUSY = 0,	/**< Transfer under way */
+	BUS_DONE = 1,	/**< Transfer finished */
+	BUS_ERROR = 2	/**< Transfer failed, for example because the device did not answer */
+};
+
+/**
+@brief One exchange with a device: some bytes sent, then some bytes received.
+
+For I2C, address is the 7-bit device address, the tx bytes are written and then rxLen bytes are read with a repeated start. For SPI, address is the Arduino pin number of the chip select, and max(txLen, rxLen) bytes are clocked in both directions.
+*/
+struct BusTransaction {
+	uint16_t address;			///< I2C device address, or SPI chip select pin
+	uint8_t txLen;				///< Bytes to send
+	uint8_t rxLen;				///< Bytes to receive
+	uint8_t tx[BUS_MAX_BYTES];	///< Bytes to send
+	uint8_t rx[BUS_MAX_BYTES];	///< Bytes received
+	uint32_t delayAfter;		///< Microseconds to leave the device alone before its next transaction, for example while it converts
+};
+
+/**
+@brief Base class for a bus that moves a BusTransaction in the background, such as MbedI2CPort or MbedSPIPort.
+*/
+class BusPort {
+public:
+	/**
+	@brief Starts a transfer and returns without waiting for it.
+
+	@param t Transaction to carry out. It must stay in place until status() is no longer BUS_BUSY.
+	@returns true if the transfer was started
+	*/
+	virtual bool start(BusTransaction &t) = 0;
+	/** @returns State of the transfer started last */
+	virtual BusStatus status(void) = 0;
+	virtual ~BusPort() {}
+};
+
+/**
+@brief Base class for a sensor read by a SensorBus.
+
+A reading is made of one or more bus transactions, numbered by step from 0. For each step, the bus calls request() to have the transaction filled in, runs it in the background, and then calls complete() with the bytes received. Both are called from loop(), never from an interrupt, so they may take their time to decode the data.
+*/
+class SensorDevice {
+public:
+	/** @returns Number of values in each reading */
+	virtual int channels(void) = 0;
+	/**
+	@brief Fills in the transaction for one step of a reading.
+
+	@param step Step of the reading, 0 for the first
+	@param t Transaction to fill in
+	*/
+	virtual void request(int step, BusTransaction &t) = 0;
+	/**
+	@brief Handles a finished transaction.
+
+	@param step Step of the reading
+	@param t The transaction, with the bytes received
+	@param values Receives channels() values when the reading is finished
+	@returns SENSOR_NEXT, SENSOR_READY or SENSOR_FAILED
+	*/
+	virtual int complete(int step, const BusTransaction &t, float *values) = 0;
+	/** Called after a failed transaction or reading, so the device can set itself up again on the next reading */
+	virtual void reset(void) {}
+	virtual ~SensorDevice() {}
+};
+
+/**
+@brief A sensor that is read by reading a run of 16-bit registers, which covers many temperature, pressure, current and motion sensors, optionally after writing a register to start a conversion.
+
+Each value is the signed register value times scale plus offset. For example, a TMP102 temperature sensor at address 0x48 is RegisterSensor(0x48, 0x00, 1, 0.0625f / 16).
+*/
+class RegisterSensor : public SensorDevice {
+public:
+	/**
+	@brief Constructor for an I2C sensor.
+
+	@param address 7-bit I2C address
+	@param reg First register to read
+	@param count Number of 16-bit registers to read, up to BUS_MAX_BYTES / 2
+	@param scale Factor applied to each register value
+	@param offset Added to each value after scaling
+	@param bigEndian true if the most significant byte comes first, as on most sensors
+	*/
+	RegisterSensor(uint16_t address, uint8_t reg, int count, float scale, float offset = 0, bool bigEndian = true);
+	/**
+	@brief Writes a register before every reading, for sensors that convert on command.
+
+	@param reg Register to write
+	@param value Value to write
+	@param conversion Microseconds the conversion takes. The bus is free for other devices meanwhile.
+	*/
+	void setTrigger(uint8_t reg, uint8_t value, uint32_t conversion);
+	int channels(void) override;
+	void request(int step, BusTransaction &t) override;
+	int complete(int step, const BusTransaction &t, float *values) override;
+private:
+	uint16_t address;
+	uint8_t reg, triggerReg, triggerValue;
+	int count;
+	float scale, offset;
+	bool bigEndian, trigger;
+	uint32_t conversion;
+};
+
+/**
+@brief A device on a SensorBus, with its schedule and statistics.
+*/
+class SensorSlot {
+public:
+	SensorDevice *device;	///< The device, nullptr if the slot is free
+	uint32_t interval;		///< Microseconds between readings
+	int channel;			///< Position of the device's first value in SensorBus::values
+	uint32_t readings;		///< Readings finished
+	uint32_t errors;		///< Readings that failed
+	uint32_t late;			///< Readings skipped because the bus was too busy to keep up with interval
+	uint32_t maxDelay;		///< Longest time in microseconds from when a reading was due to when it was finished
+	uint64_t due;			///< When the next reading should start, 0 until service() first sees the device
+	uint64_t waitUntil;		///< When the next step of the reading may start
+	uint64_t started;		///< When the last transaction of the reading started
+	int step;				///< Step of the reading in progress, -1 when no reading is in progress
+	/** Constructor for a free slot */
+	SensorSlot();
+};
+
+/**
+@brief Reads several sensors that share a bus, each at its own rate, without waiting for the bus.
+
+Only one transaction is on the bus at a time, but service() never waits for it: it starts a transaction and returns, and the next call picks up the result. The bus goes to whichever device has been waiting longest for a reading, so a fast device cannot starve a slow one, and devices that are in the middle of a reading (for example waiting for a conversion) let others use the bus meanwhile.
+
+The values of all the devices are kept together in values, with each device's values starting at its channel. Every time a device finishes a reading, service() returns true and the whole row is ready to be recorded with the time of the reading. GigaDAQ::serviceSensors() does this for GigaDAQ::sensors.
+*/
+class SensorBus {
+public:
+	SensorSlot slot[NUM_SENSORS];		///< The devices
+	float values[SENSOR_MAX_CHANNELS];	///< Newest value of every channel (NAN until its device has a reading)
+	int count;							///< Number of channels of all the devices together
+	uint64_t sampleTime;				///< Time of the reading that service() just reported, in microseconds
+	int sampleSlot;						///< Slot of the device whose reading service() just reported
+	/** Constructor for a bus without a port */
+	SensorBus();
+	/**
+	@brief Sets the bus the devices are on.
+
+	@param port An I2C or SPI port, such as an MbedI2CPort
+	*/
+	void begin(BusPort &port);
+	/**
+	@brief Adds a device to be read regularly.
+
+	@param device The device. It must exist for as long as the bus is used.
+	@param interval Microseconds between readings
+	@returns Slot of the device, or -1 if interval is 0 or there are already NUM_SENSORS devices or SENSOR_MAX_CHANNELS values
+	*/
+	int addDevice(SensorDevice *device, uint32_t interval);
+	/**
+	@brief Starts the next transaction if the bus is free and handles one that finished. Call on every pass through loop(). It never waits.
+
+	@param now Current time in microseconds, as from GigaDAQ::clock.now()
+	@returns true if a device finished a reading, so that values, sampleTime and sampleSlot are new
+	*/
+	bool service(uint64_t now);
+	/**
+	@param now Current time in microseconds
+	@returns Microseconds until service() has something to do: 0 while a transaction is on the bus or a device is due, 0xFFFFFFFF if there are no devices
+	*/
+	uint32_t untilNext(uint64_t now);
+	/** @returns Fraction of the time since begin() that the bus was busy, from 0 to 1 */
+	float utilization(uint64_t now);
+private:
+	BusPort *port;
+	BusTransaction txn;
+	int active;						//Slot whose transaction is on the bus, -1 if the bus is free
+	uint64_t txnStart, busyTime, startTime;
+	bool finish(uint64_t now, BusStatus st);
+	void schedule(SensorSlot &s, uint64_t now);
+	void startNext(uint64_t now);
+};
+
+#endif /* _SENSOR_BUS_INCLUDE_ */
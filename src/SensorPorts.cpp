@@ -0,0 +1,110 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the I2C and SPI ports of the GigaDAQ sensor bus. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+Arduino mbed core (mbed::I2C and mbed::SPI)
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "SensorPorts.h"
+
+MbedI2CPort::MbedI2CPort(PinName sda, PinName scl, uint32_t hz) : i2c(sda, scl){
+	i2c.frequency(hz);
+	state = BUS_DONE;
+}
+bool MbedI2CPort::start(BusTransaction &t){
+	int address = t.address << 1;	//mbed wants the address already shifted for the read/write bit
+
+	state = BUS_BUSY;
+#if DEVICE_I2C_ASYNCH
+	if(i2c.transfer(address, (const char *)t.tx, t.txLen, (char *)t.rx, t.rxLen,
+	                mbed::callback(this, &MbedI2CPort::onEvent), I2C_EVENT_ALL, false) != 0){
+		state = BUS_DONE;
+		return false;
+	}
+#else
+	if((t.txLen > 0 && i2c.write(address, (const char *)t.tx, t.txLen, t.rxLen > 0) != 0) ||
+	   (t.rxLen > 0 && i2c.read(address, (char *)t.rx, t.rxLen) != 0)){
+		state = BUS_ERROR;
+		return true;
+	}
+	state = BUS_DONE;
+#endif
+	return true;
+}
+void MbedI2CPort::onEvent(int event){		//Called from an interrupt
+	state = (event & I2C_EVENT_TRANSFER_COMPLETE) ? BUS_DONE : BUS_ERROR;
+}
+BusStatus MbedI2CPort::status(void){
+	return state;
+}
+
+MbedSPIPort::MbedSPIPort(PinName mosi, PinName miso, PinName sck, uint32_t hz, int mode) : spi(mosi, miso, sck){
+	spi.format(8, mode);
+	spi.frequency(hz);
+	state = BUS_DONE;
+	chipSelect = -1;
+}
+bool MbedSPIPort::start(BusTransaction &t){
+	int n = (t.txLen > t.rxLen) ? t.txLen : t.rxLen;
+
+	chipSelect = t.address;
+	pinMode(chipSelect, OUTPUT);
+	digitalWrite(chipSelect, LOW);
+	state = BUS_BUSY;
+#if DEVICE_SPI_ASYNCH
+	if(spi.transfer(t.tx, n, t.rx, n, mbed::callback(this, &MbedSPIPort::onEvent), SPI_EVENT_ALL) != 0){
+		digitalWrite(chipSelect, HIGH);
+		state = BUS_DONE;
+		return false;
+	}
+#else
+	spi.write((const char *)t.tx, n, (char *)t.rx, n);
+	onEvent(SPI_EVENT_COMPLETE);
+#endif
+	return true;
+}
+void MbedSPIPort::onEvent(int event){		//Called from an interrupt
+	digitalWrite(chipSelect, HIGH);
+	state = (event & SPI_EVENT_COMPLETE) ? BUS_DONE : BUS_ERROR;
+}
+BusStatus MbedSPIPort::status(void){
+	return state;
+}
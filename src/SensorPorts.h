@@ -0,0 +1,94 @@
+/**
+
+@file
+
+This contains the I2C and SPI ports of the GigaDAQ sensor bus, which move bus transactions in the background with the mbed asynchronous drivers. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _SENSOR_PORTS_INCLUDE_
+#define _SENSOR_PORTS_INCLUDE_
+
+#include "Arduino.h"
+#include "drivers/I2C.h"
+#include "drivers/SPI.h"
+#include "SensorBus.h"
+
+/**
+@brief An I2C bus for a SensorBus. Transfers run under interrupt and DMA control, so loop() goes on while the bytes move.
+
+Use a bus that no other library (such as Wire) is using at the same time. On the GIGA R1, SDA and SCL are I2C2, and SDA1/SCL1 and SDA2/SCL2 are two more buses.
+
+@note If the mbed core was built without asynchronous I2C (DEVICE_I2C_ASYNCH), start() falls back to an ordinary transfer that waits until it is done.
+*/
+class MbedI2CPort : public BusPort {
+public:
+	/**
+	@brief Constructor.
+
+	@param sda Data pin, such as digitalPinToPinName(SDA)
+	@param scl Clock pin, such as digitalPinToPinName(SCL)
+	@param hz Clock frequency
+	*/
+	MbedI2CPort(PinName sda, PinName scl, uint32_t hz = 400000);
+	bool start(BusTransaction &t) override;
+	BusStatus status(void) override;
+private:
+	mbed::I2C i2c;
+	volatile BusStatus state;
+	void onEvent(int event);
+};
+
+/**
+@brief An SPI bus for a SensorBus. Transfers run under interrupt and DMA control, so loop() goes on while the bytes move.
+
+The address of each BusTransaction is the Arduino pin number of the device's chip select, which is driven low for the transfer and high again when it finishes.
+
+@note If the mbed core was built without asynchronous SPI (DEVICE_SPI_ASYNCH), start() falls back to an ordinary transfer that waits until it is done.
+*/
+class MbedSPIPort : public BusPort {
+public:
+	/**
+	@brief Constructor.
+
+	@param mosi Data output pin, such as digitalPinToPinName(MOSI)
+	@param miso Data input pin, such as digitalPinToPinName(MISO)
+	@param sck Clock pin, such as digitalPinToPinName(SCK)
+	@param hz Clock frequency
+	@param mode SPI mode, 0 to 3
+	*/
+	MbedSPIPort(PinName mosi, PinName miso, PinName sck, uint32_t hz = 1000000, int mode = 0);
+	bool start(BusTransaction &t) override;
+	BusStatus status(void) override;
+private:
+	mbed::SPI spi;
+	volatile BusStatus state;
+	volatile int chipSelect;
+	void onEvent(int event);
+};
+
+#endif /* _SENSOR_PORTS_INCLUDE_ */
@@ -0,0 +1,198 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the serial streaming sink of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "SerialStream.h"
+
+uint32_t crc32(const uint8_t *data, int len){
+	//Half-byte table: a good trade between speed and 64 bytes of flash
+	static const uint32_t table[16] = {
+		0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+		0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+	};
+	uint32_t crc = 0xFFFFFFFF;
+	int i;
+
+	for(i = 0; i < len; i++){
+		crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+		crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+	}
+	return ~crc;
+}
+
+int cobsEncode(const uint8_t *in, int len, uint8_t *out){
+	int codePos = 0, outPos = 1, i;
+	uint8_t code = 1;
+
+	for(i = 0; i < len; i++){
+		if(in[i] == 0){
+			out[codePos] = code;
+			codePos = outPos++;
+			code = 1;
+		}
+		else{
+			out[outPos++] = in[i];
+			code++;
+			if(code == 0xFF){		//Longest run a code byte can describe
+				out[codePos] = code;
+				codePos = outPos++;
+				code = 1;
+			}
+		}
+	}
+	out[codePos] = code;
+	return outPos;
+}
+
+int cobsDecode(const uint8_t *in, int len, uint8_t *out){
+	int i = 0, outPos = 0, code, j;
+
+	while(i < len){
+		code = in[i++];
+		if(code == 0 || i + code - 1 > len){
+			return -1;
+		}
+		for(j = 1; j < code; j++){
+			if(in[i] == 0){
+				return -1;
+			}
+			out[outPos++] = in[i++];
+		}
+		if(code < 0xFF && i < len){		//A zero was taken out here, except after the last block
+			out[outPos++] = 0;
+		}
+	}
+	return outPos;
+}
+
+SerialStreamSink::SerialStreamSink(){
+	maxLatency = SERIAL_MAX_LATENCY;
+	framesSent = 0;
+	samplesDropped = 0;
+	port = nullptr;
+	frameLen = 0;
+	outLen = 0;
+	outPos = 0;
+	seq = 0;
+	frameStart = 0;
+	frameTime = 0;
+}
+void SerialStreamSink::begin(Stream &port){
+	this->port = &port;
+}
+bool SerialStreamSink::closeFrame(void){
+	SerialFrameHeader *h = (SerialFrameHeader *)frame;
+	uint32_t crc;
+
+	if(frameLen == 0 || outPos < outLen){	//Nothing to send, or the other buffer is still draining
+		return false;
+	}
+	h->seq = seq++;
+	h->dropped = samplesDropped;
+	crc = crc32(frame, frameLen);
+	memcpy(&frame[frameLen], &crc, sizeof(crc));
+
+	outLen = cobsEncode(frame, frameLen + sizeof(crc), out);
+	out[outLen++] = 0;					//Frame delimiter
+	outPos = 0;
+	frameLen = 0;
+	return true;
+}
+void SerialStreamSink::write(uint64_t t, const float *values, int count){
+	SerialFrameHeader *h = (SerialFrameHeader *)frame;
+	int sampleBytes;
+	uint32_t dt;
+
+	if(port == nullptr || count <= 0 || count > SERIAL_MAX_CHANNELS){
+		return;
+	}
+	sampleBytes = sizeof(uint32_t) + count * sizeof(float);
+
+	if(frameLen > 0 && (h->channels != count || frameLen + sampleBytes > SERIAL_FRAME_BYTES ||
+	                    t < frameTime || t - frameTime > 0xFFFFFFFF)){
+		if(!closeFrame()){		//Both buffers are full: the computer is not keeping up
+			samplesDropped++;
+			return;
+		}
+	}
+	if(frameLen == 0){
+		h->version = SERIAL_STREAM_VERSION;
+		h->channels = count;
+		h->count = 0;
+		h->timeLow = (uint32_t)t;
+		h->timeHigh = (uint32_t)(t >> 32);
+		frameTime = t;
+		frameLen = sizeof(SerialFrameHeader);
+		frameStart = millis();
+	}
+	dt = t - frameTime;
+	memcpy(&frame[frameLen], &dt, sizeof(uint32_t));
+	memcpy(&frame[frameLen + sizeof(uint32_t)], values, count * sizeof(float));
+	frameLen += sampleBytes;
+	h->count++;
+}
+void SerialStreamSink::service(void){
+	int room;
+
+	if(port == nullptr){
+		return;
+	}
+	if(outPos < outLen){
+		room = port->availableForWrite();	//Only what fits in the port's buffer, so this never waits
+		if(room > outLen - outPos){
+			room = outLen - outPos;
+		}
+		if(room > 0){
+			outPos += port->write(&out[outPos], room);
+		}
+		if(outPos >= outLen){
+			framesSent++;
+		}
+	}
+	if(frameLen > 0){	//Swap buffers when the frame is full, or has waited long enough that slow data still arrives promptly
+		SerialFrameHeader *h = (SerialFrameHeader *)frame;
+		if(frameLen + (int)(sizeof(uint32_t) + h->channels * sizeof(float)) > SERIAL_FRAME_BYTES ||
+		   millis() - frameStart >= maxLatency){
+			closeFrame();
+		}
+	}
+}
@@ -0,0 +1,130 @@
+/**
+
+@file
+
+This contains the serial streaming sink of the GigaDAQ project, which sends recorded samples to a computer through the USB-C port as framed binary data. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _SERIAL_STREAM_INCLUDE_
+#define _SERIAL_STREAM_INCLUDE_
+
+#include "Arduino.h"
+#include "DataSink.h"
+
+const uint8_t SERIAL_STREAM_VERSION = 2;	///< Layout version of SerialFrameHeader and the samples after it
+const int SERIAL_FRAME_BYTES = 512;			///< Largest frame before CRC and COBS encoding
+const int SERIAL_MAX_CHANNELS = 16;			///< Most values per sample
+const uint32_t SERIAL_MAX_LATENCY = 50;		///< Default milliseconds a partly filled frame may wait before it is sent
+
+/**
+@brief Start of every serial frame. It is followed by count samples, each a uint32_t time in microseconds after timeLow/timeHigh and then channels float values, and finally a CRC-32 of everything before it. All values are little-endian.
+
+The whole frame is COBS-encoded, so it contains no zero bytes, and a single zero byte ends it. A receiver that starts listening in the middle of a frame simply waits for the next zero.
+*/
+struct SerialFrameHeader {
+	uint8_t version;	///< Must be SERIAL_STREAM_VERSION
+	uint8_t channels;	///< Values per sample
+	uint16_t count;		///< Samples in this frame
+	uint32_t seq;		///< Frame sequence number. A gap means frames were lost.
+	uint32_t dropped;	///< Total samples dropped so far because the computer was not reading fast enough
+	uint32_t timeLow;	///< Low 32 bits of the 64-bit time stamp (microseconds) that sample times count from
+	uint32_t timeHigh;	///< High 32 bits of the same time stamp
+};
+
+/**
+@brief Streams samples to a computer through a serial port (usually the USB-C port, Serial) in binary frames.
+
+Samples are collected in one buffer while the previous frame, already encoded, drains from a second buffer. service() only writes as many bytes as the port can take without waiting, so loop() never waits for the computer. If the computer falls so far behind that both buffers are full, new samples are dropped and counted.
+
+Use extras/serial_capture/serial_capture.py on the computer to decode the stream to a file.
+*/
+class SerialStreamSink : public DataSink {
+public:
+	uint32_t maxLatency;	///< Milliseconds a partly filled frame may wait before it is sent
+	uint32_t framesSent;	///< Frames completely written to the port
+	uint32_t samplesDropped; ///< Samples lost because both buffers were full
+	/** Constructor for a sink that has no port yet */
+	SerialStreamSink();
+	/**
+	@brief Sets the port the frames are written to.
+
+	@param port Serial port, usually Serial (the USB-C port). Start it with begin() first. The port must tell how much it can take without waiting (availableForWrite()): a Stream that leaves it at the default of 0 is never written to, and every sample ends up dropped.
+	*/
+	void begin(Stream &port);
+	/**
+	@brief Adds a sample to the frame being collected. Called by GigaDAQ::recordSample().
+
+	@param t Time stamp in microseconds
+	@param values Array of channel values
+	@param count Number of values, at most SERIAL_MAX_CHANNELS
+	*/
+	void write(uint64_t t, const float *values, int count);
+	/** Writes as much of the encoded frame as the port accepts without waiting */
+	void service(void);
+private:
+	Stream *port;
+	alignas(4) uint8_t frame[SERIAL_FRAME_BYTES + 4];			//Frame being collected, with room for the CRC
+	uint8_t out[SERIAL_FRAME_BYTES + 4 + (SERIAL_FRAME_BYTES + 4)/254 + 2];	//Encoded frame being sent
+	int frameLen;		//Bytes in frame, 0 when no samples are waiting
+	int outLen, outPos;	//Encoded bytes in out and how many are already written
+	uint32_t seq;
+	uint32_t frameStart;
+	uint64_t frameTime;	//Time stamp of the first sample in frame
+	bool closeFrame(void);
+};
+
+/**
+@brief Calculates the CRC-32 used by Ethernet, zip files and so on.
+
+@param data Bytes to check
+@param len Number of bytes
+@returns CRC-32 of the bytes
+*/
+uint32_t crc32(const uint8_t *data, int len);
+
+/**
+@brief Encodes bytes with Consistent Overhead Byte Stuffing (COBS) so that the result contains no zero bytes.
+
+@param in Bytes to encode
+@param len Number of bytes
+@param out Receives the encoded bytes. Must have room for len + len/254 + 1 bytes.
+@returns Number of encoded bytes (not including a frame-ending zero)
+*/
+int cobsEncode(const uint8_t *in, int len, uint8_t *out);
+
+/**
+@brief Decodes bytes encoded with cobsEncode().
+
+@param in Encoded bytes, without the frame-ending zero
+@param len Number of encoded bytes
+@param out Receives the decoded bytes. Must have room for len bytes.
+@returns Number of decoded bytes, or -1 if the bytes are not a valid encoding
+*/
+int cobsDecode(const uint8_t *in, int len, uint8_t *out);
+
+#endif /* _SERIAL_STREAM_INCLUDE_ */
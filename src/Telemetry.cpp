@@ -0,0 +1,178 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the telemetry publisher of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+Libraries:
+Any library with a UDP class, such as WiFiUdp.h
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "Telemetry.h"
+
+TelemetryPublisher::TelemetryPublisher(){
+	maxLatency = TELEMETRY_MAX_LATENCY;
+	framesSent = 0;
+	sendFailures = 0;
+	samplesDropped = 0;
+	bytesSent = 0;
+	udp = nullptr;
+	port = 0;
+	head = 0;
+	tail = 0;
+	waiting = 0;
+	seq = 0;
+	frameStart = 0;
+	frameTime = 0;
+	backoff = 0;
+	nextTry = 0;
+	rateStart = 0;
+	rateBytes = 0;
+	rate = 0;
+	queue[head].header.count = 0;
+}
+void TelemetryPublisher::begin(UDP &udp, IPAddress host, uint16_t port){
+	this->udp = &udp;
+	this->host = host;
+	this->port = port;
+	rateStart = millis();
+}
+int TelemetryPublisher::frameBytes(const Frame &f){
+	return sizeof(TelemetryHeader) + f.header.count * (sizeof(uint32_t) + f.header.channels * sizeof(float));
+}
+void TelemetryPublisher::closeFrame(void){
+	Frame &f = queue[head];
+
+	if(f.header.count == 0){
+		return;
+	}
+	f.header.seq = seq++;
+	f.header.dropped = samplesDropped;
+
+	if(waiting == TELEMETRY_QUEUE - 1){		//No room left. Drop the oldest frame so fresh data gets through.
+		samplesDropped += queue[tail].header.count;
+		tail = (tail + 1) % TELEMETRY_QUEUE;
+		waiting--;
+	}
+	waiting++;
+	head = (head + 1) % TELEMETRY_QUEUE;
+	queue[head].header.count = 0;
+}
+void TelemetryPublisher::write(uint64_t t, const float *values, int count){
+	Frame *f;
+	int sampleBytes, used;
+	uint32_t dt;
+
+	if(udp == nullptr || count <= 0 || count > TELEMETRY_MAX_CHANNELS){
+		return;
+	}
+	f = &queue[head];
+	if(f->header.count > 0 && (f->header.channels != count || t < frameTime || t - frameTime > 0xFFFFFFFF)){
+		closeFrame();	//A frame holds one kind of sample, with times that fit in 32 bits after the first one
+		f = &queue[head];
+	}
+	if(f->header.count == 0){
+		f->header.magic = TELEMETRY_MAGIC;
+		f->header.version = TELEMETRY_VERSION;
+		f->header.channels = count;
+		f->header.reserved = 0;
+		f->header.reserved2 = 0;
+		f->header.timeLow = (uint32_t)t;
+		f->header.timeHigh = (uint32_t)(t >> 32);
+		frameTime = t;
+		frameStart = millis();
+	}
+
+	sampleBytes = sizeof(uint32_t) + count * sizeof(float);
+	used = f->header.count * sampleBytes;
+	dt = t - frameTime;
+	memcpy(&f->data[used], &dt, sizeof(uint32_t));
+	memcpy(&f->data[used + sizeof(uint32_t)], values, count * sizeof(float));
+	f->header.count++;
+
+	if(used + 2*sampleBytes > (int)sizeof(f->data)){	//The next sample would not fit
+		closeFrame();
+	}
+}
+void TelemetryPublisher::service(void){
+	uint32_t now = millis();
+	Frame *f;
+	int bytes;
+	bool ok;
+
+	if(udp == nullptr){
+		return;
+	}
+	if(now - rateStart >= 1000){
+		rate = rateBytes * 1000 / (now - rateStart);
+		rateStart = now;
+		rateBytes = 0;
+	}
+	if(queue[head].header.count > 0 && now - frameStart >= maxLatency){
+		closeFrame();		//Don't let a slow channel hold data back for long
+	}
+	if(waiting == 0 || (backoff != 0 && (int32_t)(now - nextTry) < 0)){
+		return;
+	}
+
+	f = &queue[tail];
+	bytes = frameBytes(*f);
+	ok = udp->beginPacket(host, port) == 1;
+	if(ok){
+		ok = udp->write((const uint8_t *)f, bytes) == (size_t)bytes;
+		ok = udp->endPacket() == 1 && ok;
+	}
+
+	if(ok){
+		tail = (tail + 1) % TELEMETRY_QUEUE;
+		waiting--;
+		framesSent++;
+		bytesSent += bytes;
+		rateBytes += bytes;
+		backoff = 0;
+	}
+	else{	//Network is congested or down. Try again later, waiting twice as long each time.
+		sendFailures++;
+		backoff = (backoff == 0) ? 10 : min(2*backoff, TELEMETRY_MAX_BACKOFF);
+		nextTry = now + backoff;
+	}
+}
+uint32_t TelemetryPublisher::bytesPerSecond(void){
+	return rate;
+}
@@ -0,0 +1,118 @@
+/**
+
+@file
+
+This contains the telemetry publisher of the GigaDAQ project, which streams recorded samples over the network in UDP datagrams. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _TELEMETRY_INCLUDE_
+#define _TELEMETRY_INCLUDE_
+
+#include "Arduino.h"
+#include "DataSink.h"
+
+const uint32_t TELEMETRY_MAGIC = 0x4D544447;	///< "GDTM" at the start of every telemetry datagram
+const uint16_t TELEMETRY_VERSION = 2;			///< Layout version of TelemetryHeader and the samples after it
+const int TELEMETRY_FRAME_BYTES = 1400;			///< Largest datagram sent. Fits in one Ethernet/WiFi packet without fragmenting.
+const int TELEMETRY_QUEUE = 8;					///< Frames that can wait to be sent
+const int TELEMETRY_MAX_CHANNELS = 16;			///< Most values per sample
+const uint32_t TELEMETRY_MAX_LATENCY = 100;		///< Default milliseconds a partly filled frame may wait before it is sent
+const uint32_t TELEMETRY_MAX_BACKOFF = 1000;	///< Longest pause in milliseconds after failed sends
+
+/**
+@brief Start of every telemetry datagram. It is followed by count samples, each a uint32_t time in microseconds after timeLow/timeHigh and then channels float values, all little-endian.
+*/
+struct TelemetryHeader {
+	uint32_t magic;		///< Must be TELEMETRY_MAGIC
+	uint16_t version;	///< Must be TELEMETRY_VERSION
+	uint8_t channels;	///< Values per sample
+	uint8_t reserved;	///< Always 0
+	uint32_t seq;		///< Frame sequence number. A gap means frames were lost on the way or dropped here.
+	uint32_t dropped;	///< Total samples dropped by the publisher so far because the network could not keep up
+	uint16_t count;		///< Samples in this frame
+	uint16_t reserved2;	///< Always 0
+	uint32_t timeLow;	///< Low 32 bits of the 64-bit time stamp (microseconds) that sample times count from
+	uint32_t timeHigh;	///< High 32 bits of the same time stamp
+};
+
+/**
+@brief Streams samples to a computer in compact UDP datagrams.
+
+Samples are batched into frames of up to TELEMETRY_FRAME_BYTES. service() sends at most one frame per call and never waits. When sending fails, the publisher waits longer and longer between attempts (up to TELEMETRY_MAX_BACKOFF), and when the queue is full the oldest frame is dropped so the newest data always gets through. Every frame carries a sequence number and the running count of dropped samples.
+
+Use extras/telemetry/telemetry_receiver.py on the computer to record the stream.
+*/
+class TelemetryPublisher : public DataSink {
+public:
+	uint32_t maxLatency;	///< Milliseconds a partly filled frame may wait before it is sent
+	uint32_t framesSent;	///< Frames handed to the network
+	uint32_t sendFailures;	///< Attempts the network refused
+	uint32_t samplesDropped; ///< Samples lost because the queue was full
+	uint32_t bytesSent;		///< Total bytes handed to the network
+	/** Constructor for a publisher that has no destination yet */
+	TelemetryPublisher();
+	/**
+	@brief Sets where the datagrams go.
+
+	@param udp A UDP object that has been started, such as a WiFiUDP
+	@param host Address of the receiving computer
+	@param port UDP port the receiver listens on
+	*/
+	void begin(UDP &udp, IPAddress host, uint16_t port);
+	/**
+	@brief Adds a sample to the current frame. Called by GigaDAQ::recordSample().
+
+	@param t Time stamp in microseconds
+	@param values Array of channel values
+	@param count Number of values, at most TELEMETRY_MAX_CHANNELS
+	*/
+	void write(uint64_t t, const float *values, int count);
+	/** Sends at most one waiting frame, unless backing off after a failure */
+	void service(void);
+	/** @returns Bytes per second handed to the network, averaged over the last second or so */
+	uint32_t bytesPerSecond(void);
+private:
+	struct Frame {
+		TelemetryHeader header;
+		uint8_t data[TELEMETRY_FRAME_BYTES - sizeof(TelemetryHeader)];
+	};
+	UDP *udp;
+	IPAddress host;
+	uint16_t port;
+	Frame queue[TELEMETRY_QUEUE];
+	int head, tail, waiting;	//Frames are filled at head and sent from tail
+	uint32_t seq;
+	uint32_t frameStart;		//When the frame being filled got its first sample
+	uint64_t frameTime;			//Time stamp of the first sample in the frame being filled
+	uint32_t backoff, nextTry;
+	uint32_t rateStart, rateBytes, rate;
+	void closeFrame(void);
+	int frameBytes(const Frame &f);
+};
+
+#endif /* _TELEMETRY_INCLUDE_ */
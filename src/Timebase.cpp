@@ -0,0 +1,198 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the timebase of the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+Hardware:
+Arduino GIGA R1 WiFi
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "Timebase.h"
+
+static uint32_t microsCounter(void){
+	return micros();
+}
+
+Timebase::Timebase(){
+	counter = microsCounter;
+	rtc = time;
+	interval = TIMEBASE_INTERVAL;
+	lastError = 0;
+	alignments = 0;
+	lastCount = 0;
+	wraps = 0;
+	anchorTime = 0;
+	anchorTicks = 0;
+	rate = 0;
+	freq = 0;
+	firstTicks = 0;
+	firstSec = 0;
+	lastAlign = 0;
+	lastPoll = 0;
+	edgeSec = 0;
+	waiting = false;
+}
+uint64_t Timebase::readTicks(void){
+	uint32_t count = counter();
+
+	if(count < lastCount){
+		wraps++;
+	}
+	lastCount = count;
+	return ((uint64_t)wraps << 32) | count;
+}
+uint64_t Timebase::timeAt(uint64_t t){
+	int64_t d = t - anchorTicks;
+
+	//d * rate / 2^32 in two parts, so it cannot overflow however long service() is not called, and needs no division
+	return anchorTime + d + (d >> 32) * rate + (((d & 0xFFFFFFFF) * rate) >> 32);
+}
+uint64_t Timebase::ticks(void){
+	uint32_t primask = __get_PRIMASK();		//An interrupt could read the counter between our steps
+	uint64_t t;
+
+	__disable_irq();
+	t = readTicks();
+	__set_PRIMASK(primask);
+	return t;
+}
+uint64_t Timebase::now(void){
+	uint32_t primask = __get_PRIMASK();
+	uint64_t t;
+
+	__disable_irq();
+	t = timeAt(readTicks());
+	__set_PRIMASK(primask);
+	return t;
+}
+void Timebase::setAnchor(uint64_t time, uint64_t t, int32_t r){
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	anchorTime = time;
+	anchorTicks = t;
+	rate = r;
+	__set_PRIMASK(primask);
+}
+int32_t Timebase::ppb(void){
+	return ((int64_t)rate * 1000000000) >> 32;
+}
+void Timebase::begin(void){
+	time_t sec = rtc(NULL), next;
+	uint64_t start = ticks(), t;
+
+	do{		//Wait for the tick so that the clock starts on a whole second
+		next = rtc(NULL);
+		t = ticks();
+	}while(next == sec && t - start < 1100000);
+
+	setAnchor((uint64_t)next * 1000000, t, 0);
+	freq = 0;
+	firstTicks = t;
+	firstSec = next;
+	lastAlign = t;
+	lastPoll = t;
+	lastError = 0;
+	waiting = false;
+}
+void Timebase::service(void){
+	uint64_t t = ticks(), edge, elapsed;
+	time_t sec;
+	int64_t error, doubt, measured, slew, r;
+
+	if(!waiting){
+		if(t - lastAlign >= (uint64_t)interval * 1000000){
+			edgeSec = rtc(NULL);
+			waiting = true;
+		}
+		lastPoll = t;
+		return;
+	}
+	sec = rtc(NULL);
+	if(sec == edgeSec){
+		lastPoll = t;
+		return;
+	}
+
+	//The RTC ticked some time since the last poll. Take the middle, which is off by no more than half the gap.
+	edge = lastPoll + (t - lastPoll) / 2;
+	doubt = (t - lastPoll) / 2;
+	lastPoll = t;
+	waiting = false;
+	lastAlign = t;
+	alignments++;
+	error = (int64_t)sec * 1000000 - (int64_t)timeAt(edge);
+	lastError = error;
+
+	if(error > TIMEBASE_STEP_LIMIT){	//The RTC was set ahead: jump, since moving forward keeps time stamps in order
+		setAnchor(timeAt(t) + error, t, rate);
+		firstTicks = edge;
+		firstSec = sec;
+		return;
+	}
+
+	if(error < -TIMEBASE_STEP_LIMIT){	//The RTC was set back. Catch up gradually, but measure the rate from here on.
+		firstTicks = edge;
+		firstSec = sec;
+	}
+
+	//Rate of the counter against the RTC, measured over everything since begin() so that it gets steadier over time
+	elapsed = edge - firstTicks;
+	measured = (elapsed > 0) ? (int64_t)(((double)(sec - firstSec) * 1000000 - (double)elapsed) * 1e9 / (double)elapsed) : freq;
+	if(measured > -TIMEBASE_MAX_PPB && measured < TIMEBASE_MAX_PPB){
+		freq = measured;
+	}
+	else{		//The RTC is not running properly. Start measuring again from here.
+		firstTicks = edge;
+		firstSec = sec;
+	}
+
+	//Take out the error gradually over the next interval, apart from the part that may just be polling late
+	if(error > doubt){
+		slew = (error - doubt) * 1000 / (int64_t)interval;
+	}
+	else if(error < -doubt){
+		slew = (error + doubt) * 1000 / (int64_t)interval;
+	}
+	else{
+		slew = 0;
+	}
+	r = freq + slew;
+	if(r > TIMEBASE_MAX_PPB) r = TIMEBASE_MAX_PPB;
+	if(r < -TIMEBASE_MAX_PPB) r = -TIMEBASE_MAX_PPB;
+	setAnchor(timeAt(t), t, (r << 32) / 1000000000);		//Restart from the current time so the clock never jumps
+}
@@ -0,0 +1,101 @@
+/**
+
+@file
+
+This contains the timebase of the GigaDAQ project, a 64-bit microsecond clock for time stamping samples that is kept in step with the real-time clock. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _TIMEBASE_INCLUDE_
+#define _TIMEBASE_INCLUDE_
+
+#include "Arduino.h"
+#include <time.h>
+
+const uint32_t TIMEBASE_INTERVAL = 60;			///< Default seconds between alignments to the real-time clock
+const int32_t TIMEBASE_MAX_PPB = 500000;		///< Largest rate correction, in parts per billion (0.05%)
+const int64_t TIMEBASE_STEP_LIMIT = 1000000;	///< Microseconds behind the real-time clock beyond which the clock jumps ahead instead of catching up gradually
+
+/**
+@brief A 64-bit clock in microseconds since 1970 (UTC, or whatever the real-time clock is set to), for time stamping samples.
+
+The clock counts with the 32-bit microsecond hardware counter behind micros(), which is fast to read but wraps every 71.6 minutes and runs a little fast or slow. now() extends the counter to 64 bits, so it never wraps, and service() regularly compares it with the real-time clock (RTC). Small differences are removed by running the clock slightly faster or slower, never by turning it back, so time stamps always increase. The rate correction that is learned also makes up for the counter's crystal running fast or slow.
+
+As a float, seconds since power-up lose millisecond resolution after about 4.6 hours. Keep time stamps as uint64_t and convert them only for display.
+
+@note now() must be called at least once every 71 minutes to notice the counter wrapping around. GigaDAQ::handleInputs() calls service(), which takes care of this.
+*/
+class Timebase {
+public:
+	uint32_t (*counter)(void);	///< Free-running 32-bit microsecond counter, micros() unless changed
+	time_t (*rtc)(time_t *);	///< Real-time clock in seconds, time() unless changed
+	uint32_t interval;			///< Seconds between alignments to the real-time clock
+	int64_t lastError;			///< Microseconds the clock was behind the real-time clock at the last alignment (negative if ahead)
+	uint32_t alignments;		///< Number of alignments so far
+	/** Constructor for a clock that starts at 0 until begin() is called */
+	Timebase();
+	/**
+	@brief Sets the clock to the real-time clock. Called by GigaDAQ::begin().
+
+	Waits (up to a little over a second) for the real-time clock to tick over to the next second, so that the clock starts in step with it to within a few microseconds.
+
+	@note This may turn the clock back. Call it before taking samples, not during a recording.
+	*/
+	void begin(void);
+	/**
+	@brief Reads the clock. Safe to call from interrupts, and quick enough to call for every sample.
+
+	@returns Microseconds since 1970
+	*/
+	uint64_t now(void);
+	/**
+	@brief Reads the hardware counter extended to 64 bits, without any correction.
+
+	@returns Microseconds since power-up, as counted by the hardware
+	*/
+	uint64_t ticks(void);
+	/** Aligns the clock to the real-time clock every interval seconds. Call often: the clock can only be as close to the real-time clock as the time between calls. It returns immediately when there is nothing to do. */
+	void service(void);
+	/** @returns Current rate correction in parts per billion. Positive means the clock is running faster than the counter. */
+	int32_t ppb(void);
+private:
+	volatile uint32_t lastCount;	//Counter value at the last read, to notice it wrapping around
+	volatile uint32_t wraps;		//Times the counter has wrapped around
+	uint64_t anchorTime, anchorTicks;	//Clock time at a counter reading; the clock runs from there at rate
+	int32_t rate;					//Rate correction in units of 2^-32, so that applying it is a multiplication and a shift
+	int64_t freq;					//Measured rate difference of the counter and the RTC, parts per billion
+	uint64_t firstTicks;			//Counter at the RTC tick that begin() waited for
+	time_t firstSec;
+	uint64_t lastAlign, lastPoll;
+	time_t edgeSec;					//RTC second being watched for its tick
+	bool waiting;					//True while watching for a tick
+	uint64_t readTicks(void);
+	uint64_t timeAt(uint64_t t);
+	void setAnchor(uint64_t time, uint64_t t, int32_t r);
+};
+
+#endif /* _TIMEBASE_INCLUDE_ */
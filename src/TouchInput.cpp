@@ -0,0 +1,216 @@
+/**
+
+@file
+
+@section intro_sec Introduction
+
+This contains the touch sample queue and the gesture decoder for the GigaDAQ project. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+@section dependencies Dependencies
+
+None. This file can be compiled on a desktop computer to replay recorded touch traces.
+
+@section author Author
+
+Written by David A. Trevas
+
+@section license License
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <math.h>
+#include "TouchInput.h"
+
+TouchSample::TouchSample(){
+	contacts = 0;
+	x[0] = x[1] = 0;
+	y[0] = y[1] = 0;
+	t = 0;
+}
+
+TouchQueue::TouchQueue(){
+	overruns = 0;
+	head = 0;
+	tail = 0;
+}
+bool TouchQueue::push(const TouchSample &s){
+	unsigned int next = (head + 1) % TOUCH_QUEUE_SIZE;
+
+	if(next == tail){	//Full. Keep the older samples so a release is never lost behind a burst.
+		overruns++;
+		return false;
+	}
+	samples[head] = s;
+	__sync_synchronize();	//The sample must be completely written before it is published
+	head = next;
+	return true;
+}
+bool TouchQueue::pop(TouchSample &s){
+	if(tail == head){
+		return false;
+	}
+	__sync_synchronize();
+	s = samples[tail];
+	tail = (tail + 1) % TOUCH_QUEUE_SIZE;
+	return true;
+}
+bool TouchQueue::empty(void){
+	return tail == head;
+}
+
+Gesture::Gesture(){
+	type = GESTURE_NONE;
+	x = 0;
+	y = 0;
+	scale = 1.0;
+	t = 0;
+}
+
+static float spacing(const TouchSample &s){
+	float dx = (float)s.x[1] - (float)s.x[0];
+	float dy = (float)s.y[1] - (float)s.y[0];
+
+	return sqrtf(dx*dx + dy*dy);
+}
+
+GestureDecoder::GestureDecoder(){
+	longPressTime = LONG_PRESS_TIME;
+	releaseTimeout = RELEASE_TIMEOUT;
+	dragThreshold = DRAG_THRESHOLD;
+	reset();
+}
+void GestureDecoder::reset(void){
+	state = IDLE;
+	startX = startY = lastX = lastY = 0;
+	downT = lastT = 0;
+	pinchStart = 0.0;
+	again = false;
+}
+bool GestureDecoder::touching(void){
+	return state != IDLE;
+}
+bool GestureDecoder::refeed(void){
+	return again;
+}
+bool GestureDecoder::feed(const TouchSample &s, Gesture &g){
+	int dx, dy;
+	float d;
+
+	g = Gesture();
+	g.t = s.t;
+	again = false;
+
+	if(state != IDLE && s.t - lastT >= releaseTimeout){	//The finger was lifted before this sample, but the samples waited in the queue
+		g.type = GESTURE_RELEASE;
+		g.t = lastT + releaseTimeout;
+		g.x = lastX;
+		g.y = lastY;
+		state = IDLE;
+		again = (s.contacts > 0);		//The sample starts a new touch
+		return true;
+	}
+	if(s.contacts == 0){		//Some controllers report the lift explicitly. Others just go quiet (see poll()).
+		if(state == IDLE){
+			return false;
+		}
+		g.type = GESTURE_RELEASE;
+		g.x = lastX;
+		g.y = lastY;
+		state = IDLE;
+		return true;
+	}
+
+	lastT = s.t;
+
+	if(s.contacts >= 2){
+		d = spacing(s);
+		g.x = (s.x[0] + s.x[1])/2;
+		g.y = (s.y[0] + s.y[1])/2;
+		lastX = g.x;
+		lastY = g.y;
+		if(state != PINCHING){
+			state = PINCHING;
+			pinchStart = d;
+		}
+		g.type = GESTURE_PINCH;
+		g.scale = (pinchStart > 0.0) ? d/pinchStart : 1.0;
+		return true;
+	}
+
+	//One finger from here on
+	g.x = s.x[0];
+	g.y = s.y[0];
+
+	switch(state){
+		case IDLE:
+			state = DOWN;
+			startX = lastX = s.x[0];
+			startY = lastY = s.y[0];
+			downT = s.t;
+			g.type = GESTURE_PRESS;
+			return true;
+		case PINCHING:		//One finger of a pinch lifted. Ignore it rather than jump to where it is.
+			return false;
+		case DOWN:
+		case HELD:
+			dx = (int)s.x[0] - (int)startX;
+			dy = (int)s.y[0] - (int)startY;
+			if((unsigned int)(dx*dx + dy*dy) < dragThreshold*dragThreshold){
+				return false;	//Jitter of a stationary finger
+			}
+			state = DRAGGING;
+			break;
+		case DRAGGING:
+			if(s.x[0] == lastX && s.y[0] == lastY){
+				return false;
+			}
+			break;
+	}
+	lastX = s.x[0];
+	lastY = s.y[0];
+	g.type = GESTURE_DRAG;
+	return true;
+}
+bool GestureDecoder::poll(uint32_t now, Gesture &g){
+	g = Gesture();
+	g.t = now;
+	g.x = lastX;
+	g.y = lastY;
+
+	if(state == IDLE){
+		return false;
+	}
+	if(now - lastT >= releaseTimeout){
+		state = IDLE;
+		g.type = GESTURE_RELEASE;
+		return true;
+	}
+	if(state == DOWN && now - downT >= longPressTime){
+		state = HELD;
+		g.type = GESTURE_LONG_PRESS;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,157 @@
+/**
+
+@file
+
+This contains the touch sample queue and the gesture decoder for the GigaDAQ project. Touch samples are queued with timestamps as the touch controller reports them and decoded into presses, drags, long presses, releases and two-finger pinches. This software is specifically for use with the Arduino GIGA R1 WiFi with the Arduino GIGA Display Shield, and allows you to make a standalone data-acquisition system (DAQ) that is interactive and can record data to a flash drive.
+
+The queue and decoder only depend on stdint.h, so recorded touch traces can be replayed through them on a desktop computer.
+
+Written by David A. Trevas
+
+MIT License
+
+Copyright (c) 2025 David A. Trevas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef _TOUCH_INPUT_INCLUDE_
+#define _TOUCH_INPUT_INCLUDE_
+
+#include <stdint.h>
+
+const int TOUCH_QUEUE_SIZE = 32;			///< Number of touch samples that can wait to be handled
+const uint32_t LONG_PRESS_TIME = 600;		///< Default milliseconds a finger must stay still for a long press
+const uint32_t RELEASE_TIMEOUT = 80;		///< Default milliseconds without a report before the finger is considered lifted
+const unsigned int DRAG_THRESHOLD = 8;		///< Default pixels a finger must move before a press becomes a drag
+
+/** Gestures recognized by the GestureDecoder */
+enum GestureType {
+	GESTURE_NONE = 0,	/**< No gesture */
+	GESTURE_PRESS,		/**< A finger landed on the screen */
+	GESTURE_DRAG,		/**< A finger moved while touching the screen */
+	GESTURE_LONG_PRESS,	/**< A finger stayed still for LONG_PRESS_TIME */
+	GESTURE_RELEASE,	/**< The finger(s) left the screen */
+	GESTURE_PINCH		/**< Two fingers moved closer together or farther apart */
+};
+
+/**
+@brief One report from the touch controller with the time it was taken.
+*/
+class TouchSample {
+public:
+	uint8_t contacts;	///< Number of fingers on the screen. Zero means the screen was released.
+	uint16_t x[2];		///< x-pixels of the first two touch points
+	uint16_t y[2];		///< y-pixels of the first two touch points
+	uint32_t t;			///< Time stamp of the report in milliseconds
+	/** Constructor for a TouchSample. Initializes with no contacts */
+	TouchSample();
+};
+
+/**
+@brief Fixed-size queue of touch samples.
+
+One side (the touch interrupt) pushes and the other (handleInputs) pops, so no locking is needed. When the queue is full, new samples are dropped and counted in overruns.
+*/
+class TouchQueue {
+public:
+	unsigned int overruns;	///< Number of samples dropped because the queue was full
+	/** Constructor for an empty TouchQueue */
+	TouchQueue();
+	/**
+	@brief Adds a sample to the end of the queue.
+
+	@param s Sample to be added
+	@returns true on success, false if the queue was full
+	*/
+	bool push(const TouchSample &s);
+	/**
+	@brief Removes the oldest sample from the queue.
+
+	@param s Receives the oldest sample
+	@returns true on success, false if the queue was empty
+	*/
+	bool pop(TouchSample &s);
+	/** @returns true if no samples are waiting */
+	bool empty(void);
+private:
+	TouchSample samples[TOUCH_QUEUE_SIZE];
+	volatile unsigned int head;
+	volatile unsigned int tail;
+};
+
+/**
+@brief A decoded gesture with the position and time it refers to.
+*/
+class Gesture {
+public:
+	GestureType type;	///< Which gesture occurred
+	uint16_t x;			///< x-pixel of the finger (midpoint of both fingers for a pinch)
+	uint16_t y;			///< y-pixel of the finger (midpoint of both fingers for a pinch)
+	float scale;		///< Pinch only: current finger spacing divided by spacing when the pinch began
+	uint32_t t;			///< Time stamp of the gesture in milliseconds
+	/** Constructor for a Gesture. Initializes to GESTURE_NONE */
+	Gesture();
+};
+
+/**
+@brief State machine that turns timestamped touch samples into gestures.
+
+Call feed() for every sample and poll() regularly with the current time. poll() produces the gestures that depend on time passing with no new samples: long presses and releases. When samples waited in the queue, a gap of releaseTimeout between two of them also ends the touch: feed() then gives the release, and refeed() tells that the sample has to be fed again to start the next touch.
+*/
+class GestureDecoder {
+public:
+	uint32_t longPressTime;		///< Milliseconds a finger must stay still for a long press
+	uint32_t releaseTimeout;	///< Milliseconds without a sample before the finger is considered lifted
+	unsigned int dragThreshold;	///< Pixels a finger must move before a press becomes a drag
+	/** Constructor for a GestureDecoder using the default timings */
+	GestureDecoder();
+	/**
+	@brief Interprets one touch sample.
+
+	@param s Sample from the touch controller
+	@param g Receives the gesture, if any
+	@returns true if a gesture was produced
+	*/
+	bool feed(const TouchSample &s, Gesture &g);
+	/**
+	@brief Checks for gestures caused by the passage of time.
+
+	@param now Current time in milliseconds, in the same timebase as the samples
+	@param g Receives the gesture, if any
+	@returns true if a gesture was produced
+	*/
+	bool poll(uint32_t now, Gesture &g);
+	/** @returns true if the last feed() gave the release of an earlier touch without using its sample, which must be fed again */
+	bool refeed(void);
+	/** @returns true if a finger is currently considered to be on the screen */
+	bool touching(void);
+	/** Forgets any gesture in progress */
+	void reset(void);
+private:
+	enum DecoderState { IDLE, DOWN, HELD, DRAGGING, PINCHING };
+	DecoderState state;
+	uint16_t startX, startY, lastX, lastY;
+	uint32_t downT, lastT;
+	float pinchStart;
+	bool again;
+};
+
+#endif /* _TOUCH_INPUT_INCLUDE_ */